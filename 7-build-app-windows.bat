@@ -132,6 +132,8 @@ echo Package Publish Windows Binaries
 tar -czvf release_win\windows-publish-binaries.tar.gz -C publish_win .
 
 echo Package Publish Windows Binaries
+call robocopy src\huffmancodec\header "build_win\build\Release" /E
+call robocopy src\memoryarena\header "build_win\build\Release" /E
 call robocopy src\userauthentication\header "build_win\build\Release" /E
 call robocopy src\ingredientmanagement\header "build_win\build\Release" /E
 call robocopy src\recipecosting\header "build_win\build\Release" /E
@@ -141,6 +143,8 @@ call robocopy src\costcalculatorapp\header "build_win\build\Release" /E
 tar -czvf release_win\windows-release-binaries.tar.gz -C build_win\build\Release .
 
 echo Package Publish Debug Windows Binaries
+call robocopy src\huffmancodec\header "build_win\build\Debug" /E
+call robocopy src\memoryarena\header "build_win\build\Debug" /E
 call robocopy src\userauthentication\header "build_win\build\Debug" /E
 call robocopy src\ingredientmanagement\header "build_win\build\Debug" /E
 call robocopy src\recipecosting\header "build_win\build\Debug" /E
@@ -32,6 +32,8 @@ cd ..
 echo Running Test Executable
 
 call .\publish_win\bin\utility_tests.exe
+call .\publish_win\bin\huffmancodec_tests.exe
+call .\publish_win\bin\memoryarena_tests.exe
 call .\publish_win\bin\userauthentication_tests.exe
 call .\publish_win\bin\ingredientmanagement_tests.exe
 call .\publish_win\bin\recipecosting_tests.exe
@@ -45,6 +47,8 @@ echo Package Publish Windows Binaries
 tar -czvf release\windows-publish-binaries.tar.gz -C publish .
 
 echo Package Publish Windows Binaries
+call robocopy src\huffmancodec\header "build_win\build\Release" /E
+call robocopy src\memoryarena\header "build_win\build\Release" /E
 call robocopy src\userauthentication\header "build_win\build\Release" /E
 call robocopy src\ingredientmanagement\header "build_win\build\Release" /E
 call robocopy src\recipecosting\header "build_win\build\Release" /E
@@ -54,6 +58,8 @@ call robocopy src\costcalculatorapp\header "build_win\build\Release" /E
 tar -czvf release_win\windows-release-binaries.tar.gz -C build_win\build\Release .
 
 echo Package Publish Debug Windows Binaries
+call robocopy src\huffmancodec\header "build_win\build\Debug" /E
+call robocopy src\memoryarena\header "build_win\build\Debug" /E
 call robocopy src\userauthentication\header "build_win\build\Debug" /E
 call robocopy src\ingredientmanagement\header "build_win\build\Debug" /E
 call robocopy src\recipecosting\header "build_win\build\Debug" /E
@@ -5,10 +5,26 @@
 #include "../../recipecosting/header/recipecosting.h"
 #include "../../userauthentication/header/userauthentication.h"
 #include "../../ingredientmanagement/header/ingredientmanagement.h"
+#include "../../ingredientmanagement/header/ingredientcatalog.h"
+#include "../../ingredientmanagement/header/ingredientpricetable.h"
 #include "../../budgetplanner/header/budgetplanner.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+/**
+ * @brief Prints every recipe with the sum of its ingredient prices.
+ * @param recipes Recipes to print
+ * @param recipeCount Number of recipes
+ * @param prices Price table of the ingredients
+ */
+static void printRecipesWithPrices(const Recipe* recipes, int recipeCount, const IngredientPriceTable* prices) {
+    for (int i = 0; i < recipeCount; i++) {
+        double recipeCost = sumIngredientPrices(prices, recipes[i].ingredients, recipes[i].ingredientCount, NULL);
+        printf("ID: %d | Name: %s | Price: %.2f TL\n", i + 1, recipes[i].name, recipeCost);
+    }
+    printf("\n");
+}
+
 /**
   * @brief Plans meals and updates the budget
   * @param pathFileRecipes Path to the file containing recipes
@@ -18,7 +34,10 @@
   */
 int planMeals(const char* pathFileRecipes, const char* pathFileIngredients, double* budget) {
     Recipe recipes[MAX_RECIPES];
-    Ingredient* ingredientList = loadIngredientsFromFile(pathFileIngredients);
+    MemoryArena ingredientArena;
+    initMemoryArena(&ingredientArena, 0);
+    IngredientCatalog ingredientCatalog;
+    loadIngredientCatalogInArena(&ingredientCatalog, pathFileIngredients, &ingredientArena);
     int recipeCount = loadRecipesFromFile(pathFileRecipes, recipes, MAX_RECIPES);
 
     if (recipeCount == 0) {
@@ -27,6 +46,15 @@ int planMeals(const char* pathFileRecipes, const char* pathFileIngredients, doub
         return 0;
     }
 
+    // Costing only reads IDs and prices, so build the compact table once for the whole session
+    IngredientPriceTable ingredientPrices;
+    if (!buildIngredientPriceTable(&ingredientPrices, &ingredientCatalog)) {
+        freeIngredientCatalog(&ingredientCatalog);
+        printf("\nIngredient prices could not be loaded for meal planning.\n");
+        enterToContinue();
+        return 0;
+    }
+
     double totalCost = 0;
     int selectedRecipeIds[MAX_RECIPES];
     int selectedRecipeCount = 0;
@@ -36,7 +64,7 @@ int planMeals(const char* pathFileRecipes, const char* pathFileIngredients, doub
     // Step 1: List available recipes
     clearScreen();
     printf("\n=== Available Recipes ===\n\n");
-    listRecipesWithPrices(pathFileRecipes, pathFileIngredients);
+    printRecipesWithPrices(recipes, recipeCount, &ingredientPrices);
 
     // Step 2: Allow user to select recipes by ID
     printf("\n=== Recipe Selection ===\n");
@@ -60,15 +88,7 @@ int planMeals(const char* pathFileRecipes, const char* pathFileIngredients, doub
         Recipe* selectedRecipe = &recipes[recipeId - 1]; // Adjusting for 0-based indexing
 
         // Calculate the cost of the selected recipe
-        double recipeCost = 0;
-        Ingredient* currentIngredient = ingredientList;
-        for (int i = 0; i < selectedRecipe->ingredientCount; i++) {
-            while (currentIngredient != NULL) {
-                if (currentIngredient->id == selectedRecipe->ingredients[i]) { recipeCost += currentIngredient->price; break; }
-                currentIngredient = currentIngredient->next;
-            }
-            currentIngredient = ingredientList; // Reset pointer to beginning of ingredient list
-        }
+        double recipeCost = sumIngredientPrices(&ingredientPrices, selectedRecipe->ingredients, selectedRecipe->ingredientCount, NULL);
 
         // Check if the recipe can be added to the budget
         if (totalCost + recipeCost > *budget) { printf("\nCannot add '%s' due to budget constraints.\n\n", selectedRecipe->name); }
@@ -92,11 +112,8 @@ int planMeals(const char* pathFileRecipes, const char* pathFileIngredients, doub
     *budget = remainingBudget;
 
     // Clean up ingredient list memory
-    while (ingredientList != NULL) {
-        Ingredient* temp = ingredientList;
-        ingredientList = ingredientList->next;
-        free(temp);
-    }
+    freeIngredientPriceTable(&ingredientPrices);
+    freeIngredientCatalog(&ingredientCatalog);
 
     enterToContinue();
     return 1;
@@ -106,34 +123,29 @@ int planMeals(const char* pathFileRecipes, const char* pathFileIngredients, doub
  * @brief Lists all recipes with their prices
  * @param pathFileRecipes Path to the file containing recipes
  * @param pathFileIngredients Path to the file containing ingredients
- * @return Returns 1 if successful, 0 if no recipes found
+ * @return Returns 1 if successful, 0 if no recipes found or the prices could not be loaded
  */
 int listRecipesWithPrices(const char* pathFileRecipes, const char* pathFileIngredients) {
     Recipe recipes[MAX_RECIPES];
-    Ingredient* ingredientList = loadIngredientsFromFile(pathFileIngredients);
+    MemoryArena ingredientArena;
+    initMemoryArena(&ingredientArena, 0);
+    IngredientCatalog ingredientCatalog;
+    loadIngredientCatalogInArena(&ingredientCatalog, pathFileIngredients, &ingredientArena);
     int recipeCount = loadRecipesFromFile(pathFileRecipes, recipes, MAX_RECIPES);
 
     if (recipeCount == 0) { printf("\nNo recipes found.\n\n"); return 0; }
 
-    for (int i = 0; i < recipeCount; i++) {
-        double recipeCost = 0;
-        Ingredient* currentIngredient = ingredientList;
-        for (int j = 0; j < recipes[i].ingredientCount; j++) {
-            while (currentIngredient != NULL) {
-                if (currentIngredient->id == recipes[i].ingredients[j]) { recipeCost += currentIngredient->price; break; }currentIngredient = currentIngredient->next;
-            }
-            currentIngredient = ingredientList; // Reset pointer to beginning of ingredient list
-        }
-        printf("ID: %d | Name: %s | Price: %.2f TL\n", i + 1, recipes[i].name, recipeCost);
+    IngredientPriceTable ingredientPrices;
+    if (!buildIngredientPriceTable(&ingredientPrices, &ingredientCatalog)) {
+        freeIngredientCatalog(&ingredientCatalog);
+        printf("\nIngredient prices could not be loaded.\n\n");
+        return 0;
     }
-    printf("\n");
+    printRecipesWithPrices(recipes, recipeCount, &ingredientPrices);
 
     // Clean up ingredient list memory
-    while (ingredientList != NULL) {
-        Ingredient* temp = ingredientList;
-        ingredientList = ingredientList->next;
-        free(temp);
-    }
+    freeIngredientPriceTable(&ingredientPrices);
+    freeIngredientCatalog(&ingredientCatalog);
     return 1;
 }
 
@@ -8,22 +8,96 @@
 
  // Standard Libraries
 #include "stdio.h"
+#include "string.h"
 #include "../../userauthentication/header/userauthentication.h"
 #include "../../ingredientmanagement/header/ingredientmanagement.h"// Adjust this include path based on your project structure
+#include "../../ingredientmanagement/header/ingredientio.h"
+#include "../../recipecosting/header/recipeexport.h"
+
+/**
+ * @brief Imports a CSV file of ingredients without starting the menu.
+ *
+ * @param csvPath The CSV file to import.
+ * @param pathFileIngredients The ingredient file to add the ingredients to.
+ * @return int Program exit status (0: success, 1: failure)
+ */
+static int runIngredientImport(const char* csvPath, const char* pathFileIngredients) {
+	IngredientImportResult result;
+	if (!importIngredientsFromCsv(csvPath, pathFileIngredients, &result)) {
+		return 1;
+	}
+
+	printf("Imported %d ingredient(s) from %s.\n", result.imported, csvPath);
+	if (result.imported > 0) {
+		printf("New ingredient IDs: %d to %d.\n", result.firstId, result.firstId + result.imported - 1);
+	}
+	if (result.rejected > 0) {
+		printf("Skipped %d invalid row(s), the first on line %d.\n", result.rejected, result.firstRejectedLine);
+	}
+	return 0;
+}
+
+/**
+ * @brief Exports the ingredients or the costed recipes without starting the menu.
+ *
+ * @param what "--export-ingredients" or "--export-recipes".
+ * @param formatName "csv" or "json".
+ * @param outputPath The file to write.
+ * @param pathFileIngredients The ingredient file to read.
+ * @param pathFileRecipes The recipe file to read.
+ * @return int Program exit status (0: success, 1: failure)
+ */
+static int runExport(const char* what, const char* formatName, const char* outputPath, const char* pathFileIngredients, const char* pathFileRecipes) {
+	ExportFormat format;
+	if (!parseExportFormat(formatName, &format)) {
+		printf("Unknown export format '%s', use csv or json.\n", formatName);
+		return 1;
+	}
+
+	bool ok;
+	if (strcmp(what, "--export-recipes") == 0) {
+		ok = exportRecipes(pathFileRecipes, pathFileIngredients, outputPath, format);
+	}
+	else {
+		MemoryArena arena;
+		initMemoryArena(&arena, 0);
+		ok = exportIngredients(loadIngredientsFromFileInArena(pathFileIngredients, &arena), outputPath, format);
+		freeMemoryArena(&arena);
+	}
+	if (ok) {
+		printf("Exported to %s.\n", outputPath);
+	}
+	return ok ? 0 : 1;
+}
 
 /**
  * @brief Main program function
  *
  * This function is the main entry point of the program. It defines the necessary file paths
  * for user authentication and ingredient management operations and starts the main menu.
+ * Run with --import-csv <file> to bulk import ingredients, or with --export-ingredients or
+ * --export-recipes followed by csv or json and an output file to export them, instead.
  *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
  * @return int Program exit status (0: success)
  */
-int main() {
+int main(int argc, char** argv) {
 	const char* pathFileUsers = "users.bin";
 	const char* pathFileIngredients = "ingredient.bin";
 	const char* pathFileRecipes = "recipes.bin";
 
+	if (argc == 3 && strcmp(argv[1], "--import-csv") == 0) {
+		return runIngredientImport(argv[2], pathFileIngredients);
+	}
+	if (argc == 4 && (strcmp(argv[1], "--export-ingredients") == 0 || strcmp(argv[1], "--export-recipes") == 0)) {
+		return runExport(argv[1], argv[2], argv[3], pathFileIngredients, pathFileRecipes);
+	}
+	if (argc > 1) {
+		printf("Usage: %s [--import-csv <file> | --export-ingredients csv|json <file> | --export-recipes csv|json <file>]\n", argv[0]);
+		return 1;
+	}
+
 	mainMenu(pathFileUsers, pathFileIngredients, pathFileRecipes);
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,60 @@
+/**
+ * @file huffmancodec.h
+ * @brief Header file for the canonical Huffman codec, including length-limited code construction
+ * and reusable encoder and decoder objects that work on plain byte buffers.
+ */
+#ifndef HUFFMANCODEC_H
+#define HUFFMANCODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Longest code the codec assigns to a symbol.
+ */
+#define HUFFMAN_MAX_CODE_LENGTH 16
+
+/**
+ * @brief Number of bits resolved by a single lookup in the decode table.
+ */
+#define HUFFMAN_TABLE_BITS 10
+
+/**
+ * @brief Upper bound of the encoded size in bytes of a buffer of the given size.
+ */
+#define HUFFMAN_MAX_ENCODED_SIZE(size) (((size) * HUFFMAN_MAX_CODE_LENGTH + 7) / 8)
+
+/**
+ * @brief Canonical Huffman encoder struct definition.
+ *
+ * Codes are assigned in canonical order, shorter codes first and symbols of the same length in
+ * ascending byte order, so the code lengths alone describe the whole code.
+ */
+typedef struct HuffmanEncoder {
+    uint8_t lengths[256]; /**< Code length of each byte value, 0 if the byte cannot be encoded. */
+    uint32_t codes[256]; /**< Canonical code of each byte value, right-aligned. */
+} HuffmanEncoder;
+
+/**
+ * @brief Canonical Huffman decoder struct definition.
+ */
+typedef struct HuffmanDecoder {
+    uint16_t counts[HUFFMAN_MAX_CODE_LENGTH + 1]; /**< Number of codes of each length. */
+    uint8_t symbols[256]; /**< Byte values ordered by code length, then by value. */
+    int symbolCount; /**< Number of byte values with a code. */
+    uint16_t table[1 << HUFFMAN_TABLE_BITS]; /**< Symbol in the high byte and code length in the low byte for every HUFFMAN_TABLE_BITS-bit prefix, 0 for prefixes of longer codes. */
+} HuffmanDecoder;
+
+// Code construction functions
+void countHuffmanSymbols(const uint8_t* data, size_t size, uint64_t freq[256]);
+bool buildHuffmanCodeLengths(const uint64_t freq[256], uint8_t lengths[256]);
+bool validateHuffmanCodeLengths(const uint8_t lengths[256]);
+
+// Encoder and decoder functions
+bool initHuffmanEncoder(HuffmanEncoder* encoder, const uint8_t lengths[256]);
+bool initHuffmanDecoder(HuffmanDecoder* decoder, const uint8_t lengths[256]);
+bool encodeHuffmanBuffer(const HuffmanEncoder* encoder, const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputCapacity, size_t* outputSize);
+bool decodeHuffmanBuffer(const HuffmanDecoder* decoder, const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize);
+
+#endif // HUFFMANCODEC_H
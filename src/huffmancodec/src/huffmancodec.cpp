@@ -0,0 +1,396 @@
+/**
+ * @file huffmancodec.cpp
+ * @brief Implementation of the canonical Huffman codec, including heap-based code construction,
+ * canonical code assignment and table-driven decoding of byte buffers.
+ */
+#include "../header/huffmancodec.h"
+#include <string.h>
+
+/**
+ * @brief Number of nodes in a Huffman tree over all 256 byte values.
+ */
+#define HUFFMAN_MAX_NODES 511
+
+/**
+ * @brief Checks whether one tree node should leave the heap before another.
+ *
+ * Ties are broken by node index so the same frequencies always produce the same code.
+ *
+ * @param weights The weight of every node.
+ * @param a The first node index.
+ * @param b The second node index.
+ * @return True if node a is lighter than node b.
+ */
+static bool isLighterHuffmanNode(const uint64_t* weights, int a, int b) {
+	return weights[a] < weights[b] || (weights[a] == weights[b] && a < b);
+}
+
+/**
+ * @brief Moves the node at a heap position down until the min-heap property holds.
+ *
+ * @param heap The heap of node indices.
+ * @param size The number of nodes in the heap.
+ * @param position The heap position to sift down.
+ * @param weights The weight of every node.
+ */
+static void siftDownHuffmanHeap(int* heap, int size, int position, const uint64_t* weights) {
+	while (true) {
+		int smallest = position;
+		int left = 2 * position + 1;
+		int right = left + 1;
+		if (left < size && isLighterHuffmanNode(weights, heap[left], heap[smallest])) {
+			smallest = left;
+		}
+		if (right < size && isLighterHuffmanNode(weights, heap[right], heap[smallest])) {
+			smallest = right;
+		}
+		if (smallest == position) {
+			return;
+		}
+		int temp = heap[position];
+		heap[position] = heap[smallest];
+		heap[smallest] = temp;
+		position = smallest;
+	}
+}
+
+/**
+ * @brief Computes the depth of every leaf of a Huffman tree built from the given weights.
+ *
+ * The tree is built with a binary min-heap in O(n log n). Leaves occupy node indices
+ * 0 to leafCount - 1 and every merged node gets a higher index than its children.
+ *
+ * @param leafWeights The weight of each leaf, all greater than zero.
+ * @param leafCount The number of leaves, at least 2.
+ * @param depths Receives the depth of each leaf.
+ * @return The depth of the deepest leaf.
+ */
+static int computeHuffmanDepths(const uint64_t* leafWeights, int leafCount, int* depths) {
+	uint64_t weights[HUFFMAN_MAX_NODES];
+	int parents[HUFFMAN_MAX_NODES];
+	int nodeDepths[HUFFMAN_MAX_NODES];
+	int heap[256];
+
+	for (int i = 0; i < leafCount; i++) {
+		weights[i] = leafWeights[i];
+		heap[i] = i;
+	}
+	int heapSize = leafCount;
+	for (int i = heapSize / 2 - 1; i >= 0; i--) {
+		siftDownHuffmanHeap(heap, heapSize, i, weights);
+	}
+
+	int nodeCount = leafCount;
+	while (heapSize > 1) {
+		int first = heap[0];
+		heap[0] = heap[--heapSize];
+		siftDownHuffmanHeap(heap, heapSize, 0, weights);
+		int second = heap[0];
+
+		weights[nodeCount] = weights[first] + weights[second];
+		parents[first] = nodeCount;
+		parents[second] = nodeCount;
+
+		// The merged node replaces the second minimum at the top of the heap
+		heap[0] = nodeCount++;
+		siftDownHuffmanHeap(heap, heapSize, 0, weights);
+	}
+
+	int root = nodeCount - 1;
+	int maxDepth = 0;
+	nodeDepths[root] = 0;
+	for (int i = root - 1; i >= 0; i--) {
+		nodeDepths[i] = nodeDepths[parents[i]] + 1;
+		if (i < leafCount) {
+			depths[i] = nodeDepths[i];
+			if (depths[i] > maxDepth) {
+				maxDepth = depths[i];
+			}
+		}
+	}
+	return maxDepth;
+}
+
+/**
+ * @brief Adds the byte frequencies of a buffer to a frequency table.
+ *
+ * @param data The bytes to count.
+ * @param size The number of bytes.
+ * @param freq The frequency table to update; it is not cleared first.
+ */
+void countHuffmanSymbols(const uint8_t* data, size_t size, uint64_t freq[256]) {
+	for (size_t i = 0; i < size; i++) {
+		freq[data[i]]++;
+	}
+}
+
+/**
+ * @brief Builds length-limited Huffman code lengths from byte frequencies.
+ *
+ * Code lengths longer than HUFFMAN_MAX_CODE_LENGTH are avoided by flattening the frequencies
+ * and rebuilding the tree, which only happens for extremely skewed inputs.
+ *
+ * @param freq The frequency of each byte value.
+ * @param lengths Receives the code length of each byte value, 0 for bytes that never occur.
+ * @return True if the code lengths were built, otherwise false.
+ */
+bool buildHuffmanCodeLengths(const uint64_t freq[256], uint8_t lengths[256]) {
+	uint64_t leafWeights[256];
+	int leafSymbols[256];
+	int leafCount = 0;
+
+	memset(lengths, 0, 256);
+	for (int i = 0; i < 256; i++) {
+		if (freq[i] > 0) {
+			leafWeights[leafCount] = freq[i];
+			leafSymbols[leafCount++] = i;
+		}
+	}
+
+	if (leafCount == 0) {
+		return true;
+	}
+	if (leafCount == 1) {
+		// A single symbol still needs one bit per occurrence
+		lengths[leafSymbols[0]] = 1;
+		return true;
+	}
+
+	int depths[256];
+	while (computeHuffmanDepths(leafWeights, leafCount, depths) > HUFFMAN_MAX_CODE_LENGTH) {
+		for (int i = 0; i < leafCount; i++) {
+			leafWeights[i] = (leafWeights[i] + 1) / 2;
+		}
+	}
+
+	for (int i = 0; i < leafCount; i++) {
+		lengths[leafSymbols[i]] = (uint8_t)depths[i];
+	}
+	return true;
+}
+
+/**
+ * @brief Checks that code lengths describe a usable prefix code.
+ *
+ * @param lengths The code length of each byte value.
+ * @return True if no length exceeds HUFFMAN_MAX_CODE_LENGTH and the code is not oversubscribed.
+ */
+bool validateHuffmanCodeLengths(const uint8_t lengths[256]) {
+	int counts[HUFFMAN_MAX_CODE_LENGTH + 1] = { 0 };
+	for (int i = 0; i < 256; i++) {
+		if (lengths[i] > HUFFMAN_MAX_CODE_LENGTH) {
+			return false;
+		}
+		counts[lengths[i]]++;
+	}
+
+	long left = 1;
+	for (int length = 1; length <= HUFFMAN_MAX_CODE_LENGTH; length++) {
+		left = (left << 1) - counts[length];
+		if (left < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Initializes an encoder by assigning canonical codes to the given code lengths.
+ *
+ * @param encoder The encoder to initialize.
+ * @param lengths The code length of each byte value, 0 if the byte is not coded.
+ * @return True if the lengths describe a valid prefix code, otherwise false.
+ */
+bool initHuffmanEncoder(HuffmanEncoder* encoder, const uint8_t lengths[256]) {
+	memset(encoder, 0, sizeof(*encoder));
+	if (!validateHuffmanCodeLengths(lengths)) {
+		return false;
+	}
+
+	int counts[HUFFMAN_MAX_CODE_LENGTH + 1] = { 0 };
+	for (int i = 0; i < 256; i++) {
+		if (lengths[i] > 0) {
+			counts[lengths[i]]++;
+		}
+	}
+
+	uint32_t nextCode[HUFFMAN_MAX_CODE_LENGTH + 1] = { 0 };
+	uint32_t code = 0;
+	for (int length = 1; length <= HUFFMAN_MAX_CODE_LENGTH; length++) {
+		code = (code + counts[length - 1]) << 1;
+		nextCode[length] = code;
+	}
+
+	for (int i = 0; i < 256; i++) {
+		encoder->lengths[i] = lengths[i];
+		if (lengths[i] > 0) {
+			encoder->codes[i] = nextCode[lengths[i]]++;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Initializes a decoder and its lookup table from the given code lengths.
+ *
+ * @param decoder The decoder to initialize.
+ * @param lengths The code length of each byte value, 0 if the byte is not coded.
+ * @return True if the lengths describe a valid prefix code, otherwise false.
+ */
+bool initHuffmanDecoder(HuffmanDecoder* decoder, const uint8_t lengths[256]) {
+	memset(decoder, 0, sizeof(*decoder));
+	if (!validateHuffmanCodeLengths(lengths)) {
+		return false;
+	}
+
+	for (int i = 0; i < 256; i++) {
+		if (lengths[i] > 0) {
+			decoder->counts[lengths[i]]++;
+			decoder->symbolCount++;
+		}
+	}
+
+	int offsets[HUFFMAN_MAX_CODE_LENGTH + 1] = { 0 };
+	for (int length = 2; length <= HUFFMAN_MAX_CODE_LENGTH; length++) {
+		offsets[length] = offsets[length - 1] + decoder->counts[length - 1];
+	}
+
+	uint32_t nextCode[HUFFMAN_MAX_CODE_LENGTH + 1] = { 0 };
+	uint32_t code = 0;
+	for (int length = 1; length <= HUFFMAN_MAX_CODE_LENGTH; length++) {
+		code = (code + decoder->counts[length - 1]) << 1;
+		nextCode[length] = code;
+	}
+
+	for (int i = 0; i < 256; i++) {
+		int length = lengths[i];
+		if (length == 0) {
+			continue;
+		}
+		decoder->symbols[offsets[length]++] = (uint8_t)i;
+
+		// Every table index that starts with a short code resolves to that code's symbol
+		uint32_t symbolCode = nextCode[length]++;
+		if (length <= HUFFMAN_TABLE_BITS) {
+			uint32_t first = symbolCode << (HUFFMAN_TABLE_BITS - length);
+			uint32_t count = 1u << (HUFFMAN_TABLE_BITS - length);
+			for (uint32_t j = 0; j < count; j++) {
+				decoder->table[first + j] = (uint16_t)((i << 8) | length);
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Encodes a buffer into packed Huffman codes, most significant bit first.
+ *
+ * @param encoder The encoder to use.
+ * @param input The bytes to encode.
+ * @param inputSize The number of bytes to encode.
+ * @param output The buffer receiving the packed codes; the last byte is padded with zero bits.
+ * @param outputCapacity The size of the output buffer in bytes.
+ * @param outputSize Receives the number of bytes written.
+ * @return True if the buffer was encoded, false if a byte has no code or the output is too small.
+ */
+bool encodeHuffmanBuffer(const HuffmanEncoder* encoder, const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputCapacity, size_t* outputSize) {
+	uint64_t bits = 0;
+	int bitCount = 0;
+	size_t written = 0;
+
+	for (size_t i = 0; i < inputSize; i++) {
+		int length = encoder->lengths[input[i]];
+		if (length == 0) {
+			return false;
+		}
+		bits = (bits << length) | encoder->codes[input[i]];
+		bitCount += length;
+		while (bitCount >= 8) {
+			if (written == outputCapacity) {
+				return false;
+			}
+			bitCount -= 8;
+			output[written++] = (uint8_t)(bits >> bitCount);
+		}
+	}
+
+	if (bitCount > 0) {
+		if (written == outputCapacity) {
+			return false;
+		}
+		output[written++] = (uint8_t)(bits << (8 - bitCount));
+	}
+	*outputSize = written;
+	return true;
+}
+
+/**
+ * @brief Decodes a code longer than HUFFMAN_TABLE_BITS one bit at a time.
+ *
+ * @param decoder The decoder the code belongs to.
+ * @param bits The pending bits, most significant bit first.
+ * @param bitCount The number of valid pending bits.
+ * @param length Receives the length of the decoded code.
+ * @return The decoded byte value, or -1 if the bits do not form a code.
+ */
+static int decodeLongHuffmanCode(const HuffmanDecoder* decoder, uint64_t bits, int bitCount, int* length) {
+	int code = 0;
+	int first = 0;
+	int index = 0;
+	for (int i = 1; i <= HUFFMAN_MAX_CODE_LENGTH && i <= bitCount; i++) {
+		code |= (int)((bits >> (64 - i)) & 1);
+		int count = decoder->counts[i];
+		if (code < first + count) {
+			*length = i;
+			return decoder->symbols[index + code - first];
+		}
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+	return -1;
+}
+
+/**
+ * @brief Decodes packed Huffman codes into a buffer of known size.
+ *
+ * Each byte is resolved with one lookup of the next HUFFMAN_TABLE_BITS bits; only codes
+ * longer than that fall back to walking the code lengths.
+ *
+ * @param decoder The decoder to use.
+ * @param input The packed codes.
+ * @param inputSize The number of packed bytes.
+ * @param output The buffer receiving the decoded bytes.
+ * @param outputSize The number of bytes to decode.
+ * @return True if all bytes were decoded, false if the input is damaged or too short.
+ */
+bool decodeHuffmanBuffer(const HuffmanDecoder* decoder, const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize) {
+	uint64_t bits = 0;
+	int bitCount = 0;
+	size_t byteIndex = 0;
+
+	for (size_t i = 0; i < outputSize; i++) {
+		while (bitCount <= 56 && byteIndex < inputSize) {
+			bits |= (uint64_t)input[byteIndex++] << (56 - bitCount);
+			bitCount += 8;
+		}
+
+		uint16_t entry = decoder->table[bits >> (64 - HUFFMAN_TABLE_BITS)];
+		int length = entry & 0xFF;
+		int symbol = entry >> 8;
+		if (length == 0) {
+			symbol = decodeLongHuffmanCode(decoder, bits, bitCount, &length);
+			if (symbol < 0) {
+				return false;
+			}
+		}
+		if (length > bitCount) {
+			return false;
+		}
+
+		output[i] = (uint8_t)symbol;
+		bits <<= length;
+		bitCount -= length;
+	}
+	return true;
+}
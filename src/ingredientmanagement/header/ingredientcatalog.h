@@ -0,0 +1,79 @@
+/**
+ * @file ingredientcatalog.h
+ * @brief Header file for the ingredient catalog, which owns the ingredient list together with
+ * a tail pointer, a hash index from ingredient ID to list node and optional name indexes.
+ */
+#ifndef INGREDIENTCATALOG_H
+#define INGREDIENTCATALOG_H
+
+#include "ingredientmanagement.h"
+#include <stdbool.h>
+
+/**
+ * @brief Trigram index over ingredient names, defined in ingredientsearch.cpp.
+ */
+typedef struct IngredientTrigramIndex IngredientTrigramIndex;
+
+/**
+ * @brief Radix tree over ingredient names, defined in ingredienttrie.h.
+ */
+typedef struct IngredientTrie IngredientTrie;
+
+/**
+ * @brief Skip list over ingredient prices, defined in ingredientpriceindex.h.
+ */
+typedef struct IngredientPriceIndex IngredientPriceIndex;
+
+/**
+ * @brief Hash set over normalized ingredient names, defined in ingredientnameset.h.
+ */
+typedef struct IngredientNameSet IngredientNameSet;
+
+/**
+ * @brief Ingredient catalog struct definition.
+ *
+ * The index is an open-addressing table with linear probing whose slots point straight at the
+ * list nodes, so looking up an ingredient by ID takes constant time on average. A set of
+ * normalized names finds an ingredient by name just as fast, which is how duplicate names are
+ * rejected. A catalog can also keep a trigram index and a prefix trie over the names and an
+ * ordered index over the prices, which every catalog mutation keeps in sync.
+ */
+typedef struct IngredientCatalog {
+    Ingredient* head; /**< First ingredient of the list. */
+    Ingredient* tail; /**< Last ingredient of the list. */
+    int count; /**< Number of ingredients in the list. */
+    Ingredient** slots; /**< ID index slots, NULL for empty slots. */
+    int capacity; /**< Number of index slots, always a power of two. */
+    MemoryArena* arena; /**< Arena holding the nodes, NULL if every node was allocated with malloc. */
+    IngredientNameSet* names; /**< Set of normalized names, NULL while empty or if memory ran out. */
+    IngredientTrigramIndex* trigrams; /**< Trigram index over the names, NULL if not enabled. */
+    IngredientTrie* trie; /**< Prefix trie over the names, NULL if not enabled. */
+    IngredientPriceIndex* prices; /**< Ordered index over the prices, NULL if not enabled. */
+    bool indexed; /**< False if the catalog only wraps a list and every lookup walks it. */
+} IngredientCatalog;
+
+// Ingredient catalog functions
+void initIngredientCatalog(IngredientCatalog* catalog);
+void attachIngredientCatalog(IngredientCatalog* catalog, Ingredient* head);
+void wrapIngredientCatalog(IngredientCatalog* catalog, Ingredient* head);
+Ingredient* detachIngredientCatalog(IngredientCatalog* catalog);
+void freeIngredientCatalog(IngredientCatalog* catalog);
+void loadIngredientCatalog(IngredientCatalog* catalog, const char* filePath);
+void loadIngredientCatalogInArena(IngredientCatalog* catalog, const char* filePath, MemoryArena* arena);
+Ingredient* findIngredientById(const IngredientCatalog* catalog, int id);
+Ingredient* findIngredientByName(const IngredientCatalog* catalog, const char* name);
+int getNextIngredientId(const IngredientCatalog* catalog);
+bool linkCatalogIngredient(IngredientCatalog* catalog, Ingredient* ingredient);
+Ingredient* unlinkCatalogIngredient(IngredientCatalog* catalog, int id);
+bool enableIngredientTrigramIndex(IngredientCatalog* catalog);
+bool enableIngredientNameTrie(IngredientCatalog* catalog);
+bool enableIngredientPriceIndex(IngredientCatalog* catalog);
+bool renameCatalogIngredient(IngredientCatalog* catalog, Ingredient* ingredient, const char* name);
+bool setCatalogIngredientPrice(IngredientCatalog* catalog, Ingredient* ingredient, float price);
+
+// Catalog-based ingredient management functions
+Ingredient* addCatalogIngredient(IngredientCatalog* catalog, const char* name, float price, const char* filePath);
+bool removeCatalogIngredient(IngredientCatalog* catalog, int id, const char* filePath);
+bool editCatalogIngredient(IngredientCatalog* catalog, const char* filePath);
+
+#endif // INGREDIENTCATALOG_H
@@ -0,0 +1,19 @@
+/**
+ * @file ingredientchecksum.h
+ * @brief Header file for the CRC32C checksums that protect the blocks of ingredient files, computed
+ * with the SSE4.2 crc32 instruction where the processor has it and with slicing-by-8 tables otherwise.
+ */
+#ifndef INGREDIENTCHECKSUM_H
+#define INGREDIENTCHECKSUM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Ingredient checksum functions
+uint32_t updateCrc32c(uint32_t crc, const void* data, size_t size);
+uint32_t updateCrc32cPortable(uint32_t crc, const void* data, size_t size);
+void computeCrc32cBlocks(const void* data, size_t size, size_t blockSize, uint32_t* checksums);
+bool hasHardwareCrc32c();
+
+#endif // INGREDIENTCHECKSUM_H
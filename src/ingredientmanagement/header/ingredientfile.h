@@ -0,0 +1,159 @@
+/**
+ * @file ingredientfile.h
+ * @brief Header file for the versioned ingredient file format, including the on-disk header, record
+ * and name pool layouts and the read-only view used to query ingredient files in place.
+ */
+#ifndef INGREDIENTFILE_H
+#define INGREDIENTFILE_H
+
+#include "ingredientmanagement.h"
+#include "ingredientstorage.h"
+#include "../../memoryarena/header/memoryarena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic number at the start of every versioned ingredient file ("ING1" on disk).
+ */
+#define INGREDIENT_FILE_MAGIC 0x31474E49u
+
+/**
+ * @brief Current version of the ingredient file format, with names interned in a name pool.
+ */
+#define INGREDIENT_FILE_VERSION 2
+
+/**
+ * @brief Previous version of the ingredient file format, with a fixed name field in every record.
+ */
+#define INGREDIENT_FILE_VERSION_FIXED_NAMES 1
+
+/**
+ * @brief Fewest records a thread of the parallel loader decodes; smaller files use fewer threads.
+ */
+#define INGREDIENT_PARALLEL_LOAD_MIN_CHUNK 65536
+
+/**
+ * @brief Size of the fixed name field in a version 1 ingredient record and in memory.
+ */
+#define INGREDIENT_NAME_SIZE 100
+
+/**
+ * @brief Header flag set when the records are stored in ascending ID order.
+ */
+#define INGREDIENT_FILE_SORTED_BY_ID 0x1u
+
+/**
+ * @brief Header flag set when the file ends with a CRC32C checksum for every block of its body.
+ */
+#define INGREDIENT_FILE_CHECKSUMMED 0x2u
+
+/**
+ * @brief Size of a checksummed block of the files this version writes.
+ */
+#define INGREDIENT_FILE_BLOCK_SIZE 4096
+
+/**
+ * @brief Record flag set on a record that was deleted in place; every reader skips such tombstones.
+ */
+#define INGREDIENT_RECORD_DELETED 0x1u
+
+/**
+ * @brief Size of the header written before records could be deleted in place, which ends before
+ * the deleted record count.
+ */
+#define INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES 32
+
+/**
+ * @brief Ingredient file header struct definition.
+ *
+ * The header is followed by recordCount records of recordSize bytes each, so record i
+ * starts at headerSize + i * recordSize and can be read without parsing the records before it.
+ * In version 2 files the records are followed by the name pool. Headers of files written before
+ * records could be deleted in place are INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES bytes long and
+ * have no deleted records.
+ *
+ * When INGREDIENT_FILE_CHECKSUMMED is set, the body between the header and the end of the name
+ * pool, padded with zeros to a multiple of four bytes, is split into blocks of blockSize bytes, the
+ * last one possibly shorter, and the file ends with one CRC32C per block. The header is not covered, as it is validated field by field.
+ */
+typedef struct IngredientFileHeader {
+    uint32_t magic; /**< Always INGREDIENT_FILE_MAGIC. */
+    uint32_t version; /**< Format version of the file. */
+    uint32_t headerSize; /**< Size of this header in bytes. */
+    uint32_t recordSize; /**< Stride of one record in bytes. */
+    uint32_t recordCount; /**< Number of records following the header. */
+    uint32_t flags; /**< Combination of INGREDIENT_FILE_* flags. */
+    uint64_t generation; /**< Random non-zero value that changes every time the file is rewritten. */
+    uint32_t deletedCount; /**< Number of records marked INGREDIENT_RECORD_DELETED. */
+    uint32_t blockSize; /**< Size of a checksummed block in bytes, 0 if the file has no checksums. */
+} IngredientFileHeader;
+
+/**
+ * @brief Pointer-free on-disk ingredient record struct definition.
+ *
+ * The name is a handle into the name pool of the file, so a record takes 16 bytes whatever the
+ * length of the name and a scan over IDs or prices stays within a few cache lines per hundred
+ * records. Use getMappedIngredientName to read the name.
+ */
+typedef struct IngredientRecord {
+    int32_t id; /**< Unique ingredient ID. */
+    float price; /**< Ingredient price. */
+    uint32_t flags; /**< Combination of INGREDIENT_RECORD_* flags. */
+    uint32_t nameHandle; /**< Position of the name in the name pool offsets. */
+} IngredientRecord;
+
+/**
+ * @brief Version 1 on-disk ingredient record struct definition.
+ *
+ * Its first three fields match IngredientRecord, so mapped version 1 files are served through the
+ * same record pointer type.
+ */
+typedef struct IngredientRecordV1 {
+    int32_t id; /**< Unique ingredient ID. */
+    float price; /**< Ingredient price. */
+    uint32_t flags; /**< Combination of INGREDIENT_RECORD_* flags. */
+    char name[INGREDIENT_NAME_SIZE]; /**< Zero-terminated ingredient name. */
+} IngredientRecordV1;
+
+/**
+ * @brief Name pool header struct definition.
+ *
+ * The header is followed by nameCount 32-bit offsets and then dataSize bytes of zero-terminated
+ * names; every distinct name is stored once, at its own length.
+ */
+typedef struct IngredientNamePoolHeader {
+    uint32_t nameCount; /**< Number of distinct names. */
+    uint32_t dataSize; /**< Number of bytes of name data. */
+} IngredientNamePoolHeader;
+
+/**
+ * @brief Read-only view of a versioned ingredient file, memory-mapped by the default storage backend.
+ */
+typedef struct IngredientMap {
+    const IngredientFileHeader* header; /**< Pointer to the mapped file header. */
+    const IngredientRecord* records; /**< Pointer to the first mapped record. */
+    int count; /**< Number of records in the view, including deleted ones. */
+    int deletedCount; /**< Number of deleted records in the view. */
+    const uint32_t* nameOffsets; /**< Name pool offsets, NULL for version 1 files. */
+    const char* names; /**< Name pool data, NULL for version 1 files. */
+    uint32_t nameCount; /**< Number of names in the name pool. */
+    const uint32_t* blockChecksums; /**< CRC32C of every block of the body, NULL if the file has none. */
+    uint32_t blockCount; /**< Number of checksummed blocks. */
+    IngredientStorageView view; /**< Storage view holding the file contents. */
+} IngredientMap;
+
+// Versioned ingredient file functions
+bool writeIngredientFile(const Ingredient* head, const char* filePath);
+bool readIngredientFileHeader(const char* filePath, IngredientFileHeader* header);
+bool openIngredientMap(const char* filePath, IngredientMap* map);
+void closeIngredientMap(IngredientMap* map);
+const IngredientRecord* getMappedIngredient(const IngredientMap* map, int index);
+const IngredientRecord* findMappedIngredientById(const IngredientMap* map, int id);
+bool deleteIngredientRecordInPlace(const char* filePath, int id, IngredientFileHeader* header);
+const char* getMappedIngredientName(const IngredientMap* map, const IngredientRecord* record);
+int findMappedIngredientsByName(const IngredientMap* map, const char* name, const IngredientRecord** results, int maxResults);
+Ingredient* buildIngredientListFromMap(const IngredientMap* map, MemoryArena* arena);
+Ingredient* buildIngredientListFromMapInParallel(const IngredientMap* map, MemoryArena* arena, int threadCount);
+
+#endif // INGREDIENTFILE_H
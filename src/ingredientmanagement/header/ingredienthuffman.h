@@ -0,0 +1,92 @@
+/**
+ * @file ingredienthuffman.h
+ * @brief Header file for the Huffman-compressed ingredient file, including the canonical codebook
+ * shared by every name in the file and the bit-packed record layout.
+ */
+#ifndef INGREDIENTHUFFMAN_H
+#define INGREDIENTHUFFMAN_H
+
+#include "ingredientmanagement.h"
+#include "../../huffmancodec/header/huffmancodec.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic number at the start of every Huffman-compressed ingredient file ("HUF1" on disk).
+ */
+#define HUFFMAN_FILE_MAGIC 0x31465548u
+
+/**
+ * @brief Current version of the Huffman-compressed ingredient file format.
+ */
+#define HUFFMAN_FILE_VERSION 2
+
+/**
+ * @brief Version of Huffman-compressed ingredient files written before records could be deleted in place.
+ */
+#define HUFFMAN_FILE_VERSION_NO_TOMBSTONES 1
+
+/**
+ * @brief Record flag marking a record that was deleted or superseded; readers skip it.
+ */
+#define HUFFMAN_RECORD_DELETED 0x01u
+
+/**
+ * @brief Path of the Huffman-compressed mirror of the ingredient file.
+ */
+#define HUFFMAN_INGREDIENT_FILE_PATH "ingredients.huf"
+
+/**
+ * @brief Upper bound of the packed payload of a single name in bytes.
+ */
+#define HUFFMAN_MAX_PAYLOAD_BYTES HUFFMAN_MAX_ENCODED_SIZE(99)
+
+/**
+ * @brief Canonical Huffman codebook struct definition.
+ *
+ * Only the code lengths are stored on disk; the encoder and decoder are rebuilt from them.
+ */
+typedef struct HuffmanCodebook {
+    HuffmanEncoder encoder; /**< Encoder for the names of the file. */
+    HuffmanDecoder decoder; /**< Decoder for the names of the file. */
+} HuffmanCodebook;
+
+/**
+ * @brief Huffman-compressed ingredient file header struct definition.
+ *
+ * The header is followed by recordCount records, each a HuffmanRecordHeader followed by
+ * payloadBytes bytes of packed codes. Single records are appended and deleted in place, so the
+ * records of deleted ingredients stay in the file until it is rewritten.
+ */
+typedef struct HuffmanFileHeader {
+    uint32_t magic; /**< Always HUFFMAN_FILE_MAGIC. */
+    uint32_t version; /**< Format version of the file. */
+    uint32_t headerSize; /**< Size of this header in bytes. */
+    uint32_t recordCount; /**< Number of records following the header. */
+    uint8_t codeLengths[256]; /**< Canonical code length of each byte value. */
+} HuffmanFileHeader;
+
+/**
+ * @brief Huffman-compressed ingredient record header struct definition.
+ */
+typedef struct HuffmanRecordHeader {
+    int32_t id; /**< Unique ingredient ID. */
+    float price; /**< Ingredient price. */
+    uint8_t flags; /**< Record flags, HUFFMAN_RECORD_DELETED or zero. */
+    uint8_t nameLength; /**< Number of characters in the decoded name. */
+    uint16_t payloadBytes; /**< Number of packed code bytes following this header. */
+} HuffmanRecordHeader;
+
+// Canonical Huffman codebook functions
+bool buildHuffmanCodebook(const uint64_t freq[256], HuffmanCodebook* book);
+bool initHuffmanCodebook(const uint8_t lengths[256], HuffmanCodebook* book);
+int encodeHuffmanName(const HuffmanCodebook* book, const char* name, uint8_t* payload, int payloadSize);
+bool decodeHuffmanName(const HuffmanCodebook* book, const uint8_t* payload, int payloadBytes, int nameLength, char* name);
+
+// Huffman-compressed ingredient file functions
+bool writeHuffmanIngredientFile(const Ingredient* head, const char* filePath);
+Ingredient* readHuffmanIngredientFile(const char* filePath);
+bool storeHuffmanIngredient(const char* filePath, const Ingredient* ingredient);
+bool deleteHuffmanIngredient(const char* filePath, int id);
+
+#endif // INGREDIENTHUFFMAN_H
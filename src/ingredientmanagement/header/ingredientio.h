@@ -0,0 +1,79 @@
+/**
+ * @file ingredientio.h
+ * @brief Header file for bulk ingredient import and export, which stream CSV and JSON files
+ * through large buffers instead of reading or printing one row at a time.
+ */
+#ifndef INGREDIENTIO_H
+#define INGREDIENTIO_H
+
+#include "ingredientmanagement.h"
+#include "ingredientfile.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Number of bytes read from a CSV file at a time.
+ */
+#define INGREDIENT_CSV_BUFFER_SIZE (1 << 20)
+
+/**
+ * @brief Size of the output buffer of an export writer.
+ */
+#define INGREDIENT_EXPORT_BUFFER_SIZE (1 << 20)
+
+/**
+ * @brief File formats an export can be written in.
+ */
+typedef enum ExportFormat {
+    EXPORT_FORMAT_CSV = 0, /**< One header row and one comma-separated row per item. */
+    EXPORT_FORMAT_JSON = 1 /**< One array with one object per item. */
+} ExportFormat;
+
+/**
+ * @brief Buffered writer used by every exporter.
+ *
+ * Text and numbers are formatted straight into the buffer, which is written to the file only when
+ * it is full, so exporting a row costs no stdio call of its own.
+ */
+typedef struct ExportWriter {
+    FILE* file; /**< Output file. */
+    char* buffer; /**< Output buffer of INGREDIENT_EXPORT_BUFFER_SIZE bytes. */
+    size_t used; /**< Number of bytes waiting in the buffer. */
+    bool failed; /**< Set once a write to the file failed. */
+} ExportWriter;
+
+/**
+ * @brief Summary of a bulk import.
+ */
+typedef struct IngredientImportResult {
+    int imported; /**< Number of rows added as ingredients. */
+    int merged; /**< Number of rows that updated the price of an ingredient with the same name. */
+    int rejected; /**< Number of rows skipped because they could not be parsed. */
+    int firstRejectedLine; /**< Line number of the first skipped row, 0 if none. */
+    int firstId; /**< ID given to the first imported ingredient, 0 if none. */
+} IngredientImportResult;
+
+// CSV parsing functions
+bool parseIngredientPrice(const char* text, size_t length, float* price);
+bool parseIngredientCsvLine(const char* line, size_t length, char name[INGREDIENT_NAME_SIZE], float* price);
+
+// Bulk import functions
+bool importIngredientsFromCsv(const char* csvPath, const char* filePath, IngredientImportResult* result);
+
+// Export writer functions
+bool openExportWriter(ExportWriter* writer, const char* filePath);
+bool closeExportWriter(ExportWriter* writer);
+void writeExportText(ExportWriter* writer, const char* text, size_t length);
+void writeExportString(ExportWriter* writer, const char* text);
+void writeExportInt(ExportWriter* writer, long long value);
+void writeExportFloat(ExportWriter* writer, float value);
+void writeExportFixed(ExportWriter* writer, double value, int precision);
+void writeExportCsvField(ExportWriter* writer, const char* text);
+void writeExportJsonString(ExportWriter* writer, const char* text);
+bool parseExportFormat(const char* text, ExportFormat* format);
+
+// Bulk export functions
+bool exportIngredients(const Ingredient* head, const char* filePath, ExportFormat format);
+
+#endif // INGREDIENTIO_H
@@ -0,0 +1,83 @@
+/**
+ * @file ingredientlog.h
+ * @brief Header file for the append-only ingredient mutation log, including the log file layout,
+ * the functions that append, replay and compact it into the base ingredient file and deletes that
+ * mark records of the base file as tombstones instead.
+ */
+#ifndef INGREDIENTLOG_H
+#define INGREDIENTLOG_H
+
+#include "ingredientmanagement.h"
+#include "ingredientfile.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic number at the start of every ingredient log file ("IWL1" on disk).
+ */
+#define INGREDIENT_LOG_MAGIC 0x314C5749u
+
+/**
+ * @brief Current version of the ingredient log format.
+ */
+#define INGREDIENT_LOG_VERSION 1
+
+/**
+ * @brief Suffix appended to the ingredient file path to name its log file.
+ */
+#define INGREDIENT_LOG_SUFFIX ".wal"
+
+/**
+ * @brief Default number of log records that triggers a background compaction.
+ */
+#define INGREDIENT_LOG_DEFAULT_COMPACTION_THRESHOLD 256
+
+/**
+ * @brief Default share of deleted records in the base file that triggers a background compaction.
+ */
+#define INGREDIENT_TOMBSTONE_DEFAULT_COMPACTION_SHARE 0.25
+
+/**
+ * @brief Operations recorded in the ingredient log.
+ */
+typedef enum IngredientLogOperation {
+    INGREDIENT_LOG_ADD = 1, /**< Appends a new ingredient. */
+    INGREDIENT_LOG_REMOVE = 2, /**< Removes the ingredient with the record ID. */
+    INGREDIENT_LOG_UPDATE = 3 /**< Replaces the name and price of the ingredient with the record ID. */
+} IngredientLogOperation;
+
+/**
+ * @brief Ingredient log header struct definition.
+ */
+typedef struct IngredientLogHeader {
+    uint32_t magic; /**< Always INGREDIENT_LOG_MAGIC. */
+    uint32_t version; /**< Format version of the log. */
+    uint64_t baseGeneration; /**< Generation of the ingredient file the log applies to. */
+} IngredientLogHeader;
+
+/**
+ * @brief Fixed-size ingredient log record struct definition.
+ */
+typedef struct IngredientLogRecord {
+    uint32_t operation; /**< One of the IngredientLogOperation values. */
+    int32_t id; /**< ID of the affected ingredient. */
+    float price; /**< New price for add and update operations. */
+    uint32_t reserved; /**< Reserved, written as zero. */
+    char name[INGREDIENT_NAME_SIZE]; /**< New name for add and update operations. */
+} IngredientLogRecord;
+
+// Ingredient log functions
+bool appendIngredientLog(const char* filePath, IngredientLogOperation operation, const Ingredient* ingredient);
+bool deleteIngredientInPlace(const char* filePath, int id);
+Ingredient* replayIngredientLog(const char* filePath, uint64_t baseGeneration, Ingredient* head, MemoryArena* arena);
+bool readIngredientLogRecords(const char* filePath, uint64_t baseGeneration, IngredientLogRecord** records, int* recordCount);
+int getIngredientLogLength(const char* filePath);
+void discardIngredientLog(const char* filePath);
+bool compactIngredientLog(const char* filePath);
+void setIngredientLogCompactionThreshold(int recordCount);
+void setIngredientTombstoneCompactionShare(double share);
+void waitForIngredientLogCompaction();
+void lockIngredientFiles();
+void unlockIngredientFiles();
+
+#endif // INGREDIENTLOG_H
@@ -6,6 +6,7 @@
 #ifndef INGREDIENTMANAGEMENT_H
 #define INGREDIENTMANAGEMENT_H
 
+#include "../../memoryarena/header/memoryarena.h"
 #include <stdbool.h>
 
  /**
@@ -37,6 +38,8 @@ bool listIngredientsDLL(Ingredient* head);
 bool listIngredientsXLL(Ingredient* head);
 bool listIngredients(Ingredient* head);
 Ingredient* loadIngredientsFromFile(const char* filePath);
+Ingredient* loadIngredientsFromFileInArena(const char* filePath, MemoryArena* arena);
+Ingredient* loadIngredientsFromFileInParallel(const char* filePath, MemoryArena* arena, int threadCount);
 Ingredient* removeIngredient(Ingredient* head, int id, const char* filePath);
 Ingredient* editIngredient(Ingredient* head, const char* filePath);
 int ingredientManagementMenu(const char* filePath);
@@ -48,14 +51,17 @@ void freeHuffmanTree(HuffmanTreeNode* root);
 bool saveHuffmanEncodedIngredientsToFile(Ingredient* head);
 Ingredient* loadHuffmanEncodedIngredientsFromFile();
 HuffmanTreeNode* createHuffmanTreeNode(char character, int frequency);
+HuffmanTreeNode* createHuffmanTreeNodeInArena(MemoryArena* arena, char character, int frequency);
 void countFrequencies(const char* str, int freq[256]);
 HuffmanTreeNode* constructHuffmanTree(const int freq[256]);
+HuffmanTreeNode* constructHuffmanTreeInArena(const int freq[256], MemoryArena* arena);
 void generateHuffmanCodes(HuffmanTreeNode* root, char* code, int depth, char codes[256][256]);
 void encodeString(const char* str, const char codes[256][256], char* encodedStr);
 void decodeString(HuffmanTreeNode* root, const char* encodedStr, char* decodedStr);
 
 void computeLPSArray(const char* pattern, int* lps, int m);
 bool KMPSearch(const char* text, const char* pattern);
+bool KMPSearchWithLPS(const char* text, const char* pattern, const int* lps, int m);
 void searchIngredientByKMP(Ingredient* head);
 
 #endif // INGREDIENTMANAGEMENT_H
\ No newline at end of file
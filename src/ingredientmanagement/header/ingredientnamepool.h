@@ -0,0 +1,43 @@
+/**
+ * @file ingredientnamepool.h
+ * @brief Header file for the ingredient name pool, which interns names into one contiguous block
+ * and hands out 32-bit handles so every distinct name is stored once at its real length.
+ */
+#ifndef INGREDIENTNAMEPOOL_H
+#define INGREDIENTNAMEPOOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Handle returned when a name could not be interned.
+ */
+#define INGREDIENT_NAME_HANDLE_INVALID 0xFFFFFFFFu
+
+/**
+ * @brief Ingredient name pool struct definition.
+ *
+ * Names are stored zero-terminated one after another in data, and handle h refers to the name at
+ * offsets[h]. An open-addressing table of handles finds an already interned name in constant time
+ * on average, so interning a repeated name adds no bytes.
+ */
+typedef struct IngredientNamePool {
+    char* data; /**< Zero-terminated names, back to back. */
+    uint32_t size; /**< Number of bytes used in data. */
+    uint32_t capacity; /**< Number of bytes allocated for data. */
+    uint32_t* offsets; /**< Start of every name in data, indexed by handle. */
+    uint32_t count; /**< Number of distinct names. */
+    uint32_t offsetCapacity; /**< Number of entries allocated for offsets. */
+    uint32_t* slots; /**< Hash slots holding handle + 1, 0 for empty slots. */
+    uint32_t slotCount; /**< Number of hash slots, always a power of two. */
+} IngredientNamePool;
+
+// Ingredient name pool functions
+void initIngredientNamePool(IngredientNamePool* pool);
+void freeIngredientNamePool(IngredientNamePool* pool);
+uint32_t internIngredientName(IngredientNamePool* pool, const char* name);
+uint32_t findIngredientNameHandle(const IngredientNamePool* pool, const char* name);
+const char* getIngredientNameByHandle(const IngredientNamePool* pool, uint32_t handle);
+
+#endif // INGREDIENTNAMEPOOL_H
@@ -0,0 +1,46 @@
+/**
+ * @file ingredientnamescan.h
+ * @brief Header file for the packed ingredient name arena and its vectorized substring scanner,
+ * which checks 16 or 32 name bytes per step on CPUs with SSE2 or AVX2.
+ */
+#ifndef INGREDIENTNAMESCAN_H
+#define INGREDIENTNAMESCAN_H
+
+#include "ingredientmanagement.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Instruction sets the name scanner can use.
+ */
+typedef enum IngredientScanBackend {
+    INGREDIENT_SCAN_SCALAR = 0, /**< Portable byte-by-byte loop. */
+    INGREDIENT_SCAN_SSE2 = 1, /**< 16 bytes per step. */
+    INGREDIENT_SCAN_AVX2 = 2 /**< 32 bytes per step. */
+} IngredientScanBackend;
+
+/**
+ * @brief Packed ingredient name arena struct definition.
+ *
+ * Every name is stored lower-cased behind a one-byte length in a single contiguous buffer, so a
+ * case-insensitive search over the whole catalog is one linear pass over memory instead of a walk
+ * over 128-byte nodes. The arena is a snapshot: rebuild it after the list changes.
+ */
+typedef struct IngredientNameArena {
+    unsigned char* data; /**< Length-prefixed lower-case names back to back. */
+    size_t size; /**< Number of bytes used in data. */
+    uint32_t* starts; /**< Offset of the first name byte of each record. */
+    Ingredient** ingredients; /**< Node each record was built from. */
+    int count; /**< Number of records. */
+} IngredientNameArena;
+
+// Name arena functions
+bool buildIngredientNameArena(IngredientNameArena* arena, Ingredient* head);
+void freeIngredientNameArena(IngredientNameArena* arena);
+
+// Scanner functions
+IngredientScanBackend getIngredientScanBackend();
+const char* getIngredientScanBackendName(IngredientScanBackend backend);
+int scanIngredientNameArena(const IngredientNameArena* arena, const char* pattern, IngredientScanBackend backend, Ingredient** results, int maxResults);
+
+#endif // INGREDIENTNAMESCAN_H
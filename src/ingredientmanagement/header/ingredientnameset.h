@@ -0,0 +1,46 @@
+/**
+ * @file ingredientnameset.h
+ * @brief Header file for the ingredient name set, a hash set over normalized ingredient names that
+ * finds an ingredient with the same name as a new or edited one in constant time.
+ */
+#ifndef INGREDIENTNAMESET_H
+#define INGREDIENTNAMESET_H
+
+#include "ingredientmanagement.h"
+#include "ingredientfile.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Ingredient name set entry struct definition.
+ */
+typedef struct IngredientNameSetEntry {
+    uint32_t hash; /**< Hash of the normalized name. */
+    Ingredient* ingredient; /**< The ingredient, NULL for empty slots. */
+} IngredientNameSetEntry;
+
+/**
+ * @brief Ingredient name set struct definition.
+ *
+ * Names are compared after normalization: leading and trailing whitespace is dropped, inner runs
+ * of whitespace count as one space and letters are compared without case, so "Olive  Oil " and
+ * "olive oil" are the same name. The set is an open-addressing table with linear probing that
+ * stores the hash next to each node, so a lookup normalizes only names whose hash matches. A name
+ * may be held by several ingredients, as files written before the set existed can hold duplicates.
+ */
+typedef struct IngredientNameSet {
+    IngredientNameSetEntry* slots; /**< Hash slots. */
+    int capacity; /**< Number of slots, always a power of two. */
+    int count; /**< Number of ingredients in the set. */
+} IngredientNameSet;
+
+// Ingredient name set functions
+size_t normalizeIngredientName(const char* name, char normalized[INGREDIENT_NAME_SIZE]);
+bool initIngredientNameSet(IngredientNameSet* set);
+void freeIngredientNameSet(IngredientNameSet* set);
+bool insertIngredientName(IngredientNameSet* set, Ingredient* ingredient);
+void removeIngredientName(IngredientNameSet* set, const Ingredient* ingredient);
+Ingredient* findIngredientByNormalizedName(const IngredientNameSet* set, const char* name);
+
+#endif // INGREDIENTNAMESET_H
@@ -0,0 +1,66 @@
+/**
+ * @file ingredientpager.h
+ * @brief Header file for the ingredient cursor, which reads windows of records straight from an
+ * offset in a versioned ingredient file so a page can be shown without loading the whole catalog.
+ */
+#ifndef INGREDIENTPAGER_H
+#define INGREDIENTPAGER_H
+
+#include "ingredientmanagement.h"
+#include "ingredientfile.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Number of records read per page by the ingredient browsing screens.
+ */
+#define INGREDIENT_PAGE_SIZE 16
+
+/**
+ * @brief Logged change to a record of the file, as seen by an ingredient cursor.
+ */
+typedef struct IngredientCursorChange {
+    int id; /**< ID of the changed record. */
+    bool removed; /**< True if the log removes the record, possibly adding the ID again at the end. */
+    float price; /**< Price after the logged updates. */
+    char name[INGREDIENT_NAME_SIZE]; /**< Name after the logged updates. */
+} IngredientCursorChange;
+
+/**
+ * @brief Ingredient cursor struct definition.
+ *
+ * Opening a cursor reads only the file header, for version 2 files the name pool header, and the
+ * pending ingredient log. Positions count the ingredients a full load would return, in the same
+ * order: the live records of the file with the logged changes applied, followed by the
+ * ingredients the log adds. The records are checked for tombstones as far as the pages read so
+ * far reach, and every page read then reads a byte range starting at its first record through
+ * the storage backend, so its cost depends on the page size and the position and not on the
+ * number of records in the file.
+ */
+typedef struct IngredientCursor {
+    char* filePath; /**< Copy of the path of the ingredient file. */
+    const IngredientStorage* storage; /**< Backend the file is read through. */
+    IngredientFileHeader header; /**< Header of the file. */
+    int count; /**< Number of ingredients; taken from the deleted record count of the header until every record was checked. */
+    uint64_t nameOffsetsStart; /**< File position of the name pool offsets, 0 for version 1 files. */
+    uint64_t namesStart; /**< File position of the name pool data, 0 for version 1 files. */
+    uint32_t nameCount; /**< Number of names in the name pool. */
+    uint32_t namesSize; /**< Number of bytes of name data. */
+    int* livePositions; /**< Record positions of the shown records found so far, in file order. */
+    int liveCount; /**< Number of entries in livePositions. */
+    int liveCapacity; /**< Capacity of livePositions. */
+    int scannedCount; /**< Number of records checked for tombstones so far. */
+    IngredientCursorChange* changes; /**< Records of the file the log removes or updates, sorted by ID. */
+    int changeCount; /**< Number of entries in changes. */
+    Ingredient* added; /**< Ingredients the log adds, shown after the records of the file in log order. */
+    int addedCount; /**< Number of entries in added. */
+} IngredientCursor;
+
+// Ingredient cursor functions
+bool openIngredientCursor(const char* filePath, IngredientCursor* cursor);
+void closeIngredientCursor(IngredientCursor* cursor);
+int readIngredientPage(IngredientCursor* cursor, int offset, Ingredient* page, int pageSize);
+bool listIngredientPageXLL(IngredientCursor* cursor, int offset, int pageSize);
+
+#endif // INGREDIENTPAGER_H
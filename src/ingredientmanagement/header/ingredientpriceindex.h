@@ -0,0 +1,61 @@
+/**
+ * @file ingredientpriceindex.h
+ * @brief Header file for the ingredient price index, a skip list that keeps ingredients ordered by
+ * price for range queries and ordered iteration.
+ */
+#ifndef INGREDIENTPRICEINDEX_H
+#define INGREDIENTPRICEINDEX_H
+
+#include "ingredientmanagement.h"
+#include "ingredientcatalog.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Highest level of a price index node; with a branching factor of four this covers
+ * millions of ingredients without degrading.
+ */
+#define INGREDIENT_PRICE_INDEX_MAX_LEVEL 16
+
+/**
+ * @brief Price index node struct definition.
+ *
+ * Nodes are ordered by price and then by ID, so ingredients with equal prices keep a stable order.
+ * The key is copied into the node, which lets the ingredient's price be changed only after its
+ * node has been removed.
+ */
+typedef struct IngredientPriceNode {
+    float price; /**< Price the node is ordered by. */
+    int id; /**< ID of the ingredient, the second ordering key. */
+    Ingredient* ingredient; /**< The indexed ingredient. */
+    struct IngredientPriceNode* prev; /**< Previous node on the bottom level, NULL for the first node. */
+    int level; /**< Number of forward pointers. */
+    struct IngredientPriceNode* next[1]; /**< Forward pointers, level entries allocated with the node. */
+} IngredientPriceNode;
+
+/**
+ * @brief Ingredient price index struct definition.
+ *
+ * A skip list: inserting, removing and finding the first price of a range take logarithmic time
+ * on average, and walking the bottom level in either direction visits the ingredients in price order.
+ */
+struct IngredientPriceIndex {
+    IngredientPriceNode* head; /**< Sentinel node with INGREDIENT_PRICE_INDEX_MAX_LEVEL forward pointers. */
+    IngredientPriceNode* last; /**< Node with the highest price, NULL if the index is empty. */
+    int level; /**< Number of levels in use. */
+    int count; /**< Number of indexed ingredients. */
+    uint32_t seed; /**< State of the generator that picks node levels. */
+};
+
+// Ingredient price index functions
+bool initIngredientPriceIndex(IngredientPriceIndex* index);
+void freeIngredientPriceIndex(IngredientPriceIndex* index);
+bool insertIngredientPrice(IngredientPriceIndex* index, Ingredient* ingredient);
+bool removeIngredientPrice(IngredientPriceIndex* index, const Ingredient* ingredient);
+const IngredientPriceNode* findFirstIngredientPrice(const IngredientPriceIndex* index, float minPrice);
+int findIngredientsInPriceRange(const IngredientPriceIndex* index, float minPrice, float maxPrice, Ingredient** results, int maxResults);
+
+// Catalog price functions
+int findCatalogIngredientsByPrice(const IngredientCatalog* catalog, float minPrice, float maxPrice, Ingredient** results, int maxResults);
+
+#endif // INGREDIENTPRICEINDEX_H
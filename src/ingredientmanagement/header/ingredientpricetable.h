@@ -0,0 +1,39 @@
+/**
+ * @file ingredientpricetable.h
+ * @brief Header file for the ingredient price table, a structure-of-arrays view of a catalog that
+ * keeps ingredient IDs and prices in their own contiguous arrays for costing loops.
+ */
+#ifndef INGREDIENTPRICETABLE_H
+#define INGREDIENTPRICETABLE_H
+
+#include "ingredientmanagement.h"
+#include "ingredientcatalog.h"
+#include <stdbool.h>
+
+/**
+ * @brief Ingredient price table struct definition.
+ *
+ * Entry i describes one ingredient: ids[i] and prices[i] are the hot fields read while costing
+ * recipes, and ingredients[i] points at the list node for the cold name data. Sixteen entries of
+ * both hot arrays fit in two cache lines, where sixteen list nodes span thirty-two.
+ *
+ * When the IDs run without gaps from ids[0], an ID is looked up by subtracting ids[0]; otherwise
+ * an open-addressing table of entry positions is used.
+ */
+typedef struct IngredientPriceTable {
+    int* ids; /**< Ingredient IDs, in catalog order. */
+    float* prices; /**< Ingredient prices, parallel to ids. */
+    const Ingredient** ingredients; /**< List nodes holding the names, parallel to ids. */
+    int count; /**< Number of entries. */
+    bool dense; /**< True if ids[i] == ids[0] + i for every entry. */
+    int* slots; /**< Hash slots holding entry position + 1, 0 for empty slots; NULL when dense. */
+    int capacity; /**< Number of hash slots, always a power of two. */
+} IngredientPriceTable;
+
+// Ingredient price table functions
+bool buildIngredientPriceTable(IngredientPriceTable* table, const IngredientCatalog* catalog);
+void freeIngredientPriceTable(IngredientPriceTable* table);
+int findIngredientPriceEntry(const IngredientPriceTable* table, int id);
+double sumIngredientPrices(const IngredientPriceTable* table, const int* ids, int count, int* missing);
+
+#endif // INGREDIENTPRICETABLE_H
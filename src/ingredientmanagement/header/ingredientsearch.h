@@ -0,0 +1,112 @@
+/**
+ * @file ingredientsearch.h
+ * @brief Header file for ingredient name search, including an Aho-Corasick automaton that matches
+ * many search terms against every ingredient name in a single pass, a trigram index that narrows
+ * substring searches down to a few candidates and a bit-parallel approximate matcher that tolerates typos.
+ */
+#ifndef INGREDIENTSEARCH_H
+#define INGREDIENTSEARCH_H
+
+#include "ingredientmanagement.h"
+#include "ingredientcatalog.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum length of the search input read by searchIngredientsByTerms.
+ */
+#define INGREDIENT_SEARCH_INPUT_SIZE 1024
+
+/**
+ * @brief Shortest pattern the trigram index can narrow down; shorter patterns scan every name.
+ */
+#define INGREDIENT_TRIGRAM_LENGTH 3
+
+/**
+ * @brief Longest pattern the approximate matcher accepts, one bit per pattern character.
+ */
+#define INGREDIENT_FUZZY_MAX_PATTERN_LENGTH 64
+
+/**
+ * @brief Largest edit distance at which a name is suggested for a term that was not found.
+ */
+#define INGREDIENT_FUZZY_MAX_DISTANCE 2
+
+/**
+ * @brief Number of names suggested for a term that was not found.
+ */
+#define INGREDIENT_FUZZY_SUGGESTION_COUNT 3
+
+/**
+ * @brief Aho-Corasick automaton over a set of search terms.
+ *
+ * The automaton is stored as a complete transition table, so every byte of a name costs one table
+ * lookup. Bytes that occur in no term share a single character class, which keeps each row as
+ * narrow as the alphabet of the terms.
+ */
+typedef struct IngredientMatcher {
+    uint8_t classes[256]; /**< Character class of each byte value, 0 for bytes that occur in no term. */
+    int classCount; /**< Number of character classes, the width of a transition row. */
+    int stateCount; /**< Number of automaton states; state 0 is the root. */
+    int* transitions; /**< Next state for every state and character class. */
+    int* firstTerm; /**< First term that ends in each state, -1 if none. */
+    int* outputLink; /**< Nearest state on the failure chain where a term ends, -1 if none. */
+    int termCount; /**< Number of terms the automaton was built from. */
+    int* termLengths; /**< Length of each term in bytes. */
+    int* nextTerm; /**< Next term with the same text, -1 if none. */
+} IngredientMatcher;
+
+/**
+ * @brief Pattern prepared for Myers' bit-parallel approximate matching.
+ *
+ * Bit i of the mask of a byte is set when pattern character i equals that byte, so one text byte
+ * updates the edit distances of all pattern prefixes with a handful of word operations.
+ */
+typedef struct IngredientFuzzyPattern {
+    uint64_t masks[256]; /**< Positions of each byte value in the pattern. */
+    int length; /**< Length of the pattern in bytes. */
+} IngredientFuzzyPattern;
+
+/**
+ * @brief Ingredient found by an approximate search together with its edit distance.
+ */
+typedef struct IngredientFuzzyMatch {
+    Ingredient* ingredient; /**< The matching ingredient. */
+    int distance; /**< Fewest edits that turn the pattern into a substring of the name. */
+} IngredientFuzzyMatch;
+
+/**
+ * @brief Callback invoked for every match found by scanIngredientNames.
+ *
+ * @param ingredient The ingredient whose name contains the term.
+ * @param termIndex The index of the matched term.
+ * @param position The offset in the name where the match starts.
+ * @param context The context pointer passed to scanIngredientNames.
+ */
+typedef void (*IngredientMatchCallback)(const Ingredient* ingredient, int termIndex, int position, void* context);
+
+// Aho-Corasick functions
+bool buildIngredientMatcher(IngredientMatcher* matcher, const char* const* terms, int termCount, bool ignoreCase);
+void freeIngredientMatcher(IngredientMatcher* matcher);
+int scanIngredientNames(const IngredientMatcher* matcher, const Ingredient* head, IngredientMatchCallback callback, void* context);
+int scanIngredientCandidates(const IngredientMatcher* matcher, Ingredient* const* candidates, int candidateCount, IngredientMatchCallback callback, void* context);
+
+// Trigram index functions
+IngredientTrigramIndex* createIngredientTrigramIndex();
+void freeIngredientTrigramIndex(IngredientTrigramIndex* index);
+void addIngredientTrigrams(IngredientTrigramIndex* index, const Ingredient* ingredient);
+void removeIngredientTrigrams(IngredientTrigramIndex* index, const Ingredient* ingredient);
+int queryIngredientTrigramIndex(const IngredientTrigramIndex* index, const char* pattern, int** ids);
+int findCatalogIngredientsByName(const IngredientCatalog* catalog, const char* pattern, Ingredient** results, int maxResults);
+
+// Approximate search functions
+bool buildIngredientFuzzyPattern(IngredientFuzzyPattern* fuzzy, const char* pattern, bool ignoreCase);
+int getIngredientNameDistance(const IngredientFuzzyPattern* fuzzy, const char* name, int maxDistance);
+int findIngredientsFuzzy(Ingredient* head, const char* pattern, int maxDistance, IngredientFuzzyMatch* results, int maxResults);
+
+// Search menu functions
+int splitSearchTerms(char* input, char** terms, int maxTerms);
+void searchIngredientsByTerms(Ingredient* head);
+void searchCatalogIngredientsByTerms(const IngredientCatalog* catalog);
+
+#endif // INGREDIENTSEARCH_H
@@ -0,0 +1,60 @@
+/**
+ * @file ingredientsnapshot.h
+ * @brief Header file for compact ingredient snapshots, which store delta-encoded IDs, fixed-point
+ * prices and front-coded names as variable-length integers for archiving the catalog.
+ */
+#ifndef INGREDIENTSNAPSHOT_H
+#define INGREDIENTSNAPSHOT_H
+
+#include "ingredientmanagement.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Magic number at the start of every ingredient snapshot ("SNP1" on disk).
+ */
+#define INGREDIENT_SNAPSHOT_MAGIC 0x31504E53u
+
+/**
+ * @brief Current version of the ingredient snapshot format.
+ */
+#define INGREDIENT_SNAPSHOT_VERSION 1
+
+/**
+ * @brief Largest number of fixed-point price units per currency unit a snapshot uses.
+ *
+ * The writer picks the smallest power of ten up to this value that stores every price exactly.
+ * If none does, the prices are stored as raw floats instead, so no snapshot is lossy.
+ */
+#define INGREDIENT_SNAPSHOT_MAX_PRICE_SCALE 1000000u
+
+/**
+ * @brief Price scale of a snapshot whose prices are stored as the raw bits of their floats.
+ */
+#define INGREDIENT_SNAPSHOT_RAW_PRICES 0u
+
+/**
+ * @brief Ingredient snapshot header struct definition.
+ *
+ * The header is followed by the name section and then the record section:
+ * - nameCount distinct names in sorted order, each as a varint count of bytes shared with the
+ *   previous name, a varint suffix length and the suffix bytes.
+ * - recordCount records in ascending ID order, each as a varint ID delta from the previous
+ *   record, a zigzag varint price in 1 / priceScale units and a varint index into the names.
+ *   With priceScale INGREDIENT_SNAPSHOT_RAW_PRICES the price is a varint of the float's bits.
+ */
+typedef struct IngredientSnapshotHeader {
+    uint32_t magic; /**< Always INGREDIENT_SNAPSHOT_MAGIC. */
+    uint32_t version; /**< Format version of the snapshot. */
+    uint32_t headerSize; /**< Size of this header in bytes. */
+    uint32_t recordCount; /**< Number of ingredient records. */
+    uint32_t nameCount; /**< Number of distinct names. */
+    uint32_t priceScale; /**< Fixed-point price units per currency unit, or INGREDIENT_SNAPSHOT_RAW_PRICES. */
+    uint64_t bodySize; /**< Size of the name and record sections in bytes. */
+} IngredientSnapshotHeader;
+
+// Ingredient snapshot functions
+bool writeIngredientSnapshot(const Ingredient* head, const char* filePath);
+Ingredient* readIngredientSnapshot(const char* filePath);
+
+#endif // INGREDIENTSNAPSHOT_H
@@ -0,0 +1,64 @@
+/**
+ * @file ingredientstorage.h
+ * @brief Header file for the ingredient storage interface, which hides how ingredient files are
+ * read and written behind one set of operations with stdio, mmap and in-memory implementations.
+ */
+#ifndef INGREDIENTSTORAGE_H
+#define INGREDIENTSTORAGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct IngredientStorage IngredientStorage;
+
+/**
+ * @brief Read-only view of the whole contents of a stored file.
+ */
+typedef struct IngredientStorageView {
+    const void* data; /**< First byte of the contents. */
+    size_t size; /**< Size of the contents in bytes. */
+    void* handle; /**< Backend state needed to release the view. */
+    const IngredientStorage* storage; /**< Backend that opened the view. */
+} IngredientStorageView;
+
+/**
+ * @brief Ingredient storage backend struct definition.
+ *
+ * Every operation takes the path the caller would otherwise pass to fopen. A view stays valid
+ * until it is closed, even if the file is replaced in the meantime; whether it sees later patches
+ * depends on the backend.
+ */
+struct IngredientStorage {
+    const char* name; /**< Short name of the backend, such as "mmap". */
+    bool (*openView)(const char* path, IngredientStorageView* view); /**< Opens a view of a file. */
+    void (*closeView)(IngredientStorageView* view); /**< Releases a view. */
+    bool (*read)(const char* path, size_t offset, void* buffer, size_t size); /**< Reads a byte range of a file. */
+    bool (*size)(const char* path, size_t* size); /**< Gets the size of a file in bytes. */
+    bool (*replace)(const char* path, const void* data, size_t size); /**< Atomically replaces a file. */
+    bool (*patch)(const char* path, size_t offset, const void* data, size_t size); /**< Overwrites a byte range of an existing file, growing it if needed. */
+    bool (*remove)(const char* path); /**< Deletes a file. */
+};
+
+/**
+ * @brief Backend that reads whole files with fread and writes them with fwrite.
+ */
+extern const IngredientStorage ingredientStdioStorage;
+
+/**
+ * @brief Backend that memory-maps files for reading and writes them with fwrite; the default.
+ */
+extern const IngredientStorage ingredientMmapStorage;
+
+/**
+ * @brief Backend that keeps every file in process memory and never touches the disk.
+ */
+extern const IngredientStorage ingredientMemoryStorage;
+
+// Ingredient storage functions
+const IngredientStorage* getIngredientStorage();
+void setIngredientStorage(const IngredientStorage* storage);
+bool openIngredientStorageView(const char* path, IngredientStorageView* view);
+void closeIngredientStorageView(IngredientStorageView* view);
+void clearIngredientMemoryStorage();
+
+#endif // INGREDIENTSTORAGE_H
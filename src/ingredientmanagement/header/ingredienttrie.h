@@ -0,0 +1,49 @@
+/**
+ * @file ingredienttrie.h
+ * @brief Header file for the ingredient name trie, a radix tree over lower-cased names that
+ * completes a typed prefix to the matching ingredients in alphabetical order.
+ */
+#ifndef INGREDIENTTRIE_H
+#define INGREDIENTTRIE_H
+
+#include "ingredientmanagement.h"
+#include "ingredientcatalog.h"
+#include <stdbool.h>
+
+/**
+ * @brief Radix tree node struct definition.
+ *
+ * Every edge carries a whole run of characters, so an inner node always has at least two children
+ * or ends a name. Children are kept sorted by the first byte of their label.
+ */
+typedef struct IngredientTrieNode {
+    char* label; /**< Characters on the edge into this node, not null-terminated. */
+    int labelLength; /**< Number of characters in the label. */
+    struct IngredientTrieNode** children; /**< Child nodes sorted by the first label byte. */
+    int childCount; /**< Number of children. */
+    int* ids; /**< IDs of the ingredients whose name ends at this node. */
+    int idCount; /**< Number of IDs. */
+} IngredientTrieNode;
+
+/**
+ * @brief Ingredient name trie struct definition.
+ *
+ * Completing a prefix costs one descent along the prefix plus a walk over the returned subtree;
+ * because no inner node has a single child, returning N names visits fewer than 2N nodes.
+ */
+struct IngredientTrie {
+    IngredientTrieNode* root; /**< Root node with an empty label. */
+    int count; /**< Number of names in the trie. */
+};
+
+// Ingredient trie functions
+bool initIngredientTrie(IngredientTrie* trie);
+void freeIngredientTrie(IngredientTrie* trie);
+bool insertIngredientTrie(IngredientTrie* trie, const char* name, int id);
+bool removeIngredientTrie(IngredientTrie* trie, const char* name, int id);
+int completeIngredientTrie(const IngredientTrie* trie, const char* prefix, int* ids, int maxResults);
+
+// Catalog autocomplete functions
+int completeCatalogIngredientNames(const IngredientCatalog* catalog, const char* prefix, Ingredient** results, int maxResults);
+
+#endif // INGREDIENTTRIE_H
@@ -0,0 +1,579 @@
+/**
+ * @file ingredientcatalog.cpp
+ * @brief Implementation of the ingredient catalog, including the open-addressing ID index and the
+ * normalized name set that let every ingredient be found, added and removed without walking the list.
+ */
+#include "../header/ingredientcatalog.h"
+#include "../header/ingredientsearch.h"
+#include "../header/ingredienttrie.h"
+#include "../header/ingredientpriceindex.h"
+#include "../header/ingredientnameset.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of index slots allocated for the first ingredient.
+ */
+#define INGREDIENT_CATALOG_INITIAL_CAPACITY 16
+
+/**
+ * @brief Returns the home slot of an ingredient ID.
+ *
+ * @param id The ingredient ID.
+ * @param capacity The number of index slots, a power of two.
+ * @return The slot where probing for the ID starts.
+ */
+static int getIngredientSlot(int id, int capacity) {
+	uint32_t hash = (uint32_t)id * 0x9E3779B1u;
+	hash ^= hash >> 16;
+	return (int)(hash & (uint32_t)(capacity - 1));
+}
+
+/**
+ * @brief Adds a node to an index that is known to have a free slot.
+ *
+ * @param slots The index slots.
+ * @param capacity The number of index slots.
+ * @param ingredient The node to add; nodes whose ID is already indexed are skipped.
+ */
+static void insertIngredientSlot(Ingredient** slots, int capacity, Ingredient* ingredient) {
+	int slot = getIngredientSlot(ingredient->id, capacity);
+	while (slots[slot] != NULL) {
+		if (slots[slot]->id == ingredient->id) {
+			return;
+		}
+		slot = (slot + 1) & (capacity - 1);
+	}
+	slots[slot] = ingredient;
+}
+
+/**
+ * @brief Makes sure the index has room for one more ingredient, doubling it when it is half full.
+ *
+ * If memory runs out the index is dropped and lookups fall back to walking the list.
+ *
+ * @param catalog The catalog whose index should grow.
+ */
+static void reserveIngredientSlot(IngredientCatalog* catalog) {
+	if (!catalog->indexed) {
+		return;
+	}
+	if (catalog->slots != NULL && (catalog->count + 1) * 2 <= catalog->capacity) {
+		return;
+	}
+	if (catalog->slots == NULL && catalog->capacity < 0) {
+		return;
+	}
+
+	int capacity = catalog->capacity > 0 ? catalog->capacity * 2 : INGREDIENT_CATALOG_INITIAL_CAPACITY;
+	while ((catalog->count + 1) * 2 > capacity) {
+		capacity *= 2;
+	}
+
+	Ingredient** slots = (Ingredient**)calloc((size_t)capacity, sizeof(Ingredient*));
+	free(catalog->slots);
+	catalog->slots = slots;
+	if (slots == NULL) {
+		// Remember the failure so every later lookup walks the list instead
+		catalog->capacity = -1;
+		return;
+	}
+
+	catalog->capacity = capacity;
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		insertIngredientSlot(slots, capacity, current);
+	}
+}
+
+/**
+ * @brief Creates the name set of a catalog from its list if it does not exist yet.
+ *
+ * If memory runs out the catalog keeps no set and name lookups walk the list instead.
+ *
+ * @param catalog The catalog whose name set should exist.
+ */
+static void ensureIngredientNameSet(IngredientCatalog* catalog) {
+	if (catalog->names != NULL || !catalog->indexed) {
+		return;
+	}
+
+	IngredientNameSet* names = (IngredientNameSet*)malloc(sizeof(IngredientNameSet));
+	if (names == NULL || !initIngredientNameSet(names)) {
+		free(names);
+		return;
+	}
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		if (!insertIngredientName(names, current)) {
+			freeIngredientNameSet(names);
+			free(names);
+			return;
+		}
+	}
+	catalog->names = names;
+}
+
+/**
+ * @brief Initializes an empty ingredient catalog.
+ *
+ * @param catalog The catalog to initialize.
+ */
+void initIngredientCatalog(IngredientCatalog* catalog) {
+	catalog->head = NULL;
+	catalog->tail = NULL;
+	catalog->count = 0;
+	catalog->slots = NULL;
+	catalog->capacity = 0;
+	catalog->arena = NULL;
+	catalog->names = NULL;
+	catalog->trigrams = NULL;
+	catalog->trie = NULL;
+	catalog->prices = NULL;
+	catalog->indexed = true;
+}
+
+/**
+ * @brief Hands an existing ingredient list to a catalog and indexes it.
+ *
+ * @param catalog The catalog to initialize; it owns the list afterwards.
+ * @param head The head of the linked list of ingredients.
+ */
+void attachIngredientCatalog(IngredientCatalog* catalog, Ingredient* head) {
+	initIngredientCatalog(catalog);
+	catalog->head = head;
+	for (Ingredient* current = head; current != NULL; current = current->next) {
+		catalog->tail = current;
+		catalog->count++;
+	}
+	if (catalog->count > 0) {
+		reserveIngredientSlot(catalog);
+		ensureIngredientNameSet(catalog);
+	}
+}
+
+/**
+ * @brief Hands an existing ingredient list to a catalog without indexing it.
+ *
+ * Building the indexes costs more than the single lookup of one mutation, so the list-based
+ * wrappers use this and let every lookup walk the list instead.
+ *
+ * @param catalog The catalog to initialize; it owns the list until it is detached.
+ * @param head The head of the linked list of ingredients.
+ */
+void wrapIngredientCatalog(IngredientCatalog* catalog, Ingredient* head) {
+	initIngredientCatalog(catalog);
+	catalog->indexed = false;
+	catalog->head = head;
+	for (Ingredient* current = head; current != NULL; current = current->next) {
+		catalog->tail = current;
+		catalog->count++;
+	}
+}
+
+/**
+ * @brief Releases the indexes of a catalog and hands its list back to the caller.
+ *
+ * @param catalog The catalog to detach; it is empty afterwards.
+ * @return The head of the linked list of ingredients.
+ */
+Ingredient* detachIngredientCatalog(IngredientCatalog* catalog) {
+	Ingredient* head = catalog->head;
+	free(catalog->slots);
+	if (catalog->names != NULL) {
+		freeIngredientNameSet(catalog->names);
+		free(catalog->names);
+	}
+	freeIngredientTrigramIndex(catalog->trigrams);
+	if (catalog->trie != NULL) {
+		freeIngredientTrie(catalog->trie);
+		free(catalog->trie);
+	}
+	if (catalog->prices != NULL) {
+		freeIngredientPriceIndex(catalog->prices);
+		free(catalog->prices);
+	}
+	initIngredientCatalog(catalog);
+	return head;
+}
+
+/**
+ * @brief Frees every ingredient of a catalog together with its index.
+ *
+ * A catalog loaded into an arena releases the whole arena instead of freeing node by node.
+ *
+ * @param catalog The catalog to free; it is empty afterwards.
+ */
+void freeIngredientCatalog(IngredientCatalog* catalog) {
+	MemoryArena* arena = catalog->arena;
+	Ingredient* current = detachIngredientCatalog(catalog);
+	if (arena != NULL) {
+		freeMemoryArena(arena);
+		return;
+	}
+	while (current != NULL) {
+		Ingredient* temp = current;
+		current = current->next;
+		free(temp);
+	}
+}
+
+/**
+ * @brief Loads an ingredient file into a catalog.
+ *
+ * @param catalog The catalog to initialize.
+ * @param filePath The file path to load the ingredients from.
+ */
+void loadIngredientCatalog(IngredientCatalog* catalog, const char* filePath) {
+	attachIngredientCatalog(catalog, loadIngredientsFromFile(filePath));
+}
+
+/**
+ * @brief Loads an ingredient file into a catalog whose nodes live in an arena.
+ *
+ * Large files are decoded on one thread per hardware thread. Ingredients added to the catalog
+ * later are allocated from the same arena, and freeIngredientCatalog releases the arena.
+ *
+ * @param catalog The catalog to initialize.
+ * @param filePath The file path to load the ingredients from.
+ * @param arena The arena to allocate the nodes from.
+ */
+void loadIngredientCatalogInArena(IngredientCatalog* catalog, const char* filePath, MemoryArena* arena) {
+	attachIngredientCatalog(catalog, loadIngredientsFromFileInParallel(filePath, arena, 0));
+	catalog->arena = arena;
+}
+
+/**
+ * @brief Finds an ingredient by ID.
+ *
+ * @param catalog The catalog to search.
+ * @param id The ingredient ID to look up.
+ * @return The ingredient node, or NULL if the ID is not in the catalog.
+ */
+Ingredient* findIngredientById(const IngredientCatalog* catalog, int id) {
+	if (catalog->slots == NULL) {
+		Ingredient* current = catalog->head;
+		while (current != NULL && current->id != id) {
+			current = current->next;
+		}
+		return current;
+	}
+
+	int slot = getIngredientSlot(id, catalog->capacity);
+	while (catalog->slots[slot] != NULL) {
+		if (catalog->slots[slot]->id == id) {
+			return catalog->slots[slot];
+		}
+		slot = (slot + 1) & (catalog->capacity - 1);
+	}
+	return NULL;
+}
+
+/**
+ * @brief Finds an ingredient whose name equals a name after normalization.
+ *
+ * Names are compared without case and with whitespace trimmed and collapsed, as described in
+ * ingredientnameset.h.
+ *
+ * @param catalog The catalog to search.
+ * @param name The name to look for.
+ * @return An ingredient with that name, or NULL if there is none.
+ */
+Ingredient* findIngredientByName(const IngredientCatalog* catalog, const char* name) {
+	if (catalog->names != NULL) {
+		return findIngredientByNormalizedName(catalog->names, name);
+	}
+
+	char normalized[INGREDIENT_NAME_SIZE];
+	char candidate[INGREDIENT_NAME_SIZE];
+	normalizeIngredientName(name, normalized);
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		normalizeIngredientName(current->name, candidate);
+		if (strcmp(candidate, normalized) == 0) {
+			return current;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Returns the ID for the next ingredient added to a catalog.
+ *
+ * New ingredients continue from the ID of the last ingredient, skipping IDs that are already taken.
+ *
+ * @param catalog The catalog to add to.
+ * @return An ID that is not used by any ingredient in the catalog.
+ */
+int getNextIngredientId(const IngredientCatalog* catalog) {
+	int id = catalog->tail != NULL ? catalog->tail->id + 1 : 1;
+	while (findIngredientById(catalog, id) != NULL) {
+		id++;
+	}
+	return id;
+}
+
+/**
+ * @brief Takes a node out of the list and indexes of a catalog.
+ *
+ * Indexes that do not hold the node are left alone, so a node whose linking failed halfway can
+ * be taken out as well.
+ *
+ * @param catalog The catalog to remove from.
+ * @param ingredient The node to remove.
+ */
+static void removeCatalogNode(IngredientCatalog* catalog, Ingredient* ingredient) {
+	if (ingredient->prev != NULL) {
+		ingredient->prev->next = ingredient->next;
+	}
+	else {
+		catalog->head = ingredient->next;
+	}
+	if (ingredient->next != NULL) {
+		ingredient->next->prev = ingredient->prev;
+	}
+	else {
+		catalog->tail = ingredient->prev;
+	}
+	catalog->count--;
+
+	if (catalog->names != NULL) {
+		removeIngredientName(catalog->names, ingredient);
+	}
+	if (catalog->trigrams != NULL) {
+		removeIngredientTrigrams(catalog->trigrams, ingredient);
+	}
+	if (catalog->trie != NULL) {
+		removeIngredientTrie(catalog->trie, ingredient->name, ingredient->id);
+	}
+	if (catalog->prices != NULL) {
+		removeIngredientPrice(catalog->prices, ingredient);
+	}
+	if (catalog->slots != NULL) {
+		int mask = catalog->capacity - 1;
+		int slot = getIngredientSlot(ingredient->id, catalog->capacity);
+		while (catalog->slots[slot] != NULL && catalog->slots[slot] != ingredient) {
+			slot = (slot + 1) & mask;
+		}
+
+		// Shift later entries of the probe run back so no lookup stops at the hole
+		int next = slot;
+		while (catalog->slots[slot] != NULL) {
+			next = (next + 1) & mask;
+			if (catalog->slots[next] == NULL) {
+				catalog->slots[slot] = NULL;
+				break;
+			}
+			int home = getIngredientSlot(catalog->slots[next]->id, catalog->capacity);
+			if (((next - home) & mask) >= ((next - slot) & mask)) {
+				catalog->slots[slot] = catalog->slots[next];
+				slot = next;
+			}
+		}
+	}
+
+	ingredient->prev = NULL;
+	ingredient->next = NULL;
+}
+
+/**
+ * @brief Appends an ingredient node to the end of a catalog and indexes it.
+ *
+ * @param catalog The catalog to add to; it owns the node afterwards.
+ * @param ingredient The node to append.
+ * @return True if the node was linked; false if the name trie or the price index ran out of
+ * memory, in which case the node is unlinked again and still owned by the caller.
+ */
+bool linkCatalogIngredient(IngredientCatalog* catalog, Ingredient* ingredient) {
+	reserveIngredientSlot(catalog);
+
+	ingredient->prev = catalog->tail;
+	ingredient->next = NULL;
+	if (catalog->tail != NULL) {
+		catalog->tail->next = ingredient;
+	}
+	else {
+		catalog->head = ingredient;
+	}
+	catalog->tail = ingredient;
+	catalog->count++;
+
+	if (catalog->slots != NULL) {
+		insertIngredientSlot(catalog->slots, catalog->capacity, ingredient);
+	}
+	if (catalog->names == NULL) {
+		ensureIngredientNameSet(catalog);
+	}
+	else if (!insertIngredientName(catalog->names, ingredient)) {
+		freeIngredientNameSet(catalog->names);
+		free(catalog->names);
+		catalog->names = NULL;
+	}
+	if (catalog->trigrams != NULL) {
+		addIngredientTrigrams(catalog->trigrams, ingredient);
+	}
+	if ((catalog->trie != NULL && !insertIngredientTrie(catalog->trie, ingredient->name, ingredient->id))
+		|| (catalog->prices != NULL && !insertIngredientPrice(catalog->prices, ingredient))) {
+		// Unlinking skips the indexes the node never reached, so every index agrees with the list again
+		removeCatalogNode(catalog, ingredient);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Removes an ingredient from a catalog without freeing it.
+ *
+ * @param catalog The catalog to remove from.
+ * @param id The ID of the ingredient to remove.
+ * @return The unlinked node, owned by the caller, or NULL if the ID is not in the catalog.
+ */
+Ingredient* unlinkCatalogIngredient(IngredientCatalog* catalog, int id) {
+	Ingredient* ingredient = findIngredientById(catalog, id);
+	if (ingredient != NULL) {
+		removeCatalogNode(catalog, ingredient);
+	}
+	return ingredient;
+}
+
+/**
+ * @brief Builds a trigram index over the names of a catalog and keeps it in sync from then on.
+ *
+ * @param catalog The catalog to index.
+ * @return True if the index is available, false if memory allocation failed.
+ */
+bool enableIngredientTrigramIndex(IngredientCatalog* catalog) {
+	if (catalog->trigrams != NULL) {
+		return true;
+	}
+
+	catalog->trigrams = createIngredientTrigramIndex();
+	if (catalog->trigrams == NULL) {
+		return false;
+	}
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		addIngredientTrigrams(catalog->trigrams, current);
+	}
+	return true;
+}
+
+/**
+ * @brief Builds a prefix trie over the names of a catalog and keeps it in sync from then on.
+ *
+ * @param catalog The catalog to index.
+ * @return True if the trie is available, false if memory allocation failed.
+ */
+bool enableIngredientNameTrie(IngredientCatalog* catalog) {
+	if (catalog->trie != NULL) {
+		return true;
+	}
+
+	IngredientTrie* trie = (IngredientTrie*)malloc(sizeof(IngredientTrie));
+	if (trie == NULL || !initIngredientTrie(trie)) {
+		free(trie);
+		return false;
+	}
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		if (!insertIngredientTrie(trie, current->name, current->id)) {
+			freeIngredientTrie(trie);
+			free(trie);
+			return false;
+		}
+	}
+	catalog->trie = trie;
+	return true;
+}
+
+/**
+ * @brief Builds a price index over a catalog and keeps it in sync from then on.
+ *
+ * @param catalog The catalog to index.
+ * @return True if the index is available, false if memory allocation failed.
+ */
+bool enableIngredientPriceIndex(IngredientCatalog* catalog) {
+	if (catalog->prices != NULL) {
+		return true;
+	}
+
+	IngredientPriceIndex* prices = (IngredientPriceIndex*)malloc(sizeof(IngredientPriceIndex));
+	if (prices == NULL || !initIngredientPriceIndex(prices)) {
+		free(prices);
+		return false;
+	}
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		if (!insertIngredientPrice(prices, current)) {
+			freeIngredientPriceIndex(prices);
+			free(prices);
+			return false;
+		}
+	}
+	catalog->prices = prices;
+	return true;
+}
+
+/**
+ * @brief Changes the name of an ingredient in a catalog and updates the name indexes.
+ *
+ * The new name enters the trie before the old one leaves it, so running out of memory leaves the
+ * ingredient and every index unchanged.
+ *
+ * @param catalog The catalog that owns the ingredient.
+ * @param ingredient The ingredient to rename.
+ * @param name The new name; it is truncated to the size of the name field.
+ * @return True if the ingredient was renamed, false if the name trie ran out of memory.
+ */
+bool renameCatalogIngredient(IngredientCatalog* catalog, Ingredient* ingredient, const char* name) {
+	char newName[sizeof(ingredient->name)];
+	strncpy(newName, name, sizeof(newName) - 1);
+	newName[sizeof(newName) - 1] = '\0';
+	if (catalog->trie != NULL) {
+		if (!insertIngredientTrie(catalog->trie, newName, ingredient->id)) {
+			return false;
+		}
+		removeIngredientTrie(catalog->trie, ingredient->name, ingredient->id);
+	}
+
+	if (catalog->names != NULL) {
+		removeIngredientName(catalog->names, ingredient);
+	}
+	if (catalog->trigrams != NULL) {
+		removeIngredientTrigrams(catalog->trigrams, ingredient);
+	}
+	memcpy(ingredient->name, newName, sizeof(newName));
+	if (catalog->names != NULL && !insertIngredientName(catalog->names, ingredient)) {
+		freeIngredientNameSet(catalog->names);
+		free(catalog->names);
+		catalog->names = NULL;
+	}
+	if (catalog->trigrams != NULL) {
+		addIngredientTrigrams(catalog->trigrams, ingredient);
+	}
+	return true;
+}
+
+/**
+ * @brief Changes the price of an ingredient in a catalog and moves it in the price index.
+ *
+ * The node for the new price is added before the old one is removed, so running out of memory
+ * leaves the ingredient and the index unchanged.
+ *
+ * @param catalog The catalog that owns the ingredient.
+ * @param ingredient The ingredient to reprice.
+ * @param price The new price.
+ * @return True if the price was changed, false if the price index ran out of memory.
+ */
+bool setCatalogIngredientPrice(IngredientCatalog* catalog, Ingredient* ingredient, float price) {
+	float oldPrice = ingredient->price;
+	ingredient->price = price;
+	if (catalog->prices == NULL) {
+		return true;
+	}
+	if (!insertIngredientPrice(catalog->prices, ingredient)) {
+		ingredient->price = oldPrice;
+		return false;
+	}
+
+	// Nodes keep their own key, so the old node is found under the old price
+	ingredient->price = oldPrice;
+	removeIngredientPrice(catalog->prices, ingredient);
+	ingredient->price = price;
+	return true;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file ingredientchecksum.cpp
+ * @brief Implementation of CRC32C (Castagnoli), including the slicing-by-8 tables, the SSE4.2 path
+ * and the choice between them when the process starts.
+ */
+#include "../header/ingredientchecksum.h"
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define INGREDIENT_CRC32C_SSE42 1
+#define INGREDIENT_CRC32C_TARGET __attribute__((target("sse4.2")))
+#include <nmmintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define INGREDIENT_CRC32C_SSE42 1
+#define INGREDIENT_CRC32C_TARGET
+#include <intrin.h>
+#include <nmmintrin.h>
+#endif
+
+/**
+ * @brief Reflected CRC32C polynomial.
+ */
+#define CRC32C_POLYNOMIAL 0x82F63B78u
+
+/**
+ * @brief Slicing-by-8 lookup tables; table[k][b] is the CRC of byte b followed by k zero bytes.
+ */
+typedef struct Crc32cTables {
+	uint32_t table[8][256]; /**< The eight lookup tables. */
+} Crc32cTables;
+
+/**
+ * @brief Builds the slicing-by-8 tables.
+ *
+ * @return The tables, built once on first use.
+ */
+static const Crc32cTables* getCrc32cTables() {
+	static const Crc32cTables tables = []() {
+		Crc32cTables built;
+		for (uint32_t b = 0; b < 256; b++) {
+			uint32_t crc = b;
+			for (int bit = 0; bit < 8; bit++) {
+				crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0u - (crc & 1u)));
+			}
+			built.table[0][b] = crc;
+		}
+		for (uint32_t b = 0; b < 256; b++) {
+			for (int k = 1; k < 8; k++) {
+				uint32_t previous = built.table[k - 1][b];
+				built.table[k][b] = (previous >> 8) ^ built.table[0][previous & 0xFF];
+			}
+		}
+		return built;
+	}();
+	return &tables;
+}
+
+/**
+ * @brief Continues a CRC32C over more bytes with slicing-by-8 tables, eight bytes per step.
+ *
+ * @param crc The CRC of the bytes before, 0 to start a new CRC.
+ * @param data The bytes to add.
+ * @param size The number of bytes.
+ * @return The CRC of all bytes so far.
+ */
+uint32_t updateCrc32cPortable(uint32_t crc, const void* data, size_t size) {
+	const uint32_t (*table)[256] = getCrc32cTables()->table;
+	const unsigned char* p = (const unsigned char*)data;
+	crc = ~crc;
+
+	while (size >= 8) {
+		// The tables are built for little-endian words, so the bytes are combined explicitly
+		uint32_t low = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+		crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+			^ table[3][p[4]] ^ table[2][p[5]] ^ table[1][p[6]] ^ table[0][p[7]];
+		p += 8;
+		size -= 8;
+	}
+	while (size > 0) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xFF];
+		size--;
+	}
+	return ~crc;
+}
+
+#ifdef INGREDIENT_CRC32C_SSE42
+/**
+ * @brief Continues a CRC32C over more bytes with the SSE4.2 crc32 instruction.
+ *
+ * @param crc The CRC of the bytes before, 0 to start a new CRC.
+ * @param data The bytes to add.
+ * @param size The number of bytes.
+ * @return The CRC of all bytes so far.
+ */
+INGREDIENT_CRC32C_TARGET static uint32_t updateCrc32cSse42(uint32_t crc, const void* data, size_t size) {
+	const unsigned char* p = (const unsigned char*)data;
+	uint64_t state = ~crc;
+	while (size >= 8) {
+		uint64_t word;
+		memcpy(&word, p, sizeof(word));
+		state = _mm_crc32_u64(state, word);
+		p += 8;
+		size -= 8;
+	}
+	uint32_t tail = (uint32_t)state;
+	while (size > 0) {
+		tail = _mm_crc32_u8(tail, *p++);
+		size--;
+	}
+	return ~tail;
+}
+
+/**
+ * @brief Computes the CRC32C of every block of a buffer with the SSE4.2 crc32 instruction.
+ *
+ * A single CRC is bound by the latency of the instruction, so three blocks are run side by side
+ * to keep three instructions in flight.
+ *
+ * @param data The buffer.
+ * @param size The size of the buffer in bytes.
+ * @param blockSize The size of a block in bytes.
+ * @param checksums Receives one CRC per block.
+ */
+INGREDIENT_CRC32C_TARGET static void computeCrc32cBlocksSse42(const unsigned char* data, size_t size, size_t blockSize, uint32_t* checksums) {
+	size_t blockCount = (size + blockSize - 1) / blockSize;
+	size_t block = 0;
+	if (blockSize % 8 == 0) {
+		for (; (block + 3) * blockSize <= size; block += 3) {
+			const unsigned char* first = data + block * blockSize;
+			const unsigned char* second = first + blockSize;
+			const unsigned char* third = second + blockSize;
+			uint64_t firstState = 0xFFFFFFFFu;
+			uint64_t secondState = 0xFFFFFFFFu;
+			uint64_t thirdState = 0xFFFFFFFFu;
+			for (size_t offset = 0; offset < blockSize; offset += 8) {
+				uint64_t firstWord, secondWord, thirdWord;
+				memcpy(&firstWord, first + offset, sizeof(firstWord));
+				memcpy(&secondWord, second + offset, sizeof(secondWord));
+				memcpy(&thirdWord, third + offset, sizeof(thirdWord));
+				firstState = _mm_crc32_u64(firstState, firstWord);
+				secondState = _mm_crc32_u64(secondState, secondWord);
+				thirdState = _mm_crc32_u64(thirdState, thirdWord);
+			}
+			checksums[block] = ~(uint32_t)firstState;
+			checksums[block + 1] = ~(uint32_t)secondState;
+			checksums[block + 2] = ~(uint32_t)thirdState;
+		}
+	}
+	for (; block < blockCount; block++) {
+		size_t start = block * blockSize;
+		checksums[block] = updateCrc32cSse42(0, data + start, size - start < blockSize ? size - start : blockSize);
+	}
+}
+
+/**
+ * @brief Checks once whether the processor has the SSE4.2 crc32 instruction.
+ *
+ * @return True if it does, otherwise false.
+ */
+static bool detectHardwareCrc32c() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#else
+	return __builtin_cpu_supports("sse4.2");
+#endif
+}
+#endif
+
+/**
+ * @brief Reports whether updateCrc32c uses the SSE4.2 crc32 instruction.
+ *
+ * @return True on x86-64 processors with SSE4.2, false where the slicing-by-8 tables are used.
+ */
+bool hasHardwareCrc32c() {
+#ifdef INGREDIENT_CRC32C_SSE42
+	static const bool available = detectHardwareCrc32c();
+	return available;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Continues a CRC32C over more bytes with the fastest implementation of the processor.
+ *
+ * CRCs chain, so updating with two halves of a buffer gives the CRC of the whole buffer.
+ *
+ * @param crc The CRC of the bytes before, 0 to start a new CRC.
+ * @param data The bytes to add.
+ * @param size The number of bytes.
+ * @return The CRC of all bytes so far.
+ */
+uint32_t updateCrc32c(uint32_t crc, const void* data, size_t size) {
+#ifdef INGREDIENT_CRC32C_SSE42
+	if (hasHardwareCrc32c()) {
+		return updateCrc32cSse42(crc, data, size);
+	}
+#endif
+	return updateCrc32cPortable(crc, data, size);
+}
+
+/**
+ * @brief Computes the CRC32C of every block of a buffer.
+ *
+ * @param data The buffer.
+ * @param size The size of the buffer in bytes.
+ * @param blockSize The size of a block in bytes; the last block may be shorter.
+ * @param checksums Receives one CRC per block.
+ */
+void computeCrc32cBlocks(const void* data, size_t size, size_t blockSize, uint32_t* checksums) {
+#ifdef INGREDIENT_CRC32C_SSE42
+	if (hasHardwareCrc32c()) {
+		computeCrc32cBlocksSse42((const unsigned char*)data, size, blockSize, checksums);
+		return;
+	}
+#endif
+	for (size_t start = 0, block = 0; start < size; start += blockSize, block++) {
+		checksums[block] = updateCrc32cPortable(0, (const char*)data + start, size - start < blockSize ? size - start : blockSize);
+	}
+}
@@ -0,0 +1,760 @@
+/**
+ * @file ingredientfile.cpp
+ * @brief Implementation of the versioned ingredient file format, including writing fixed-stride
+ * records with interned names, opening ingredient files through the storage backend so they can be
+ * queried in place, verifying their block checksums and decoding large files into lists on several
+ * threads.
+ */
+#include "../header/ingredientfile.h"
+#include "../header/ingredientchecksum.h"
+#include "../header/ingredientnamepool.h"
+#include "../header/ingredientstorage.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Largest number of damaged blocks openIngredientMap reports one by one.
+ */
+#define INGREDIENT_FILE_REPORTED_BLOCKS 16
+
+/**
+ * @brief Number of blocks whose checksums are computed in one batch while verifying a file.
+ */
+#define INGREDIENT_FILE_VERIFY_BATCH 256
+
+static_assert(offsetof(IngredientFileHeader, deletedCount) == INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES,
+	"headers without tombstones must end where the deleted record count starts");
+
+/**
+ * @brief Generates a new non-zero file generation.
+ *
+ * @return A value that is unique for every rewrite of an ingredient file.
+ */
+static uint64_t newIngredientFileGeneration() {
+	static std::atomic<uint64_t> counter(0);
+	std::random_device device;
+	uint64_t generation = ((uint64_t)device() << 32) ^ (uint64_t)device() ^ ++counter;
+	return generation != 0 ? generation : 1;
+}
+
+/**
+ * @brief Appends raw bytes to a file image.
+ *
+ * @param image The file image.
+ * @param data The bytes to append.
+ * @param size The number of bytes.
+ */
+static void appendIngredientFileBytes(std::vector<char>& image, const void* data, size_t size) {
+	image.insert(image.end(), (const char*)data, (const char*)data + size);
+}
+
+/**
+ * @brief Writes a linked list of ingredients to a versioned, fixed-stride ingredient file.
+ *
+ * Only the ID, name and price of each ingredient are written; list pointers never reach the disk.
+ * Names are interned while the records are written and stored once each in the name pool after
+ * the records. A CRC32C of every INGREDIENT_FILE_BLOCK_SIZE bytes after the header is appended
+ * last. The file is built in memory and handed to the storage backend in one piece, so readers
+ * never see a partial file.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param filePath The file path to write the ingredients to.
+ * @return True if the file was written successfully, otherwise false.
+ */
+bool writeIngredientFile(const Ingredient* head, const char* filePath) {
+	IngredientFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = INGREDIENT_FILE_MAGIC;
+	header.version = INGREDIENT_FILE_VERSION;
+	header.headerSize = sizeof(IngredientFileHeader);
+	header.recordSize = sizeof(IngredientRecord);
+	header.flags = INGREDIENT_FILE_SORTED_BY_ID | INGREDIENT_FILE_CHECKSUMMED;
+	header.generation = newIngredientFileGeneration();
+	header.blockSize = INGREDIENT_FILE_BLOCK_SIZE;
+
+	bool ok = true;
+	IngredientNamePool pool;
+	initIngredientNamePool(&pool);
+	try {
+		// Reserve the header, it is filled in once the record count is known
+		std::vector<char> image(sizeof(header));
+
+		const Ingredient* temp = head;
+		int previousId = 0;
+		while (temp != NULL) {
+			char name[INGREDIENT_NAME_SIZE];
+			strncpy(name, temp->name, INGREDIENT_NAME_SIZE - 1);
+			name[INGREDIENT_NAME_SIZE - 1] = '\0';
+
+			IngredientRecord record;
+			memset(&record, 0, sizeof(record));
+			record.id = temp->id;
+			record.price = temp->price;
+			record.nameHandle = internIngredientName(&pool, name);
+			if (record.nameHandle == INGREDIENT_NAME_HANDLE_INVALID) {
+				ok = false;
+				break;
+			}
+
+			if (header.recordCount > 0 && temp->id <= previousId) {
+				header.flags &= ~INGREDIENT_FILE_SORTED_BY_ID;
+			}
+			previousId = temp->id;
+
+			appendIngredientFileBytes(image, &record, sizeof(record));
+			header.recordCount++;
+			temp = temp->next;
+		}
+
+		if (ok) {
+			IngredientNamePoolHeader poolHeader;
+			poolHeader.nameCount = pool.count;
+			poolHeader.dataSize = pool.size;
+			appendIngredientFileBytes(image, &poolHeader, sizeof(poolHeader));
+			appendIngredientFileBytes(image, pool.offsets, pool.count * sizeof(uint32_t));
+			appendIngredientFileBytes(image, pool.data, pool.size);
+
+			// Pad the body so the checksums that follow it are aligned
+			image.resize((image.size() + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1), '\0');
+			size_t bodySize = image.size() - sizeof(header);
+			std::vector<uint32_t> checksums((bodySize + header.blockSize - 1) / header.blockSize);
+			computeCrc32cBlocks(image.data() + sizeof(header), bodySize, header.blockSize, checksums.data());
+			appendIngredientFileBytes(image, checksums.data(), checksums.size() * sizeof(uint32_t));
+			memcpy(image.data(), &header, sizeof(header));
+			ok = getIngredientStorage()->replace(filePath, image.data(), image.size());
+		}
+	}
+	catch (...) {
+		ok = false;
+	}
+	freeIngredientNamePool(&pool);
+
+	if (!ok) {
+		printf("Error: Failed to write ingredient file %s.\n", filePath);
+	}
+	return ok;
+}
+
+/**
+ * @brief Reads only the header of a versioned ingredient file.
+ *
+ * @param filePath The file path of the ingredient file.
+ * @param header The header to fill; a header without a deleted record count gets a count of zero.
+ * @return True if the file exists and starts with a supported header, otherwise false.
+ */
+bool readIngredientFileHeader(const char* filePath, IngredientFileHeader* header) {
+	memset(header, 0, sizeof(*header));
+	const IngredientStorage* storage = getIngredientStorage();
+	bool ok = storage->read(filePath, 0, header, INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES);
+	if (ok && header->headerSize >= sizeof(*header)) {
+		ok = storage->read(filePath, INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES, (char*)header + INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES,
+			sizeof(*header) - INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES);
+	}
+	else if (ok) {
+		memset((char*)header + INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES, 0, sizeof(*header) - INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES);
+	}
+	return ok && header->magic == INGREDIENT_FILE_MAGIC
+		&& (header->version == INGREDIENT_FILE_VERSION || header->version == INGREDIENT_FILE_VERSION_FIXED_NAMES);
+}
+
+/**
+ * @brief Locates the block checksums that follow the body of a checksummed ingredient file.
+ *
+ * @param base The start of the mapped file.
+ * @param size The size of the mapped file in bytes.
+ * @param bodyEnd The offset just past the last section before the checksums and their padding.
+ * @param map Receives the block checksums; they stay NULL for a file without checksums.
+ * @return True if the file has no checksums or all of them fit in the buffer, otherwise false.
+ */
+static bool locateIngredientBlockChecksums(const void* base, size_t size, uint64_t bodyEnd, IngredientMap* map) {
+	const IngredientFileHeader* header = (const IngredientFileHeader*)base;
+	if ((header->flags & INGREDIENT_FILE_CHECKSUMMED) == 0) {
+		return true;
+	}
+	if (header->headerSize < sizeof(IngredientFileHeader) || header->blockSize == 0 || header->blockSize % sizeof(uint32_t) != 0) {
+		return false;
+	}
+	bodyEnd = (bodyEnd + sizeof(uint32_t) - 1) & ~(uint64_t)(sizeof(uint32_t) - 1);
+
+	uint64_t blockCount = (bodyEnd - header->headerSize + header->blockSize - 1) / header->blockSize;
+	if (blockCount > UINT32_MAX || bodyEnd + blockCount * sizeof(uint32_t) > size) {
+		return false;
+	}
+	map->blockChecksums = (const uint32_t*)((const char*)base + bodyEnd);
+	map->blockCount = (uint32_t)blockCount;
+	return true;
+}
+
+/**
+ * @brief Checks that a mapped buffer holds a complete, supported ingredient file and locates its
+ * name pool and block checksums.
+ *
+ * The name offsets of a version 2 file are checked here so names can later be read with a single
+ * bounds check on the handle; version 1 records are checked for a terminated name. The block
+ * checksums are located but not verified.
+ *
+ * @param base The start of the mapped file.
+ * @param size The size of the mapped file in bytes.
+ * @param map Receives the name pool of a version 2 file and the block checksums of a checksummed file.
+ * @return True if the header is valid and all sections fit in the buffer, otherwise false.
+ */
+static bool validateIngredientFile(const void* base, size_t size, IngredientMap* map) {
+	if (size < INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES) {
+		return false;
+	}
+
+	const IngredientFileHeader* header = (const IngredientFileHeader*)base;
+	if (header->magic != INGREDIENT_FILE_MAGIC) {
+		return false;
+	}
+	size_t minimumRecordSize = header->version == INGREDIENT_FILE_VERSION ? sizeof(IngredientRecord)
+		: header->version == INGREDIENT_FILE_VERSION_FIXED_NAMES ? sizeof(IngredientRecordV1) : 0;
+	if (minimumRecordSize == 0 || header->headerSize < INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES || header->recordSize < minimumRecordSize
+		|| header->headerSize % sizeof(uint32_t) != 0 || header->recordSize % sizeof(uint32_t) != 0) {
+		return false;
+	}
+
+	uint64_t required = (uint64_t)header->headerSize + (uint64_t)header->recordCount * header->recordSize;
+	if (required > size) {
+		return false;
+	}
+
+	const char* records = (const char*)base + header->headerSize;
+	if (header->version == INGREDIENT_FILE_VERSION_FIXED_NAMES) {
+		for (uint32_t i = 0; i < header->recordCount; i++) {
+			const IngredientRecordV1* record = (const IngredientRecordV1*)(records + (size_t)i * header->recordSize);
+			if (memchr(record->name, '\0', INGREDIENT_NAME_SIZE) == NULL) {
+				return false;
+			}
+		}
+		return locateIngredientBlockChecksums(base, size, required, map);
+	}
+
+	if (required + sizeof(IngredientNamePoolHeader) > size) {
+		return false;
+	}
+	const IngredientNamePoolHeader* pool = (const IngredientNamePoolHeader*)((const char*)base + required);
+	uint64_t offsetsStart = required + sizeof(IngredientNamePoolHeader);
+	uint64_t namesStart = offsetsStart + (uint64_t)pool->nameCount * sizeof(uint32_t);
+	if (namesStart + pool->dataSize > size || (pool->nameCount > 0 && pool->dataSize == 0)) {
+		return false;
+	}
+	const uint32_t* offsets = (const uint32_t*)((const char*)base + offsetsStart);
+	const char* names = (const char*)base + namesStart;
+	if (pool->dataSize > 0 && names[pool->dataSize - 1] != '\0') {
+		return false;
+	}
+	for (uint32_t i = 0; i < pool->nameCount; i++) {
+		if (offsets[i] >= pool->dataSize) {
+			return false;
+		}
+	}
+
+	map->nameOffsets = offsets;
+	map->names = names;
+	map->nameCount = pool->nameCount;
+	return locateIngredientBlockChecksums(base, size, namesStart + pool->dataSize, map);
+}
+
+/**
+ * @brief Opens a versioned ingredient file and checks its layout without verifying its checksums.
+ *
+ * @param filePath The file path of the ingredient file.
+ * @param map The view to initialize.
+ * @return True if the file was opened, otherwise false.
+ */
+static bool mapIngredientFile(const char* filePath, IngredientMap* map) {
+	memset(map, 0, sizeof(*map));
+	if (!openIngredientStorageView(filePath, &map->view)) {
+		return false;
+	}
+
+	if (!validateIngredientFile(map->view.data, map->view.size, map)) {
+		closeIngredientMap(map);
+		return false;
+	}
+
+	map->header = (const IngredientFileHeader*)map->view.data;
+	map->records = (const IngredientRecord*)((const char*)map->view.data + map->header->headerSize);
+	map->count = (int)map->header->recordCount;
+	map->deletedCount = map->header->headerSize >= sizeof(IngredientFileHeader) ? (int)map->header->deletedCount : 0;
+	return true;
+}
+
+/**
+ * @brief Returns the byte range of a checksummed block.
+ *
+ * @param map The mapped ingredient file.
+ * @param block The zero-based block number.
+ * @param start Receives the offset of the first byte of the block.
+ * @return The length of the block in bytes.
+ */
+static size_t getIngredientBlockRange(const IngredientMap* map, uint32_t block, size_t* start) {
+	size_t bodyEnd = (size_t)((const char*)map->blockChecksums - (const char*)map->view.data);
+	*start = map->header->headerSize + (size_t)block * map->header->blockSize;
+	return bodyEnd - *start < map->header->blockSize ? bodyEnd - *start : map->header->blockSize;
+}
+
+/**
+ * @brief Computes the checksum a block would have with other flags in one of its records.
+ *
+ * @param map The mapped ingredient file.
+ * @param start The offset of the first byte of the block.
+ * @param length The length of the block in bytes.
+ * @param flagsOffset The offset of the flags of a record inside the block.
+ * @param flags The flags to use instead of the ones in the file.
+ * @return The CRC32C of the block with the flags replaced.
+ */
+static uint32_t computeIngredientBlockChecksumWithFlags(const IngredientMap* map, size_t start, size_t length, size_t flagsOffset, uint32_t flags) {
+	const char* data = (const char*)map->view.data;
+	uint32_t checksum = updateCrc32c(0, data + start, flagsOffset - start);
+	checksum = updateCrc32c(checksum, &flags, sizeof(flags));
+	return updateCrc32c(checksum, data + flagsOffset + sizeof(flags), start + length - flagsOffset - sizeof(flags));
+}
+
+/**
+ * @brief Checks whether a block that fails its checksum holds a tombstone whose checksum was never written.
+ *
+ * deleteIngredientRecordInPlace sets the deleted flag of a record before it writes the new
+ * checksum of the block, so a crash in between leaves a block that matches its checksum again
+ * once the deleted flag of that one record is cleared. Such a block is intact, and the record
+ * counts as deleted.
+ *
+ * @param map The mapped ingredient file.
+ * @param block The zero-based block number.
+ * @return True if clearing the deleted flag of a single record makes the block match its checksum.
+ */
+static bool isTornIngredientTombstone(const IngredientMap* map, uint32_t block) {
+	size_t start;
+	size_t length = getIngredientBlockRange(map, block, &start);
+	size_t recordsStart = map->header->headerSize;
+	uint32_t recordSize = map->header->recordSize;
+	for (int i = (int)((start - recordsStart) / recordSize); i < map->count; i++) {
+		size_t flagsOffset = recordsStart + (size_t)i * recordSize + offsetof(IngredientRecord, flags);
+		if (flagsOffset >= start + length) {
+			break;
+		}
+		uint32_t flags;
+		memcpy(&flags, (const char*)map->view.data + flagsOffset, sizeof(flags));
+		if (flagsOffset >= start && (flags & INGREDIENT_RECORD_DELETED)
+			&& computeIngredientBlockChecksumWithFlags(map, start, length, flagsOffset, flags & ~INGREDIENT_RECORD_DELETED) == map->blockChecksums[block]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Finds the blocks of a mapped ingredient file whose contents do not match their checksum.
+ *
+ * @param map The mapped ingredient file.
+ * @param blocks Receives the numbers of the first maxBlocks damaged blocks in ascending order.
+ * @param maxBlocks The capacity of the blocks array.
+ * @return The number of damaged blocks, which may exceed maxBlocks; 0 for a file without checksums.
+ * A block whose only difference is an interrupted tombstone is not damaged.
+ */
+static uint32_t findDamagedIngredientBlocks(const IngredientMap* map, uint32_t* blocks, uint32_t maxBlocks) {
+	uint32_t damaged = 0;
+	uint32_t checksums[INGREDIENT_FILE_VERIFY_BATCH];
+	for (uint32_t first = 0; first < map->blockCount; first += INGREDIENT_FILE_VERIFY_BATCH) {
+		uint32_t count = map->blockCount - first < INGREDIENT_FILE_VERIFY_BATCH ? map->blockCount - first : INGREDIENT_FILE_VERIFY_BATCH;
+		size_t start;
+		size_t lastStart;
+		getIngredientBlockRange(map, first, &start);
+		size_t end = getIngredientBlockRange(map, first + count - 1, &lastStart);
+		end += lastStart;
+		computeCrc32cBlocks((const char*)map->view.data + start, end - start, map->header->blockSize, checksums);
+
+		for (uint32_t i = 0; i < count; i++) {
+			if (checksums[i] != map->blockChecksums[first + i] && !isTornIngredientTombstone(map, first + i)) {
+				if (damaged < maxBlocks) {
+					blocks[damaged] = first + i;
+				}
+				damaged++;
+			}
+		}
+	}
+	return damaged;
+}
+
+/**
+ * @brief Opens a versioned ingredient file for in-place, read-only queries.
+ *
+ * The file is read through the current storage backend; the default backend memory-maps it, so
+ * only the pages that are queried are loaded. Both versioned formats are accepted. Legacy files that store raw Ingredient structs are not;
+ * use loadIngredientsFromFile for them. The block checksums of a checksummed file are verified, and
+ * every damaged block is reported with its byte range.
+ *
+ * @param filePath The file path of the ingredient file.
+ * @param map The view to initialize.
+ * @return True if the file was opened, otherwise false.
+ */
+bool openIngredientMap(const char* filePath, IngredientMap* map) {
+	if (!mapIngredientFile(filePath, map)) {
+		return false;
+	}
+
+	uint32_t blocks[INGREDIENT_FILE_REPORTED_BLOCKS];
+	uint32_t damaged = findDamagedIngredientBlocks(map, blocks, INGREDIENT_FILE_REPORTED_BLOCKS);
+	if (damaged == 0) {
+		return true;
+	}
+	for (uint32_t i = 0; i < damaged && i < INGREDIENT_FILE_REPORTED_BLOCKS; i++) {
+		size_t start;
+		size_t length = getIngredientBlockRange(map, blocks[i], &start);
+		printf("Error: Ingredient file %s is damaged in block %u (bytes %zu to %zu).\n", filePath, blocks[i], start, start + length - 1);
+	}
+	if (damaged > INGREDIENT_FILE_REPORTED_BLOCKS) {
+		printf("Error: Ingredient file %s has %u more damaged blocks.\n", filePath, damaged - INGREDIENT_FILE_REPORTED_BLOCKS);
+	}
+	closeIngredientMap(map);
+	return false;
+}
+
+/**
+ * @brief Releases an ingredient file view and resets it.
+ *
+ * @param map The view to close.
+ */
+void closeIngredientMap(IngredientMap* map) {
+	closeIngredientStorageView(&map->view);
+	memset(map, 0, sizeof(*map));
+}
+
+/**
+ * @brief Returns the record at the given position of a mapped ingredient file.
+ *
+ * Deleted records are returned as well; check INGREDIENT_RECORD_DELETED in their flags.
+ *
+ * @param map The mapped ingredient file.
+ * @param index The zero-based record position.
+ * @return Pointer to the record inside the mapping, or NULL if the index is out of range.
+ */
+const IngredientRecord* getMappedIngredient(const IngredientMap* map, int index) {
+	if (index < 0 || index >= map->count) {
+		return NULL;
+	}
+	return (const IngredientRecord*)((const char*)map->records + (size_t)index * map->header->recordSize);
+}
+
+/**
+ * @brief Finds a record by ID in a mapped ingredient file without copying it.
+ *
+ * Uses binary search when the file is sorted by ID, otherwise scans the records. A deleted record
+ * keeps its ID and position, so the order the search relies on survives deletes.
+ *
+ * @param map The mapped ingredient file.
+ * @param id The ingredient ID to look up.
+ * @return Pointer to the record inside the mapping, or NULL if the ID is not present or was deleted.
+ */
+const IngredientRecord* findMappedIngredientById(const IngredientMap* map, int id) {
+	if (map->count == 0) {
+		return NULL;
+	}
+
+	if (map->header->flags & INGREDIENT_FILE_SORTED_BY_ID) {
+		int low = 0;
+		int high = map->count - 1;
+		while (low <= high) {
+			int mid = low + (high - low) / 2;
+			const IngredientRecord* record = getMappedIngredient(map, mid);
+			if (record->id == id) {
+				return (record->flags & INGREDIENT_RECORD_DELETED) == 0 ? record : NULL;
+			}
+			if (record->id < id) {
+				low = mid + 1;
+			}
+			else {
+				high = mid - 1;
+			}
+		}
+		return NULL;
+	}
+
+	for (int i = 0; i < map->count; i++) {
+		const IngredientRecord* record = getMappedIngredient(map, i);
+		if (record->id == id && (record->flags & INGREDIENT_RECORD_DELETED) == 0) {
+			return record;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Deletes a record of a versioned ingredient file by marking it as a tombstone in place.
+ *
+ * Only the flags of the record, the checksum of its block and the deleted record count of the
+ * header are written, in that order; the record stays in the file until it is rewritten. The
+ * block is verified before it is changed, so a damaged block is never given a matching checksum.
+ * A crash after the flags but before the checksum leaves a block whose only mismatch is the
+ * deleted flag of this record, which openIngredientMap accepts as a completed delete. A crash
+ * before the count is written leaves the count too low, which only delays the next compaction.
+ *
+ * @param filePath The file path of the ingredient file.
+ * @param id The ID of the record to delete.
+ * @param header Receives the header of the file after the delete.
+ * @return True if the record was marked as deleted, false if the file has no live record with that
+ * ID, its header has no deleted record count or the block of the record is damaged.
+ */
+bool deleteIngredientRecordInPlace(const char* filePath, int id, IngredientFileHeader* header) {
+	IngredientMap map;
+	if (!mapIngredientFile(filePath, &map)) {
+		return false;
+	}
+
+	const IngredientRecord* record = findMappedIngredientById(&map, id);
+	bool ok = record != NULL && map.header->headerSize >= sizeof(IngredientFileHeader);
+	size_t flagsOffset = 0;
+	uint32_t flags = 0;
+	size_t checksumOffset = 0;
+	uint32_t checksum = 0;
+	if (ok) {
+		memcpy(header, map.header, sizeof(*header));
+		flagsOffset = (size_t)((const char*)record - (const char*)map.view.data) + offsetof(IngredientRecord, flags);
+		flags = record->flags | INGREDIENT_RECORD_DELETED;
+	}
+	if (ok && map.blockChecksums != NULL) {
+		// Flags are aligned to four bytes like the blocks, so they never straddle two blocks
+		uint32_t block = (uint32_t)((flagsOffset - map.header->headerSize) / map.header->blockSize);
+		size_t start;
+		size_t length = getIngredientBlockRange(&map, block, &start);
+		const char* data = (const char*)map.view.data;
+		ok = updateCrc32c(0, data + start, length) == map.blockChecksums[block] || isTornIngredientTombstone(&map, block);
+		checksum = computeIngredientBlockChecksumWithFlags(&map, start, length, flagsOffset, flags);
+		checksumOffset = (size_t)((const char*)&map.blockChecksums[block] - data);
+	}
+	closeIngredientMap(&map);
+	if (!ok) {
+		return false;
+	}
+
+	header->deletedCount++;
+	const IngredientStorage* storage = getIngredientStorage();
+	return storage->patch(filePath, flagsOffset, &flags, sizeof(flags))
+		&& (checksumOffset == 0 || storage->patch(filePath, checksumOffset, &checksum, sizeof(checksum)))
+		&& storage->patch(filePath, offsetof(IngredientFileHeader, deletedCount), &header->deletedCount, sizeof(header->deletedCount));
+}
+
+/**
+ * @brief Returns the name of a mapped ingredient record.
+ *
+ * @param map The mapped ingredient file.
+ * @param record A record of the mapped file.
+ * @return The zero-terminated name inside the mapping; an empty string for a handle that is not in
+ * the name pool.
+ */
+const char* getMappedIngredientName(const IngredientMap* map, const IngredientRecord* record) {
+	if (map->names == NULL) {
+		return ((const IngredientRecordV1*)record)->name;
+	}
+	return record->nameHandle < map->nameCount ? map->names + map->nameOffsets[record->nameHandle] : "";
+}
+
+/**
+ * @brief Finds the records of a mapped ingredient file with exactly the given name.
+ *
+ * In a version 2 file the name is looked up once among the distinct names of the pool, after which
+ * the records are matched by comparing 32-bit handles instead of strings.
+ *
+ * @param map The mapped ingredient file.
+ * @param name The zero-terminated name to look for.
+ * @param results Receives the matching live records in file order.
+ * @param maxResults The capacity of the results array.
+ * @return The number of records stored in results.
+ */
+int findMappedIngredientsByName(const IngredientMap* map, const char* name, const IngredientRecord** results, int maxResults) {
+	int found = 0;
+	if (map->names == NULL) {
+		for (int i = 0; i < map->count && found < maxResults; i++) {
+			const IngredientRecord* record = getMappedIngredient(map, i);
+			if ((record->flags & INGREDIENT_RECORD_DELETED) == 0 && strcmp(getMappedIngredientName(map, record), name) == 0) {
+				results[found++] = record;
+			}
+		}
+		return found;
+	}
+
+	// Names are interned, so at most one handle can match
+	uint32_t handle = 0;
+	while (handle < map->nameCount && strcmp(map->names + map->nameOffsets[handle], name) != 0) {
+		handle++;
+	}
+	if (handle == map->nameCount) {
+		return 0;
+	}
+	for (int i = 0; i < map->count && found < maxResults; i++) {
+		const IngredientRecord* record = getMappedIngredient(map, i);
+		if (record->nameHandle == handle && (record->flags & INGREDIENT_RECORD_DELETED) == 0) {
+			results[found++] = record;
+		}
+	}
+	return found;
+}
+
+/**
+ * @brief Range of mapped records decoded into one piece of a linked list.
+ */
+typedef struct IngredientMapChunk {
+	int begin; /**< Index of the first record of the chunk. */
+	int end; /**< Index just past the last record of the chunk. */
+	MemoryArena* arena; /**< Arena the nodes are allocated from, NULL for malloc. */
+	Ingredient* head; /**< First node of the chunk, NULL if none was built. */
+	Ingredient* tail; /**< Last node of the chunk. */
+	bool complete; /**< True if every record of the chunk got a node. */
+} IngredientMapChunk;
+
+/**
+ * @brief Decodes a range of mapped records into a doubly linked list, skipping deleted records.
+ *
+ * @param map The mapped ingredient file.
+ * @param chunk The range to decode; receives the head and tail of the list.
+ */
+static void buildIngredientChunkFromMap(const IngredientMap* map, IngredientMapChunk* chunk) {
+	chunk->head = NULL;
+	chunk->tail = NULL;
+	chunk->complete = false;
+
+	for (int i = chunk->begin; i < chunk->end; i++) {
+		const IngredientRecord* record = getMappedIngredient(map, i);
+		if (record->flags & INGREDIENT_RECORD_DELETED) {
+			continue;
+		}
+		Ingredient* newIngredient = (Ingredient*)allocateArenaNode(chunk->arena, sizeof(Ingredient));
+		if (newIngredient == NULL) {
+			printf("Error: Memory allocation failed while loading ingredients.\n");
+			return;
+		}
+		newIngredient->id = record->id;
+		strncpy(newIngredient->name, getMappedIngredientName(map, record), INGREDIENT_NAME_SIZE - 1);
+		newIngredient->name[INGREDIENT_NAME_SIZE - 1] = '\0';
+		newIngredient->price = record->price;
+		newIngredient->prev = chunk->tail;
+		newIngredient->next = NULL;
+		newIngredient->npx = NULL;
+
+		if (chunk->head == NULL) {
+			chunk->head = newIngredient;
+		}
+		else {
+			chunk->tail->next = newIngredient;
+		}
+		chunk->tail = newIngredient;
+	}
+	chunk->complete = true;
+}
+
+/**
+ * @brief Builds a doubly linked list of ingredients from a mapped ingredient file.
+ *
+ * @param map The mapped ingredient file.
+ * @param arena The arena to allocate the nodes from, or NULL to allocate each node with malloc.
+ * @return A pointer to the head of the linked list, or NULL if the file has no live records.
+ */
+Ingredient* buildIngredientListFromMap(const IngredientMap* map, MemoryArena* arena) {
+	IngredientMapChunk chunk;
+	chunk.begin = 0;
+	chunk.end = map->count;
+	chunk.arena = arena;
+	buildIngredientChunkFromMap(map, &chunk);
+	return chunk.head;
+}
+
+/**
+ * @brief Builds a doubly linked list of ingredients from a mapped ingredient file on several threads.
+ *
+ * The records are split into contiguous chunks of at least INGREDIENT_PARALLEL_LOAD_MIN_CHUNK
+ * records. Every chunk is decoded on its own thread into an arena of its own, so the threads never
+ * share an allocator; the chunk lists are then linked in file order and their arenas merged into
+ * the given arena. Like the serial build, the list ends at the first node that could not be allocated.
+ *
+ * Without an arena every node must be freed on its own, so the nodes cannot come from per-thread
+ * arenas; mallocing them from every worker would only make the threads contend for the heap, so
+ * the list is then built on the calling thread.
+ *
+ * @param map The mapped ingredient file.
+ * @param arena The arena to allocate the nodes from, or NULL to allocate each node with malloc.
+ * @param threadCount The largest number of threads to use, or 0 for one per hardware thread.
+ * @return A pointer to the head of the linked list, or NULL if the file has no live records.
+ */
+Ingredient* buildIngredientListFromMapInParallel(const IngredientMap* map, MemoryArena* arena, int threadCount) {
+	if (threadCount <= 0) {
+		threadCount = (int)std::thread::hardware_concurrency();
+	}
+	int chunkCount = map->count / INGREDIENT_PARALLEL_LOAD_MIN_CHUNK;
+	if (chunkCount > threadCount) {
+		chunkCount = threadCount;
+	}
+	if (chunkCount <= 1 || arena == NULL) {
+		return buildIngredientListFromMap(map, arena);
+	}
+
+	std::vector<IngredientMapChunk> chunks;
+	std::vector<MemoryArena> arenas;
+	std::vector<std::thread> workers;
+	try {
+		chunks.resize(chunkCount);
+		arenas.resize(chunkCount);
+		workers.reserve(chunkCount);
+	}
+	catch (...) {
+		return buildIngredientListFromMap(map, arena);
+	}
+
+	for (int i = 0; i < chunkCount; i++) {
+		chunks[i].begin = (int)((int64_t)map->count * i / chunkCount);
+		chunks[i].end = (int)((int64_t)map->count * (i + 1) / chunkCount);
+		initMemoryArena(&arenas[i], arena->blockSize);
+		chunks[i].arena = &arenas[i];
+	}
+
+	// The calling thread decodes the first chunk; a chunk whose thread cannot start is decoded inline
+	for (int i = 1; i < chunkCount; i++) {
+		IngredientMapChunk* chunk = &chunks[i];
+		try {
+			workers.push_back(std::thread(buildIngredientChunkFromMap, map, chunk));
+		}
+		catch (...) {
+			buildIngredientChunkFromMap(map, chunk);
+		}
+	}
+	buildIngredientChunkFromMap(map, &chunks[0]);
+	for (size_t i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+
+	Ingredient* head = chunks[0].head;
+	Ingredient* tail = chunks[0].tail;
+	bool linking = chunks[0].complete;
+	for (int i = 1; i < chunkCount; i++) {
+		if (linking && chunks[i].head != NULL) {
+			chunks[i].head->prev = tail;
+			if (tail != NULL) {
+				tail->next = chunks[i].head;
+			}
+			else {
+				head = chunks[i].head;
+			}
+			tail = chunks[i].tail;
+			linking = chunks[i].complete;
+		}
+		else if (linking && chunks[i].complete) {
+			// Every record of the chunk was deleted
+			continue;
+		}
+		else {
+			// Chunks after a failed allocation are dropped, as the serial build never reaches them
+			linking = false;
+		}
+	}
+
+	for (int i = 0; i < chunkCount; i++) {
+		mergeMemoryArena(arena, &arenas[i]);
+	}
+	return head;
+}
@@ -0,0 +1,501 @@
+/**
+ * @file ingredienthuffman.cpp
+ * @brief Implementation of the Huffman-compressed ingredient file, including building a canonical
+ * codebook from every name in the list, packing the codes of each name into real bits and patching
+ * single records in place.
+ */
+#include "../header/ingredienthuffman.h"
+#include "../header/ingredientstorage.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Position and header of a live record of a Huffman-compressed ingredient file.
+ */
+typedef struct HuffmanIndexedRecord {
+	size_t offset; /**< Position of the record header. */
+	HuffmanRecordHeader record; /**< The record header. */
+} HuffmanIndexedRecord;
+
+/**
+ * @brief Record directory of a Huffman-compressed ingredient file, kept between mutations so a
+ * mutation reads and writes only its own record instead of walking the file.
+ */
+typedef struct HuffmanFileIndex {
+	const IngredientStorage* storage; /**< Backend the file was indexed through. */
+	HuffmanFileHeader header; /**< Header of the file as last written or indexed. */
+	size_t size; /**< Size of the file in bytes as last written or indexed. */
+	size_t end; /**< Position just past the last record. */
+	uint32_t deletedCount; /**< Number of records marked as deleted. */
+	std::unordered_map<int, HuffmanIndexedRecord> live; /**< Live records by ID. */
+} HuffmanFileIndex;
+
+/**
+ * @brief Lock protecting the record directories.
+ */
+static std::mutex huffmanIndexMutex;
+
+/**
+ * @brief Record directories of the Huffman-compressed ingredient files by path.
+ */
+static std::unordered_map<std::string, HuffmanFileIndex> huffmanIndexes;
+
+/**
+ * @brief Builds a canonical Huffman codebook from character frequencies.
+ *
+ * @param freq An array containing the frequency of each character.
+ * @param book The codebook to initialize.
+ * @return True if the codebook was built, otherwise false.
+ */
+bool buildHuffmanCodebook(const uint64_t freq[256], HuffmanCodebook* book) {
+	uint8_t lengths[256];
+	return buildHuffmanCodeLengths(freq, lengths) && initHuffmanCodebook(lengths, book);
+}
+
+/**
+ * @brief Initializes a canonical Huffman codebook from the code length of each character.
+ *
+ * @param lengths The code length of each byte value, 0 if the byte is not coded.
+ * @param book The codebook to initialize.
+ * @return True if the lengths describe a valid prefix code, otherwise false.
+ */
+bool initHuffmanCodebook(const uint8_t lengths[256], HuffmanCodebook* book) {
+	return initHuffmanEncoder(&book->encoder, lengths) && initHuffmanDecoder(&book->decoder, lengths);
+}
+
+/**
+ * @brief Encodes a name into packed Huffman codes, most significant bit first.
+ *
+ * @param book The codebook to encode with.
+ * @param name The name to encode.
+ * @param payload The buffer receiving the packed codes; the last byte is padded with zero bits.
+ * @param payloadSize The size of the payload buffer in bytes.
+ * @return The number of payload bytes written, or -1 if a character has no code or the buffer is too small.
+ */
+int encodeHuffmanName(const HuffmanCodebook* book, const char* name, uint8_t* payload, int payloadSize) {
+	size_t written;
+	if (!encodeHuffmanBuffer(&book->encoder, (const uint8_t*)name, strlen(name), payload, (size_t)payloadSize, &written)) {
+		return -1;
+	}
+	return (int)written;
+}
+
+/**
+ * @brief Decodes a name from packed Huffman codes.
+ *
+ * @param book The codebook the name was encoded with.
+ * @param payload The packed codes.
+ * @param payloadBytes The number of payload bytes.
+ * @param nameLength The number of characters to decode.
+ * @param name The buffer receiving the zero-terminated name, at least nameLength + 1 bytes.
+ * @return True if all characters were decoded, false if the payload is damaged.
+ */
+bool decodeHuffmanName(const HuffmanCodebook* book, const uint8_t* payload, int payloadBytes, int nameLength, char* name) {
+	if (!decodeHuffmanBuffer(&book->decoder, payload, (size_t)payloadBytes, (uint8_t*)name, (size_t)nameLength)) {
+		return false;
+	}
+	name[nameLength] = '\0';
+	return true;
+}
+
+/**
+ * @brief Writes a linked list of ingredients to a Huffman-compressed ingredient file.
+ *
+ * One canonical codebook is built from the characters of every name and stored in the header,
+ * so each record only carries the packed codes of its name.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param filePath The file path to write the ingredients to.
+ * @return True if the file was written successfully, otherwise false.
+ */
+bool writeHuffmanIngredientFile(const Ingredient* head, const char* filePath) {
+	uint64_t freq[256] = { 0 };
+	uint32_t recordCount = 0;
+	for (const Ingredient* temp = head; temp != NULL; temp = temp->next) {
+		size_t length = 0;
+		while (length < sizeof(temp->name) - 1 && temp->name[length] != '\0') {
+			length++;
+		}
+		countHuffmanSymbols((const uint8_t*)temp->name, length, freq);
+		recordCount++;
+	}
+
+	HuffmanCodebook book;
+	if (!buildHuffmanCodebook(freq, &book)) {
+		printf("Error: Huffman codebook construction failed.\n");
+		return false;
+	}
+
+	HuffmanFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = HUFFMAN_FILE_MAGIC;
+	header.version = HUFFMAN_FILE_VERSION;
+	header.headerSize = sizeof(HuffmanFileHeader);
+	header.recordCount = recordCount;
+	memcpy(header.codeLengths, book.encoder.lengths, sizeof(header.codeLengths));
+
+	// Build the whole file in memory and hand it to the storage backend in one piece
+	bool ok = true;
+	try {
+		std::vector<char> image((const char*)&header, (const char*)&header + sizeof(header));
+
+		// The directory of the new file is known while it is built, so the next mutation need not walk it
+		HuffmanFileIndex index;
+		index.storage = getIngredientStorage();
+		index.header = header;
+		index.deletedCount = 0;
+
+		for (const Ingredient* temp = head; temp != NULL; temp = temp->next) {
+			char name[sizeof(temp->name)];
+			memcpy(name, temp->name, sizeof(name));
+			name[sizeof(name) - 1] = '\0';
+
+			uint8_t payload[HUFFMAN_MAX_PAYLOAD_BYTES];
+			int payloadBytes = encodeHuffmanName(&book, name, payload, (int)sizeof(payload));
+			if (payloadBytes < 0) {
+				ok = false;
+				break;
+			}
+
+			HuffmanRecordHeader record;
+			memset(&record, 0, sizeof(record));
+			record.id = temp->id;
+			record.price = temp->price;
+			record.nameLength = (uint8_t)strlen(name);
+			record.payloadBytes = (uint16_t)payloadBytes;
+
+			HuffmanIndexedRecord indexed;
+			indexed.offset = image.size();
+			indexed.record = record;
+			index.live[record.id] = indexed;
+
+			image.insert(image.end(), (const char*)&record, (const char*)&record + sizeof(record));
+			image.insert(image.end(), (const char*)payload, (const char*)payload + payloadBytes);
+		}
+		index.size = image.size();
+		index.end = image.size();
+
+		std::lock_guard<std::mutex> guard(huffmanIndexMutex);
+		huffmanIndexes.erase(filePath);
+		ok = ok && index.storage->replace(filePath, image.data(), image.size());
+		if (ok) {
+			huffmanIndexes[filePath] = std::move(index);
+		}
+	}
+	catch (...) {
+		ok = false;
+	}
+
+	if (!ok) {
+		printf("Error: Failed to write Huffman-encoded file %s.\n", filePath);
+	}
+	return ok;
+}
+
+/**
+ * @brief Loads ingredients from a Huffman-compressed ingredient file.
+ *
+ * @param filePath The file path of the Huffman-compressed ingredient file.
+ * @return A pointer to the head of the linked list of ingredients, or NULL if the file is missing or damaged.
+ */
+Ingredient* readHuffmanIngredientFile(const char* filePath) {
+	IngredientStorageView view;
+	if (!openIngredientStorageView(filePath, &view)) {
+		printf("Error: Could not open file %s for reading.\n", filePath);
+		return NULL;
+	}
+	const uint8_t* data = (const uint8_t*)view.data;
+	size_t position = sizeof(HuffmanFileHeader);
+
+	HuffmanFileHeader header;
+	HuffmanCodebook book;
+	bool ok = view.size >= sizeof(header);
+	if (ok) {
+		memcpy(&header, data, sizeof(header));
+		position = header.headerSize;
+	}
+	ok = ok && header.magic == HUFFMAN_FILE_MAGIC
+		&& (header.version == HUFFMAN_FILE_VERSION || header.version == HUFFMAN_FILE_VERSION_NO_TOMBSTONES)
+		&& header.headerSize >= sizeof(HuffmanFileHeader)
+		&& header.headerSize <= view.size
+		&& initHuffmanCodebook(header.codeLengths, &book);
+
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+
+	for (uint32_t i = 0; ok && i < header.recordCount; i++) {
+		HuffmanRecordHeader record;
+		uint8_t payload[HUFFMAN_MAX_PAYLOAD_BYTES];
+		char name[100];
+
+		ok = view.size - position >= sizeof(record);
+		if (ok) {
+			memcpy(&record, data + position, sizeof(record));
+			position += sizeof(record);
+		}
+		ok = ok && record.nameLength < sizeof(name)
+			&& record.payloadBytes <= sizeof(payload)
+			&& view.size - position >= record.payloadBytes;
+		if (ok) {
+			memcpy(payload, data + position, record.payloadBytes);
+			position += record.payloadBytes;
+		}
+		if (ok && (record.flags & HUFFMAN_RECORD_DELETED) != 0) {
+			continue;
+		}
+		ok = ok && decodeHuffmanName(&book, payload, record.payloadBytes, record.nameLength, name);
+		if (!ok) {
+			break;
+		}
+
+		Ingredient* newIngredient = (Ingredient*)malloc(sizeof(Ingredient));
+		if (newIngredient == NULL) {
+			printf("Error: Memory allocation failed while loading ingredients.\n");
+			break;
+		}
+		newIngredient->id = record.id;
+		strcpy(newIngredient->name, name);
+		newIngredient->price = record.price;
+		newIngredient->prev = tail;
+		newIngredient->next = NULL;
+		newIngredient->npx = NULL;
+
+		if (head == NULL) {
+			head = newIngredient;
+		}
+		else {
+			tail->next = newIngredient;
+		}
+		tail = newIngredient;
+	}
+
+	closeIngredientStorageView(&view);
+
+	if (!ok) {
+		printf("Error: Huffman-encoded file %s is damaged or has an unsupported version.\n", filePath);
+		while (head != NULL) {
+			Ingredient* temp = head;
+			head = head->next;
+			free(temp);
+		}
+	}
+	return head;
+}
+
+/**
+ * @brief Builds the record directory of a Huffman-compressed ingredient file of the current version
+ * by walking its record headers, without decoding any name.
+ *
+ * @param filePath The file path of the Huffman-compressed ingredient file.
+ * @param index Receives the header, the end of the records and the live records by ID.
+ * @return True if the file exists and is intact, otherwise false.
+ */
+static bool indexHuffmanIngredientFile(const char* filePath, HuffmanFileIndex* index) {
+	IngredientStorageView view;
+	if (!openIngredientStorageView(filePath, &view)) {
+		return false;
+	}
+	const uint8_t* data = (const uint8_t*)view.data;
+
+	bool ok = view.size >= sizeof(index->header);
+	if (ok) {
+		memcpy(&index->header, data, sizeof(index->header));
+	}
+	ok = ok && index->header.magic == HUFFMAN_FILE_MAGIC
+		&& index->header.version == HUFFMAN_FILE_VERSION
+		&& index->header.headerSize >= sizeof(HuffmanFileHeader)
+		&& index->header.headerSize <= view.size;
+
+	index->storage = view.storage;
+	index->size = view.size;
+	index->deletedCount = 0;
+	index->live.clear();
+	size_t position = ok ? index->header.headerSize : 0;
+
+	for (uint32_t i = 0; ok && i < index->header.recordCount; i++) {
+		HuffmanIndexedRecord indexed;
+		ok = view.size - position >= sizeof(indexed.record);
+		if (!ok) {
+			break;
+		}
+		memcpy(&indexed.record, data + position, sizeof(indexed.record));
+		ok = view.size - position - sizeof(indexed.record) >= indexed.record.payloadBytes;
+
+		if ((indexed.record.flags & HUFFMAN_RECORD_DELETED) != 0) {
+			index->deletedCount++;
+		}
+		else {
+			indexed.offset = position;
+			index->live[indexed.record.id] = indexed;
+		}
+		position += sizeof(indexed.record) + indexed.record.payloadBytes;
+	}
+	index->end = position;
+
+	closeIngredientStorageView(&view);
+	return ok;
+}
+
+/**
+ * @brief Returns the record directory of a Huffman-compressed ingredient file.
+ *
+ * A kept directory is used if the size and header of the file still match it, which costs one
+ * small read; otherwise the file is walked once. Must be called with huffmanIndexMutex held.
+ *
+ * @param filePath The file path of the Huffman-compressed ingredient file.
+ * @return The directory, or NULL if the file is missing, damaged or of an older version.
+ */
+static HuffmanFileIndex* findHuffmanFileIndex(const char* filePath) {
+	const IngredientStorage* storage = getIngredientStorage();
+	std::unordered_map<std::string, HuffmanFileIndex>::iterator found = huffmanIndexes.find(filePath);
+	if (found != huffmanIndexes.end()) {
+		HuffmanFileHeader header;
+		size_t size;
+		if (found->second.storage == storage && storage->size(filePath, &size) && size == found->second.size
+			&& storage->read(filePath, 0, &header, sizeof(header)) && memcmp(&header, &found->second.header, sizeof(header)) == 0) {
+			return &found->second;
+		}
+		huffmanIndexes.erase(found);
+	}
+
+	HuffmanFileIndex index;
+	if (!indexHuffmanIngredientFile(filePath, &index)) {
+		return NULL;
+	}
+	return &(huffmanIndexes[filePath] = std::move(index));
+}
+
+/**
+ * @brief Marks the record at a position of a Huffman-compressed ingredient file as deleted.
+ *
+ * @param filePath The file path of the Huffman-compressed ingredient file.
+ * @param offset The position of the record header.
+ * @param record The current header of the record.
+ * @return True if the flags were written, otherwise false.
+ */
+static bool markHuffmanRecordDeleted(const char* filePath, size_t offset, const HuffmanRecordHeader* record) {
+	uint8_t flags = (uint8_t)(record->flags | HUFFMAN_RECORD_DELETED);
+	return getIngredientStorage()->patch(filePath, offset + offsetof(HuffmanRecordHeader, flags), &flags, sizeof(flags));
+}
+
+/**
+ * @brief Writes one ingredient into an existing Huffman-compressed ingredient file without
+ * re-encoding the other names.
+ *
+ * The name is encoded with the codebook already in the file. A record of the same length is
+ * overwritten in place; otherwise the new record is appended and the old one marked as deleted.
+ * The record is found through the directory kept for the file, so only it and the header are written.
+ *
+ * @param filePath The file path of the Huffman-compressed ingredient file.
+ * @param ingredient The added or changed ingredient.
+ * @return True if the file was patched; false if it is missing, damaged or of an older version,
+ * the codebook has no code for a character of the name, or deleted records would outnumber live
+ * ones. The caller then rewrites the whole file with writeHuffmanIngredientFile.
+ */
+bool storeHuffmanIngredient(const char* filePath, const Ingredient* ingredient) {
+	std::lock_guard<std::mutex> guard(huffmanIndexMutex);
+	HuffmanFileIndex* index = findHuffmanFileIndex(filePath);
+	HuffmanCodebook book;
+	if (index == NULL || !initHuffmanCodebook(index->header.codeLengths, &book)) {
+		return false;
+	}
+
+	char name[sizeof(ingredient->name)];
+	memcpy(name, ingredient->name, sizeof(name));
+	name[sizeof(name) - 1] = '\0';
+
+	uint8_t buffer[sizeof(HuffmanRecordHeader) + HUFFMAN_MAX_PAYLOAD_BYTES];
+	int payloadBytes = encodeHuffmanName(&book, name, buffer + sizeof(HuffmanRecordHeader), HUFFMAN_MAX_PAYLOAD_BYTES);
+	if (payloadBytes < 0) {
+		return false;
+	}
+
+	HuffmanRecordHeader record;
+	memset(&record, 0, sizeof(record));
+	record.id = ingredient->id;
+	record.price = ingredient->price;
+	record.nameLength = (uint8_t)strlen(name);
+	record.payloadBytes = (uint16_t)payloadBytes;
+	memcpy(buffer, &record, sizeof(record));
+	size_t recordSize = sizeof(record) + (size_t)payloadBytes;
+
+	const IngredientStorage* storage = getIngredientStorage();
+	std::unordered_map<int, HuffmanIndexedRecord>::iterator found = index->live.find(ingredient->id);
+	bool replaces = found != index->live.end();
+	if (replaces && found->second.record.payloadBytes == record.payloadBytes) {
+		if (!storage->patch(filePath, found->second.offset, buffer, recordSize)) {
+			huffmanIndexes.erase(filePath);
+			return false;
+		}
+		found->second.record = record;
+		return true;
+	}
+
+	uint32_t liveCount = index->header.recordCount - index->deletedCount;
+	if (replaces && index->deletedCount + 1 > liveCount) {
+		return false;
+	}
+
+	// Append the record before counting it, so an interrupted write leaves the old file readable
+	uint32_t recordCount = index->header.recordCount + 1;
+	if (!storage->patch(filePath, index->end, buffer, recordSize)
+		|| !storage->patch(filePath, offsetof(HuffmanFileHeader, recordCount), &recordCount, sizeof(recordCount))
+		|| (replaces && !markHuffmanRecordDeleted(filePath, found->second.offset, &found->second.record))) {
+		huffmanIndexes.erase(filePath);
+		return false;
+	}
+
+	HuffmanIndexedRecord appended;
+	appended.offset = index->end;
+	appended.record = record;
+	index->header.recordCount = recordCount;
+	index->end += recordSize;
+	if (index->end > index->size) {
+		index->size = index->end;
+	}
+	if (replaces) {
+		index->deletedCount++;
+	}
+	index->live[record.id] = appended;
+	return true;
+}
+
+/**
+ * @brief Deletes one ingredient from an existing Huffman-compressed ingredient file by flagging
+ * its record, without rewriting the file.
+ *
+ * @param filePath The file path of the Huffman-compressed ingredient file.
+ * @param id The ID of the deleted ingredient.
+ * @return True if the record was flagged; false if the file is missing, damaged or of an older
+ * version, has no record with the ID, or deleted records would outnumber live ones. The caller
+ * then rewrites the whole file with writeHuffmanIngredientFile.
+ */
+bool deleteHuffmanIngredient(const char* filePath, int id) {
+	std::lock_guard<std::mutex> guard(huffmanIndexMutex);
+	HuffmanFileIndex* index = findHuffmanFileIndex(filePath);
+	if (index == NULL) {
+		return false;
+	}
+	std::unordered_map<int, HuffmanIndexedRecord>::iterator found = index->live.find(id);
+	if (found == index->live.end()) {
+		return false;
+	}
+
+	uint32_t liveCount = index->header.recordCount - index->deletedCount;
+	if (index->deletedCount + 1 > liveCount - 1) {
+		return false;
+	}
+	if (!markHuffmanRecordDeleted(filePath, found->second.offset, &found->second.record)) {
+		huffmanIndexes.erase(filePath);
+		return false;
+	}
+	index->deletedCount++;
+	index->live.erase(found);
+	return true;
+}
@@ -0,0 +1,656 @@
+/**
+ * @file ingredientio.cpp
+ * @brief Implementation of bulk ingredient import and export, including the streaming CSV reader,
+ * row parsing, merging of rows into ingredients of the same name, batch ID assignment and the
+ * buffered CSV and JSON writer.
+ */
+#include "../header/ingredientio.h"
+#include "../header/ingredientlog.h"
+#include "../header/ingredientnameset.h"
+#include "../../memoryarena/header/memoryarena.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__has_include)
+#if __has_include(<charconv>) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#include <charconv>
+#endif
+#endif
+
+/**
+ * @brief Longest price field accepted by the strtod fallback.
+ */
+#define INGREDIENT_PRICE_TEXT_SIZE 64
+
+/**
+ * @brief State of a running CSV import.
+ */
+typedef struct IngredientCsvImport {
+	Ingredient* head; /**< First ingredient of the combined list. */
+	Ingredient* tail; /**< Last ingredient of the combined list. */
+	MemoryArena* arena; /**< Arena holding every node of the list. */
+	IngredientNameSet names; /**< Normalized names of every ingredient in the list. */
+	int nextId; /**< ID for the next imported row. */
+	int lineNumber; /**< Number of lines read so far. */
+	bool outOfMemory; /**< Set when a node or a name set entry could not be allocated. */
+	IngredientImportResult* result; /**< Counters reported to the caller. */
+} IngredientCsvImport;
+
+/**
+ * @brief Returns whether a byte is a space or tab.
+ *
+ * @param c The byte.
+ * @return True for blanks.
+ */
+static bool isCsvBlank(char c) {
+	return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Parses a price without requiring a terminating zero.
+ *
+ * Uses std::from_chars when the standard library provides it for floating-point values and
+ * strtod on a copy otherwise. The whole text must be a finite, non-negative number.
+ *
+ * @param text The price text.
+ * @param length The number of characters in the text.
+ * @param price Receives the parsed price.
+ * @return True if the text is a valid price, otherwise false.
+ */
+bool parseIngredientPrice(const char* text, size_t length, float* price) {
+	if (length > 0 && text[0] == '+') {
+		text++;
+		length--;
+	}
+	if (length == 0) {
+		return false;
+	}
+
+	double value;
+#ifdef __cpp_lib_to_chars
+	std::from_chars_result parsed = std::from_chars(text, text + length, value);
+	if (parsed.ec != std::errc() || parsed.ptr != text + length) {
+		return false;
+	}
+#else
+	char copy[INGREDIENT_PRICE_TEXT_SIZE];
+	if (length >= sizeof(copy) || isCsvBlank(text[0])) {
+		return false;
+	}
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+	char* end;
+	value = strtod(copy, &end);
+	if (end != copy + length) {
+		return false;
+	}
+#endif
+
+	if (!isfinite(value) || value < 0.0 || value > 3.4e38) {
+		return false;
+	}
+	*price = (float)value;
+	return true;
+}
+
+/**
+ * @brief Parses one "name,price" row of an ingredient CSV file.
+ *
+ * Names may be quoted, with "" standing for a quote; unquoted names may contain commas because the
+ * price is taken from after the last comma. Blanks around both fields are ignored.
+ *
+ * @param line The row, without its line break.
+ * @param length The number of characters in the row.
+ * @param name Receives the zero-terminated name.
+ * @param price Receives the price.
+ * @return True if the row holds a non-empty name that fits the name field and a valid price.
+ */
+bool parseIngredientCsvLine(const char* line, size_t length, char name[INGREDIENT_NAME_SIZE], float* price) {
+	if (length > 0 && line[length - 1] == '\r') {
+		length--;
+	}
+	size_t start = 0;
+	while (start < length && isCsvBlank(line[start])) {
+		start++;
+	}
+
+	size_t nameLength = 0;
+	size_t priceStart;
+	if (start < length && line[start] == '"') {
+		size_t i = start + 1;
+		while (true) {
+			if (i >= length) {
+				return false;
+			}
+			if (line[i] == '"') {
+				if (i + 1 < length && line[i + 1] == '"') {
+					i++;
+				}
+				else {
+					break;
+				}
+			}
+			if (nameLength >= INGREDIENT_NAME_SIZE - 1) {
+				return false;
+			}
+			name[nameLength++] = line[i++];
+		}
+		i++;
+		while (i < length && isCsvBlank(line[i])) {
+			i++;
+		}
+		if (i >= length || line[i] != ',') {
+			return false;
+		}
+		priceStart = i + 1;
+	}
+	else {
+		const char* comma = NULL;
+		for (size_t i = length; i > start; i--) {
+			if (line[i - 1] == ',') {
+				comma = line + i - 1;
+				break;
+			}
+		}
+		if (comma == NULL) {
+			return false;
+		}
+		size_t end = comma - line;
+		while (end > start && isCsvBlank(line[end - 1])) {
+			end--;
+		}
+		nameLength = end - start;
+		if (nameLength >= INGREDIENT_NAME_SIZE) {
+			return false;
+		}
+		memcpy(name, line + start, nameLength);
+		priceStart = (size_t)(comma - line) + 1;
+	}
+	if (nameLength == 0) {
+		return false;
+	}
+	name[nameLength] = '\0';
+
+	size_t priceEnd = length;
+	while (priceStart < priceEnd && isCsvBlank(line[priceStart])) {
+		priceStart++;
+	}
+	while (priceEnd > priceStart && isCsvBlank(line[priceEnd - 1])) {
+		priceEnd--;
+	}
+	return parseIngredientPrice(line + priceStart, priceEnd - priceStart, price);
+}
+
+/**
+ * @brief Records a row that could not be imported.
+ *
+ * @param import The running import.
+ */
+static void rejectCsvLine(IngredientCsvImport* import) {
+	if (import->result->rejected == 0) {
+		import->result->firstRejectedLine = import->lineNumber;
+	}
+	import->result->rejected++;
+}
+
+/**
+ * @brief Turns one CSV row into an ingredient at the end of the list.
+ *
+ * Blank rows are ignored, and a first row that does not parse is taken as a column header.
+ *
+ * @param import The running import.
+ * @param line The row, without its line break.
+ * @param length The number of characters in the row.
+ */
+static void importCsvLine(IngredientCsvImport* import, const char* line, size_t length) {
+	import->lineNumber++;
+	if (length == 0 || (length == 1 && line[0] == '\r')) {
+		return;
+	}
+
+	char name[INGREDIENT_NAME_SIZE];
+	float price;
+	if (!parseIngredientCsvLine(line, length, name, &price)) {
+		if (import->lineNumber > 1) {
+			rejectCsvLine(import);
+		}
+		return;
+	}
+
+	// A row naming an ingredient that already exists updates its price instead of adding a duplicate
+	Ingredient* existing = findIngredientByNormalizedName(&import->names, name);
+	if (existing != NULL) {
+		existing->price = price;
+		import->result->merged++;
+		return;
+	}
+
+	Ingredient* ingredient = (Ingredient*)allocateFromMemoryArena(import->arena, sizeof(Ingredient));
+	if (ingredient == NULL) {
+		import->outOfMemory = true;
+		return;
+	}
+	ingredient->id = import->nextId++;
+	strcpy(ingredient->name, name);
+	ingredient->price = price;
+	ingredient->prev = import->tail;
+	ingredient->next = NULL;
+	if (import->tail != NULL) {
+		import->tail->next = ingredient;
+	}
+	else {
+		import->head = ingredient;
+	}
+	import->tail = ingredient;
+	if (!insertIngredientName(&import->names, ingredient)) {
+		import->outOfMemory = true;
+	}
+	if (import->result->imported == 0) {
+		import->result->firstId = ingredient->id;
+	}
+	import->result->imported++;
+}
+
+/**
+ * @brief Appends every row of a CSV file of "name,price" rows to the ingredient files.
+ *
+ * The CSV file is read in blocks of INGREDIENT_CSV_BUFFER_SIZE bytes, so its size is not limited
+ * by memory for text. A row whose name matches an ingredient already in the file or earlier in the
+ * CSV file, ignoring case and spacing, updates the price of that ingredient. New ingredients get
+ * consecutive IDs after the highest existing ID, and the ingredient file and the Huffman-encoded
+ * copy are each written once at the end. Rows that cannot be parsed are counted and skipped.
+ *
+ * @param csvPath The CSV file to import.
+ * @param filePath The ingredient file to add the ingredients to.
+ * @param result Receives the number of imported and rejected rows.
+ * @return True if the CSV file was read and the ingredient files were written, otherwise false.
+ */
+bool importIngredientsFromCsv(const char* csvPath, const char* filePath, IngredientImportResult* result) {
+	memset(result, 0, sizeof(*result));
+	FILE* csv = fopen(csvPath, "rb");
+	if (csv == NULL) {
+		printf("Error: Could not open file %s for reading.\n", csvPath);
+		return false;
+	}
+	char* buffer = (char*)malloc(INGREDIENT_CSV_BUFFER_SIZE);
+	if (buffer == NULL) {
+		printf("Error: Memory allocation failed.\n");
+		fclose(csv);
+		return false;
+	}
+
+	// Hold the files for the whole import so a background compaction cannot interleave
+	lockIngredientFiles();
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	IngredientCsvImport import;
+	memset(&import, 0, sizeof(import));
+	import.arena = &arena;
+	import.result = result;
+	import.head = loadIngredientsFromFileInArena(filePath, &arena);
+	import.outOfMemory = !initIngredientNameSet(&import.names);
+	int maxId = 0;
+	for (Ingredient* current = import.head; current != NULL && !import.outOfMemory; current = current->next) {
+		import.outOfMemory = !insertIngredientName(&import.names, current);
+	}
+	for (Ingredient* current = import.head; current != NULL; current = current->next) {
+		import.tail = current;
+		if (current->id > maxId) {
+			maxId = current->id;
+		}
+	}
+	import.nextId = maxId + 1;
+
+	size_t pending = 0;
+	bool skipping = false;
+	while (!import.outOfMemory) {
+		size_t read = fread(buffer + pending, 1, INGREDIENT_CSV_BUFFER_SIZE - pending, csv);
+		size_t filled = pending + read;
+		size_t start = 0;
+		const char* newline;
+		while ((newline = (const char*)memchr(buffer + start, '\n', filled - start)) != NULL) {
+			size_t end = newline - buffer;
+			if (skipping) {
+				skipping = false;
+			}
+			else {
+				importCsvLine(&import, buffer + start, end - start);
+			}
+			start = end + 1;
+		}
+
+		if (read == 0) {
+			if (start < filled && !skipping) {
+				importCsvLine(&import, buffer + start, filled - start);
+			}
+			break;
+		}
+
+		pending = filled - start;
+		if (pending == INGREDIENT_CSV_BUFFER_SIZE) {
+			// A row longer than the whole buffer cannot be valid, drop it up to its line break;
+			// it is counted once however many buffers it spans
+			if (!skipping) {
+				import.lineNumber++;
+				rejectCsvLine(&import);
+				skipping = true;
+			}
+			pending = 0;
+		}
+		else {
+			memmove(buffer, buffer + start, pending);
+		}
+	}
+
+	bool ok = !ferror(csv) && !import.outOfMemory;
+	fclose(csv);
+	free(buffer);
+	if (!ok) {
+		printf("Error: Could not import %s.\n", csvPath);
+	}
+	else if (result->imported > 0 || result->merged > 0) {
+		ok = saveIngredientsToFile(import.head, filePath) && saveHuffmanEncodedIngredientsToFile(import.head);
+	}
+	unlockIngredientFiles();
+	freeIngredientNameSet(&import.names);
+	freeMemoryArena(&arena);
+	return ok;
+}
+
+/**
+ * @brief Writes the buffered bytes of an export writer to its file.
+ *
+ * @param writer The writer to flush.
+ */
+static void flushExportWriter(ExportWriter* writer) {
+	if (writer->used > 0 && !writer->failed && fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+		writer->failed = true;
+	}
+	writer->used = 0;
+}
+
+/**
+ * @brief Makes room for a number of bytes in the buffer of an export writer.
+ *
+ * @param writer The writer.
+ * @param length The number of bytes about to be written, at most the buffer size.
+ * @return The position in the buffer where the bytes go.
+ */
+static char* reserveExportBytes(ExportWriter* writer, size_t length) {
+	if (INGREDIENT_EXPORT_BUFFER_SIZE - writer->used < length) {
+		flushExportWriter(writer);
+	}
+	return writer->buffer + writer->used;
+}
+
+/**
+ * @brief Opens a file for a buffered export.
+ *
+ * @param writer The writer to initialize.
+ * @param filePath The file to write; an existing file is replaced.
+ * @return True if the file could be opened, otherwise false.
+ */
+bool openExportWriter(ExportWriter* writer, const char* filePath) {
+	writer->used = 0;
+	writer->failed = false;
+	writer->buffer = (char*)malloc(INGREDIENT_EXPORT_BUFFER_SIZE);
+	writer->file = writer->buffer != NULL ? fopen(filePath, "wb") : NULL;
+	if (writer->file == NULL) {
+		printf("Error: Could not open file %s for writing.\n", filePath);
+		free(writer->buffer);
+		writer->buffer = NULL;
+		return false;
+	}
+	// The writer does its own buffering, stdio only has to pass the blocks through
+	setvbuf(writer->file, NULL, _IONBF, 0);
+	return true;
+}
+
+/**
+ * @brief Flushes and closes an export writer.
+ *
+ * @param writer The writer to close.
+ * @return True if every byte reached the file, otherwise false.
+ */
+bool closeExportWriter(ExportWriter* writer) {
+	flushExportWriter(writer);
+	if (fclose(writer->file) != 0) {
+		writer->failed = true;
+	}
+	free(writer->buffer);
+	writer->file = NULL;
+	writer->buffer = NULL;
+	return !writer->failed;
+}
+
+/**
+ * @brief Writes raw text.
+ *
+ * @param writer The writer.
+ * @param text The text.
+ * @param length The number of bytes to write.
+ */
+void writeExportText(ExportWriter* writer, const char* text, size_t length) {
+	if (length > INGREDIENT_EXPORT_BUFFER_SIZE) {
+		flushExportWriter(writer);
+		if (!writer->failed && fwrite(text, 1, length, writer->file) != length) {
+			writer->failed = true;
+		}
+		return;
+	}
+	memcpy(reserveExportBytes(writer, length), text, length);
+	writer->used += length;
+}
+
+/**
+ * @brief Writes zero-terminated text.
+ *
+ * @param writer The writer.
+ * @param text The text.
+ */
+void writeExportString(ExportWriter* writer, const char* text) {
+	writeExportText(writer, text, strlen(text));
+}
+
+/**
+ * @brief Writes an integer in decimal.
+ *
+ * @param writer The writer.
+ * @param value The value.
+ */
+void writeExportInt(ExportWriter* writer, long long value) {
+	char* out = reserveExportBytes(writer, 24);
+#ifdef __cpp_lib_to_chars
+	writer->used = std::to_chars(out, out + 24, value).ptr - writer->buffer;
+#else
+	char digits[24];
+	int count = 0;
+	unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+	do {
+		digits[count++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude > 0);
+	if (value < 0) {
+		*out++ = '-';
+	}
+	while (count > 0) {
+		*out++ = digits[--count];
+	}
+	writer->used = out - writer->buffer;
+#endif
+}
+
+/**
+ * @brief Writes a float with the fewest digits that read back as the same value.
+ *
+ * @param writer The writer.
+ * @param value The value.
+ */
+void writeExportFloat(ExportWriter* writer, float value) {
+	char* out = reserveExportBytes(writer, 32);
+#ifdef __cpp_lib_to_chars
+	writer->used = std::to_chars(out, out + 32, value).ptr - writer->buffer;
+#else
+	writer->used += snprintf(out, 32, "%.9g", value);
+#endif
+}
+
+/**
+ * @brief Writes a number with a fixed number of decimals.
+ *
+ * @param writer The writer.
+ * @param value The value; magnitudes of 1e15 and above are written in the shortest form instead.
+ * @param precision The number of decimals, at most 9.
+ */
+void writeExportFixed(ExportWriter* writer, double value, int precision) {
+	char* out = reserveExportBytes(writer, 32);
+	if (!(fabs(value) < 1e15)) {
+#ifdef __cpp_lib_to_chars
+		writer->used = std::to_chars(out, out + 32, value).ptr - writer->buffer;
+#else
+		writer->used += snprintf(out, 32, "%.17g", value);
+#endif
+		return;
+	}
+#ifdef __cpp_lib_to_chars
+	writer->used = std::to_chars(out, out + 32, value, std::chars_format::fixed, precision).ptr - writer->buffer;
+#else
+	writer->used += snprintf(out, 32, "%.*f", precision, value);
+#endif
+}
+
+/**
+ * @brief Writes a CSV field, quoting it when it holds a separator, quote, line break or edge blank.
+ *
+ * @param writer The writer.
+ * @param text The zero-terminated field value.
+ */
+void writeExportCsvField(ExportWriter* writer, const char* text) {
+	size_t length = strlen(text);
+	bool quote = length > 0 && (isCsvBlank(text[0]) || isCsvBlank(text[length - 1]));
+	for (size_t i = 0; i < length && !quote; i++) {
+		quote = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+	}
+	if (!quote) {
+		writeExportText(writer, text, length);
+		return;
+	}
+
+	writeExportText(writer, "\"", 1);
+	const char* start = text;
+	for (const char* c = text; *c != '\0'; c++) {
+		if (*c == '"') {
+			writeExportText(writer, start, c - start + 1);
+			start = c;
+		}
+	}
+	writeExportText(writer, start, text + length - start);
+	writeExportText(writer, "\"", 1);
+}
+
+/**
+ * @brief Writes a quoted JSON string, escaping quotes, backslashes and control characters.
+ *
+ * @param writer The writer.
+ * @param text The zero-terminated string.
+ */
+void writeExportJsonString(ExportWriter* writer, const char* text) {
+	static const char hex[] = "0123456789abcdef";
+	writeExportText(writer, "\"", 1);
+	const char* start = text;
+	for (const char* c = text; *c != '\0'; c++) {
+		unsigned char byte = (unsigned char)*c;
+		if (byte >= 0x20 && byte != '"' && byte != '\\') {
+			continue;
+		}
+		writeExportText(writer, start, c - start);
+		char escape[6] = { '\\', (char)byte, 0, 0, 0, 0 };
+		size_t escapeLength = 2;
+		if (byte == '\n') {
+			escape[1] = 'n';
+		}
+		else if (byte == '\r') {
+			escape[1] = 'r';
+		}
+		else if (byte == '\t') {
+			escape[1] = 't';
+		}
+		else if (byte < 0x20) {
+			escape[1] = 'u';
+			escape[2] = '0';
+			escape[3] = '0';
+			escape[4] = hex[byte >> 4];
+			escape[5] = hex[byte & 0xF];
+			escapeLength = 6;
+		}
+		writeExportText(writer, escape, escapeLength);
+		start = c + 1;
+	}
+	writeExportText(writer, start, strlen(start));
+	writeExportText(writer, "\"", 1);
+}
+
+/**
+ * @brief Parses the name of an export format.
+ *
+ * @param text "csv" or "json".
+ * @param format Receives the format.
+ * @return True if the name is known, otherwise false.
+ */
+bool parseExportFormat(const char* text, ExportFormat* format) {
+	if (strcmp(text, "csv") == 0) {
+		*format = EXPORT_FORMAT_CSV;
+		return true;
+	}
+	if (strcmp(text, "json") == 0) {
+		*format = EXPORT_FORMAT_JSON;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Writes every ingredient to a CSV or JSON file.
+ *
+ * The CSV file has an "id,name,price" header row, and the JSON file holds an array of objects with
+ * the same fields. Prices are written with the fewest digits that read back exactly.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param filePath The file to write.
+ * @param format The file format.
+ * @return True if the file was written completely, otherwise false.
+ */
+bool exportIngredients(const Ingredient* head, const char* filePath, ExportFormat format) {
+	ExportWriter writer;
+	if (!openExportWriter(&writer, filePath)) {
+		return false;
+	}
+
+	if (format == EXPORT_FORMAT_CSV) {
+		writeExportString(&writer, "id,name,price\n");
+		for (const Ingredient* current = head; current != NULL; current = current->next) {
+			writeExportInt(&writer, current->id);
+			writeExportString(&writer, ",");
+			writeExportCsvField(&writer, current->name);
+			writeExportString(&writer, ",");
+			writeExportFloat(&writer, current->price);
+			writeExportString(&writer, "\n");
+		}
+	}
+	else {
+		writeExportString(&writer, "[");
+		for (const Ingredient* current = head; current != NULL; current = current->next) {
+			writeExportString(&writer, current == head ? "\n  {\"id\":" : ",\n  {\"id\":");
+			writeExportInt(&writer, current->id);
+			writeExportString(&writer, ",\"name\":");
+			writeExportJsonString(&writer, current->name);
+			writeExportString(&writer, ",\"price\":");
+			writeExportFloat(&writer, current->price);
+			writeExportString(&writer, "}");
+		}
+		writeExportString(&writer, head != NULL ? "\n]\n" : "]\n");
+	}
+	return closeExportWriter(&writer);
+}
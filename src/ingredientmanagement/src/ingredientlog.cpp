@@ -0,0 +1,492 @@
+/**
+ * @file ingredientlog.cpp
+ * @brief Implementation of the append-only ingredient mutation log, including appending single
+ * mutations, replaying them on load, deleting records of the base file in place and compacting
+ * the log and the deleted records into the base file in the background.
+ */
+#include "../header/ingredientlog.h"
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @brief Serializes every access to the ingredient file and its log, including background compaction.
+ */
+static std::recursive_mutex ingredientFileMutex;
+
+/**
+ * @brief Number of log records that triggers a background compaction.
+ */
+static std::atomic<int> compactionThreshold(INGREDIENT_LOG_DEFAULT_COMPACTION_THRESHOLD);
+
+/**
+ * @brief Share of deleted records in the base file that triggers a background compaction.
+ */
+static std::atomic<double> tombstoneCompactionShare(INGREDIENT_TOMBSTONE_DEFAULT_COMPACTION_SHARE);
+
+/**
+ * @brief Runs at most one log compaction at a time on a background thread.
+ */
+class IngredientLogCompactor {
+public:
+	/**
+	 * @brief Waits for a running compaction before the process exits.
+	 */
+	~IngredientLogCompactor() {
+		wait();
+	}
+
+	/**
+	 * @brief Starts compacting an ingredient file unless a compaction is already running.
+	 *
+	 * Must not be called while holding the ingredient file lock.
+	 *
+	 * @param filePath The path of the ingredient file to compact.
+	 */
+	void schedule(const char* filePath) {
+		std::lock_guard<std::mutex> guard(stateMutex);
+		if (running) {
+			return;
+		}
+		if (worker.joinable()) {
+			worker.join();
+		}
+		running = true;
+		std::string path(filePath);
+		worker = std::thread([this, path]() {
+			compactIngredientLog(path.c_str());
+			running = false;
+		});
+	}
+
+	/**
+	 * @brief Blocks until the current compaction, if any, has finished.
+	 */
+	void wait() {
+		std::lock_guard<std::mutex> guard(stateMutex);
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+private:
+	std::mutex stateMutex; /**< Guards the worker handle. */
+	std::thread worker; /**< The current or last compaction thread. */
+	std::atomic<bool> running{ false }; /**< True while a compaction is in progress. */
+};
+
+/**
+ * @brief The process-wide background compactor, declared after the file mutex so it is destroyed first.
+ */
+static IngredientLogCompactor compactor;
+
+/**
+ * @brief Builds the log file path for an ingredient file.
+ *
+ * @param filePath The path of the ingredient file.
+ * @return The path of its log file.
+ */
+static std::string ingredientLogPath(const char* filePath) {
+	return std::string(filePath) + INGREDIENT_LOG_SUFFIX;
+}
+
+/**
+ * @brief Opens a view of a log file and checks that it belongs to the given base file generation.
+ *
+ * @param logPath The path of the log file.
+ * @param baseGeneration The generation of the current base file.
+ * @param view The view to initialize.
+ * @param recordCount Receives the number of complete records after the header.
+ * @param readable Receives false if the log exists but cannot be read or its header is damaged,
+ * otherwise true; a missing, empty or stale log is readable.
+ * @return The first record of the log, or NULL if the log is missing, stale or unreadable, in which
+ * case the view is closed.
+ */
+static const IngredientLogRecord* openMatchingIngredientLog(const std::string& logPath, uint64_t baseGeneration, IngredientStorageView* view, size_t* recordCount, bool* readable) {
+	size_t size = 0;
+	*readable = true;
+	if (!getIngredientStorage()->size(logPath.c_str(), &size) || size == 0) {
+		return NULL;
+	}
+	if (!openIngredientStorageView(logPath.c_str(), view)) {
+		*readable = false;
+		return NULL;
+	}
+
+	IngredientLogHeader header;
+	if (view->size < sizeof(header)) {
+		*readable = false;
+		closeIngredientStorageView(view);
+		return NULL;
+	}
+	memcpy(&header, view->data, sizeof(header));
+	if (header.magic != INGREDIENT_LOG_MAGIC || header.version != INGREDIENT_LOG_VERSION) {
+		*readable = false;
+		closeIngredientStorageView(view);
+		return NULL;
+	}
+	if (header.baseGeneration != baseGeneration) {
+		closeIngredientStorageView(view);
+		return NULL;
+	}
+	*recordCount = (view->size - sizeof(header)) / sizeof(IngredientLogRecord);
+	return (const IngredientLogRecord*)((const char*)view->data + sizeof(header));
+}
+
+/**
+ * @brief Acquires the lock that serializes access to ingredient files and their logs.
+ */
+void lockIngredientFiles() {
+	ingredientFileMutex.lock();
+}
+
+/**
+ * @brief Releases the lock acquired by lockIngredientFiles.
+ */
+void unlockIngredientFiles() {
+	ingredientFileMutex.unlock();
+}
+
+/**
+ * @brief Appends one ingredient mutation to the log of a versioned ingredient file.
+ *
+ * A log that belongs to an older generation of the base file is replaced by a new one. When the
+ * log reaches the compaction threshold a background compaction is started.
+ *
+ * @param filePath The path of the ingredient file.
+ * @param operation The mutation to record.
+ * @param ingredient The ingredient after the mutation, or the removed ingredient.
+ * @return True if the mutation was logged, false if the base file is missing or not versioned.
+ */
+bool appendIngredientLog(const char* filePath, IngredientLogOperation operation, const Ingredient* ingredient) {
+	const IngredientStorage* storage = getIngredientStorage();
+	std::string logPath = ingredientLogPath(filePath);
+	size_t recordCount = 0;
+	bool ok = false;
+
+	lockIngredientFiles();
+	IngredientFileHeader base;
+	if (readIngredientFileHeader(filePath, &base)) {
+		IngredientLogHeader header;
+		header.magic = INGREDIENT_LOG_MAGIC;
+		header.version = INGREDIENT_LOG_VERSION;
+		header.baseGeneration = base.generation;
+
+		IngredientLogHeader existing;
+		size_t size = 0;
+		bool matching = storage->size(logPath.c_str(), &size) && size >= sizeof(existing)
+			&& storage->read(logPath.c_str(), 0, &existing, sizeof(existing))
+			&& existing.magic == header.magic && existing.version == header.version
+			&& existing.baseGeneration == header.baseGeneration;
+
+		IngredientLogRecord record;
+		memset(&record, 0, sizeof(record));
+		record.operation = operation;
+		record.id = ingredient->id;
+		record.price = ingredient->price;
+		strncpy(record.name, ingredient->name, INGREDIENT_NAME_SIZE - 1);
+
+		if (matching) {
+			// Append after the last complete record so a torn write from a crash is overwritten
+			recordCount = (size - sizeof(IngredientLogHeader)) / sizeof(IngredientLogRecord);
+			ok = storage->patch(logPath.c_str(), sizeof(IngredientLogHeader) + recordCount * sizeof(IngredientLogRecord), &record, sizeof(record));
+		}
+		else {
+			char log[sizeof(IngredientLogHeader) + sizeof(IngredientLogRecord)];
+			memcpy(log, &header, sizeof(header));
+			memcpy(log + sizeof(header), &record, sizeof(record));
+			ok = storage->replace(logPath.c_str(), log, sizeof(log));
+		}
+		recordCount++;
+	}
+	unlockIngredientFiles();
+
+	if (ok && recordCount >= (size_t)compactionThreshold) {
+		compactor.schedule(filePath);
+	}
+	return ok;
+}
+
+/**
+ * @brief Checks whether the log of an ingredient file removes an ingredient.
+ *
+ * @param filePath The path of the ingredient file.
+ * @param baseGeneration The generation of the current base file.
+ * @param id The ingredient ID to look for.
+ * @return True if a removal of the ID is logged, otherwise false.
+ */
+static bool ingredientLogRemoves(const char* filePath, uint64_t baseGeneration, int id) {
+	IngredientStorageView view;
+	size_t recordCount = 0;
+	bool readable;
+	const IngredientLogRecord* records = openMatchingIngredientLog(ingredientLogPath(filePath), baseGeneration, &view, &recordCount, &readable);
+	if (records == NULL) {
+		return false;
+	}
+
+	bool found = false;
+	for (size_t i = 0; i < recordCount && !found; i++) {
+		found = records[i].operation == INGREDIENT_LOG_REMOVE && records[i].id == id;
+	}
+	closeIngredientStorageView(&view);
+	return found;
+}
+
+/**
+ * @brief Deletes an ingredient by marking its record in the base file as a tombstone.
+ *
+ * This replaces logging the removal whenever the base file still holds a live record with the ID,
+ * so a delete writes a few bytes in place and the log does not grow. The removal is logged instead
+ * when the log already removes the ID, as a later record of the log re-added it and would be
+ * replayed over the tombstone. Once the share of deleted records reaches the tombstone compaction
+ * share a background compaction rewrites the file without them.
+ *
+ * @param filePath The path of the ingredient file.
+ * @param id The ID of the removed ingredient.
+ * @return True if the record was marked as deleted, false if the removal has to be logged or
+ * saved another way.
+ */
+bool deleteIngredientInPlace(const char* filePath, int id) {
+	IngredientFileHeader base;
+	bool ok = false;
+
+	lockIngredientFiles();
+	if (readIngredientFileHeader(filePath, &base) && !ingredientLogRemoves(filePath, base.generation, id)) {
+		ok = deleteIngredientRecordInPlace(filePath, id, &base);
+	}
+	unlockIngredientFiles();
+
+	if (ok && base.deletedCount >= tombstoneCompactionShare * base.recordCount) {
+		compactor.schedule(filePath);
+	}
+	return ok;
+}
+
+/**
+ * @brief Applies the log of an ingredient file to a list loaded from that file and reports whether
+ * every logged mutation made it into the list.
+ *
+ * @param filePath The path of the ingredient file.
+ * @param baseGeneration The generation of the base file the list was loaded from.
+ * @param head The head of the list loaded from the base file; receives the head after the replay.
+ * @param arena The arena the list was allocated from, or NULL if its nodes were allocated with malloc.
+ * @return True if the log is missing or stale or was applied completely, false if it could not be
+ * read or an added ingredient could not be allocated.
+ */
+static bool applyIngredientLog(const char* filePath, uint64_t baseGeneration, Ingredient** head, MemoryArena* arena) {
+	IngredientStorageView view;
+	size_t recordCount = 0;
+	bool complete;
+	const IngredientLogRecord* records = openMatchingIngredientLog(ingredientLogPath(filePath), baseGeneration, &view, &recordCount, &complete);
+	if (records == NULL) {
+		return complete;
+	}
+
+	std::unordered_map<int, Ingredient*> byId;
+	Ingredient* tail = NULL;
+	for (Ingredient* current = *head; current != NULL; current = current->next) {
+		byId[current->id] = current;
+		tail = current;
+	}
+
+	for (size_t i = 0; i < recordCount; i++) {
+		const IngredientLogRecord* record = &records[i];
+		std::unordered_map<int, Ingredient*>::iterator found = byId.find(record->id);
+
+		if (record->operation == INGREDIENT_LOG_ADD && found == byId.end()) {
+			Ingredient* newIngredient = (Ingredient*)allocateArenaNode(arena, sizeof(Ingredient));
+			if (newIngredient == NULL) {
+				complete = false;
+				continue;
+			}
+			newIngredient->id = record->id;
+			memcpy(newIngredient->name, record->name, INGREDIENT_NAME_SIZE);
+			newIngredient->name[INGREDIENT_NAME_SIZE - 1] = '\0';
+			newIngredient->price = record->price;
+			newIngredient->prev = tail;
+			newIngredient->next = NULL;
+			newIngredient->npx = NULL;
+			if (tail == NULL) {
+				*head = newIngredient;
+			}
+			else {
+				tail->next = newIngredient;
+			}
+			tail = newIngredient;
+			byId[record->id] = newIngredient;
+		}
+		else if (record->operation == INGREDIENT_LOG_REMOVE && found != byId.end()) {
+			Ingredient* current = found->second;
+			if (current->prev != NULL) {
+				current->prev->next = current->next;
+			}
+			else {
+				*head = current->next;
+			}
+			if (current->next != NULL) {
+				current->next->prev = current->prev;
+			}
+			else {
+				tail = current->prev;
+			}
+			byId.erase(found);
+			releaseArenaNode(arena, current);
+		}
+		else if (record->operation == INGREDIENT_LOG_UPDATE && found != byId.end()) {
+			memcpy(found->second->name, record->name, INGREDIENT_NAME_SIZE);
+			found->second->name[INGREDIENT_NAME_SIZE - 1] = '\0';
+			found->second->price = record->price;
+		}
+	}
+
+	closeIngredientStorageView(&view);
+	return complete;
+}
+
+/**
+ * @brief Applies the log of an ingredient file to a list loaded from that file.
+ *
+ * @param filePath The path of the ingredient file.
+ * @param baseGeneration The generation of the base file the list was loaded from.
+ * @param head The head of the list loaded from the base file.
+ * @param arena The arena the list was allocated from, or NULL if its nodes were allocated with malloc.
+ * @return The head of the list with every logged mutation applied.
+ */
+Ingredient* replayIngredientLog(const char* filePath, uint64_t baseGeneration, Ingredient* head, MemoryArena* arena) {
+	std::lock_guard<std::recursive_mutex> guard(ingredientFileMutex);
+	applyIngredientLog(filePath, baseGeneration, &head, arena);
+	return head;
+}
+
+/**
+ * @brief Copies the records of the log of an ingredient file.
+ *
+ * @param filePath The path of the ingredient file.
+ * @param baseGeneration The generation of the base file the records have to apply to.
+ * @param records Receives the records in log order, to be released with free; NULL if there are none.
+ * @param recordCount Receives the number of records.
+ * @return True if the log is missing or stale or was copied, false if it could not be read or
+ * memory allocation failed.
+ */
+bool readIngredientLogRecords(const char* filePath, uint64_t baseGeneration, IngredientLogRecord** records, int* recordCount) {
+	std::lock_guard<std::recursive_mutex> guard(ingredientFileMutex);
+	*records = NULL;
+	*recordCount = 0;
+	IngredientStorageView view;
+	size_t count = 0;
+	bool readable;
+	const IngredientLogRecord* logged = openMatchingIngredientLog(ingredientLogPath(filePath), baseGeneration, &view, &count, &readable);
+	if (logged == NULL) {
+		return readable;
+	}
+
+	*records = count > 0 ? (IngredientLogRecord*)malloc(count * sizeof(IngredientLogRecord)) : NULL;
+	if (*records != NULL) {
+		memcpy(*records, logged, count * sizeof(IngredientLogRecord));
+		*recordCount = (int)count;
+	}
+	closeIngredientStorageView(&view);
+	return count == 0 || *records != NULL;
+}
+
+/**
+ * @brief Returns the number of complete records in the log of an ingredient file.
+ *
+ * @param filePath The path of the ingredient file.
+ * @return The number of logged mutations, or 0 if there is no log.
+ */
+int getIngredientLogLength(const char* filePath) {
+	size_t size = 0;
+	if (!getIngredientStorage()->size(ingredientLogPath(filePath).c_str(), &size) || size < sizeof(IngredientLogHeader)) {
+		return 0;
+	}
+	return (int)((size - sizeof(IngredientLogHeader)) / sizeof(IngredientLogRecord));
+}
+
+/**
+ * @brief Deletes the log of an ingredient file after its contents reached the base file.
+ *
+ * @param filePath The path of the ingredient file.
+ */
+void discardIngredientLog(const char* filePath) {
+	std::lock_guard<std::recursive_mutex> guard(ingredientFileMutex);
+	getIngredientStorage()->remove(ingredientLogPath(filePath).c_str());
+}
+
+/**
+ * @brief Folds the log of an ingredient file into the base file and drops its deleted records.
+ *
+ * The base file is read with its checksums verified and the log is replayed on top; the file is
+ * only rewritten, and the log only discarded, if every live record and every logged mutation made
+ * it into the list. Otherwise both are left untouched, so a damaged block or a failed allocation
+ * never replaces the catalog with a shorter one. The Huffman-encoded mirror is left alone because
+ * every logged mutation and delete already patched it.
+ *
+ * @param filePath The path of the ingredient file.
+ * @return True if there was nothing to compact or the file was compacted successfully, otherwise false.
+ */
+bool compactIngredientLog(const char* filePath) {
+	std::lock_guard<std::recursive_mutex> guard(ingredientFileMutex);
+	IngredientFileHeader base;
+	bool hasTombstones = readIngredientFileHeader(filePath, &base) && base.deletedCount > 0;
+	if (getIngredientLogLength(filePath) == 0 && !hasTombstones) {
+		return true;
+	}
+
+	IngredientMap map;
+	if (!openIngredientMap(filePath, &map)) {
+		return false;
+	}
+	int liveCount = 0;
+	for (int i = 0; i < map.count; i++) {
+		if ((getMappedIngredient(&map, i)->flags & INGREDIENT_RECORD_DELETED) == 0) {
+			liveCount++;
+		}
+	}
+	Ingredient* head = buildIngredientListFromMap(&map, NULL);
+	uint64_t generation = map.header->generation;
+	closeIngredientMap(&map);
+
+	int loadedCount = 0;
+	for (const Ingredient* current = head; current != NULL; current = current->next) {
+		loadedCount++;
+	}
+	bool ok = loadedCount == liveCount && applyIngredientLog(filePath, generation, &head, NULL) && saveIngredientsToFile(head, filePath);
+
+	while (head != NULL) {
+		Ingredient* temp = head;
+		head = head->next;
+		free(temp);
+	}
+	return ok;
+}
+
+/**
+ * @brief Sets how many log records trigger a background compaction.
+ *
+ * @param recordCount The new threshold; values below 1 are treated as 1.
+ */
+void setIngredientLogCompactionThreshold(int recordCount) {
+	compactionThreshold = recordCount < 1 ? 1 : recordCount;
+}
+
+/**
+ * @brief Sets the share of deleted records in the base file that triggers a background compaction.
+ *
+ * @param share The new share of all records; values are clamped to the range from 0 to 1, and 0
+ * compacts after every delete.
+ */
+void setIngredientTombstoneCompactionShare(double share) {
+	tombstoneCompactionShare = share < 0.0 ? 0.0 : share > 1.0 ? 1.0 : share;
+}
+
+/**
+ * @brief Blocks until a running background compaction has finished.
+ */
+void waitForIngredientLogCompaction() {
+	compactor.wait();
+}
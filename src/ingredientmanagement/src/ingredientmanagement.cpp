@@ -4,6 +4,12 @@
  * linked list operations, and file handling for saving/loading ingredients.
  */
 #include "../header/ingredientmanagement.h"
+#include "../header/ingredientcatalog.h"
+#include "../header/ingredientfile.h"
+#include "../header/ingredienthuffman.h"
+#include "../header/ingredientlog.h"
+#include "../header/ingredientsearch.h"
+#include "../header/ingredientpager.h"
 #include "../../userauthentication/header/userauthentication.h"
 #include <string.h>
 #include <stdio.h>
@@ -20,7 +26,22 @@
    * @return A pointer to the newly created HuffmanTreeNode.
    */
 HuffmanTreeNode* createHuffmanTreeNode(char character, int frequency) {
-	HuffmanTreeNode* node = (HuffmanTreeNode*)malloc(sizeof(HuffmanTreeNode));
+	return createHuffmanTreeNodeInArena(NULL, character, frequency);
+}
+
+/**
+ * @brief Creates a new Huffman tree node in an arena.
+ *
+ * @param arena The arena to allocate the node from, or NULL to allocate it with malloc.
+ * @param character The character to store in the node.
+ * @param frequency The frequency of the character.
+ * @return A pointer to the newly created HuffmanTreeNode, or NULL if memory allocation failed.
+ */
+HuffmanTreeNode* createHuffmanTreeNodeInArena(MemoryArena* arena, char character, int frequency) {
+	HuffmanTreeNode* node = (HuffmanTreeNode*)allocateArenaNode(arena, sizeof(HuffmanTreeNode));
+	if (node == NULL) {
+		return NULL;
+	}
 	node->character = character;
 	node->frequency = frequency;
 	node->left = node->right = NULL;
@@ -42,43 +63,88 @@ void countFrequencies(const char* str, int freq[256]) {
 	}
 }
 
+/**
+ * @brief Moves the node at a heap position down until the min-heap property holds.
+ *
+ * @param heap The heap of Huffman tree nodes ordered by frequency.
+ * @param size The number of nodes in the heap.
+ * @param position The heap position to sift down.
+ */
+static void siftDownHuffmanTreeHeap(HuffmanTreeNode** heap, int size, int position) {
+	while (true) {
+		int smallest = position;
+		int left = 2 * position + 1;
+		int right = left + 1;
+		if (left < size && heap[left]->frequency < heap[smallest]->frequency) {
+			smallest = left;
+		}
+		if (right < size && heap[right]->frequency < heap[smallest]->frequency) {
+			smallest = right;
+		}
+		if (smallest == position) {
+			return;
+		}
+		HuffmanTreeNode* temp = heap[position];
+		heap[position] = heap[smallest];
+		heap[smallest] = temp;
+		position = smallest;
+	}
+}
+
 /**
  * @brief Constructs a Huffman tree from character frequencies.
  *
+ * The two lightest nodes are taken from a binary min-heap, so construction takes O(n log n).
+ *
  * @param freq An array containing the frequency of each character.
- * @return A pointer to the root of the constructed Huffman tree.
+ * @return A pointer to the root of the constructed Huffman tree, or NULL if no character occurs.
  */
 HuffmanTreeNode* constructHuffmanTree(const int freq[256]) {
-	HuffmanTreeNode* nodes[256];
+	return constructHuffmanTreeInArena(freq, NULL);
+}
+
+/**
+ * @brief Constructs a Huffman tree from character frequencies with every node allocated in an arena.
+ *
+ * The tree is released together with the arena instead of with freeHuffmanTree.
+ *
+ * @param freq An array containing the frequency of each character.
+ * @param arena The arena to allocate the nodes from, or NULL to allocate each node with malloc.
+ * @return A pointer to the root of the constructed Huffman tree, or NULL if no character occurs.
+ */
+HuffmanTreeNode* constructHuffmanTreeInArena(const int freq[256], MemoryArena* arena) {
+	HuffmanTreeNode* heap[256];
 	int count = 0;
 
 	for (int i = 0; i < 256; i++) {
 		if (freq[i] > 0) {
-			nodes[count++] = createHuffmanTreeNode((char)i, freq[i]);
+			heap[count++] = createHuffmanTreeNodeInArena(arena, (char)i, freq[i]);
 		}
 	}
+	if (count == 0) {
+		return NULL;
+	}
 
-	while (count > 1) {
-		int minIndex1 = -1, minIndex2 = -1;
-		for (int i = 0; i < count; i++) {
-			if (minIndex1 == -1 || nodes[i]->frequency < nodes[minIndex1]->frequency) {
-				minIndex2 = minIndex1;
-				minIndex1 = i;
-			}
-			else if (minIndex2 == -1 || nodes[i]->frequency < nodes[minIndex2]->frequency) {
-				minIndex2 = i;
-			}
-		}
-
-		HuffmanTreeNode* merged = createHuffmanTreeNode('\0', nodes[minIndex1]->frequency + nodes[minIndex2]->frequency);
-		merged->left = nodes[minIndex1];
-		merged->right = nodes[minIndex2];
+	for (int i = count / 2 - 1; i >= 0; i--) {
+		siftDownHuffmanTreeHeap(heap, count, i);
+	}
 
-		nodes[minIndex1] = merged;
-		nodes[minIndex2] = nodes[--count];
+	while (count > 1) {
+		HuffmanTreeNode* first = heap[0];
+		heap[0] = heap[--count];
+		siftDownHuffmanTreeHeap(heap, count, 0);
+		HuffmanTreeNode* second = heap[0];
+
+		HuffmanTreeNode* merged = createHuffmanTreeNodeInArena(arena, '\0', first->frequency + second->frequency);
+		merged->left = first;
+		merged->right = second;
+
+		// The merged node replaces the second minimum at the top of the heap
+		heap[0] = merged;
+		siftDownHuffmanTreeHeap(heap, count, 0);
 	}
 
-	return nodes[0];
+	return heap[0];
 }
 
 /**
@@ -169,49 +235,13 @@ void freeHuffmanTree(HuffmanTreeNode* root) {
 /**
  * @brief Saves all ingredients to a Huffman-encoded .huf binary file.
  *
+ * The names share one canonical codebook stored in the file header and are written as packed bits.
+ *
  * @param head The head of the linked list of ingredients.
  * @return True if the ingredients were saved successfully, otherwise false.
  */
 bool saveHuffmanEncodedIngredientsToFile(Ingredient* head) {
-	const char* filePath = "ingredients.huf";
-	FILE* file = fopen(filePath, "wb");
-	if (file == NULL) {
-		printf("Error: Could not open file %s for writing.\n", filePath);
-		return false;
-	}
-
-	Ingredient* temp = head;
-	while (temp != NULL) {
-		int freq[256] = { 0 };
-		countFrequencies(temp->name, freq);
-		HuffmanTreeNode* root = constructHuffmanTree(freq);
-
-		if (!root) {
-			printf("Error: Huffman tree construction failed for ingredient: %s\n", temp->name);
-			fclose(file);
-			return false;
-		}
-
-		char codes[256][256] = { {0} };
-		char code[256];
-		generateHuffmanCodes(root, code, 0, codes);
-
-		char encodedName[1024] = { 0 };
-		encodeString(temp->name, codes, encodedName);
-
-		// Write the encoded ingredient to the .huf file
-		fwrite(&temp->id, sizeof(temp->id), 1, file);
-		size_t encodedLength = strlen(encodedName);
-		fwrite(&encodedLength, sizeof(size_t), 1, file);
-		fwrite(encodedName, sizeof(char), encodedLength, file);
-		fwrite(&temp->price, sizeof(temp->price), 1, file);
-
-		freeHuffmanTree(root);
-		temp = temp->next;
-	}
-
-	fclose(file);
-	return true;
+	return writeHuffmanIngredientFile(head, HUFFMAN_INGREDIENT_FILE_PATH);
 }
 
 /**
@@ -220,202 +250,163 @@ bool saveHuffmanEncodedIngredientsToFile(Ingredient* head) {
  * @return A pointer to the head of the linked list of ingredients.
  */
 Ingredient* loadHuffmanEncodedIngredientsFromFile() {
-	const char* filePath = "ingredients.huf";
-	FILE* file = fopen(filePath, "rb");
-	if (file == NULL) {
-		printf("Error: Could not open file %s for reading.\n", filePath);
-		return NULL;
-	}
-
-	Ingredient* head = NULL;
-	Ingredient* tail = NULL;
-
-	while (1) {
-		int id;
-		size_t encodedLength;
-		char encodedName[1024] = { 0 };
-		float price;
-
-		if (fread(&id, sizeof(id), 1, file) != 1) break;
-		if (fread(&encodedLength, sizeof(size_t), 1, file) != 1) break;
-		if (fread(encodedName, sizeof(char), encodedLength, file) != encodedLength) break;
-		if (fread(&price, sizeof(price), 1, file) != 1) break;
-
-		encodedName[encodedLength] = '\0';
-
-		// Decode the Huffman-encoded name
-		int freq[256] = { 0 };
-		countFrequencies(encodedName, freq);
-		HuffmanTreeNode* root = constructHuffmanTree(freq);
-
-		char decodedName[100] = { 0 };
-		decodeString(root, encodedName, decodedName);
-
-		// Create a new ingredient
-		Ingredient* newIngredient = (Ingredient*)malloc(sizeof(Ingredient));
-		newIngredient->id = id;
-		strcpy(newIngredient->name, decodedName);
-		newIngredient->price = price;
-		newIngredient->prev = tail;
-		newIngredient->next = NULL;
+	return readHuffmanIngredientFile(HUFFMAN_INGREDIENT_FILE_PATH);
+}
 
-		if (head == NULL) {
-			head = newIngredient;
-		}
-		else {
-			tail->next = newIngredient;
-		}
-		tail = newIngredient;
-	}
+/**
+ * @brief Applies a single ingredient mutation to the Huffman-encoded .huf file.
+ *
+ * Only the record of the ingredient is written; the whole file is re-encoded when it cannot be
+ * patched, such as when the name has a character the codebook of the file does not cover.
+ *
+ * @param head The head of the linked list after the mutation.
+ * @param operation The mutation that was applied to the list.
+ * @param ingredient The added, updated or removed ingredient.
+ * @return True if the .huf file reflects the list, otherwise false.
+ */
+static bool saveHuffmanIngredientMutation(Ingredient* head, IngredientLogOperation operation, const Ingredient* ingredient) {
+	bool patched = operation == INGREDIENT_LOG_REMOVE
+		? deleteHuffmanIngredient(HUFFMAN_INGREDIENT_FILE_PATH, ingredient->id)
+		: storeHuffmanIngredient(HUFFMAN_INGREDIENT_FILE_PATH, ingredient);
+	return patched || saveHuffmanEncodedIngredientsToFile(head);
+}
 
-	fclose(file);
-	return head;
+/**
+ * @brief Persists a single ingredient mutation.
+ *
+ * A removal marks the record of the versioned file on disk as deleted in place. Other mutations,
+ * and removals of ingredients that only the log holds, are appended to the ingredient log when the
+ * file on disk is a versioned file; otherwise the whole list is rewritten to the binary file. Either
+ * way only the changed record of the Huffman-encoded .huf file is written.
+ *
+ * @param head The head of the linked list after the mutation.
+ * @param filePath The binary file path for saving ingredients.
+ * @param operation The mutation that was applied to the list.
+ * @param ingredient The added, updated or removed ingredient.
+ * @return True if the mutation was persisted, otherwise false.
+ */
+static bool persistIngredientMutation(Ingredient* head, const char* filePath, IngredientLogOperation operation, const Ingredient* ingredient) {
+	// Hold the file lock so a compaction started by the append rewrites the .huf file after the patch
+	lockIngredientFiles();
+	bool saved = (operation == INGREDIENT_LOG_REMOVE && deleteIngredientInPlace(filePath, ingredient->id))
+		|| appendIngredientLog(filePath, operation, ingredient) || saveIngredientsToFile(head, filePath);
+	saved = saved && saveHuffmanIngredientMutation(head, operation, ingredient);
+	unlockIngredientFiles();
+	return saved;
 }
 
 /**
- * @brief Adds a new ingredient to the linked list and updates both the binary and Huffman-encoded .huf file.
+ * @brief Adds a new ingredient to the end of a catalog and records it in the ingredient log.
  *
- * @param head The head of the linked list of ingredients.
+ * The first ingredient of a catalog rewrites the binary and Huffman-encoded .huf files so the file
+ * on disk starts out identical to the list; later additions are appended to the log. A name that
+ * is already in the catalog is rejected.
+ *
+ * @param catalog The catalog of ingredients.
  * @param name The name of the ingredient.
  * @param price The price of the ingredient.
  * @param filePath The binary file path for saving ingredients.
- * @return The updated head of the linked list.
+ * @return The added ingredient, or NULL if it was not added.
  */
-Ingredient* addIngredient(Ingredient* head, const char* name, float price, const char* filePath) {
+Ingredient* addCatalogIngredient(IngredientCatalog* catalog, const char* name, float price, const char* filePath) {
 	// Validate that the ingredient name has at least 2 characters
 	if (strlen(name) < 2) {
 		printf("Error: Ingredient name must be at least 2 characters long.\n");
-		return head;
+		return NULL;
 	}
 
-	int freq[256] = { 0 };
-	countFrequencies(name, freq);
-
-	HuffmanTreeNode* root = constructHuffmanTree(freq);
-	if (root == NULL) {
-		printf("Error: Huffman tree construction failed for new ingredient: %s\n", name);
-		return head;
+	// Names that differ only in case or spacing are the same ingredient
+	Ingredient* existing = findIngredientByName(catalog, name);
+	if (existing != NULL) {
+		printf("Error: Ingredient \"%s\" already exists with ID %d.\n", existing->name, existing->id);
+		return NULL;
 	}
 
-	char codes[256][256] = { {0} };
-	char code[256] = { 0 };
-	generateHuffmanCodes(root, code, 0, codes);
-
-	char encodedName[1024] = { 0 };
-	encodeString(name, codes, encodedName);
-
-	char decodedName[100] = { 0 };
-	decodeString(root, encodedName, decodedName);
-
-	Ingredient* newIngredient = (Ingredient*)malloc(sizeof(Ingredient));
+	Ingredient* newIngredient = (Ingredient*)allocateArenaNode(catalog->arena, sizeof(Ingredient));
 	if (newIngredient == NULL) {
 		printf("Error: Memory allocation failed for new ingredient.\n");
-		freeHuffmanTree(root);
-		return head;
+		return NULL;
 	}
 
-	int newId = 1;
-	if (head != NULL) {
-		Ingredient* temp = head;
-		while (temp->next != NULL) {
-			temp = temp->next;
-		}
-		newId = temp->id + 1;
-	}
-	newIngredient->id = newId;
-	strcpy(newIngredient->name, decodedName);
+	newIngredient->id = getNextIngredientId(catalog);
+	strncpy(newIngredient->name, name, sizeof(newIngredient->name) - 1);
+	newIngredient->name[sizeof(newIngredient->name) - 1] = '\0';
 	newIngredient->price = price;
-	newIngredient->prev = NULL;
-	newIngredient->next = NULL;
+	newIngredient->npx = NULL;
 
-	if (head == NULL) {
-		head = newIngredient;
+	bool wasEmpty = catalog->head == NULL;
+	if (!linkCatalogIngredient(catalog, newIngredient)) {
+		printf("Error: Memory allocation failed for new ingredient.\n");
+		releaseArenaNode(catalog->arena, newIngredient);
+		return NULL;
+	}
+
+	bool saved;
+	if (wasEmpty) {
+		saved = saveIngredientsToFile(catalog->head, filePath) && saveHuffmanEncodedIngredientsToFile(catalog->head);
 	}
 	else {
-		Ingredient* temp = head;
-		while (temp->next != NULL) {
-			temp = temp->next;
-		}
-		temp->next = newIngredient;
-		newIngredient->prev = temp;
+		saved = persistIngredientMutation(catalog->head, filePath, INGREDIENT_LOG_ADD, newIngredient);
 	}
 
-	if (!saveIngredientsToFile(head, filePath) || !saveHuffmanEncodedIngredientsToFile(head)) {
+	if (!saved) {
 		printf("Error: Failed to save ingredient data to files.\n");
 	}
 
 	printf("Ingredient added successfully.\n");
-	freeHuffmanTree(root);
-	return head;
+	return newIngredient;
 }
 
 /**
- * @brief Removes an ingredient by ID and updates the Huffman-encoded .huf binary file.
+ * @brief Removes an ingredient from a catalog by ID and marks its record in the ingredient file as deleted.
  *
- * @param head The head of the linked list of ingredients.
+ * @param catalog The catalog of ingredients.
  * @param id The ID of the ingredient to remove.
  * @param filePath The binary file path for saving ingredients.
- * @return The updated head of the linked list.
+ * @return True if the ingredient was removed, otherwise false.
  */
-Ingredient* removeIngredient(Ingredient* head, int id, const char* filePath) {
-	if (head == NULL) {
+bool removeCatalogIngredient(IngredientCatalog* catalog, int id, const char* filePath) {
+	if (catalog->head == NULL) {
 		printf("No ingredients to remove.\n");
 		enterToContinue();
-		return head;
-	}
-
-	Ingredient* current = head;
-
-	// Find the ingredient with the specified ID
-	while (current != NULL && current->id != id) {
-		current = current->next;
+		return false;
 	}
 
-	if (current == NULL) {
+	Ingredient* removed = unlinkCatalogIngredient(catalog, id);
+	if (removed == NULL) {
 		printf("Ingredient with ID %d not found.\n", id);
 		enterToContinue();
-		return head;
-	}
-
-	// Remove the ingredient from the list
-	if (current->prev != NULL) {
-		current->prev->next = current->next;
-	}
-	else {
-		head = current->next;
-	}
-
-	if (current->next != NULL) {
-		current->next->prev = current->prev;
+		return false;
 	}
 
-	free(current);
+	bool saved = persistIngredientMutation(catalog->head, filePath, INGREDIENT_LOG_REMOVE, removed);
+	releaseArenaNode(catalog->arena, removed);
 
-	if (!saveIngredientsToFile(head, filePath) || !saveHuffmanEncodedIngredientsToFile(head)) {
+	if (!saved) {
 		printf("Error: Failed to update files after removal.\n");
 	}
 
 	printf("Ingredient with ID %d removed successfully.\n", id);
 	enterToContinue();
-	return head;
+	return true;
 }
 
 /**
- * @brief Edits an ingredient's name by ID and updates both the binary and Huffman-encoded .huf file.
+ * @brief Edits the name of an ingredient in a catalog and records the change in the ingredient log.
  *
- * @param head The head of the linked list of ingredients.
+ * @param catalog The catalog of ingredients.
  * @param filePath The binary file path for saving ingredients.
- * @return The updated head of the linked list.
+ * @return True if an ingredient was updated, otherwise false.
  */
-Ingredient* editIngredient(Ingredient* head, const char* filePath) {
-	if (head == NULL) {
+bool editCatalogIngredient(IngredientCatalog* catalog, const char* filePath) {
+	if (catalog->head == NULL) {
 		printf("No ingredients available to edit.\n");
 		enterToContinue();
-		return head;
+		return false;
 	}
 
 	// Display the list of ingredients
-	listIngredients(head);
+	listIngredients(catalog->head);
 
 	// Prompt for the ID of the ingredient to edit
 	int id;
@@ -424,19 +415,14 @@ Ingredient* editIngredient(Ingredient* head, const char* filePath) {
 	if (id == -2) {
 		handleInputError();
 		enterToContinue();
-		return head;
-	}
-
-	// Find the ingredient with the specified ID
-	Ingredient* current = head;
-	while (current != NULL && current->id != id) {
-		current = current->next;
+		return false;
 	}
 
+	Ingredient* current = findIngredientById(catalog, id);
 	if (current == NULL) {
 		printf("Ingredient with ID %d not found.\n", id);
 		enterToContinue();
-		return head;
+		return false;
 	}
 
 	// Get the new name for the ingredient and validate it
@@ -454,45 +440,98 @@ Ingredient* editIngredient(Ingredient* head, const char* filePath) {
 			}
 		}
 
-		if (validName && strlen(newName) > 0) {
-			break;
-		}
-		else {
+		if (!validName || strlen(newName) == 0) {
 			printf("Invalid ingredient name. Please enter a valid name without numbers.\n");
 			enterToContinue();
+			continue;
+		}
+
+		Ingredient* existing = findIngredientByName(catalog, newName);
+		if (existing == NULL || existing == current) {
+			break;
 		}
+		printf("Ingredient \"%s\" already exists with ID %d. Please enter a different name.\n", existing->name, existing->id);
+		enterToContinue();
 	}
 
 	// Update the ingredient's name
-	strcpy(current->name, newName);
+	if (!renameCatalogIngredient(catalog, current, newName)) {
+		printf("Error: Memory allocation failed while renaming the ingredient.\n");
+		enterToContinue();
+		return false;
+	}
 
-	// Save updated ingredient list to file
-	saveIngredientsToFile(head, filePath);
-	saveHuffmanEncodedIngredientsToFile(head);
+	// Record the change in the ingredient log
+	if (!persistIngredientMutation(catalog->head, filePath, INGREDIENT_LOG_UPDATE, current)) {
+		printf("Error: Failed to save ingredient data to files.\n");
+	}
 	printf("Ingredient name updated successfully.\n");
 	enterToContinue();
+	return true;
+}
 
-	return head;
+/**
+ * @brief Adds a new ingredient to the linked list and records it in the ingredient log.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param name The name of the ingredient.
+ * @param price The price of the ingredient.
+ * @param filePath The binary file path for saving ingredients.
+ * @return The updated head of the linked list.
+ */
+Ingredient* addIngredient(Ingredient* head, const char* name, float price, const char* filePath) {
+	IngredientCatalog catalog;
+	wrapIngredientCatalog(&catalog, head);
+	addCatalogIngredient(&catalog, name, price, filePath);
+	return detachIngredientCatalog(&catalog);
+}
+
+/**
+ * @brief Removes an ingredient by ID and records the removal in the ingredient log.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param id The ID of the ingredient to remove.
+ * @param filePath The binary file path for saving ingredients.
+ * @return The updated head of the linked list.
+ */
+Ingredient* removeIngredient(Ingredient* head, int id, const char* filePath) {
+	IngredientCatalog catalog;
+	wrapIngredientCatalog(&catalog, head);
+	removeCatalogIngredient(&catalog, id, filePath);
+	return detachIngredientCatalog(&catalog);
+}
+
+/**
+ * @brief Edits an ingredient's name by ID and records the change in the ingredient log.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param filePath The binary file path for saving ingredients.
+ * @return The updated head of the linked list.
+ */
+Ingredient* editIngredient(Ingredient* head, const char* filePath) {
+	IngredientCatalog catalog;
+	wrapIngredientCatalog(&catalog, head);
+	editCatalogIngredient(&catalog, filePath);
+	return detachIngredientCatalog(&catalog);
 }
 
 /**
- * @brief Saves all ingredients to a binary file.
+ * @brief Saves all ingredients to a binary file in the versioned ingredient file format.
+ *
+ * The file then holds the complete list, so any pending ingredient log is discarded.
  *
  * @param head The head of the linked list of ingredients.
  * @param filePath The file path to save the ingredients.
  * @return True if the ingredients were saved successfully, otherwise false.
  */
 bool saveIngredientsToFile(Ingredient* head, const char* filePath) {
-	FILE* file = fopen(filePath, "wb");
-
-	Ingredient* temp = head;
-	while (temp != NULL) {
-		fwrite(temp, sizeof(Ingredient), 1, file);
-		temp = temp->next;
+	lockIngredientFiles();
+	bool saved = writeIngredientFile(head, filePath);
+	if (saved) {
+		discardIngredientLog(filePath);
 	}
-
-	fclose(file);
-	return true;
+	unlockIngredientFiles();
+	return saved;
 }
 
 /**
@@ -595,22 +634,82 @@ bool listIngredients(Ingredient* head) {
 /**
  * @brief Loads ingredients from a binary file.
  *
+ * Versioned ingredient files are memory-mapped and read in place, then the pending ingredient log
+ * is replayed on top; files written by older versions as raw Ingredient structs are still read
+ * record by record.
+ *
  * @param filePath The file path to load the ingredients from.
  * @return A pointer to the head of the linked list of ingredients.
  */
 Ingredient* loadIngredientsFromFile(const char* filePath) {
-	FILE* file = fopen(filePath, "rb");
-	if (file == NULL) {
+	return loadIngredientsFromFileInArena(filePath, NULL);
+}
+
+/**
+ * @brief Loads ingredients from a binary file with every node allocated in an arena.
+ *
+ * The list is released together with the arena, so loading n ingredients costs a handful of
+ * block allocations instead of n calls to malloc and n calls to free.
+ *
+ * @param filePath The file path to load the ingredients from.
+ * @param arena The arena to allocate the nodes from, or NULL to allocate each node with malloc.
+ * @return A pointer to the head of the linked list of ingredients.
+ */
+Ingredient* loadIngredientsFromFileInArena(const char* filePath, MemoryArena* arena) {
+	return loadIngredientsFromFileInParallel(filePath, arena, 1);
+}
+
+/**
+ * @brief Loads ingredients from a binary file, decoding the records of a large versioned file on
+ * several threads.
+ *
+ * Each thread fills an arena of its own, which is merged into the given arena afterwards. Files
+ * with fewer than two chunks of INGREDIENT_PARALLEL_LOAD_MIN_CHUNK records, raw-struct files and
+ * loads without an arena are loaded on the calling thread.
+ *
+ * @param filePath The file path to load the ingredients from.
+ * @param arena The arena to allocate the nodes from, or NULL to allocate each node with malloc.
+ * @param threadCount The largest number of threads to use, or 0 for one per hardware thread.
+ * @return A pointer to the head of the linked list of ingredients.
+ */
+Ingredient* loadIngredientsFromFileInParallel(const char* filePath, MemoryArena* arena, int threadCount) {
+	IngredientMap map;
+	lockIngredientFiles();
+	if (openIngredientMap(filePath, &map)) {
+		Ingredient* head = buildIngredientListFromMapInParallel(&map, arena, threadCount);
+		uint64_t generation = map.header->generation;
+		closeIngredientMap(&map);
+		head = replayIngredientLog(filePath, generation, head, arena);
+		unlockIngredientFiles();
+		return head;
+	}
+	unlockIngredientFiles();
+
+	IngredientStorageView view;
+	if (!openIngredientStorageView(filePath, &view)) {
+		return NULL;
+	}
+
+	uint32_t magic = 0;
+	if (view.size >= sizeof(magic)) {
+		memcpy(&magic, view.data, sizeof(magic));
+	}
+	if (magic == INGREDIENT_FILE_MAGIC) {
+		printf("Error: Ingredient file %s is damaged or has an unsupported version.\n", filePath);
+		closeIngredientStorageView(&view);
 		return NULL;
 	}
 
 	Ingredient* head = NULL;
 	Ingredient* tail = NULL;
-	Ingredient temp;
+	size_t count = view.size / sizeof(Ingredient);
 
-	while (fread(&temp, sizeof(Ingredient), 1, file) == 1) {
-		Ingredient* newIngredient = (Ingredient*)malloc(sizeof(Ingredient));
-		*newIngredient = temp;
+	for (size_t i = 0; i < count; i++) {
+		Ingredient* newIngredient = (Ingredient*)allocateArenaNode(arena, sizeof(Ingredient));
+		if (newIngredient == NULL) {
+			break;
+		}
+		memcpy(newIngredient, (const char*)view.data + i * sizeof(Ingredient), sizeof(Ingredient));
 		newIngredient->prev = tail;
 		newIngredient->next = NULL;
 
@@ -623,7 +722,7 @@ Ingredient* loadIngredientsFromFile(const char* filePath) {
 		tail = newIngredient;
 	}
 
-	fclose(file);
+	closeIngredientStorageView(&view);
 	return head;
 }
 
@@ -658,19 +757,16 @@ void computeLPSArray(const char* pattern, int* lps, int m) {
 }
 
 /**
- * @brief KMP string matching function to search for a pattern in the given text.
+ * @brief KMP string matching with an LPS array that was computed in advance.
  *
  * @param text The text in which to search for the pattern.
  * @param pattern The pattern to search for.
+ * @param lps The LPS array of the pattern.
+ * @param m The length of the pattern, at least 1.
  * @return True if the pattern is found in the text, otherwise false.
  */
-bool KMPSearch(const char* text, const char* pattern) {
+bool KMPSearchWithLPS(const char* text, const char* pattern, const int* lps, int m) {
 	int n = strlen(text);
-	int m = strlen(pattern);
-	int* lps = (int*)malloc(m * sizeof(int));
-
-	computeLPSArray(pattern, lps, m);
-
 	int i = 0; // index for text
 	int j = 0; // index for pattern
 	while (i < n) {
@@ -680,7 +776,6 @@ bool KMPSearch(const char* text, const char* pattern) {
 		}
 
 		if (j == m) {
-			free(lps);
 			return true;
 		}
 		else if (i < n && pattern[j] != text[i]) {
@@ -692,10 +787,38 @@ bool KMPSearch(const char* text, const char* pattern) {
 			}
 		}
 	}
-	free(lps);
 	return false;
 }
 
+/**
+ * @brief KMP string matching function to search for a pattern in the given text.
+ *
+ * Patterns that fit in an ingredient name keep their LPS array on the stack.
+ *
+ * @param text The text in which to search for the pattern.
+ * @param pattern The pattern to search for.
+ * @return True if the pattern is found in the text, otherwise false.
+ */
+bool KMPSearch(const char* text, const char* pattern) {
+	int m = strlen(pattern);
+	if (m == 0) {
+		return true;
+	}
+
+	int stackLps[sizeof(((Ingredient*)0)->name)];
+	int* lps = m <= (int)(sizeof(stackLps) / sizeof(stackLps[0])) ? stackLps : (int*)malloc(m * sizeof(int));
+	if (lps == NULL) {
+		return false;
+	}
+
+	computeLPSArray(pattern, lps, m);
+	bool found = KMPSearchWithLPS(text, pattern, lps, m);
+	if (lps != stackLps) {
+		free(lps);
+	}
+	return found;
+}
+
 /**
  * @brief Searches for an ingredient by name using the KMP algorithm.
  *
@@ -713,10 +836,17 @@ void searchIngredientByKMP(Ingredient* head) {
 	fgets(searchName, sizeof(searchName), stdin);
 	searchName[strcspn(searchName, "\n")] = 0;
 
+	// The pattern is the same for every ingredient, so its LPS array is computed once
+	int m = strlen(searchName);
+	int lps[sizeof(searchName)];
+	if (m > 0) {
+		computeLPSArray(searchName, lps, m);
+	}
+
 	Ingredient* current = head;
 	bool found = false;
 	while (current != NULL) {
-		if (KMPSearch(current->name, searchName)) {
+		if (m == 0 || KMPSearchWithLPS(current->name, searchName, lps, m)) {
 			printf("Ingredient found:\n");
 			printf("ID: %d\n", current->id);
 			printf("Name: %s\n", current->name);
@@ -746,7 +876,7 @@ int printIngredientManagementMenu() {
 	printf("| 2. Add Ingredient                    |\n");
 	printf("| 3. Remove Ingredient                 |\n");
 	printf("| 4. Edit Ingredient                   |\n");
-	printf("| 5. Search Ingredient by Name (KMP)   |\n");
+	printf("| 5. Search Ingredients by Name        |\n");
 	printf("| 6. Exit                              |\n");
 	printf("+--------------------------------------+\n");
 	printf("Please enter a number to select: ");
@@ -769,6 +899,151 @@ int printIngredientViewMenu() {
 	return 1;
 }
 
+/**
+ * @brief Shows the ingredients of a catalog one at a time with next and previous navigation.
+ *
+ * @param catalog The catalog to browse.
+ */
+static void viewCatalogIngredients(const IngredientCatalog* catalog) {
+	if (catalog->head == NULL) {
+		printf("No ingredients available.\n");
+		enterToContinue();
+		return;
+	}
+
+	const Ingredient* current = catalog->head;
+	int viewChoice;
+	while (true) {
+		clearScreen();
+		printf("Current Ingredient:\n");
+		printf("ID: %d\n", current->id);
+		printf("Name: %s\n", current->name);
+		printf("Price: %.2f\n", current->price);
+		printIngredientViewMenu();
+		viewChoice = getInput();
+		if (viewChoice == -2) {
+			handleInputError();
+			enterToContinue();
+			continue;
+		}
+
+		if (viewChoice == 1 && current->next != NULL) {
+			current = current->next;
+		}
+		else if (viewChoice == 2 && current->prev != NULL) {
+			current = current->prev;
+		}
+		else if (viewChoice == 3) {
+			break;
+		}
+		else {
+			printf("Invalid choice or no more ingredients in that direction.\n");
+			enterToContinue();
+		}
+	}
+}
+
+/**
+ * @brief Shows the ingredients of a versioned ingredient file one at a time, reading a page of
+ * records at a time through an ingredient cursor.
+ *
+ * The cursor merges pending log records and deleted records into each page as it is read, so
+ * every persisted change shows up while compaction is left to the background compactor. Only
+ * the page around the current ingredient is in memory, so the first ingredient shows up without
+ * reading or rewriting the rest of the file.
+ *
+ * @param filePath The file path of the ingredient file.
+ * @return True if the file could be browsed, false if it has to be loaded as a catalog instead.
+ */
+static bool browseIngredientFile(const char* filePath) {
+	IngredientCursor cursor;
+	if (!openIngredientCursor(filePath, &cursor)) {
+		return false;
+	}
+	if (cursor.count == 0) {
+		closeIngredientCursor(&cursor);
+		printf("No ingredients available.\n");
+		enterToContinue();
+		return true;
+	}
+
+	// The next page is read into the spare buffer, so the current one survives a read past the end
+	Ingredient pages[2][INGREDIENT_PAGE_SIZE];
+	Ingredient* page = pages[0];
+	Ingredient* spare = pages[1];
+	int pageStart = 0;
+	int pageCount = readIngredientPage(&cursor, pageStart, page, INGREDIENT_PAGE_SIZE);
+	int position = 0;
+	int viewChoice;
+	while (pageCount > 0) {
+		const Ingredient* current = &page[position - pageStart];
+		clearScreen();
+		printf("Current Ingredient:\n");
+		printf("ID: %d\n", current->id);
+		printf("Name: %s\n", current->name);
+		printf("Price: %.2f\n", current->price);
+		printIngredientViewMenu();
+		viewChoice = getInput();
+		if (viewChoice == -2) {
+			handleInputError();
+			enterToContinue();
+			continue;
+		}
+
+		int next = position;
+		if (viewChoice == 1 && position + 1 < cursor.count) {
+			next = position + 1;
+		}
+		else if (viewChoice == 2 && position > 0) {
+			next = position - 1;
+		}
+		else if (viewChoice == 3) {
+			break;
+		}
+
+		// Positions count live ingredients; load the page holding the new position when it leaves the current one
+		if (next != position && (next < pageStart || next >= pageStart + pageCount)) {
+			int nextStart = next - next % INGREDIENT_PAGE_SIZE;
+			int nextCount = readIngredientPage(&cursor, nextStart, spare, INGREDIENT_PAGE_SIZE);
+			if (nextCount > next - nextStart) {
+				Ingredient* previous = page;
+				page = spare;
+				spare = previous;
+				pageStart = nextStart;
+				pageCount = nextCount;
+			}
+			else {
+				next = position;
+			}
+		}
+		if (next == position) {
+			printf("Invalid choice or no more ingredients in that direction.\n");
+			enterToContinue();
+			continue;
+		}
+		position = next;
+	}
+
+	closeIngredientCursor(&cursor);
+	return true;
+}
+
+/**
+ * @brief Loads the catalog of the ingredient management menu the first time it is needed.
+ *
+ * @param catalog The menu catalog.
+ * @param loaded Whether the catalog was already loaded; set to true.
+ * @param filePath The file path to load ingredients from.
+ */
+static void loadMenuCatalog(IngredientCatalog* catalog, bool* loaded, const char* filePath) {
+	if (*loaded) {
+		return;
+	}
+	loadIngredientCatalog(catalog, filePath);
+	enableIngredientTrigramIndex(catalog);
+	*loaded = true;
+}
+
 /**
  * @brief Displays the ingredient management menu and handles user interaction.
  *
@@ -777,7 +1052,10 @@ int printIngredientViewMenu() {
  */
 int ingredientManagementMenu(const char* filePath) {
 	clearScreen();
-	Ingredient* head = loadIngredientsFromFile(filePath);
+	// The catalog is loaded when a choice first needs it, browsing reads the file page by page
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	bool catalogLoaded = false;
 	int choice;
 	char name[100];
 	float price;
@@ -793,46 +1071,19 @@ int ingredientManagementMenu(const char* filePath) {
 			continue;
 		}
 
+		if (choice >= 2 && choice <= 5) {
+			loadMenuCatalog(&catalog, &catalogLoaded, filePath);
+		}
+
 		switch (choice) {
 		case 1:
 			clearScreen();
-			// View ingredients
-			if (head == NULL) {
-				printf("No ingredients available.\n");
-				enterToContinue();
-			}
-			else {
-				Ingredient* current = head;
-				int viewChoice;
-				while (true) {
-					clearScreen();
-					printf("Current Ingredient:\n");
-					printf("ID: %d\n", current->id);
-					printf("Name: %s\n", current->name);
-					printf("Price: %.2f\n", current->price);
-					printIngredientViewMenu();
-					viewChoice = getInput();
-					if (viewChoice == -2) {
-						handleInputError();
-						enterToContinue();
-						continue;
-					}
-
-					if (viewChoice == 1 && current->next != NULL) {
-						current = current->next;
-					}
-					else if (viewChoice == 2 && current->prev != NULL) {
-						current = current->prev;
-					}
-					else if (viewChoice == 3) {
-						break;
-					}
-					else {
-						printf("Invalid choice or no more ingredients in that direction.\n");
-						enterToContinue();
-					}
-				}
+			// View ingredients page by page from the file, the catalog is only needed for legacy files
+			if (browseIngredientFile(filePath)) {
+				break;
 			}
+			loadMenuCatalog(&catalog, &catalogLoaded, filePath);
+			viewCatalogIngredients(&catalog);
 			break;
 
 		case 2:
@@ -874,13 +1125,13 @@ int ingredientManagementMenu(const char* filePath) {
 				}
 			}
 
-			head = addIngredient(head, name, price, filePath);
+			addCatalogIngredient(&catalog, name, price, filePath);
 			enterToContinue();
 			break;
 
 		case 3:
 			clearScreen();
-			if (!listIngredients(head))
+			if (!listIngredients(catalog.head))
 			{
 				break;
 			}
@@ -891,21 +1142,22 @@ int ingredientManagementMenu(const char* filePath) {
 				enterToContinue();
 				break;
 			}
-			head = removeIngredient(head, id, filePath);
+			removeCatalogIngredient(&catalog, id, filePath);
 			break;
 
 		case 4:
-			head = editIngredient(head, filePath);
+			editCatalogIngredient(&catalog, filePath);
 			break;
 
 		case 5:
 			clearScreen();
-			searchIngredientByKMP(head);
+			searchCatalogIngredientsByTerms(&catalog);
 			break;
 		case 6:
-			saveIngredientsToFile(head, filePath);
+			// Every change was already persisted when it was made
 			printf("Exiting Ingredient Management Menu.\n");
 			enterToContinue();
+			freeIngredientCatalog(&catalog);
 			return 0;
 		default:
 			printf("Invalid choice. Please try again.\n");
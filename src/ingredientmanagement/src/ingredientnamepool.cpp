@@ -0,0 +1,183 @@
+/**
+ * @file ingredientnamepool.cpp
+ * @brief Implementation of the ingredient name pool, including the growing name block and the
+ * hash table that maps a name to its handle.
+ */
+#include "../header/ingredientnamepool.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of hash slots allocated for the first name.
+ */
+#define INGREDIENT_NAME_POOL_INITIAL_SLOTS 64
+
+/**
+ * @brief Hashes a name with 32-bit FNV-1a.
+ *
+ * @param name The zero-terminated name.
+ * @param length Receives the length of the name.
+ * @return The hash of the name.
+ */
+static uint32_t hashIngredientName(const char* name, size_t* length) {
+	uint32_t hash = 2166136261u;
+	const char* c = name;
+	while (*c != '\0') {
+		hash = (hash ^ (unsigned char)*c++) * 16777619u;
+	}
+	*length = c - name;
+	return hash;
+}
+
+/**
+ * @brief Finds the slot of a name, or the empty slot where it would be inserted.
+ *
+ * @param pool The pool to search; it must have hash slots.
+ * @param name The zero-terminated name.
+ * @param length The length of the name.
+ * @param hash The hash of the name.
+ * @return The slot position.
+ */
+static uint32_t findIngredientNameSlot(const IngredientNamePool* pool, const char* name, size_t length, uint32_t hash) {
+	uint32_t mask = pool->slotCount - 1;
+	uint32_t slot = hash & mask;
+	while (pool->slots[slot] != 0) {
+		// Names are back to back, so a name ends one byte before the next one starts; comparing
+		// lengths first keeps memcmp inside the candidate
+		uint32_t handle = pool->slots[slot] - 1;
+		uint32_t end = handle + 1 < pool->count ? pool->offsets[handle + 1] : pool->size;
+		if (end - pool->offsets[handle] == length + 1 && memcmp(pool->data + pool->offsets[handle], name, length) == 0) {
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+/**
+ * @brief Doubles the hash table and reinserts every handle.
+ *
+ * @param pool The pool whose table should grow.
+ * @return True on success, false if memory allocation failed.
+ */
+static bool growIngredientNameSlots(IngredientNamePool* pool) {
+	uint32_t slotCount = pool->slotCount > 0 ? pool->slotCount * 2 : INGREDIENT_NAME_POOL_INITIAL_SLOTS;
+	uint32_t* slots = (uint32_t*)calloc(slotCount, sizeof(uint32_t));
+	if (slots == NULL) {
+		return false;
+	}
+	free(pool->slots);
+	pool->slots = slots;
+	pool->slotCount = slotCount;
+	for (uint32_t handle = 0; handle < pool->count; handle++) {
+		size_t length;
+		const char* name = pool->data + pool->offsets[handle];
+		uint32_t hash = hashIngredientName(name, &length);
+		pool->slots[findIngredientNameSlot(pool, name, length, hash)] = handle + 1;
+	}
+	return true;
+}
+
+/**
+ * @brief Initializes an empty name pool.
+ *
+ * @param pool The pool to initialize.
+ */
+void initIngredientNamePool(IngredientNamePool* pool) {
+	memset(pool, 0, sizeof(*pool));
+}
+
+/**
+ * @brief Frees the memory of a name pool; every handle it returned becomes invalid.
+ *
+ * @param pool The pool to free.
+ */
+void freeIngredientNamePool(IngredientNamePool* pool) {
+	free(pool->data);
+	free(pool->offsets);
+	free(pool->slots);
+	memset(pool, 0, sizeof(*pool));
+}
+
+/**
+ * @brief Returns the handle of a name, adding the name to the pool if it is not there yet.
+ *
+ * @param pool The pool to intern into.
+ * @param name The zero-terminated name.
+ * @return The handle of the name, or INGREDIENT_NAME_HANDLE_INVALID if memory allocation failed.
+ */
+uint32_t internIngredientName(IngredientNamePool* pool, const char* name) {
+	if ((pool->count + 1) * 2 > pool->slotCount && !growIngredientNameSlots(pool)) {
+		return INGREDIENT_NAME_HANDLE_INVALID;
+	}
+	size_t length;
+	uint32_t hash = hashIngredientName(name, &length);
+	uint32_t slot = findIngredientNameSlot(pool, name, length, hash);
+	if (pool->slots[slot] != 0) {
+		return pool->slots[slot] - 1;
+	}
+
+	if (length + 1 > UINT32_MAX - pool->size || pool->count == INGREDIENT_NAME_HANDLE_INVALID) {
+		return INGREDIENT_NAME_HANDLE_INVALID;
+	}
+	if (pool->size + length + 1 > pool->capacity) {
+		size_t capacity = pool->capacity > 0 ? (size_t)pool->capacity * 2 : 1024;
+		while (capacity < pool->size + length + 1) {
+			capacity *= 2;
+		}
+		if (capacity > UINT32_MAX) {
+			capacity = UINT32_MAX;
+		}
+		char* data = (char*)realloc(pool->data, capacity);
+		if (data == NULL) {
+			return INGREDIENT_NAME_HANDLE_INVALID;
+		}
+		pool->data = data;
+		pool->capacity = (uint32_t)capacity;
+	}
+	if (pool->count == pool->offsetCapacity) {
+		uint32_t offsetCapacity = pool->offsetCapacity > 0 ? pool->offsetCapacity * 2 : 64;
+		uint32_t* offsets = (uint32_t*)realloc(pool->offsets, offsetCapacity * sizeof(uint32_t));
+		if (offsets == NULL) {
+			return INGREDIENT_NAME_HANDLE_INVALID;
+		}
+		pool->offsets = offsets;
+		pool->offsetCapacity = offsetCapacity;
+	}
+
+	memcpy(pool->data + pool->size, name, length + 1);
+	pool->offsets[pool->count] = pool->size;
+	pool->size += (uint32_t)(length + 1);
+	pool->slots[slot] = ++pool->count;
+	return pool->count - 1;
+}
+
+/**
+ * @brief Looks up the handle of a name without adding it.
+ *
+ * @param pool The pool to search.
+ * @param name The zero-terminated name.
+ * @return The handle of the name, or INGREDIENT_NAME_HANDLE_INVALID if it was never interned.
+ */
+uint32_t findIngredientNameHandle(const IngredientNamePool* pool, const char* name) {
+	if (pool->count == 0) {
+		return INGREDIENT_NAME_HANDLE_INVALID;
+	}
+	size_t length;
+	uint32_t hash = hashIngredientName(name, &length);
+	uint32_t slot = findIngredientNameSlot(pool, name, length, hash);
+	return pool->slots[slot] != 0 ? pool->slots[slot] - 1 : INGREDIENT_NAME_HANDLE_INVALID;
+}
+
+/**
+ * @brief Returns the name behind a handle.
+ *
+ * The pointer stays valid until the next name is interned, which may move the name block.
+ *
+ * @param pool The pool the handle came from.
+ * @param handle The handle.
+ * @return The zero-terminated name, or NULL for an unknown handle.
+ */
+const char* getIngredientNameByHandle(const IngredientNamePool* pool, uint32_t handle) {
+	return handle < pool->count ? pool->data + pool->offsets[handle] : NULL;
+}
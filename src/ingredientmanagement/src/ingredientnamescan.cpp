@@ -0,0 +1,340 @@
+/**
+ * @file ingredientnamescan.cpp
+ * @brief Implementation of the packed ingredient name arena and its substring scanner, including
+ * the runtime CPU feature check and the SSE2, AVX2 and scalar scan loops.
+ */
+#include "../header/ingredientnamescan.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define INGREDIENT_SCAN_X86 1
+#define INGREDIENT_SCAN_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define INGREDIENT_SCAN_X86 1
+#define INGREDIENT_SCAN_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Progress of one scan over a name arena.
+ */
+typedef struct IngredientNameScan {
+	const IngredientNameArena* arena; /**< The arena being scanned. */
+	const unsigned char* pattern; /**< Lower-case pattern. */
+	size_t length; /**< Length of the pattern, at least one byte. */
+	Ingredient** results; /**< Receives the matching ingredients. */
+	int maxResults; /**< Capacity of results. */
+	int found; /**< Number of matches stored so far. */
+	int record; /**< First record that may still contain a match. */
+} IngredientNameScan;
+
+/**
+ * @brief Builds a packed, lower-cased copy of every ingredient name.
+ *
+ * @param arena The arena to initialize.
+ * @param head The head of the linked list of ingredients.
+ * @return True on success, false if memory allocation failed.
+ */
+bool buildIngredientNameArena(IngredientNameArena* arena, Ingredient* head) {
+	arena->data = NULL;
+	arena->size = 0;
+	arena->starts = NULL;
+	arena->ingredients = NULL;
+	arena->count = 0;
+
+	size_t size = 0;
+	int count = 0;
+	for (Ingredient* current = head; current != NULL; current = current->next) {
+		const char* end = (const char*)memchr(current->name, '\0', sizeof(current->name));
+		size += 1 + (end != NULL ? (size_t)(end - current->name) : sizeof(current->name));
+		count++;
+	}
+
+	arena->data = (unsigned char*)malloc(size > 0 ? size : 1);
+	arena->starts = (uint32_t*)malloc((count > 0 ? count : 1) * sizeof(uint32_t));
+	arena->ingredients = (Ingredient**)malloc((count > 0 ? count : 1) * sizeof(Ingredient*));
+	if (arena->data == NULL || arena->starts == NULL || arena->ingredients == NULL) {
+		freeIngredientNameArena(arena);
+		return false;
+	}
+
+	for (Ingredient* current = head; current != NULL; current = current->next) {
+		const char* end = (const char*)memchr(current->name, '\0', sizeof(current->name));
+		size_t length = end != NULL ? (size_t)(end - current->name) : sizeof(current->name);
+		arena->data[arena->size++] = (unsigned char)length;
+		arena->starts[arena->count] = (uint32_t)arena->size;
+		arena->ingredients[arena->count] = current;
+		arena->count++;
+		for (size_t i = 0; i < length; i++) {
+			arena->data[arena->size++] = (unsigned char)tolower((unsigned char)current->name[i]);
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Frees the buffers of a name arena.
+ *
+ * @param arena The arena to free; it is empty afterwards.
+ */
+void freeIngredientNameArena(IngredientNameArena* arena) {
+	free(arena->data);
+	free(arena->starts);
+	free(arena->ingredients);
+	arena->data = NULL;
+	arena->size = 0;
+	arena->starts = NULL;
+	arena->ingredients = NULL;
+	arena->count = 0;
+}
+
+/**
+ * @brief Checks which vector instructions the CPU and operating system support.
+ *
+ * @return The widest backend that can run on this machine; the result is computed once.
+ */
+IngredientScanBackend getIngredientScanBackend() {
+	static int detected = -1;
+	if (detected >= 0) {
+		return (IngredientScanBackend)detected;
+	}
+
+	IngredientScanBackend backend = INGREDIENT_SCAN_SCALAR;
+#if defined(INGREDIENT_SCAN_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		backend = INGREDIENT_SCAN_AVX2;
+	}
+	else if (__builtin_cpu_supports("sse2")) {
+		backend = INGREDIENT_SCAN_SSE2;
+	}
+#elif defined(INGREDIENT_SCAN_X86)
+	int info[4];
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+	__cpuidex(info, 7, 0);
+	if (osAvx && (info[1] & (1 << 5)) != 0) {
+		backend = INGREDIENT_SCAN_AVX2;
+	}
+	else if (sse2) {
+		backend = INGREDIENT_SCAN_SSE2;
+	}
+#endif
+	detected = backend;
+	return backend;
+}
+
+/**
+ * @brief Returns a printable name for a scanner backend.
+ *
+ * @param backend The backend.
+ * @return The name of the instruction set the backend uses.
+ */
+const char* getIngredientScanBackendName(IngredientScanBackend backend) {
+	switch (backend) {
+	case INGREDIENT_SCAN_AVX2:
+		return "AVX2";
+	case INGREDIENT_SCAN_SSE2:
+		return "SSE2";
+	default:
+		return "scalar";
+	}
+}
+
+/**
+ * @brief Checks a position whose first and last pattern bytes already match.
+ *
+ * @param scan The scan in progress; a match is appended to its results.
+ * @param position The offset in the arena where the pattern would start.
+ * @return The offset from which scanning continues; a match skips the rest of its name.
+ */
+static size_t acceptNameCandidate(IngredientNameScan* scan, size_t position) {
+	const IngredientNameArena* arena = scan->arena;
+
+	// Candidates arrive in increasing order, so the record cursor only moves forward
+	while (scan->record < arena->count &&
+		arena->starts[scan->record] + arena->data[arena->starts[scan->record] - 1] <= position) {
+		scan->record++;
+	}
+	if (scan->record >= arena->count) {
+		return arena->size;
+	}
+
+	size_t start = arena->starts[scan->record];
+	size_t end = start + arena->data[start - 1];
+	if (position < start || position + scan->length > end) {
+		return position + 1;
+	}
+	if (scan->length > 2 && memcmp(arena->data + position + 1, scan->pattern + 1, scan->length - 2) != 0) {
+		return position + 1;
+	}
+
+	scan->results[scan->found++] = arena->ingredients[scan->record];
+	scan->record++;
+	return end;
+}
+
+/**
+ * @brief Scans the arena one byte at a time.
+ *
+ * @param scan The scan in progress.
+ * @param position The offset to start from.
+ */
+static void scanNamesScalar(IngredientNameScan* scan, size_t position) {
+	const unsigned char* data = scan->arena->data;
+	size_t size = scan->arena->size;
+	unsigned char first = scan->pattern[0];
+	unsigned char last = scan->pattern[scan->length - 1];
+
+	while (position + scan->length <= size && scan->found < scan->maxResults) {
+		if (data[position] == first && data[position + scan->length - 1] == last) {
+			position = acceptNameCandidate(scan, position);
+		}
+		else {
+			position++;
+		}
+	}
+}
+
+#ifdef INGREDIENT_SCAN_X86
+/**
+ * @brief Returns the index of the lowest set bit of a non-zero mask.
+ *
+ * @param mask The mask.
+ * @return The bit index.
+ */
+static int getLowestSetBit(uint32_t mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * @brief Verifies every candidate of a block whose first and last pattern bytes match.
+ *
+ * @param scan The scan in progress.
+ * @param block The offset of the block.
+ * @param mask One bit per block offset where both bytes match.
+ * @param resume The offset before which candidates are skipped.
+ * @return The offset from which scanning continues.
+ */
+static size_t acceptNameCandidates(IngredientNameScan* scan, size_t block, uint32_t mask, size_t resume) {
+	while (mask != 0 && scan->found < scan->maxResults) {
+		size_t position = block + getLowestSetBit(mask);
+		mask &= mask - 1;
+		if (position >= resume) {
+			resume = acceptNameCandidate(scan, position);
+		}
+	}
+	return resume;
+}
+
+/**
+ * @brief Scans the arena 16 bytes at a time with SSE2.
+ *
+ * Each step compares 16 starting offsets against the first pattern byte and the 16 offsets one
+ * pattern length further against the last byte; only offsets where both match are verified.
+ *
+ * @param scan The scan in progress.
+ */
+INGREDIENT_SCAN_TARGET("sse2")
+static void scanNamesSse2(IngredientNameScan* scan) {
+	const unsigned char* data = scan->arena->data;
+	size_t size = scan->arena->size;
+	__m128i first = _mm_set1_epi8((char)scan->pattern[0]);
+	__m128i last = _mm_set1_epi8((char)scan->pattern[scan->length - 1]);
+
+	size_t position = 0;
+	size_t resume = 0;
+	while (position + scan->length + 15 <= size && scan->found < scan->maxResults) {
+		__m128i blockFirst = _mm_loadu_si128((const __m128i*)(data + position));
+		__m128i blockLast = _mm_loadu_si128((const __m128i*)(data + position + scan->length - 1));
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+		if (mask != 0) {
+			resume = acceptNameCandidates(scan, position, mask, resume);
+		}
+		position += 16;
+	}
+	scanNamesScalar(scan, position > resume ? position : resume);
+}
+
+/**
+ * @brief Scans the arena 32 bytes at a time with AVX2.
+ *
+ * @param scan The scan in progress.
+ */
+INGREDIENT_SCAN_TARGET("avx2")
+static void scanNamesAvx2(IngredientNameScan* scan) {
+	const unsigned char* data = scan->arena->data;
+	size_t size = scan->arena->size;
+	__m256i first = _mm256_set1_epi8((char)scan->pattern[0]);
+	__m256i last = _mm256_set1_epi8((char)scan->pattern[scan->length - 1]);
+
+	size_t position = 0;
+	size_t resume = 0;
+	while (position + scan->length + 31 <= size && scan->found < scan->maxResults) {
+		__m256i blockFirst = _mm256_loadu_si256((const __m256i*)(data + position));
+		__m256i blockLast = _mm256_loadu_si256((const __m256i*)(data + position + scan->length - 1));
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last)));
+		if (mask != 0) {
+			resume = acceptNameCandidates(scan, position, mask, resume);
+		}
+		position += 32;
+	}
+	scanNamesScalar(scan, position > resume ? position : resume);
+}
+#endif
+
+/**
+ * @brief Finds the ingredients whose name contains a pattern, ignoring case.
+ *
+ * @param arena The name arena to scan.
+ * @param pattern The pattern to search for; an empty pattern matches every name.
+ * @param backend The instruction set to use; it is lowered to what the CPU supports.
+ * @param results Receives the matching ingredients in list order.
+ * @param maxResults The capacity of the results array.
+ * @return The number of matching ingredients stored in results.
+ */
+int scanIngredientNameArena(const IngredientNameArena* arena, const char* pattern, IngredientScanBackend backend, Ingredient** results, int maxResults) {
+	unsigned char folded[sizeof(((Ingredient*)0)->name)];
+	size_t length = strlen(pattern);
+	if (length >= sizeof(folded)) {
+		return 0;
+	}
+	if (length == 0) {
+		int found = arena->count < maxResults ? arena->count : maxResults;
+		for (int i = 0; i < found; i++) {
+			results[i] = arena->ingredients[i];
+		}
+		return found;
+	}
+	for (size_t i = 0; i < length; i++) {
+		folded[i] = (unsigned char)tolower((unsigned char)pattern[i]);
+	}
+
+	IngredientNameScan scan = { arena, folded, length, results, maxResults, 0, 0 };
+	if (backend > getIngredientScanBackend()) {
+		backend = getIngredientScanBackend();
+	}
+#ifdef INGREDIENT_SCAN_X86
+	if (backend == INGREDIENT_SCAN_AVX2) {
+		scanNamesAvx2(&scan);
+		return scan.found;
+	}
+	if (backend == INGREDIENT_SCAN_SSE2) {
+		scanNamesSse2(&scan);
+		return scan.found;
+	}
+#endif
+	scanNamesScalar(&scan, 0);
+	return scan.found;
+}
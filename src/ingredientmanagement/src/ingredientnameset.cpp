@@ -0,0 +1,216 @@
+/**
+ * @file ingredientnameset.cpp
+ * @brief Implementation of the ingredient name set, including name normalization, FNV-1a hashing
+ * of the normalized name and the open-addressing table of ingredients.
+ */
+#include "../header/ingredientnameset.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of slots allocated for an empty set.
+ */
+#define INGREDIENT_NAME_SET_INITIAL_CAPACITY 16
+
+/**
+ * @brief Normalizes an ingredient name for duplicate detection.
+ *
+ * Leading and trailing whitespace is dropped, every inner run of whitespace becomes one space and
+ * letters are folded to lower case.
+ *
+ * @param name The name to normalize.
+ * @param normalized Receives the zero-terminated normalized name, truncated to fit.
+ * @return The length of the normalized name.
+ */
+size_t normalizeIngredientName(const char* name, char normalized[INGREDIENT_NAME_SIZE]) {
+	size_t length = 0;
+	bool pendingSpace = false;
+	for (const unsigned char* c = (const unsigned char*)name; *c != '\0' && length < INGREDIENT_NAME_SIZE - 1; c++) {
+		if (isspace(*c)) {
+			pendingSpace = length > 0;
+			continue;
+		}
+		if (pendingSpace) {
+			normalized[length++] = ' ';
+			pendingSpace = false;
+			if (length == INGREDIENT_NAME_SIZE - 1) {
+				break;
+			}
+		}
+		normalized[length++] = (char)tolower(*c);
+	}
+	normalized[length] = '\0';
+	return length;
+}
+
+/**
+ * @brief Hashes a normalized name with 32-bit FNV-1a.
+ *
+ * @param normalized The normalized name.
+ * @param length The length of the normalized name.
+ * @return The hash of the name.
+ */
+static uint32_t hashNormalizedName(const char* normalized, size_t length) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)normalized[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief Hashes the normalized form of an ingredient name.
+ *
+ * @param name The name as stored in the ingredient.
+ * @return The hash of the normalized name.
+ */
+static uint32_t hashIngredientName(const char* name) {
+	char normalized[INGREDIENT_NAME_SIZE];
+	size_t length = normalizeIngredientName(name, normalized);
+	return hashNormalizedName(normalized, length);
+}
+
+/**
+ * @brief Initializes an empty name set.
+ *
+ * @param set The set to initialize.
+ * @return True if the set was initialized, false if memory allocation failed.
+ */
+bool initIngredientNameSet(IngredientNameSet* set) {
+	set->slots = (IngredientNameSetEntry*)calloc(INGREDIENT_NAME_SET_INITIAL_CAPACITY, sizeof(IngredientNameSetEntry));
+	set->capacity = set->slots != NULL ? INGREDIENT_NAME_SET_INITIAL_CAPACITY : 0;
+	set->count = 0;
+	return set->slots != NULL;
+}
+
+/**
+ * @brief Frees the slots of a name set; the ingredients are not touched.
+ *
+ * @param set The set to free.
+ */
+void freeIngredientNameSet(IngredientNameSet* set) {
+	free(set->slots);
+	set->slots = NULL;
+	set->capacity = 0;
+	set->count = 0;
+}
+
+/**
+ * @brief Doubles the number of slots of a name set and reinserts every entry.
+ *
+ * @param set The set to grow.
+ * @return True if the set grew, false if memory allocation failed.
+ */
+static bool growIngredientNameSet(IngredientNameSet* set) {
+	int capacity = set->capacity * 2;
+	IngredientNameSetEntry* slots = (IngredientNameSetEntry*)calloc((size_t)capacity, sizeof(IngredientNameSetEntry));
+	if (slots == NULL) {
+		return false;
+	}
+	for (int i = 0; i < set->capacity; i++) {
+		if (set->slots[i].ingredient != NULL) {
+			int slot = (int)(set->slots[i].hash & (uint32_t)(capacity - 1));
+			while (slots[slot].ingredient != NULL) {
+				slot = (slot + 1) & (capacity - 1);
+			}
+			slots[slot] = set->slots[i];
+		}
+	}
+	free(set->slots);
+	set->slots = slots;
+	set->capacity = capacity;
+	return true;
+}
+
+/**
+ * @brief Adds an ingredient to a name set under its current name.
+ *
+ * @param set The set to add to.
+ * @param ingredient The ingredient; it must be removed before its name changes.
+ * @return True if the ingredient was added, false if memory allocation failed.
+ */
+bool insertIngredientName(IngredientNameSet* set, Ingredient* ingredient) {
+	if ((set->count + 1) * 2 > set->capacity && !growIngredientNameSet(set)) {
+		return false;
+	}
+
+	uint32_t hash = hashIngredientName(ingredient->name);
+	int slot = (int)(hash & (uint32_t)(set->capacity - 1));
+	while (set->slots[slot].ingredient != NULL) {
+		slot = (slot + 1) & (set->capacity - 1);
+	}
+	set->slots[slot].hash = hash;
+	set->slots[slot].ingredient = ingredient;
+	set->count++;
+	return true;
+}
+
+/**
+ * @brief Removes an ingredient from a name set.
+ *
+ * @param set The set to remove from.
+ * @param ingredient The ingredient, still carrying the name it was added under.
+ */
+void removeIngredientName(IngredientNameSet* set, const Ingredient* ingredient) {
+	if (set->count == 0) {
+		return;
+	}
+
+	int mask = set->capacity - 1;
+	int slot = (int)(hashIngredientName(ingredient->name) & (uint32_t)mask);
+	while (set->slots[slot].ingredient != ingredient) {
+		if (set->slots[slot].ingredient == NULL) {
+			return;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	// Shift later entries of the probe run back so no lookup stops at the hole
+	int next = slot;
+	while (true) {
+		next = (next + 1) & mask;
+		if (set->slots[next].ingredient == NULL) {
+			break;
+		}
+		int home = (int)(set->slots[next].hash & (uint32_t)mask);
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			set->slots[slot] = set->slots[next];
+			slot = next;
+		}
+	}
+	set->slots[slot].ingredient = NULL;
+	set->slots[slot].hash = 0;
+	set->count--;
+}
+
+/**
+ * @brief Finds an ingredient whose name equals a name after normalization.
+ *
+ * @param set The set to search.
+ * @param name The name to look for.
+ * @return An ingredient with that name, or NULL if there is none.
+ */
+Ingredient* findIngredientByNormalizedName(const IngredientNameSet* set, const char* name) {
+	if (set->count == 0) {
+		return NULL;
+	}
+
+	char normalized[INGREDIENT_NAME_SIZE];
+	size_t length = normalizeIngredientName(name, normalized);
+	uint32_t hash = hashNormalizedName(normalized, length);
+
+	int slot = (int)(hash & (uint32_t)(set->capacity - 1));
+	while (set->slots[slot].ingredient != NULL) {
+		if (set->slots[slot].hash == hash) {
+			char candidate[INGREDIENT_NAME_SIZE];
+			if (normalizeIngredientName(set->slots[slot].ingredient->name, candidate) == length
+				&& memcmp(candidate, normalized, length) == 0) {
+				return set->slots[slot].ingredient;
+			}
+		}
+		slot = (slot + 1) & (set->capacity - 1);
+	}
+	return NULL;
+}
@@ -0,0 +1,540 @@
+/**
+ * @file ingredientpager.cpp
+ * @brief Implementation of the ingredient cursor, including reading record windows and their
+ * interned names at an offset, merging the pending ingredient log into them and printing a
+ * window as an XLL table.
+ */
+#include "../header/ingredientpager.h"
+#include "../header/ingredientlog.h"
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Number of records checked for tombstones per read while a cursor looks for live records.
+ */
+#define INGREDIENT_CURSOR_SCAN_BATCH 256
+
+/**
+ * @brief Reads a byte range of the file of a cursor.
+ *
+ * @param cursor The open cursor.
+ * @param position The position of the first byte from the start of the file.
+ * @param buffer Receives the bytes.
+ * @param size The number of bytes to read.
+ * @return True if the whole range was read, otherwise false.
+ */
+static bool readIngredientCursorBytes(const IngredientCursor* cursor, uint64_t position, void* buffer, size_t size) {
+	return position <= SIZE_MAX && cursor->storage->read(cursor->filePath, (size_t)position, buffer, size);
+}
+
+/**
+ * @brief Reads the name behind a name pool handle.
+ *
+ * @param cursor The cursor of a version 2 file.
+ * @param handle The name handle of a record.
+ * @param name Receives the zero-terminated name; it is empty if the handle is invalid.
+ */
+static void readIngredientCursorName(IngredientCursor* cursor, uint32_t handle, char name[INGREDIENT_NAME_SIZE]) {
+	name[0] = '\0';
+	uint32_t offset;
+	if (handle >= cursor->nameCount
+		|| !readIngredientCursorBytes(cursor, cursor->nameOffsetsStart + (uint64_t)handle * sizeof(uint32_t), &offset, sizeof(offset))
+		|| offset >= cursor->namesSize) {
+		return;
+	}
+
+	size_t length = cursor->namesSize - offset;
+	if (length > INGREDIENT_NAME_SIZE - 1) {
+		length = INGREDIENT_NAME_SIZE - 1;
+	}
+	if (readIngredientCursorBytes(cursor, cursor->namesStart + offset, name, length)) {
+		name[length] = '\0';
+	}
+}
+
+/**
+ * @brief Checks whether the file of a cursor has a live record with an ID.
+ *
+ * Uses binary search when the file is sorted by ID, otherwise checks the records in batches.
+ *
+ * @param cursor The open cursor.
+ * @param id The ingredient ID to look up.
+ * @return True if a live record has the ID, false if none has or the records could not be read.
+ */
+static bool findIngredientCursorRecord(const IngredientCursor* cursor, int id) {
+	int recordCount = (int)cursor->header.recordCount;
+	uint32_t recordSize = cursor->header.recordSize;
+	IngredientRecord record;
+	if (cursor->header.flags & INGREDIENT_FILE_SORTED_BY_ID) {
+		int low = 0;
+		int high = recordCount - 1;
+		while (low <= high) {
+			int mid = low + (high - low) / 2;
+			if (!readIngredientCursorBytes(cursor, (uint64_t)cursor->header.headerSize + (uint64_t)mid * recordSize, &record, sizeof(record))) {
+				return false;
+			}
+			if (record.id == id) {
+				return (record.flags & INGREDIENT_RECORD_DELETED) == 0;
+			}
+			if (record.id < id) {
+				low = mid + 1;
+			}
+			else {
+				high = mid - 1;
+			}
+		}
+		return false;
+	}
+
+	char* batch = (char*)malloc((size_t)INGREDIENT_CURSOR_SCAN_BATCH * recordSize);
+	bool found = false;
+	for (int first = 0; batch != NULL && !found && first < recordCount; first += INGREDIENT_CURSOR_SCAN_BATCH) {
+		int batchCount = recordCount - first < INGREDIENT_CURSOR_SCAN_BATCH ? recordCount - first : INGREDIENT_CURSOR_SCAN_BATCH;
+		if (!readIngredientCursorBytes(cursor, (uint64_t)cursor->header.headerSize + (uint64_t)first * recordSize, batch, (size_t)batchCount * recordSize)) {
+			break;
+		}
+		for (int i = 0; i < batchCount && !found; i++) {
+			memcpy(&record, batch + (size_t)i * recordSize, sizeof(record));
+			found = record.id == id && (record.flags & INGREDIENT_RECORD_DELETED) == 0;
+		}
+	}
+	free(batch);
+	return found;
+}
+
+/**
+ * @brief Finds the logged change to a record of the file of a cursor.
+ *
+ * @param cursor The open cursor.
+ * @param id The ID of the record.
+ * @return The change, or NULL if the log leaves the record alone.
+ */
+static const IngredientCursorChange* findIngredientCursorChange(const IngredientCursor* cursor, int id) {
+	int low = 0;
+	int high = cursor->changeCount - 1;
+	while (low <= high) {
+		int mid = low + (high - low) / 2;
+		if (cursor->changes[mid].id == id) {
+			return &cursor->changes[mid];
+		}
+		if (cursor->changes[mid].id < id) {
+			low = mid + 1;
+		}
+		else {
+			high = mid - 1;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief State of one ingredient ID while the log is folded into a cursor.
+ */
+typedef struct LoggedIngredient {
+	bool inFile; /**< True if the file has a live record with the ID. */
+	bool present; /**< True if the ID exists after the records folded so far. */
+	bool appended; /**< True if the ID was added by the log and sits after the records of the file. */
+	bool updated; /**< True if the log changed the name or price. */
+	int order; /**< Position among the appended ingredients, in the order the log added them. */
+	float price; /**< Latest logged price. */
+	char name[INGREDIENT_NAME_SIZE]; /**< Latest logged name. */
+} LoggedIngredient;
+
+/**
+ * @brief Folds the pending log of the file of a cursor into its change and added arrays.
+ *
+ * The records are applied with the rules replayIngredientLog uses, so the cursor shows what a
+ * full load would return. Each ID the log touches costs one lookup in the file.
+ *
+ * @param cursor The open cursor.
+ * @return True if the log is missing or was folded, false if it could not be read or memory
+ * allocation failed.
+ */
+static bool loadIngredientCursorChanges(IngredientCursor* cursor) {
+	IngredientLogRecord* records;
+	int recordCount;
+	if (!readIngredientLogRecords(cursor->filePath, cursor->header.generation, &records, &recordCount)) {
+		return false;
+	}
+	if (recordCount == 0) {
+		return true;
+	}
+
+	try {
+		std::unordered_map<int, LoggedIngredient> logged;
+		int order = 0;
+		for (int i = 0; i < recordCount; i++) {
+			const IngredientLogRecord* record = &records[i];
+			std::unordered_map<int, LoggedIngredient>::iterator found = logged.find(record->id);
+			if (found == logged.end()) {
+				LoggedIngredient ingredient = {};
+				ingredient.inFile = ingredient.present = findIngredientCursorRecord(cursor, record->id);
+				found = logged.insert(std::make_pair(record->id, ingredient)).first;
+			}
+
+			LoggedIngredient* ingredient = &found->second;
+			if (record->operation == INGREDIENT_LOG_ADD && !ingredient->present) {
+				ingredient->present = ingredient->appended = true;
+				ingredient->order = order++;
+			}
+			else if (record->operation == INGREDIENT_LOG_REMOVE && ingredient->present) {
+				ingredient->present = ingredient->appended = false;
+				continue;
+			}
+			else if (record->operation == INGREDIENT_LOG_UPDATE && ingredient->present) {
+				ingredient->updated = true;
+			}
+			else {
+				continue;
+			}
+			memcpy(ingredient->name, record->name, INGREDIENT_NAME_SIZE);
+			ingredient->name[INGREDIENT_NAME_SIZE - 1] = '\0';
+			ingredient->price = record->price;
+		}
+		free(records);
+		records = NULL;
+
+		std::vector<IngredientCursorChange> changes;
+		std::vector<std::pair<int, Ingredient> > added;
+		for (std::unordered_map<int, LoggedIngredient>::const_iterator it = logged.begin(); it != logged.end(); ++it) {
+			const LoggedIngredient* ingredient = &it->second;
+			if (ingredient->inFile && (!ingredient->present || ingredient->appended || ingredient->updated)) {
+				IngredientCursorChange change;
+				change.id = it->first;
+				change.removed = !ingredient->present || ingredient->appended;
+				change.price = ingredient->price;
+				memcpy(change.name, ingredient->name, INGREDIENT_NAME_SIZE);
+				changes.push_back(change);
+			}
+			if (ingredient->present && ingredient->appended) {
+				Ingredient appended;
+				appended.id = it->first;
+				memcpy(appended.name, ingredient->name, INGREDIENT_NAME_SIZE);
+				appended.price = ingredient->price;
+				appended.prev = appended.next = appended.npx = NULL;
+				added.push_back(std::make_pair(ingredient->order, appended));
+			}
+		}
+		std::sort(changes.begin(), changes.end(), [](const IngredientCursorChange& a, const IngredientCursorChange& b) { return a.id < b.id; });
+		std::sort(added.begin(), added.end(), [](const std::pair<int, Ingredient>& a, const std::pair<int, Ingredient>& b) { return a.first < b.first; });
+
+		cursor->changes = (IngredientCursorChange*)malloc((changes.empty() ? 1 : changes.size()) * sizeof(IngredientCursorChange));
+		cursor->added = (Ingredient*)malloc((added.empty() ? 1 : added.size()) * sizeof(Ingredient));
+		if (cursor->changes == NULL || cursor->added == NULL) {
+			return false;
+		}
+		std::copy(changes.begin(), changes.end(), cursor->changes);
+		cursor->changeCount = (int)changes.size();
+		for (size_t i = 0; i < added.size(); i++) {
+			cursor->added[i] = added[i].second;
+		}
+		cursor->addedCount = (int)added.size();
+		return true;
+	}
+	catch (...) {
+		free(records);
+		return false;
+	}
+}
+
+/**
+ * @brief Opens a cursor over a versioned ingredient file.
+ *
+ * Only the headers are checked, so a damaged record shows up as an empty name when its page is
+ * read instead of failing the open. The pending ingredient log is folded in, so the cursor shows
+ * every persisted change without compacting the file. Legacy files that store raw Ingredient
+ * structs are not accepted.
+ *
+ * @param filePath The file path of the ingredient file.
+ * @param cursor The cursor to initialize.
+ * @return True if the file was opened, otherwise false.
+ */
+bool openIngredientCursor(const char* filePath, IngredientCursor* cursor) {
+	memset(cursor, 0, sizeof(*cursor));
+	cursor->storage = getIngredientStorage();
+	cursor->filePath = (char*)malloc(strlen(filePath) + 1);
+	if (cursor->filePath == NULL) {
+		return false;
+	}
+	strcpy(cursor->filePath, filePath);
+
+	// Hold the file lock so the file and its log are read from the same generation
+	lockIngredientFiles();
+	IngredientFileHeader* header = &cursor->header;
+	size_t size = 0;
+	bool ok = readIngredientFileHeader(filePath, header)
+		&& header->headerSize >= INGREDIENT_FILE_HEADER_SIZE_NO_TOMBSTONES && header->recordCount <= INT32_MAX
+		&& ((header->version == INGREDIENT_FILE_VERSION && header->recordSize >= sizeof(IngredientRecord))
+			|| (header->version == INGREDIENT_FILE_VERSION_FIXED_NAMES && header->recordSize >= sizeof(IngredientRecordV1)));
+	ok = ok && cursor->storage->size(filePath, &size);
+	uint64_t recordsEnd = (uint64_t)header->headerSize + (uint64_t)header->recordCount * header->recordSize;
+	ok = ok && recordsEnd <= (uint64_t)size;
+
+	if (ok && header->version == INGREDIENT_FILE_VERSION) {
+		IngredientNamePoolHeader pool;
+		ok = readIngredientCursorBytes(cursor, recordsEnd, &pool, sizeof(pool));
+		cursor->nameOffsetsStart = recordsEnd + sizeof(pool);
+		cursor->namesStart = cursor->nameOffsetsStart + (uint64_t)pool.nameCount * sizeof(uint32_t);
+		cursor->nameCount = pool.nameCount;
+		cursor->namesSize = pool.dataSize;
+		ok = ok && cursor->namesStart + pool.dataSize <= (uint64_t)size;
+	}
+
+	ok = ok && loadIngredientCursorChanges(cursor);
+	unlockIngredientFiles();
+	if (!ok) {
+		closeIngredientCursor(cursor);
+		return false;
+	}
+
+	int hiddenCount = 0;
+	for (int i = 0; i < cursor->changeCount; i++) {
+		hiddenCount += cursor->changes[i].removed ? 1 : 0;
+	}
+	uint32_t deletedCount = header->headerSize >= sizeof(IngredientFileHeader) ? header->deletedCount : 0;
+	int64_t liveCount = (int64_t)header->recordCount - deletedCount - hiddenCount;
+	cursor->count = (liveCount > 0 ? (int)liveCount : 0) + cursor->addedCount;
+	return true;
+}
+
+/**
+ * @brief Closes a cursor.
+ *
+ * @param cursor The cursor to close.
+ */
+void closeIngredientCursor(IngredientCursor* cursor) {
+	free(cursor->filePath);
+	free(cursor->livePositions);
+	free(cursor->changes);
+	free(cursor->added);
+	memset(cursor, 0, sizeof(*cursor));
+}
+
+/**
+ * @brief Checks records for tombstones and logged removals until enough shown records are known.
+ *
+ * Once every record was checked, the count of the cursor is exact.
+ *
+ * @param cursor The open cursor.
+ * @param liveCount The number of shown records to find.
+ * @return True if liveCount shown records are known or every record was checked, false if the
+ * records could not be read or memory allocation failed.
+ */
+static bool findIngredientCursorRecords(IngredientCursor* cursor, int liveCount) {
+	int recordCount = (int)cursor->header.recordCount;
+	uint32_t recordSize = cursor->header.recordSize;
+	char* batch = NULL;
+	while (cursor->liveCount < liveCount && cursor->scannedCount < recordCount) {
+		int batchCount = recordCount - cursor->scannedCount < INGREDIENT_CURSOR_SCAN_BATCH ? recordCount - cursor->scannedCount : INGREDIENT_CURSOR_SCAN_BATCH;
+		if (batch == NULL) {
+			batch = (char*)malloc((size_t)INGREDIENT_CURSOR_SCAN_BATCH * recordSize);
+		}
+		if (cursor->liveCount + batchCount > cursor->liveCapacity) {
+			int capacity = cursor->liveCapacity * 2 > cursor->liveCount + batchCount ? cursor->liveCapacity * 2 : cursor->liveCount + batchCount;
+			int* positions = (int*)realloc(cursor->livePositions, (size_t)capacity * sizeof(int));
+			if (positions == NULL) {
+				free(batch);
+				return false;
+			}
+			cursor->livePositions = positions;
+			cursor->liveCapacity = capacity;
+		}
+		uint64_t start = (uint64_t)cursor->header.headerSize + (uint64_t)cursor->scannedCount * recordSize;
+		if (batch == NULL || !readIngredientCursorBytes(cursor, start, batch, (size_t)batchCount * recordSize)) {
+			free(batch);
+			return false;
+		}
+
+		for (int i = 0; i < batchCount; i++) {
+			IngredientRecord record;
+			memcpy(&record, batch + (size_t)i * recordSize, sizeof(record));
+			if ((record.flags & INGREDIENT_RECORD_DELETED) == 0) {
+				const IngredientCursorChange* change = findIngredientCursorChange(cursor, record.id);
+				if (change == NULL || !change->removed) {
+					cursor->livePositions[cursor->liveCount++] = cursor->scannedCount + i;
+				}
+			}
+		}
+		cursor->scannedCount += batchCount;
+	}
+	free(batch);
+
+	if (cursor->scannedCount == recordCount) {
+		cursor->count = cursor->liveCount + cursor->addedCount;
+	}
+	return true;
+}
+
+/**
+ * @brief Reopens a cursor whose file was replaced since it was opened.
+ *
+ * A compaction writes the live records with the log applied followed by the ingredients the log
+ * added, which is the order the cursor shows, so every position keeps its ingredient.
+ *
+ * @param cursor The open cursor.
+ * @return True if the cursor is current, false if the file could not be reopened.
+ */
+static bool refreshIngredientCursor(IngredientCursor* cursor) {
+	IngredientFileHeader header;
+	if (!readIngredientFileHeader(cursor->filePath, &header)) {
+		return false;
+	}
+	if (header.generation == cursor->header.generation) {
+		return true;
+	}
+
+	char* filePath = cursor->filePath;
+	cursor->filePath = NULL;
+	closeIngredientCursor(cursor);
+	bool ok = openIngredientCursor(filePath, cursor);
+	free(filePath);
+	return ok;
+}
+
+/**
+ * @brief Reads shown records of the file of a cursor into ingredients.
+ *
+ * @param cursor The open cursor.
+ * @param offset The index of the first record in livePositions.
+ * @param page Receives the ingredients.
+ * @param count The number of records to read, all of them in livePositions.
+ * @return True if the records were read, otherwise false.
+ */
+static bool readIngredientCursorRecords(IngredientCursor* cursor, int offset, Ingredient* page, int count) {
+	// Read every record from the first to the last shown one in one go, names are resolved afterwards
+	uint32_t recordSize = cursor->header.recordSize;
+	int firstRecord = cursor->livePositions[offset];
+	size_t spanSize = (size_t)(cursor->livePositions[offset + count - 1] - firstRecord + 1) * recordSize;
+	char* records = (char*)malloc(spanSize);
+	if (records == NULL) {
+		return false;
+	}
+	uint64_t start = (uint64_t)cursor->header.headerSize + (uint64_t)firstRecord * recordSize;
+	if (!readIngredientCursorBytes(cursor, start, records, spanSize)) {
+		free(records);
+		return false;
+	}
+
+	for (int i = 0; i < count; i++) {
+		const IngredientRecord* record = (const IngredientRecord*)(records + (size_t)(cursor->livePositions[offset + i] - firstRecord) * recordSize);
+		Ingredient* ingredient = &page[i];
+		ingredient->id = record->id;
+		ingredient->price = record->price;
+		ingredient->prev = ingredient->next = ingredient->npx = NULL;
+
+		const IngredientCursorChange* change = findIngredientCursorChange(cursor, record->id);
+		if (change != NULL) {
+			memcpy(ingredient->name, change->name, INGREDIENT_NAME_SIZE);
+			ingredient->price = change->price;
+		}
+		else if (cursor->header.version == INGREDIENT_FILE_VERSION_FIXED_NAMES) {
+			memcpy(ingredient->name, ((const IngredientRecordV1*)record)->name, INGREDIENT_NAME_SIZE);
+			ingredient->name[INGREDIENT_NAME_SIZE - 1] = '\0';
+		}
+		else {
+			readIngredientCursorName(cursor, record->nameHandle, ingredient->name);
+		}
+	}
+
+	free(records);
+	return true;
+}
+
+/**
+ * @brief Reads a window of consecutive ingredients into an array of ingredients.
+ *
+ * The ingredients get their ID, name and price; their list pointers are set to NULL. Deleted
+ * records and records the log removes are not counted, and logged updates are applied, so the
+ * window holds the ingredients a full load would have at positions offset to offset + pageSize - 1.
+ * If a compaction replaced the file since the cursor was opened, the cursor is reopened first.
+ *
+ * @param cursor The open cursor.
+ * @param offset The position of the first ingredient to read.
+ * @param page Receives the ingredients.
+ * @param pageSize The capacity of the page array.
+ * @return The number of ingredients read, 0 if offset is past the last ingredient.
+ */
+int readIngredientPage(IngredientCursor* cursor, int offset, Ingredient* page, int pageSize) {
+	if (cursor->filePath == NULL || offset < 0 || pageSize <= 0 || offset > INT_MAX - pageSize) {
+		return 0;
+	}
+
+	lockIngredientFiles();
+	int count = 0;
+	if (refreshIngredientCursor(cursor) && findIngredientCursorRecords(cursor, offset + pageSize)) {
+		// The ingredients the log adds follow the records, so they are known once every record was checked
+		bool scanned = cursor->scannedCount == (int)cursor->header.recordCount;
+		int total = scanned ? cursor->liveCount + cursor->addedCount : cursor->liveCount;
+		count = offset < total ? (total - offset < pageSize ? total - offset : pageSize) : 0;
+		int recordCount = offset < cursor->liveCount ? (cursor->liveCount - offset < count ? cursor->liveCount - offset : count) : 0;
+		if (recordCount > 0 && !readIngredientCursorRecords(cursor, offset, page, recordCount)) {
+			count = 0;
+		}
+		for (int i = recordCount; i < count; i++) {
+			page[i] = cursor->added[offset + i - cursor->liveCount];
+		}
+	}
+	unlockIngredientFiles();
+	return count;
+}
+
+/**
+ * @brief Lists a window of ingredients in the XLL table layout.
+ *
+ * The ingredients just before and after the window are read as well, so the first and last rows show
+ * the same neighbours as listIngredientsXLL does for the whole list.
+ *
+ * @param cursor The open cursor.
+ * @param offset The position of the first ingredient to list.
+ * @param pageSize The number of ingredients to list.
+ * @return True if at least one ingredient was listed, otherwise false.
+ */
+bool listIngredientPageXLL(IngredientCursor* cursor, int offset, int pageSize) {
+	if (offset < 0 || offset >= cursor->count || pageSize <= 0) {
+		printf("No ingredients available.\n");
+		return false;
+	}
+
+	int first = offset > 0 ? offset - 1 : 0;
+	Ingredient* window = (Ingredient*)malloc((size_t)(pageSize + 2) * sizeof(Ingredient));
+	if (window == NULL) {
+		return false;
+	}
+	int read = readIngredientPage(cursor, first, window, pageSize + (offset - first) + 1);
+	if (read <= offset - first) {
+		free(window);
+		printf("No ingredients available.\n");
+		return false;
+	}
+
+	int last = offset - first + pageSize < read ? offset - first + pageSize : read;
+	printf("+----+----------------------+------------+----------------------+--------+\n");
+	printf("| ID | Name                 | Price      | Next/Prev            | Price  |\n");
+	printf("+----+----------------------+------------+----------------------+--------+\n");
+	for (int i = offset - first; i < last; i++) {
+		const Ingredient* current = &window[i];
+		printf("| %-2d | %-20s | %-6.2f |", current->id, current->name, current->price);
+
+		if (i + 1 < read) {
+			printf(" %-20s | %-6.2f |\n", window[i + 1].name, window[i + 1].price);
+		}
+		else {
+			printf(" %-20s | %-6s |\n", "-", "-");
+		}
+
+		if (i > 0) {
+			printf("|    | %-20s | %-6s | %-20s | %-6.2f |\n", "", "", window[i - 1].name, window[i - 1].price);
+		}
+
+		printf("+----+----------------------+------------+----------------------+--------+\n");
+	}
+
+	free(window);
+	return true;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file ingredientpriceindex.cpp
+ * @brief Implementation of the ingredient price index, including the skip list operations and the
+ * price range queries on catalogs.
+ */
+#include "../header/ingredientpriceindex.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Allocates a price index node with room for the given number of forward pointers.
+ *
+ * @param level The number of forward pointers.
+ * @return The node with every forward pointer set to NULL, or NULL if memory allocation failed.
+ */
+static IngredientPriceNode* createIngredientPriceNode(int level) {
+	size_t size = sizeof(IngredientPriceNode) + (size_t)(level - 1) * sizeof(IngredientPriceNode*);
+	IngredientPriceNode* node = (IngredientPriceNode*)calloc(1, size);
+	if (node != NULL) {
+		node->level = level;
+	}
+	return node;
+}
+
+/**
+ * @brief Picks the level of a new node, promoting it to each next level with probability 1/4.
+ *
+ * @param index The index whose generator is advanced.
+ * @return A level between 1 and INGREDIENT_PRICE_INDEX_MAX_LEVEL.
+ */
+static int pickIngredientPriceLevel(IngredientPriceIndex* index) {
+	// xorshift32, so the layout of an index is the same on every run
+	uint32_t x = index->seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	index->seed = x;
+
+	int level = 1;
+	while (level < INGREDIENT_PRICE_INDEX_MAX_LEVEL && (x & 3) == 0) {
+		level++;
+		x >>= 2;
+	}
+	return level;
+}
+
+/**
+ * @brief Checks whether a node sorts before the given price and ID.
+ *
+ * @param node The node to compare.
+ * @param price The price of the key.
+ * @param id The ID of the key.
+ * @return True if the node's key is smaller than the given key.
+ */
+static bool precedesIngredientPrice(const IngredientPriceNode* node, float price, int id) {
+	return node->price < price || (node->price == price && node->id < id);
+}
+
+/**
+ * @brief Finds, on every level, the last node that sorts before the given key.
+ *
+ * @param index The index to search.
+ * @param price The price of the key.
+ * @param id The ID of the key.
+ * @param update Receives the predecessor on each of the INGREDIENT_PRICE_INDEX_MAX_LEVEL levels.
+ */
+static void findIngredientPricePredecessors(const IngredientPriceIndex* index, float price, int id, IngredientPriceNode** update) {
+	IngredientPriceNode* current = index->head;
+	for (int level = INGREDIENT_PRICE_INDEX_MAX_LEVEL - 1; level >= 0; level--) {
+		while (current->next[level] != NULL && precedesIngredientPrice(current->next[level], price, id)) {
+			current = current->next[level];
+		}
+		update[level] = current;
+	}
+}
+
+/**
+ * @brief Initializes an empty price index.
+ *
+ * @param index The index to initialize.
+ * @return True on success, false if memory allocation failed.
+ */
+bool initIngredientPriceIndex(IngredientPriceIndex* index) {
+	index->head = createIngredientPriceNode(INGREDIENT_PRICE_INDEX_MAX_LEVEL);
+	index->last = NULL;
+	index->level = 1;
+	index->count = 0;
+	index->seed = 0x9E3779B9u;
+	return index->head != NULL;
+}
+
+/**
+ * @brief Frees every node of a price index; the indexed ingredients are not touched.
+ *
+ * @param index The index to free.
+ */
+void freeIngredientPriceIndex(IngredientPriceIndex* index) {
+	IngredientPriceNode* current = index->head;
+	while (current != NULL) {
+		IngredientPriceNode* next = current->next[0];
+		free(current);
+		current = next;
+	}
+	index->head = NULL;
+	index->last = NULL;
+	index->count = 0;
+}
+
+/**
+ * @brief Adds an ingredient to a price index under its current price.
+ *
+ * @param index The index to add to.
+ * @param ingredient The ingredient to add.
+ * @return True on success, false if memory allocation failed.
+ */
+bool insertIngredientPrice(IngredientPriceIndex* index, Ingredient* ingredient) {
+	IngredientPriceNode* update[INGREDIENT_PRICE_INDEX_MAX_LEVEL];
+	findIngredientPricePredecessors(index, ingredient->price, ingredient->id, update);
+
+	int level = pickIngredientPriceLevel(index);
+	IngredientPriceNode* node = createIngredientPriceNode(level);
+	if (node == NULL) {
+		return false;
+	}
+	node->price = ingredient->price;
+	node->id = ingredient->id;
+	node->ingredient = ingredient;
+
+	for (int i = 0; i < level; i++) {
+		node->next[i] = update[i]->next[i];
+		update[i]->next[i] = node;
+	}
+	node->prev = update[0] != index->head ? update[0] : NULL;
+	if (node->next[0] != NULL) {
+		node->next[0]->prev = node;
+	}
+	else {
+		index->last = node;
+	}
+	if (level > index->level) {
+		index->level = level;
+	}
+	index->count++;
+	return true;
+}
+
+/**
+ * @brief Removes an ingredient from a price index.
+ *
+ * The ingredient must still have the price it was indexed under, so a price change removes the
+ * ingredient first and inserts it again afterwards.
+ *
+ * @param index The index to remove from.
+ * @param ingredient The ingredient to remove.
+ * @return True if the ingredient was indexed, otherwise false.
+ */
+bool removeIngredientPrice(IngredientPriceIndex* index, const Ingredient* ingredient) {
+	IngredientPriceNode* update[INGREDIENT_PRICE_INDEX_MAX_LEVEL];
+	findIngredientPricePredecessors(index, ingredient->price, ingredient->id, update);
+
+	IngredientPriceNode* node = update[0]->next[0];
+	if (node == NULL || node->ingredient != ingredient) {
+		return false;
+	}
+
+	for (int i = 0; i < node->level; i++) {
+		update[i]->next[i] = node->next[i];
+	}
+	if (node->next[0] != NULL) {
+		node->next[0]->prev = node->prev;
+	}
+	else {
+		index->last = node->prev;
+	}
+	while (index->level > 1 && index->head->next[index->level - 1] == NULL) {
+		index->level--;
+	}
+	index->count--;
+	free(node);
+	return true;
+}
+
+/**
+ * @brief Finds the cheapest indexed ingredient whose price is at least the given price.
+ *
+ * Following next[0] from the returned node visits the remaining ingredients in ascending price
+ * order; following prev from index->last visits them all in descending order.
+ *
+ * @param index The index to search.
+ * @param minPrice The lowest price of interest.
+ * @return The first node at or above minPrice, or NULL if every price is lower.
+ */
+const IngredientPriceNode* findFirstIngredientPrice(const IngredientPriceIndex* index, float minPrice) {
+	const IngredientPriceNode* current = index->head;
+	for (int level = index->level - 1; level >= 0; level--) {
+		while (current->next[level] != NULL && current->next[level]->price < minPrice) {
+			current = current->next[level];
+		}
+	}
+	return current->next[0];
+}
+
+/**
+ * @brief Collects the ingredients whose price lies in a closed range, cheapest first.
+ *
+ * @param index The index to search.
+ * @param minPrice The lowest price to include.
+ * @param maxPrice The highest price to include.
+ * @param results Receives the matching ingredients.
+ * @param maxResults The capacity of the results array.
+ * @return The number of ingredients stored in results.
+ */
+int findIngredientsInPriceRange(const IngredientPriceIndex* index, float minPrice, float maxPrice, Ingredient** results, int maxResults) {
+	int found = 0;
+	for (const IngredientPriceNode* node = findFirstIngredientPrice(index, minPrice);
+		node != NULL && node->price <= maxPrice && found < maxResults; node = node->next[0]) {
+		results[found++] = node->ingredient;
+	}
+	return found;
+}
+
+/**
+ * @brief Collects the ingredients of a catalog whose price lies in a closed range, cheapest first.
+ *
+ * Catalogs without a price index are scanned and the matches sorted, so the result is the same
+ * either way.
+ *
+ * @param catalog The catalog to search.
+ * @param minPrice The lowest price to include.
+ * @param maxPrice The highest price to include.
+ * @param results Receives the matching ingredients.
+ * @param maxResults The capacity of the results array.
+ * @return The number of ingredients stored in results.
+ */
+int findCatalogIngredientsByPrice(const IngredientCatalog* catalog, float minPrice, float maxPrice, Ingredient** results, int maxResults) {
+	if (catalog->prices != NULL) {
+		return findIngredientsInPriceRange(catalog->prices, minPrice, maxPrice, results, maxResults);
+	}
+
+	IngredientPriceIndex index;
+	if (!initIngredientPriceIndex(&index)) {
+		return 0;
+	}
+	for (Ingredient* current = catalog->head; current != NULL; current = current->next) {
+		if (current->price >= minPrice && current->price <= maxPrice && !insertIngredientPrice(&index, current)) {
+			break;
+		}
+	}
+	int found = findIngredientsInPriceRange(&index, minPrice, maxPrice, results, maxResults);
+	freeIngredientPriceIndex(&index);
+	return found;
+}
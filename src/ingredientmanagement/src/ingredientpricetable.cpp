@@ -0,0 +1,163 @@
+/**
+ * @file ingredientpricetable.cpp
+ * @brief Implementation of the ingredient price table, including building the parallel ID and
+ * price arrays from a catalog and looking up entries by ingredient ID.
+ */
+#include "../header/ingredientpricetable.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Returns the home slot of an ingredient ID.
+ *
+ * @param id The ingredient ID.
+ * @param capacity The number of hash slots, a power of two.
+ * @return The slot where probing for the ID starts.
+ */
+static int getPriceTableSlot(int id, int capacity) {
+	uint32_t hash = (uint32_t)id * 0x9E3779B1u;
+	hash ^= hash >> 16;
+	return (int)(hash & (uint32_t)(capacity - 1));
+}
+
+/**
+ * @brief Builds the hash slots of a table whose IDs are not dense.
+ *
+ * When an ID occurs more than once, the first entry wins, as it does in the catalog index.
+ *
+ * @param table The table to index.
+ * @return True on success, false if memory allocation failed.
+ */
+static bool buildPriceTableSlots(IngredientPriceTable* table) {
+	int capacity = 16;
+	while (capacity < table->count * 2) {
+		capacity *= 2;
+	}
+	table->slots = (int*)calloc((size_t)capacity, sizeof(int));
+	if (table->slots == NULL) {
+		return false;
+	}
+	table->capacity = capacity;
+
+	for (int i = 0; i < table->count; i++) {
+		int slot = getPriceTableSlot(table->ids[i], capacity);
+		while (table->slots[slot] != 0 && table->ids[table->slots[slot] - 1] != table->ids[i]) {
+			slot = (slot + 1) & (capacity - 1);
+		}
+		if (table->slots[slot] == 0) {
+			table->slots[slot] = i + 1;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Builds a price table over the ingredients of a catalog.
+ *
+ * The table is a snapshot: later changes to the catalog are not reflected in it, and its
+ * ingredient pointers are valid only while the catalog keeps its nodes.
+ *
+ * @param table The table to initialize.
+ * @param catalog The catalog to copy the IDs and prices from.
+ * @return True on success, false if memory allocation failed; the table is empty in that case.
+ */
+bool buildIngredientPriceTable(IngredientPriceTable* table, const IngredientCatalog* catalog) {
+	memset(table, 0, sizeof(*table));
+	if (catalog->count == 0) {
+		return true;
+	}
+
+	table->ids = (int*)malloc((size_t)catalog->count * sizeof(int));
+	table->prices = (float*)malloc((size_t)catalog->count * sizeof(float));
+	table->ingredients = (const Ingredient**)malloc((size_t)catalog->count * sizeof(Ingredient*));
+	if (table->ids == NULL || table->prices == NULL || table->ingredients == NULL) {
+		freeIngredientPriceTable(table);
+		return false;
+	}
+
+	table->dense = true;
+	for (const Ingredient* current = catalog->head; current != NULL && table->count < catalog->count; current = current->next) {
+		int i = table->count++;
+		table->ids[i] = current->id;
+		table->prices[i] = current->price;
+		table->ingredients[i] = current;
+		if (i > 0 && current->id != table->ids[i - 1] + 1) {
+			table->dense = false;
+		}
+	}
+
+	if (!table->dense && !buildPriceTableSlots(table)) {
+		freeIngredientPriceTable(table);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Frees the arrays of a price table.
+ *
+ * @param table The table to free; it is empty afterwards.
+ */
+void freeIngredientPriceTable(IngredientPriceTable* table) {
+	free(table->ids);
+	free(table->prices);
+	free((void*)table->ingredients);
+	free(table->slots);
+	memset(table, 0, sizeof(*table));
+}
+
+/**
+ * @brief Finds the entry of an ingredient ID.
+ *
+ * @param table The table to search.
+ * @param id The ingredient ID to look up.
+ * @return The position of the entry in the table arrays, or -1 if the ID is not in the table.
+ */
+int findIngredientPriceEntry(const IngredientPriceTable* table, int id) {
+	if (table->count == 0) {
+		return -1;
+	}
+	if (table->dense) {
+		// Compare as unsigned so IDs below ids[0] fall out of range as well
+		unsigned int offset = (unsigned int)id - (unsigned int)table->ids[0];
+		return offset < (unsigned int)table->count ? (int)offset : -1;
+	}
+
+	int slot = getPriceTableSlot(id, table->capacity);
+	while (table->slots[slot] != 0) {
+		int entry = table->slots[slot] - 1;
+		if (table->ids[entry] == id) {
+			return entry;
+		}
+		slot = (slot + 1) & (table->capacity - 1);
+	}
+	return -1;
+}
+
+/**
+ * @brief Adds up the prices of a list of ingredient IDs.
+ *
+ * @param table The table to read the prices from.
+ * @param ids The ingredient IDs, for example the ingredients of a recipe.
+ * @param count The number of IDs.
+ * @param missing Receives the number of IDs that are not in the table; may be NULL.
+ * @return The sum of the prices of the IDs found in the table.
+ */
+double sumIngredientPrices(const IngredientPriceTable* table, const int* ids, int count, int* missing) {
+	double total = 0.0;
+	int notFound = 0;
+	for (int i = 0; i < count; i++) {
+		int entry = findIngredientPriceEntry(table, ids[i]);
+		if (entry >= 0) {
+			total += table->prices[entry];
+		}
+		else {
+			notFound++;
+		}
+	}
+	if (missing != NULL) {
+		*missing = notFound;
+	}
+	return total;
+}
@@ -0,0 +1,735 @@
+/**
+ * @file ingredientsearch.cpp
+ * @brief Implementation of ingredient name search, including construction of the Aho-Corasick
+ * automaton, maintenance of the trigram posting lists, Myers' approximate matching and the
+ * multi-term search menu.
+ */
+#include "../header/ingredientsearch.h"
+#include "../../userauthentication/header/userauthentication.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Trigram index struct definition.
+ *
+ * Every case-folded trigram of a name maps to a posting list of the IDs of the ingredients whose
+ * name contains it, kept sorted so lists can be intersected by merging.
+ */
+struct IngredientTrigramIndex {
+	std::unordered_map<uint32_t, std::vector<int> > postings; /**< Sorted ingredient IDs per trigram. */
+};
+
+/**
+ * @brief Builds an Aho-Corasick automaton from a set of search terms.
+ *
+ * Empty terms never match. Terms with the same text are all reported for every occurrence.
+ *
+ * @param matcher The matcher to initialize.
+ * @param terms The search terms.
+ * @param termCount The number of search terms.
+ * @param ignoreCase True to match letters regardless of case.
+ * @return True if the automaton was built, false if memory allocation failed.
+ */
+bool buildIngredientMatcher(IngredientMatcher* matcher, const char* const* terms, int termCount, bool ignoreCase) {
+	memset(matcher, 0, sizeof(*matcher));
+	matcher->termCount = termCount;
+
+	// Every byte value that occurs in a term gets its own character class
+	int maxStates = 1;
+	matcher->classCount = 1;
+	for (int i = 0; i < termCount; i++) {
+		for (const unsigned char* c = (const unsigned char*)terms[i]; *c != '\0'; c++) {
+			int byte = ignoreCase ? tolower(*c) : *c;
+			if (matcher->classes[byte] == 0) {
+				matcher->classes[byte] = (uint8_t)matcher->classCount;
+				if (ignoreCase) {
+					matcher->classes[toupper(byte)] = (uint8_t)matcher->classCount;
+				}
+				matcher->classCount++;
+			}
+			maxStates++;
+		}
+	}
+
+	size_t rowCount = (size_t)maxStates * matcher->classCount;
+	matcher->transitions = (int*)calloc(rowCount, sizeof(int));
+	matcher->firstTerm = (int*)malloc(maxStates * sizeof(int));
+	matcher->outputLink = (int*)malloc(maxStates * sizeof(int));
+	matcher->termLengths = (int*)malloc((termCount > 0 ? termCount : 1) * sizeof(int));
+	matcher->nextTerm = (int*)malloc((termCount > 0 ? termCount : 1) * sizeof(int));
+	int* failure = (int*)malloc(maxStates * sizeof(int));
+	int* queue = (int*)malloc(maxStates * sizeof(int));
+	if (matcher->transitions == NULL || matcher->firstTerm == NULL || matcher->outputLink == NULL ||
+		matcher->termLengths == NULL || matcher->nextTerm == NULL || failure == NULL || queue == NULL) {
+		free(failure);
+		free(queue);
+		freeIngredientMatcher(matcher);
+		return false;
+	}
+
+	// Insert the terms into a trie; 0 marks a missing edge because no edge leads back to the root
+	int width = matcher->classCount;
+	matcher->stateCount = 1;
+	matcher->firstTerm[0] = -1;
+	for (int i = 0; i < termCount; i++) {
+		int state = 0;
+		int length = 0;
+		for (const unsigned char* c = (const unsigned char*)terms[i]; *c != '\0'; c++, length++) {
+			int* edge = &matcher->transitions[state * width + matcher->classes[*c]];
+			if (*edge == 0) {
+				*edge = matcher->stateCount;
+				matcher->firstTerm[matcher->stateCount++] = -1;
+			}
+			state = *edge;
+		}
+		matcher->termLengths[i] = length;
+		matcher->nextTerm[i] = -1;
+		if (state != 0) {
+			matcher->nextTerm[i] = matcher->firstTerm[state];
+			matcher->firstTerm[state] = i;
+		}
+	}
+
+	// Breadth-first pass: resolve failure links and turn missing edges into failure transitions
+	int head = 0;
+	int tail = 0;
+	failure[0] = 0;
+	matcher->outputLink[0] = -1;
+	queue[tail++] = 0;
+	while (head < tail) {
+		int state = queue[head++];
+		int* row = &matcher->transitions[state * width];
+		const int* failureRow = &matcher->transitions[failure[state] * width];
+		for (int c = 0; c < width; c++) {
+			if (row[c] != 0) {
+				int child = row[c];
+				int link = state == 0 ? 0 : failureRow[c];
+				failure[child] = link;
+				matcher->outputLink[child] = matcher->firstTerm[link] >= 0 ? link : matcher->outputLink[link];
+				queue[tail++] = child;
+			}
+			else if (state != 0) {
+				row[c] = failureRow[c];
+			}
+		}
+	}
+
+	free(failure);
+	free(queue);
+	return true;
+}
+
+/**
+ * @brief Frees the tables of an Aho-Corasick automaton.
+ *
+ * @param matcher The matcher to free.
+ */
+void freeIngredientMatcher(IngredientMatcher* matcher) {
+	free(matcher->transitions);
+	free(matcher->firstTerm);
+	free(matcher->outputLink);
+	free(matcher->termLengths);
+	free(matcher->nextTerm);
+	memset(matcher, 0, sizeof(*matcher));
+}
+
+/**
+ * @brief Streams one ingredient name through the automaton and reports every match.
+ *
+ * @param matcher The automaton built from the search terms.
+ * @param ingredient The ingredient whose name is scanned.
+ * @param callback The function called for every match, or NULL to only count matches.
+ * @param context A pointer passed through to the callback.
+ * @return The number of matches in the name.
+ */
+static int scanIngredientName(const IngredientMatcher* matcher, const Ingredient* ingredient, IngredientMatchCallback callback, void* context) {
+	int matchCount = 0;
+	int width = matcher->classCount;
+	int state = 0;
+	for (int i = 0; ingredient->name[i] != '\0'; i++) {
+		state = matcher->transitions[state * width + matcher->classes[(unsigned char)ingredient->name[i]]];
+
+		int output = matcher->firstTerm[state] >= 0 ? state : matcher->outputLink[state];
+		for (; output >= 0; output = matcher->outputLink[output]) {
+			for (int term = matcher->firstTerm[output]; term >= 0; term = matcher->nextTerm[term]) {
+				matchCount++;
+				if (callback != NULL) {
+					callback(ingredient, term, i + 1 - matcher->termLengths[term], context);
+				}
+			}
+		}
+	}
+	return matchCount;
+}
+
+/**
+ * @brief Streams every ingredient name through the automaton and reports every match.
+ *
+ * Each name is scanned once regardless of the number of terms; matches never span two names.
+ *
+ * @param matcher The automaton built from the search terms.
+ * @param head The head of the linked list of ingredients.
+ * @param callback The function called for every match, or NULL to only count matches.
+ * @param context A pointer passed through to the callback.
+ * @return The total number of matches.
+ */
+int scanIngredientNames(const IngredientMatcher* matcher, const Ingredient* head, IngredientMatchCallback callback, void* context) {
+	int matchCount = 0;
+	for (const Ingredient* current = head; current != NULL; current = current->next) {
+		matchCount += scanIngredientName(matcher, current, callback, context);
+	}
+	return matchCount;
+}
+
+/**
+ * @brief Streams the names of selected ingredients through the automaton and reports every match.
+ *
+ * @param matcher The automaton built from the search terms.
+ * @param candidates The ingredients to scan, for example the candidates of a trigram query.
+ * @param candidateCount The number of candidates.
+ * @param callback The function called for every match, or NULL to only count matches.
+ * @param context A pointer passed through to the callback.
+ * @return The total number of matches.
+ */
+int scanIngredientCandidates(const IngredientMatcher* matcher, Ingredient* const* candidates, int candidateCount, IngredientMatchCallback callback, void* context) {
+	int matchCount = 0;
+	for (int i = 0; i < candidateCount; i++) {
+		matchCount += scanIngredientName(matcher, candidates[i], callback, context);
+	}
+	return matchCount;
+}
+
+/**
+ * @brief Packs the case-folded trigram starting at a position of a string into a key.
+ *
+ * @param text The string, with at least INGREDIENT_TRIGRAM_LENGTH bytes from the position on.
+ * @return The trigram key.
+ */
+static uint32_t getTrigramKey(const char* text) {
+	return ((uint32_t)tolower((unsigned char)text[0]) << 16) |
+		((uint32_t)tolower((unsigned char)text[1]) << 8) |
+		(uint32_t)tolower((unsigned char)text[2]);
+}
+
+/**
+ * @brief Collects the distinct trigram keys of a string.
+ *
+ * @param text The string.
+ * @param keys Receives the sorted distinct keys.
+ */
+static void collectTrigramKeys(const char* text, std::vector<uint32_t>& keys) {
+	keys.clear();
+	int length = (int)strlen(text);
+	for (int i = 0; i + INGREDIENT_TRIGRAM_LENGTH <= length; i++) {
+		keys.push_back(getTrigramKey(text + i));
+	}
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+/**
+ * @brief Creates an empty trigram index.
+ *
+ * @return The new index, or NULL if memory allocation failed.
+ */
+IngredientTrigramIndex* createIngredientTrigramIndex() {
+	try {
+		return new IngredientTrigramIndex();
+	}
+	catch (...) {
+		return NULL;
+	}
+}
+
+/**
+ * @brief Frees a trigram index.
+ *
+ * @param index The index to free, may be NULL.
+ */
+void freeIngredientTrigramIndex(IngredientTrigramIndex* index) {
+	delete index;
+}
+
+/**
+ * @brief Adds the trigrams of an ingredient name to the posting lists.
+ *
+ * @param index The trigram index.
+ * @param ingredient The ingredient to add.
+ */
+void addIngredientTrigrams(IngredientTrigramIndex* index, const Ingredient* ingredient) {
+	std::vector<uint32_t> keys;
+	collectTrigramKeys(ingredient->name, keys);
+	for (size_t i = 0; i < keys.size(); i++) {
+		std::vector<int>& ids = index->postings[keys[i]];
+		// New ingredients usually get the highest ID, which makes this an append
+		if (ids.empty() || ids.back() < ingredient->id) {
+			ids.push_back(ingredient->id);
+		}
+		else {
+			std::vector<int>::iterator position = std::lower_bound(ids.begin(), ids.end(), ingredient->id);
+			if (*position != ingredient->id) {
+				ids.insert(position, ingredient->id);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Removes the trigrams of an ingredient name from the posting lists.
+ *
+ * Must be called with the same name the ingredient had when it was added.
+ *
+ * @param index The trigram index.
+ * @param ingredient The ingredient to remove.
+ */
+void removeIngredientTrigrams(IngredientTrigramIndex* index, const Ingredient* ingredient) {
+	std::vector<uint32_t> keys;
+	collectTrigramKeys(ingredient->name, keys);
+	for (size_t i = 0; i < keys.size(); i++) {
+		std::unordered_map<uint32_t, std::vector<int> >::iterator found = index->postings.find(keys[i]);
+		if (found == index->postings.end()) {
+			continue;
+		}
+		std::vector<int>& ids = found->second;
+		std::vector<int>::iterator position = std::lower_bound(ids.begin(), ids.end(), ingredient->id);
+		if (position != ids.end() && *position == ingredient->id) {
+			ids.erase(position);
+		}
+		if (ids.empty()) {
+			index->postings.erase(found);
+		}
+	}
+}
+
+/**
+ * @brief Returns the IDs of the ingredients whose name contains every trigram of a pattern.
+ *
+ * The posting lists are intersected from the shortest one up, so the work is bounded by the
+ * rarest trigram. The candidates are a superset of the case-insensitive matches and still have
+ * to be verified.
+ *
+ * @param index The trigram index.
+ * @param pattern The pattern to look up.
+ * @param ids Receives a malloc'd array of candidate IDs in ascending order, NULL if there are none.
+ * @return The number of candidates, or -1 if the pattern is shorter than a trigram.
+ */
+int queryIngredientTrigramIndex(const IngredientTrigramIndex* index, const char* pattern, int** ids) {
+	*ids = NULL;
+	if (strlen(pattern) < INGREDIENT_TRIGRAM_LENGTH) {
+		return -1;
+	}
+
+	std::vector<uint32_t> keys;
+	collectTrigramKeys(pattern, keys);
+	std::vector<const std::vector<int>*> lists;
+	for (size_t i = 0; i < keys.size(); i++) {
+		std::unordered_map<uint32_t, std::vector<int> >::const_iterator found = index->postings.find(keys[i]);
+		if (found == index->postings.end()) {
+			return 0;
+		}
+		lists.push_back(&found->second);
+	}
+	std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) {
+		return a->size() < b->size();
+	});
+
+	std::vector<int> candidates(*lists[0]);
+	for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+		const std::vector<int>& list = *lists[i];
+		size_t kept = 0;
+		std::vector<int>::const_iterator position = list.begin();
+		for (size_t j = 0; j < candidates.size(); j++) {
+			// Later lists are longer, so binary search beats a linear merge
+			position = std::lower_bound(position, list.end(), candidates[j]);
+			if (position == list.end()) {
+				break;
+			}
+			if (*position == candidates[j]) {
+				candidates[kept++] = candidates[j];
+			}
+		}
+		candidates.resize(kept);
+	}
+
+	if (candidates.empty()) {
+		return 0;
+	}
+	*ids = (int*)malloc(candidates.size() * sizeof(int));
+	if (*ids == NULL) {
+		return 0;
+	}
+	memcpy(*ids, candidates.data(), candidates.size() * sizeof(int));
+	return (int)candidates.size();
+}
+
+/**
+ * @brief Finds the ingredients of a catalog whose name contains a pattern.
+ *
+ * With a trigram index only the candidates of the index are checked with KMP; otherwise every
+ * name is. Matching is case-sensitive like searchIngredientByKMP.
+ *
+ * @param catalog The catalog to search.
+ * @param pattern The pattern to search for.
+ * @param results Receives the matching ingredients.
+ * @param maxResults The capacity of the results array.
+ * @return The number of matching ingredients stored in results.
+ */
+int findCatalogIngredientsByName(const IngredientCatalog* catalog, const char* pattern, Ingredient** results, int maxResults) {
+	int m = strlen(pattern);
+	if (m == 0 || m >= (int)sizeof(((Ingredient*)0)->name)) {
+		return 0;
+	}
+	int lps[sizeof(((Ingredient*)0)->name)];
+	computeLPSArray(pattern, lps, m);
+
+	int* ids = NULL;
+	int candidateCount = catalog->trigrams != NULL ? queryIngredientTrigramIndex(catalog->trigrams, pattern, &ids) : -1;
+	int found = 0;
+	if (candidateCount < 0) {
+		for (Ingredient* current = catalog->head; current != NULL && found < maxResults; current = current->next) {
+			if (KMPSearchWithLPS(current->name, pattern, lps, m)) {
+				results[found++] = current;
+			}
+		}
+		return found;
+	}
+
+	for (int i = 0; i < candidateCount && found < maxResults; i++) {
+		Ingredient* candidate = findIngredientById(catalog, ids[i]);
+		if (candidate != NULL && KMPSearchWithLPS(candidate->name, pattern, lps, m)) {
+			results[found++] = candidate;
+		}
+	}
+	free(ids);
+	return found;
+}
+
+/**
+ * @brief Prepares a pattern for approximate matching.
+ *
+ * @param fuzzy The pattern to initialize.
+ * @param pattern The text to search for.
+ * @param ignoreCase Whether letters should match regardless of case.
+ * @return True on success, false if the pattern is empty or longer than INGREDIENT_FUZZY_MAX_PATTERN_LENGTH.
+ */
+bool buildIngredientFuzzyPattern(IngredientFuzzyPattern* fuzzy, const char* pattern, bool ignoreCase) {
+	int length = strlen(pattern);
+	if (length == 0 || length > INGREDIENT_FUZZY_MAX_PATTERN_LENGTH) {
+		return false;
+	}
+
+	memset(fuzzy->masks, 0, sizeof(fuzzy->masks));
+	fuzzy->length = length;
+	for (int i = 0; i < length; i++) {
+		unsigned char c = (unsigned char)pattern[i];
+		uint64_t bit = (uint64_t)1 << i;
+		fuzzy->masks[c] |= bit;
+		if (ignoreCase) {
+			fuzzy->masks[(unsigned char)tolower(c)] |= bit;
+			fuzzy->masks[(unsigned char)toupper(c)] |= bit;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Computes the fewest edits that turn a pattern into some substring of a name.
+ *
+ * Uses Myers' bit-vector algorithm: the vertical deltas of a whole column of the edit distance
+ * matrix are kept in two 64-bit words, so each byte of the name costs constant time.
+ *
+ * @param fuzzy The prepared pattern.
+ * @param name The name to search.
+ * @param maxDistance Distance at or below which the scan may stop early, or -1 to scan the whole name.
+ * @return The smallest edit distance, between 0 and the pattern length.
+ */
+int getIngredientNameDistance(const IngredientFuzzyPattern* fuzzy, const char* name, int maxDistance) {
+	uint64_t highBit = (uint64_t)1 << (fuzzy->length - 1);
+	uint64_t positive = ~(uint64_t)0;
+	uint64_t negative = 0;
+	int score = fuzzy->length;
+	int best = score;
+
+	for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++) {
+		uint64_t equal = fuzzy->masks[*c];
+		uint64_t vertical = equal | negative;
+		uint64_t horizontal = (((equal & positive) + positive) ^ positive) | equal;
+		uint64_t horizontalPositive = negative | ~(horizontal | positive);
+		uint64_t horizontalNegative = positive & horizontal;
+
+		if (horizontalPositive & highBit) {
+			score++;
+		}
+		else if (horizontalNegative & highBit) {
+			score--;
+		}
+
+		// The top row stays zero because a match may start anywhere in the name
+		horizontalPositive <<= 1;
+		horizontalNegative <<= 1;
+		positive = horizontalNegative | ~(vertical | horizontalPositive);
+		negative = horizontalPositive & vertical;
+
+		if (score < best) {
+			best = score;
+			if (best == 0 || best <= maxDistance) {
+				break;
+			}
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief Finds the ingredients whose name is within an edit distance of a pattern.
+ *
+ * Letters match regardless of case. Results are ranked by distance, ties keep the list order.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param pattern The text to search for.
+ * @param maxDistance The largest number of inserted, deleted or substituted characters allowed.
+ * @param results Receives the closest matches.
+ * @param maxResults The capacity of the results array.
+ * @return The number of matches stored in results, or -1 if the pattern cannot be searched.
+ */
+int findIngredientsFuzzy(Ingredient* head, const char* pattern, int maxDistance, IngredientFuzzyMatch* results, int maxResults) {
+	IngredientFuzzyPattern fuzzy;
+	if (!buildIngredientFuzzyPattern(&fuzzy, pattern, true)) {
+		return -1;
+	}
+
+	// Count the matches of each distance first so the ranking needs no sort
+	std::vector<IngredientFuzzyMatch> matches;
+	int countsByDistance[INGREDIENT_FUZZY_MAX_PATTERN_LENGTH + 1] = { 0 };
+	for (Ingredient* current = head; current != NULL; current = current->next) {
+		int distance = getIngredientNameDistance(&fuzzy, current->name, -1);
+		if (distance <= maxDistance) {
+			IngredientFuzzyMatch match = { current, distance };
+			matches.push_back(match);
+			countsByDistance[distance]++;
+		}
+	}
+
+	int offsets[INGREDIENT_FUZZY_MAX_PATTERN_LENGTH + 1];
+	int offset = 0;
+	for (int distance = 0; distance <= fuzzy.length; distance++) {
+		offsets[distance] = offset;
+		offset += countsByDistance[distance];
+	}
+
+	int found = (int)matches.size() < maxResults ? (int)matches.size() : maxResults;
+	for (size_t i = 0; i < matches.size(); i++) {
+		int slot = offsets[matches[i].distance]++;
+		if (slot < found) {
+			results[slot] = matches[i];
+		}
+	}
+	return found;
+}
+
+/**
+ * @brief Prints the closest ingredient names for a term that was not found.
+ *
+ * Short terms allow fewer edits so that they do not match almost every name.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param term The term that was not found.
+ */
+static void printIngredientSuggestions(Ingredient* head, const char* term) {
+	int maxDistance = ((int)strlen(term) - 1) / 2;
+	if (maxDistance > INGREDIENT_FUZZY_MAX_DISTANCE) {
+		maxDistance = INGREDIENT_FUZZY_MAX_DISTANCE;
+	}
+	if (maxDistance < 1) {
+		return;
+	}
+
+	IngredientFuzzyMatch suggestions[INGREDIENT_FUZZY_SUGGESTION_COUNT];
+	int count = findIngredientsFuzzy(head, term, maxDistance, suggestions, INGREDIENT_FUZZY_SUGGESTION_COUNT);
+	if (count <= 0) {
+		return;
+	}
+
+	printf("Did you mean: ");
+	for (int i = 0; i < count; i++) {
+		printf("%s%s (%d edit%s)", i > 0 ? ", " : "", suggestions[i].ingredient->name,
+			suggestions[i].distance, suggestions[i].distance == 1 ? "" : "s");
+	}
+	printf("?\n");
+}
+
+/**
+ * @brief Splits comma-separated search input into trimmed terms in place.
+ *
+ * @param input The input to split; commas and surrounding spaces are overwritten.
+ * @param terms Receives pointers to the non-empty terms.
+ * @param maxTerms The capacity of the terms array.
+ * @return The number of terms found.
+ */
+int splitSearchTerms(char* input, char** terms, int maxTerms) {
+	int count = 0;
+	char* term = input;
+	while (term != NULL && count < maxTerms) {
+		char* comma = strchr(term, ',');
+		if (comma != NULL) {
+			*comma = '\0';
+		}
+
+		while (isspace((unsigned char)*term)) {
+			term++;
+		}
+		char* end = term + strlen(term);
+		while (end > term && isspace((unsigned char)end[-1])) {
+			*--end = '\0';
+		}
+		if (*term != '\0') {
+			terms[count++] = term;
+		}
+
+		term = comma != NULL ? comma + 1 : NULL;
+	}
+	return count;
+}
+
+/**
+ * @brief Search state shared with the match callback of searchIngredientsByTerms.
+ */
+typedef struct IngredientSearchResults {
+    char** terms; /**< The search terms. */
+    int* hitCounts; /**< Number of matches of each term. */
+} IngredientSearchResults;
+
+/**
+ * @brief Prints one match and counts it for its term.
+ *
+ * @param ingredient The ingredient whose name contains the term.
+ * @param termIndex The index of the matched term.
+ * @param position The offset in the name where the match starts.
+ * @param context The IngredientSearchResults of the search.
+ */
+static void printIngredientMatch(const Ingredient* ingredient, int termIndex, int position, void* context) {
+	IngredientSearchResults* results = (IngredientSearchResults*)context;
+	results->hitCounts[termIndex]++;
+	printf("'%s' found at position %d in ID: %d | Name: %s | Price: %.2f\n",
+		results->terms[termIndex], position, ingredient->id, ingredient->name, ingredient->price);
+}
+
+/**
+ * @brief Collects the ingredients that may contain any of the search terms.
+ *
+ * @param catalog The catalog with a trigram index.
+ * @param terms The search terms.
+ * @param termCount The number of search terms.
+ * @param candidates Receives the candidates in ascending ID order.
+ * @return True if the index narrowed the search, false if a term is too short and every name must be scanned.
+ */
+static bool collectTermCandidates(const IngredientCatalog* catalog, char** terms, int termCount, std::vector<Ingredient*>& candidates) {
+	std::vector<int> ids;
+	for (int i = 0; i < termCount; i++) {
+		int* termIds = NULL;
+		int count = queryIngredientTrigramIndex(catalog->trigrams, terms[i], &termIds);
+		if (count < 0) {
+			return false;
+		}
+		ids.insert(ids.end(), termIds, termIds + count);
+		free(termIds);
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+	candidates.clear();
+	for (size_t i = 0; i < ids.size(); i++) {
+		Ingredient* candidate = findIngredientById(catalog, ids[i]);
+		if (candidate != NULL) {
+			candidates.push_back(candidate);
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Reads comma-separated search terms and lists every occurrence of every term.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param catalog The catalog the list belongs to, or NULL; its trigram index is used when enabled.
+ */
+static void runIngredientTermSearch(Ingredient* head, const IngredientCatalog* catalog) {
+	if (head == NULL) {
+		printf("No ingredients available to search.\n");
+		enterToContinue();
+		return;
+	}
+
+	char input[INGREDIENT_SEARCH_INPUT_SIZE];
+	printf("Enter the ingredient names to search, separated by commas: ");
+	if (fgets(input, sizeof(input), stdin) == NULL) {
+		input[0] = '\0';
+	}
+	input[strcspn(input, "\n")] = 0;
+
+	char* terms[INGREDIENT_SEARCH_INPUT_SIZE / 2];
+	int termCount = splitSearchTerms(input, terms, INGREDIENT_SEARCH_INPUT_SIZE / 2);
+	if (termCount == 0) {
+		printf("No search terms entered.\n");
+		enterToContinue();
+		return;
+	}
+
+	IngredientMatcher matcher;
+	int hitCounts[INGREDIENT_SEARCH_INPUT_SIZE / 2] = { 0 };
+	if (!buildIngredientMatcher(&matcher, terms, termCount, true)) {
+		printf("Error: Memory allocation failed while preparing the search.\n");
+		enterToContinue();
+		return;
+	}
+
+	// The trigram index only has to be consulted for terms of at least three characters
+	IngredientSearchResults results = { terms, hitCounts };
+	std::vector<Ingredient*> candidates;
+	int matchCount;
+	if (catalog != NULL && catalog->trigrams != NULL && collectTermCandidates(catalog, terms, termCount, candidates)) {
+		matchCount = scanIngredientCandidates(&matcher, candidates.data(), (int)candidates.size(), printIngredientMatch, &results);
+	}
+	else {
+		matchCount = scanIngredientNames(&matcher, head, printIngredientMatch, &results);
+	}
+	freeIngredientMatcher(&matcher);
+
+	for (int i = 0; i < termCount; i++) {
+		if (hitCounts[i] == 0) {
+			printf("Ingredient '%s' not found in the list.\n", terms[i]);
+			printIngredientSuggestions(head, terms[i]);
+		}
+	}
+	printf("%d match(es) found for %d search term(s).\n", matchCount, termCount);
+	enterToContinue();
+}
+
+/**
+ * @brief Searches the ingredient names for one or more comma-separated terms at once.
+ *
+ * Letters match regardless of case and every occurrence of every term is listed. Terms that are
+ * not found get the closest names within a few typos suggested.
+ *
+ * @param head The head of the linked list of ingredients.
+ */
+void searchIngredientsByTerms(Ingredient* head) {
+	runIngredientTermSearch(head, NULL);
+}
+
+/**
+ * @brief Searches the ingredients of a catalog for one or more comma-separated terms at once.
+ *
+ * When the catalog has a trigram index, only the names that contain every trigram of some term
+ * are scanned.
+ *
+ * @param catalog The catalog to search.
+ */
+void searchCatalogIngredientsByTerms(const IngredientCatalog* catalog) {
+	runIngredientTermSearch(catalog->head, catalog);
+}
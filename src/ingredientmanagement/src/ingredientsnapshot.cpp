@@ -0,0 +1,324 @@
+/**
+ * @file ingredientsnapshot.cpp
+ * @brief Implementation of compact ingredient snapshots, including the varint coder, the choice
+ * of fixed-point price scale and front coding of the sorted names.
+ */
+#include "../header/ingredientsnapshot.h"
+#include "../header/ingredientstorage.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Longest encoding of a 64-bit varint in bytes.
+ */
+#define SNAPSHOT_MAX_VARINT_BYTES 10
+
+/**
+ * @brief Largest magnitude of a fixed-point price, chosen so the conversion through double is exact.
+ */
+#define SNAPSHOT_MAX_PRICE_UNITS 9007199254740992.0
+
+/**
+ * @brief Appends an unsigned integer as a little-endian base-128 varint.
+ *
+ * @param out The buffer to append to.
+ * @param value The value to encode.
+ */
+static void putSnapshotVarint(std::vector<uint8_t>& out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+/**
+ * @brief Decodes a little-endian base-128 varint.
+ *
+ * @param position The read position, advanced past the varint.
+ * @param end The end of the readable bytes.
+ * @param value Receives the decoded value.
+ * @return True if a complete varint of at most 64 bits was read, otherwise false.
+ */
+static bool getSnapshotVarint(const uint8_t** position, const uint8_t* end, uint64_t* value) {
+	uint64_t result = 0;
+	const uint8_t* p = *position;
+	for (int shift = 0; shift < 7 * SNAPSHOT_MAX_VARINT_BYTES && p < end; shift += 7) {
+		uint8_t byte = *p++;
+		result |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			*position = p;
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Returns the length of a name, which is at most sizeof(Ingredient::name) - 1.
+ *
+ * @param ingredient The ingredient.
+ * @return The number of characters before the terminator or the end of the buffer.
+ */
+static size_t snapshotNameLength(const Ingredient* ingredient) {
+	const char* end = (const char*)memchr(ingredient->name, '\0', sizeof(ingredient->name) - 1);
+	return end != NULL ? (size_t)(end - ingredient->name) : sizeof(ingredient->name) - 1;
+}
+
+/**
+ * @brief Compares two ingredient names, including names without a terminator.
+ *
+ * @param a The first ingredient.
+ * @param b The second ingredient.
+ * @return Negative, zero or positive like strcmp.
+ */
+static int compareSnapshotNames(const Ingredient* a, const Ingredient* b) {
+	size_t lengthA = snapshotNameLength(a);
+	size_t lengthB = snapshotNameLength(b);
+	int order = memcmp(a->name, b->name, lengthA < lengthB ? lengthA : lengthB);
+	if (order != 0) {
+		return order;
+	}
+	return lengthA < lengthB ? -1 : lengthA > lengthB ? 1 : 0;
+}
+
+/**
+ * @brief Picks the smallest power-of-ten price scale that stores every price exactly.
+ *
+ * A scale only qualifies if every price, multiplied by it, still converts through double exactly,
+ * so large prices can use a small scale even though they would overflow the largest one.
+ *
+ * @param ingredients The ingredients of the snapshot.
+ * @return The scale, or INGREDIENT_SNAPSHOT_RAW_PRICES if no scale stores every price exactly.
+ */
+static uint32_t chooseSnapshotPriceScale(const std::vector<const Ingredient*>& ingredients) {
+	for (uint32_t candidate = 100; candidate <= INGREDIENT_SNAPSHOT_MAX_PRICE_SCALE; candidate *= 10) {
+		bool exact = true;
+		for (size_t i = 0; exact && i < ingredients.size(); i++) {
+			double scaled = (double)ingredients[i]->price * candidate;
+			exact = isfinite(scaled) && fabs(scaled) < SNAPSHOT_MAX_PRICE_UNITS
+				&& (float)(floor(scaled + 0.5) / candidate) == ingredients[i]->price;
+		}
+		if (exact) {
+			return candidate;
+		}
+	}
+	return INGREDIENT_SNAPSHOT_RAW_PRICES;
+}
+
+/**
+ * @brief Writes a linked list of ingredients to a compact snapshot file.
+ *
+ * Records are stored in ascending ID order, so a list that is not sorted by ID is read back sorted.
+ *
+ * @param head The head of the linked list of ingredients.
+ * @param filePath The file path to write the snapshot to.
+ * @return True if the snapshot was written successfully, otherwise false.
+ */
+bool writeIngredientSnapshot(const Ingredient* head, const char* filePath) {
+	bool ok = true;
+	try {
+		std::vector<const Ingredient*> byId;
+		for (const Ingredient* temp = head; temp != NULL; temp = temp->next) {
+			byId.push_back(temp);
+		}
+		std::stable_sort(byId.begin(), byId.end(), [](const Ingredient* a, const Ingredient* b) {
+			return a->id < b->id;
+		});
+
+		IngredientSnapshotHeader header;
+		memset(&header, 0, sizeof(header));
+		header.magic = INGREDIENT_SNAPSHOT_MAGIC;
+		header.version = INGREDIENT_SNAPSHOT_VERSION;
+		header.headerSize = sizeof(IngredientSnapshotHeader);
+		header.recordCount = (uint32_t)byId.size();
+		ok = byId.empty() || byId.front()->id >= 0;
+		header.priceScale = chooseSnapshotPriceScale(byId);
+
+		// Sort the records by name so equal names share one entry and neighbours share prefixes
+		std::vector<uint32_t> byName(byId.size());
+		for (size_t i = 0; i < byName.size(); i++) {
+			byName[i] = (uint32_t)i;
+		}
+		std::stable_sort(byName.begin(), byName.end(), [&byId](uint32_t a, uint32_t b) {
+			return compareSnapshotNames(byId[a], byId[b]) < 0;
+		});
+
+		std::vector<uint8_t> body;
+		std::vector<uint32_t> nameIndex(byId.size());
+		const Ingredient* previous = NULL;
+		for (size_t i = 0; ok && i < byName.size(); i++) {
+			const Ingredient* current = byId[byName[i]];
+			if (previous == NULL || compareSnapshotNames(previous, current) != 0) {
+				size_t length = snapshotNameLength(current);
+				size_t shared = 0;
+				if (previous != NULL) {
+					size_t previousLength = snapshotNameLength(previous);
+					while (shared < length && shared < previousLength && previous->name[shared] == current->name[shared]) {
+						shared++;
+					}
+				}
+				putSnapshotVarint(body, shared);
+				putSnapshotVarint(body, length - shared);
+				body.insert(body.end(), current->name + shared, current->name + length);
+				header.nameCount++;
+				previous = current;
+			}
+			nameIndex[byName[i]] = header.nameCount - 1;
+		}
+
+		int64_t previousId = 0;
+		for (size_t i = 0; ok && i < byId.size(); i++) {
+			putSnapshotVarint(body, (uint64_t)(byId[i]->id - previousId));
+			if (header.priceScale == INGREDIENT_SNAPSHOT_RAW_PRICES) {
+				uint32_t bits;
+				memcpy(&bits, &byId[i]->price, sizeof(bits));
+				putSnapshotVarint(body, bits);
+			}
+			else {
+				int64_t units = (int64_t)floor((double)byId[i]->price * header.priceScale + 0.5);
+				putSnapshotVarint(body, ((uint64_t)units << 1) ^ (uint64_t)(units >> 63));
+			}
+			putSnapshotVarint(body, nameIndex[i]);
+			previousId = byId[i]->id;
+		}
+		header.bodySize = body.size();
+
+		if (ok) {
+			std::vector<char> image((const char*)&header, (const char*)&header + sizeof(header));
+			image.insert(image.end(), body.begin(), body.end());
+			ok = getIngredientStorage()->replace(filePath, image.data(), image.size());
+		}
+	}
+	catch (...) {
+		ok = false;
+	}
+
+	if (!ok) {
+		printf("Error: Failed to write ingredient snapshot %s.\n", filePath);
+	}
+	return ok;
+}
+
+/**
+ * @brief Loads ingredients from a compact snapshot file.
+ *
+ * @param filePath The file path of the snapshot.
+ * @return A pointer to the head of the linked list of ingredients in ascending ID order, or NULL
+ * if the snapshot is missing, empty or damaged.
+ */
+Ingredient* readIngredientSnapshot(const char* filePath) {
+	IngredientStorageView view;
+	if (!openIngredientStorageView(filePath, &view)) {
+		printf("Error: Could not open file %s for reading.\n", filePath);
+		return NULL;
+	}
+
+	IngredientSnapshotHeader header;
+	bool ok = view.size >= sizeof(header);
+	if (ok) {
+		memcpy(&header, view.data, sizeof(header));
+	}
+	ok = ok && header.magic == INGREDIENT_SNAPSHOT_MAGIC
+		&& header.version == INGREDIENT_SNAPSHOT_VERSION
+		&& header.headerSize >= sizeof(IngredientSnapshotHeader)
+		&& header.headerSize <= view.size
+		&& header.bodySize == view.size - header.headerSize
+		&& header.nameCount <= header.recordCount
+		&& header.recordCount <= header.bodySize;
+
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+
+	try {
+		const uint8_t* position = ok ? (const uint8_t*)view.data + header.headerSize : NULL;
+		const uint8_t* end = ok ? position + header.bodySize : NULL;
+
+		// Names are decoded into fixed slots so each one can copy its prefix from the slot before
+		const size_t slotSize = sizeof(head->name);
+		std::vector<char> names(ok ? (size_t)header.nameCount * slotSize : 0);
+		size_t previousLength = 0;
+		for (uint32_t i = 0; ok && i < header.nameCount; i++) {
+			uint64_t shared, suffix;
+			ok = getSnapshotVarint(&position, end, &shared)
+				&& getSnapshotVarint(&position, end, &suffix)
+				&& shared <= previousLength
+				&& suffix < slotSize - shared
+				&& suffix <= (uint64_t)(end - position);
+			if (ok) {
+				char* name = &names[i * slotSize];
+				if (shared > 0) {
+					memcpy(name, name - slotSize, (size_t)shared);
+				}
+				memcpy(name + shared, position, (size_t)suffix);
+				position += suffix;
+				previousLength = (size_t)(shared + suffix);
+				name[previousLength] = '\0';
+			}
+		}
+
+		int64_t id = 0;
+		for (uint32_t i = 0; ok && i < header.recordCount; i++) {
+			uint64_t delta, encodedPrice, nameIndex;
+			ok = getSnapshotVarint(&position, end, &delta)
+				&& getSnapshotVarint(&position, end, &encodedPrice)
+				&& getSnapshotVarint(&position, end, &nameIndex)
+				&& nameIndex < header.nameCount
+				&& delta <= (uint64_t)(INT32_MAX - id)
+				&& (header.priceScale != INGREDIENT_SNAPSHOT_RAW_PRICES || encodedPrice <= UINT32_MAX);
+			if (!ok) {
+				break;
+			}
+			id += (int64_t)delta;
+
+			Ingredient* newIngredient = (Ingredient*)malloc(sizeof(Ingredient));
+			if (newIngredient == NULL) {
+				printf("Error: Memory allocation failed while loading ingredients.\n");
+				ok = false;
+				break;
+			}
+			newIngredient->id = (int)id;
+			memcpy(newIngredient->name, &names[(size_t)nameIndex * slotSize], slotSize);
+			if (header.priceScale == INGREDIENT_SNAPSHOT_RAW_PRICES) {
+				uint32_t bits = (uint32_t)encodedPrice;
+				memcpy(&newIngredient->price, &bits, sizeof(bits));
+			}
+			else {
+				int64_t units = (int64_t)(encodedPrice >> 1) ^ -(int64_t)(encodedPrice & 1);
+				newIngredient->price = (float)((double)units / header.priceScale);
+			}
+			newIngredient->prev = tail;
+			newIngredient->next = NULL;
+			newIngredient->npx = NULL;
+
+			if (head == NULL) {
+				head = newIngredient;
+			}
+			else {
+				tail->next = newIngredient;
+			}
+			tail = newIngredient;
+		}
+		ok = ok && position == end;
+	}
+	catch (...) {
+		ok = false;
+	}
+
+	closeIngredientStorageView(&view);
+
+	if (!ok) {
+		printf("Error: Ingredient snapshot %s is damaged or has an unsupported version.\n", filePath);
+		while (head != NULL) {
+			Ingredient* temp = head;
+			head = head->next;
+			free(temp);
+		}
+	}
+	return head;
+}
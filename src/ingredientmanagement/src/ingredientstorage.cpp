@@ -0,0 +1,522 @@
+/**
+ * @file ingredientstorage.cpp
+ * @brief Implementation of the ingredient storage backends, including the shared atomic file
+ * writer, the stdio and mmap readers and the in-memory file table.
+ */
+#include "../header/ingredientstorage.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Backend used by every ingredient file operation.
+ */
+static std::atomic<const IngredientStorage*> currentStorage(&ingredientMmapStorage);
+
+/**
+ * @brief Writes a file next to the target and renames it over the target, so readers never see a
+ * partial file.
+ *
+ * @param path The path of the file to replace.
+ * @param data The new contents.
+ * @param size The size of the new contents in bytes.
+ * @return True if the file was replaced, otherwise false.
+ */
+static bool replaceDiskFile(const char* path, const void* data, size_t size) {
+	std::string tempPath = std::string(path) + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (file == NULL) {
+		return false;
+	}
+
+	bool ok = size == 0 || fwrite(data, 1, size, file) == size;
+	if (fclose(file) != 0) {
+		ok = false;
+	}
+	if (ok) {
+#ifdef _WIN32
+		ok = MoveFileExA(tempPath.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		ok = rename(tempPath.c_str(), path) == 0;
+#endif
+	}
+	if (!ok) {
+		remove(tempPath.c_str());
+	}
+	return ok;
+}
+
+/**
+ * @brief Reads a byte range of a file on disk.
+ *
+ * @param path The path of the file.
+ * @param offset The position of the first byte to read.
+ * @param buffer Receives the bytes.
+ * @param size The number of bytes to read.
+ * @return True if the whole range was read, otherwise false.
+ */
+static bool readDiskFile(const char* path, size_t offset, void* buffer, size_t size) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+	bool ok = offset <= (size_t)LONG_MAX && fseek(file, (long)offset, SEEK_SET) == 0 && fread(buffer, 1, size, file) == size;
+	fclose(file);
+	return ok;
+}
+
+/**
+ * @brief Gets the size of a file on disk.
+ *
+ * @param path The path of the file.
+ * @param size Receives the size in bytes.
+ * @return True if the file exists, otherwise false.
+ */
+static bool sizeDiskFile(const char* path, size_t* size) {
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes)) {
+		return false;
+	}
+	*size = (size_t)(((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow);
+	return true;
+#else
+	struct stat st;
+	if (stat(path, &st) != 0) {
+		return false;
+	}
+	*size = (size_t)st.st_size;
+	return true;
+#endif
+}
+
+/**
+ * @brief Overwrites a byte range of an existing file on disk in place.
+ *
+ * @param path The path of the file.
+ * @param offset The position of the first byte to write; may be the end of the file to append.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
+ * @return True if the whole range was written, otherwise false.
+ */
+static bool patchDiskFile(const char* path, size_t offset, const void* data, size_t size) {
+	FILE* file = fopen(path, "r+b");
+	if (file == NULL) {
+		return false;
+	}
+	bool ok = offset <= (size_t)LONG_MAX && fseek(file, (long)offset, SEEK_SET) == 0 && (size == 0 || fwrite(data, 1, size, file) == size);
+	if (fclose(file) != 0) {
+		ok = false;
+	}
+	return ok;
+}
+
+/**
+ * @brief Deletes a file on disk.
+ *
+ * @param path The path of the file.
+ * @return True if the file was deleted, otherwise false.
+ */
+static bool removeDiskFile(const char* path) {
+	return remove(path) == 0;
+}
+
+/**
+ * @brief Opens a view by reading the whole file into a heap buffer.
+ *
+ * @param path The path of the file.
+ * @param view The view to initialize.
+ * @return True if the file was read, otherwise false.
+ */
+static bool openStdioView(const char* path, IngredientStorageView* view) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+	void* data = size >= 0 ? malloc(size > 0 ? (size_t)size : 1) : NULL;
+	bool ok = data != NULL && fseek(file, 0, SEEK_SET) == 0 && fread(data, 1, (size_t)size, file) == (size_t)size;
+	fclose(file);
+	if (!ok) {
+		free(data);
+		return false;
+	}
+
+	view->data = data;
+	view->size = (size_t)size;
+	view->handle = data;
+	return true;
+}
+
+/**
+ * @brief Releases a view opened by openStdioView.
+ *
+ * @param view The view to release.
+ */
+static void closeStdioView(IngredientStorageView* view) {
+	free(view->handle);
+}
+
+/**
+ * @brief Handles of a Windows file mapping.
+ */
+#ifdef _WIN32
+typedef struct MappedViewHandles {
+	HANDLE file; /**< The mapped file. */
+	HANDLE mapping; /**< The file mapping object. */
+} MappedViewHandles;
+#endif
+
+/**
+ * @brief Opens a view by memory-mapping the file, so only the pages that are read are loaded.
+ *
+ * Empty files cannot be mapped and are served as an empty view instead.
+ *
+ * @param path The path of the file.
+ * @param view The view to initialize.
+ * @return True if the file was mapped, otherwise false.
+ */
+static bool openMmapView(const char* path, IngredientStorageView* view) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+	if (fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		view->data = "";
+		view->size = 0;
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	MappedViewHandles* handles = base != NULL ? (MappedViewHandles*)malloc(sizeof(MappedViewHandles)) : NULL;
+	if (handles == NULL) {
+		if (base != NULL) {
+			UnmapViewOfFile(base);
+		}
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	handles->file = file;
+	handles->mapping = mapping;
+	view->data = base;
+	view->size = (size_t)fileSize.QuadPart;
+	view->handle = handles;
+	return true;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return false;
+	}
+	if (st.st_size == 0) {
+		close(fd);
+		view->data = "";
+		view->size = 0;
+		return true;
+	}
+
+	size_t size = (size_t)st.st_size;
+	void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		return false;
+	}
+
+	view->data = base;
+	view->size = size;
+	view->handle = base;
+	return true;
+#endif
+}
+
+/**
+ * @brief Releases a view opened by openMmapView.
+ *
+ * @param view The view to release.
+ */
+static void closeMmapView(IngredientStorageView* view) {
+	if (view->handle == NULL) {
+		return;
+	}
+#ifdef _WIN32
+	MappedViewHandles* handles = (MappedViewHandles*)view->handle;
+	UnmapViewOfFile(view->data);
+	CloseHandle(handles->mapping);
+	CloseHandle(handles->file);
+	free(handles);
+#else
+	munmap(view->handle, view->size);
+#endif
+}
+
+/**
+ * @brief Contents of one in-memory file, shared with the views opened on it.
+ */
+typedef std::shared_ptr<const std::vector<char> > MemoryFile;
+
+/**
+ * @brief Lock protecting the in-memory file table.
+ */
+static std::mutex memoryFilesMutex;
+
+/**
+ * @brief In-memory files by path.
+ */
+static std::unordered_map<std::string, MemoryFile> memoryFiles;
+
+/**
+ * @brief Looks up an in-memory file.
+ *
+ * @param path The path of the file.
+ * @return The contents, or an empty pointer if there is no such file.
+ */
+static MemoryFile findMemoryFile(const char* path) {
+	std::lock_guard<std::mutex> guard(memoryFilesMutex);
+	std::unordered_map<std::string, MemoryFile>::const_iterator found = memoryFiles.find(path);
+	return found != memoryFiles.end() ? found->second : MemoryFile();
+}
+
+/**
+ * @brief Opens a view of an in-memory file without copying it.
+ *
+ * The view keeps its own reference to the contents, so replacing the file does not invalidate it.
+ *
+ * @param path The path of the file.
+ * @param view The view to initialize.
+ * @return True if the file exists, otherwise false.
+ */
+static bool openMemoryView(const char* path, IngredientStorageView* view) {
+	MemoryFile file = findMemoryFile(path);
+	if (!file) {
+		return false;
+	}
+	MemoryFile* handle = new (std::nothrow) MemoryFile(file);
+	if (handle == NULL) {
+		return false;
+	}
+	view->data = file->empty() ? "" : file->data();
+	view->size = file->size();
+	view->handle = handle;
+	return true;
+}
+
+/**
+ * @brief Releases a view opened by openMemoryView.
+ *
+ * @param view The view to release.
+ */
+static void closeMemoryView(IngredientStorageView* view) {
+	delete (MemoryFile*)view->handle;
+}
+
+/**
+ * @brief Reads a byte range of an in-memory file.
+ *
+ * @param path The path of the file.
+ * @param offset The position of the first byte to read.
+ * @param buffer Receives the bytes.
+ * @param size The number of bytes to read.
+ * @return True if the whole range was read, otherwise false.
+ */
+static bool readMemoryFile(const char* path, size_t offset, void* buffer, size_t size) {
+	MemoryFile file = findMemoryFile(path);
+	if (!file || offset > file->size() || size > file->size() - offset) {
+		return false;
+	}
+	if (size > 0) {
+		memcpy(buffer, file->data() + offset, size);
+	}
+	return true;
+}
+
+/**
+ * @brief Gets the size of an in-memory file.
+ *
+ * @param path The path of the file.
+ * @param size Receives the size in bytes.
+ * @return True if the file exists, otherwise false.
+ */
+static bool sizeMemoryFile(const char* path, size_t* size) {
+	MemoryFile file = findMemoryFile(path);
+	if (!file) {
+		return false;
+	}
+	*size = file->size();
+	return true;
+}
+
+/**
+ * @brief Replaces an in-memory file with a copy of the given contents.
+ *
+ * @param path The path of the file.
+ * @param data The new contents.
+ * @param size The size of the new contents in bytes.
+ * @return True on success, false if memory allocation failed.
+ */
+static bool replaceMemoryFile(const char* path, const void* data, size_t size) {
+	try {
+		MemoryFile file = std::make_shared<const std::vector<char> >((const char*)data, (const char*)data + size);
+		std::lock_guard<std::mutex> guard(memoryFilesMutex);
+		memoryFiles[path] = file;
+		return true;
+	}
+	catch (...) {
+		return false;
+	}
+}
+
+/**
+ * @brief Overwrites a byte range of an in-memory file.
+ *
+ * The patched contents are a new copy, so views opened before the patch keep the old contents.
+ *
+ * @param path The path of the file.
+ * @param offset The position of the first byte to write; at most the size of the file.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
+ * @return True if the file exists and was patched, otherwise false.
+ */
+static bool patchMemoryFile(const char* path, size_t offset, const void* data, size_t size) {
+	try {
+		std::lock_guard<std::mutex> guard(memoryFilesMutex);
+		std::unordered_map<std::string, MemoryFile>::iterator found = memoryFiles.find(path);
+		if (found == memoryFiles.end() || offset > found->second->size()) {
+			return false;
+		}
+		std::shared_ptr<std::vector<char> > file = std::make_shared<std::vector<char> >(*found->second);
+		if (file->size() < offset + size) {
+			file->resize(offset + size);
+		}
+		if (size > 0) {
+			memcpy(file->data() + offset, data, size);
+		}
+		found->second = file;
+		return true;
+	}
+	catch (...) {
+		return false;
+	}
+}
+
+/**
+ * @brief Deletes an in-memory file.
+ *
+ * @param path The path of the file.
+ * @return True if the file existed, otherwise false.
+ */
+static bool removeMemoryFile(const char* path) {
+	std::lock_guard<std::mutex> guard(memoryFilesMutex);
+	return memoryFiles.erase(path) > 0;
+}
+
+const IngredientStorage ingredientStdioStorage = {
+	"stdio", openStdioView, closeStdioView, readDiskFile, sizeDiskFile, replaceDiskFile, patchDiskFile, removeDiskFile
+};
+
+const IngredientStorage ingredientMmapStorage = {
+	"mmap", openMmapView, closeMmapView, readDiskFile, sizeDiskFile, replaceDiskFile, patchDiskFile, removeDiskFile
+};
+
+const IngredientStorage ingredientMemoryStorage = {
+	"memory", openMemoryView, closeMemoryView, readMemoryFile, sizeMemoryFile, replaceMemoryFile, patchMemoryFile, removeMemoryFile
+};
+
+/**
+ * @brief Returns the backend used for ingredient files.
+ *
+ * @return The current backend; ingredientMmapStorage unless another one was set.
+ */
+const IngredientStorage* getIngredientStorage() {
+	return currentStorage.load();
+}
+
+/**
+ * @brief Selects the backend used for ingredient files from now on.
+ *
+ * Views that are already open keep working, because they are closed by the backend that opened them.
+ *
+ * @param storage The backend to use, or NULL to restore the default.
+ */
+void setIngredientStorage(const IngredientStorage* storage) {
+	currentStorage.store(storage != NULL ? storage : &ingredientMmapStorage);
+}
+
+/**
+ * @brief Opens a view of a file through the current backend.
+ *
+ * @param path The path of the file.
+ * @param view The view to initialize.
+ * @return True if the file was opened, otherwise false.
+ */
+bool openIngredientStorageView(const char* path, IngredientStorageView* view) {
+	const IngredientStorage* storage = getIngredientStorage();
+	memset(view, 0, sizeof(*view));
+	if (!storage->openView(path, view)) {
+		memset(view, 0, sizeof(*view));
+		return false;
+	}
+	view->storage = storage;
+	return true;
+}
+
+/**
+ * @brief Releases a view and resets it.
+ *
+ * @param view The view to close; closing a view that is not open does nothing.
+ */
+void closeIngredientStorageView(IngredientStorageView* view) {
+	if (view->storage != NULL) {
+		view->storage->closeView(view);
+	}
+	memset(view, 0, sizeof(*view));
+}
+
+/**
+ * @brief Deletes every file of the in-memory backend.
+ */
+void clearIngredientMemoryStorage() {
+	std::lock_guard<std::mutex> guard(memoryFilesMutex);
+	memoryFiles.clear();
+}
@@ -0,0 +1,391 @@
+/**
+ * @file ingredienttrie.cpp
+ * @brief Implementation of the ingredient name trie, including edge splitting on insert, node
+ * merging on removal and prefix completion.
+ */
+#include "../header/ingredienttrie.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Creates a trie node with a copy of the given label.
+ *
+ * @param label The label characters.
+ * @param labelLength The number of label characters.
+ * @return The new node, or NULL if memory allocation failed.
+ */
+static IngredientTrieNode* createIngredientTrieNode(const char* label, int labelLength) {
+	IngredientTrieNode* node = (IngredientTrieNode*)calloc(1, sizeof(IngredientTrieNode));
+	if (node == NULL) {
+		return NULL;
+	}
+	node->label = (char*)malloc(labelLength > 0 ? labelLength : 1);
+	if (node->label == NULL) {
+		free(node);
+		return NULL;
+	}
+	memcpy(node->label, label, labelLength);
+	node->labelLength = labelLength;
+	return node;
+}
+
+/**
+ * @brief Frees a trie node together with its subtree.
+ *
+ * @param node The node to free.
+ */
+static void freeIngredientTrieNode(IngredientTrieNode* node) {
+	for (int i = 0; i < node->childCount; i++) {
+		freeIngredientTrieNode(node->children[i]);
+	}
+	free(node->children);
+	free(node->ids);
+	free(node->label);
+	free(node);
+}
+
+/**
+ * @brief Copies a name in lower case so completion ignores case.
+ *
+ * @param name The name to fold.
+ * @param key Receives the folded name.
+ * @return The length of the folded name.
+ */
+static int foldIngredientTrieKey(const char* name, char key[sizeof(((Ingredient*)0)->name)]) {
+	int length = 0;
+	while (name[length] != '\0' && length < (int)sizeof(((Ingredient*)0)->name) - 1) {
+		key[length] = (char)tolower((unsigned char)name[length]);
+		length++;
+	}
+	key[length] = '\0';
+	return length;
+}
+
+/**
+ * @brief Finds the child whose label starts with a byte.
+ *
+ * @param node The parent node.
+ * @param c The first byte of the label.
+ * @param index Receives the position of the child, or the position where it would be inserted.
+ * @return The child, or NULL if there is none.
+ */
+static IngredientTrieNode* findIngredientTrieChild(const IngredientTrieNode* node, char c, int* index) {
+	int low = 0;
+	int high = node->childCount;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if ((unsigned char)node->children[mid]->label[0] < (unsigned char)c) {
+			low = mid + 1;
+		}
+		else {
+			high = mid;
+		}
+	}
+	*index = low;
+	if (low < node->childCount && node->children[low]->label[0] == c) {
+		return node->children[low];
+	}
+	return NULL;
+}
+
+/**
+ * @brief Inserts a child at a position of the sorted child array.
+ *
+ * @param node The parent node.
+ * @param index The position to insert at.
+ * @param child The child to insert.
+ * @return True on success, false if memory allocation failed.
+ */
+static bool insertIngredientTrieChild(IngredientTrieNode* node, int index, IngredientTrieNode* child) {
+	IngredientTrieNode** children = (IngredientTrieNode**)realloc(node->children, (node->childCount + 1) * sizeof(IngredientTrieNode*));
+	if (children == NULL) {
+		return false;
+	}
+	memmove(children + index + 1, children + index, (node->childCount - index) * sizeof(IngredientTrieNode*));
+	children[index] = child;
+	node->children = children;
+	node->childCount++;
+	return true;
+}
+
+/**
+ * @brief Records that an ingredient name ends at a node.
+ *
+ * @param node The node.
+ * @param id The ingredient ID.
+ * @return True on success, false if memory allocation failed.
+ */
+static bool addIngredientTrieId(IngredientTrieNode* node, int id) {
+	int* ids = (int*)realloc(node->ids, (node->idCount + 1) * sizeof(int));
+	if (ids == NULL) {
+		return false;
+	}
+	ids[node->idCount++] = id;
+	node->ids = ids;
+	return true;
+}
+
+/**
+ * @brief Merges a node that ends no name into its only child.
+ *
+ * @param node The node; it takes over the label suffix, children and IDs of the child.
+ */
+static void mergeIngredientTrieChild(IngredientTrieNode* node) {
+	IngredientTrieNode* child = node->children[0];
+	char* label = (char*)realloc(node->label, node->labelLength + child->labelLength);
+	if (label == NULL) {
+		// The tree stays correct without the merge, it only keeps one extra node
+		return;
+	}
+	memcpy(label + node->labelLength, child->label, child->labelLength);
+	node->label = label;
+	node->labelLength += child->labelLength;
+
+	free(node->children);
+	free(node->ids);
+	node->children = child->children;
+	node->childCount = child->childCount;
+	node->ids = child->ids;
+	node->idCount = child->idCount;
+	free(child->label);
+	free(child);
+}
+
+/**
+ * @brief Initializes an empty ingredient trie.
+ *
+ * @param trie The trie to initialize.
+ * @return True on success, false if memory allocation failed.
+ */
+bool initIngredientTrie(IngredientTrie* trie) {
+	trie->root = createIngredientTrieNode("", 0);
+	trie->count = 0;
+	return trie->root != NULL;
+}
+
+/**
+ * @brief Frees every node of an ingredient trie.
+ *
+ * @param trie The trie to free.
+ */
+void freeIngredientTrie(IngredientTrie* trie) {
+	if (trie->root != NULL) {
+		freeIngredientTrieNode(trie->root);
+	}
+	trie->root = NULL;
+	trie->count = 0;
+}
+
+/**
+ * @brief Adds an ingredient name to a trie.
+ *
+ * An edge that only partly matches the name is split at the first differing character.
+ *
+ * @param trie The trie to add to.
+ * @param name The ingredient name.
+ * @param id The ingredient ID.
+ * @return True on success, false if memory allocation failed.
+ */
+bool insertIngredientTrie(IngredientTrie* trie, const char* name, int id) {
+	char key[sizeof(((Ingredient*)0)->name)];
+	int length = foldIngredientTrieKey(name, key);
+	IngredientTrieNode* node = trie->root;
+	int position = 0;
+
+	while (position < length) {
+		int index;
+		IngredientTrieNode* child = findIngredientTrieChild(node, key[position], &index);
+		if (child == NULL) {
+			IngredientTrieNode* leaf = createIngredientTrieNode(key + position, length - position);
+			if (leaf == NULL || !addIngredientTrieId(leaf, id) || !insertIngredientTrieChild(node, index, leaf)) {
+				if (leaf != NULL) {
+					freeIngredientTrieNode(leaf);
+				}
+				return false;
+			}
+			trie->count++;
+			return true;
+		}
+
+		int common = 1;
+		while (common < child->labelLength && position + common < length && child->label[common] == key[position + common]) {
+			common++;
+		}
+		if (common < child->labelLength) {
+			IngredientTrieNode* middle = createIngredientTrieNode(child->label, common);
+			if (middle == NULL || !insertIngredientTrieChild(middle, 0, child)) {
+				if (middle != NULL) {
+					free(middle->label);
+					free(middle);
+				}
+				return false;
+			}
+			memmove(child->label, child->label + common, child->labelLength - common);
+			child->labelLength -= common;
+			node->children[index] = middle;
+			child = middle;
+		}
+		node = child;
+		position += common;
+	}
+
+	if (!addIngredientTrieId(node, id)) {
+		return false;
+	}
+	trie->count++;
+	return true;
+}
+
+/**
+ * @brief Removes an ingredient name from a trie.
+ *
+ * Nodes left without names are removed and single-child chains are merged back into one edge.
+ *
+ * @param trie The trie to remove from.
+ * @param name The ingredient name as it was inserted.
+ * @param id The ingredient ID.
+ * @return True if the name was found and removed, false otherwise.
+ */
+bool removeIngredientTrie(IngredientTrie* trie, const char* name, int id) {
+	char key[sizeof(((Ingredient*)0)->name)];
+	int length = foldIngredientTrieKey(name, key);
+	IngredientTrieNode* parent = NULL;
+	int parentIndex = 0;
+	IngredientTrieNode* node = trie->root;
+	int position = 0;
+
+	while (position < length) {
+		int index;
+		IngredientTrieNode* child = findIngredientTrieChild(node, key[position], &index);
+		if (child == NULL || child->labelLength > length - position || memcmp(child->label, key + position, child->labelLength) != 0) {
+			return false;
+		}
+		parent = node;
+		parentIndex = index;
+		node = child;
+		position += child->labelLength;
+	}
+
+	int slot = 0;
+	while (slot < node->idCount && node->ids[slot] != id) {
+		slot++;
+	}
+	if (slot == node->idCount) {
+		return false;
+	}
+	node->ids[slot] = node->ids[--node->idCount];
+	trie->count--;
+
+	if (parent == NULL || node->idCount > 0) {
+		return true;
+	}
+	if (node->childCount == 1) {
+		mergeIngredientTrieChild(node);
+		return true;
+	}
+	if (node->childCount == 0) {
+		freeIngredientTrieNode(node);
+		memmove(parent->children + parentIndex, parent->children + parentIndex + 1, (parent->childCount - parentIndex - 1) * sizeof(IngredientTrieNode*));
+		parent->childCount--;
+		if (parent != trie->root && parent->idCount == 0 && parent->childCount == 1) {
+			mergeIngredientTrieChild(parent);
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Collects the IDs of a subtree in alphabetical order.
+ *
+ * @param node The subtree root.
+ * @param ids Receives the IDs.
+ * @param found The number of IDs already collected.
+ * @param maxResults The capacity of the IDs array.
+ * @return The number of IDs collected so far.
+ */
+static int collectIngredientTrieIds(const IngredientTrieNode* node, int* ids, int found, int maxResults) {
+	for (int i = 0; i < node->idCount && found < maxResults; i++) {
+		ids[found++] = node->ids[i];
+	}
+	for (int i = 0; i < node->childCount && found < maxResults; i++) {
+		found = collectIngredientTrieIds(node->children[i], ids, found, maxResults);
+	}
+	return found;
+}
+
+/**
+ * @brief Completes a prefix to the first ingredient names that start with it.
+ *
+ * @param trie The trie to search.
+ * @param prefix The typed prefix; case is ignored.
+ * @param ids Receives the IDs of the completions in alphabetical order of their names.
+ * @param maxResults The capacity of the IDs array.
+ * @return The number of IDs stored.
+ */
+int completeIngredientTrie(const IngredientTrie* trie, const char* prefix, int* ids, int maxResults) {
+	char key[sizeof(((Ingredient*)0)->name)];
+	int length = foldIngredientTrieKey(prefix, key);
+	const IngredientTrieNode* node = trie->root;
+	int position = 0;
+
+	while (position < length) {
+		int index;
+		const IngredientTrieNode* child = findIngredientTrieChild(node, key[position], &index);
+		if (child == NULL) {
+			return 0;
+		}
+		int compare = child->labelLength < length - position ? child->labelLength : length - position;
+		if (memcmp(child->label, key + position, compare) != 0) {
+			return 0;
+		}
+		node = child;
+		position += compare;
+	}
+	return collectIngredientTrieIds(node, ids, 0, maxResults);
+}
+
+/**
+ * @brief Completes a prefix to the ingredients of a catalog whose name starts with it.
+ *
+ * Without a name trie the list is walked and every name is compared instead.
+ *
+ * @param catalog The catalog to search.
+ * @param prefix The typed prefix; case is ignored.
+ * @param results Receives the matching ingredients.
+ * @param maxResults The capacity of the results array.
+ * @return The number of ingredients stored in results.
+ */
+int completeCatalogIngredientNames(const IngredientCatalog* catalog, const char* prefix, Ingredient** results, int maxResults) {
+	if (maxResults <= 0) {
+		return 0;
+	}
+	if (catalog->trie == NULL) {
+		char key[sizeof(((Ingredient*)0)->name)];
+		char name[sizeof(((Ingredient*)0)->name)];
+		int length = foldIngredientTrieKey(prefix, key);
+		int found = 0;
+		for (Ingredient* current = catalog->head; current != NULL && found < maxResults; current = current->next) {
+			foldIngredientTrieKey(current->name, name);
+			if (strncmp(name, key, length) == 0) {
+				results[found++] = current;
+			}
+		}
+		return found;
+	}
+
+	int* ids = (int*)malloc(maxResults * sizeof(int));
+	if (ids == NULL) {
+		return 0;
+	}
+	int count = completeIngredientTrie(catalog->trie, prefix, ids, maxResults);
+	int found = 0;
+	for (int i = 0; i < count; i++) {
+		Ingredient* ingredient = findIngredientById(catalog, ids[i]);
+		if (ingredient != NULL) {
+			results[found++] = ingredient;
+		}
+	}
+	free(ids);
+	return found;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file memoryarena.h
+ * @brief Header file for the memory arena, a block-based bump allocator that hands out memory
+ * for linked structures and releases all of it at once.
+ */
+#ifndef MEMORYARENA_H
+#define MEMORYARENA_H
+
+#include <stddef.h>
+
+/**
+ * @brief Default number of usable bytes in each arena block.
+ */
+#define MEMORY_ARENA_DEFAULT_BLOCK_SIZE 65536
+
+/**
+ * @brief Alignment of every allocation handed out by an arena.
+ */
+#define MEMORY_ARENA_ALIGNMENT 16
+
+/**
+ * @brief Memory arena block struct definition.
+ *
+ * The usable bytes of the block follow the header directly.
+ */
+typedef struct MemoryArenaBlock {
+    struct MemoryArenaBlock* next; /**< Previously filled block, NULL for the first block. */
+    size_t size; /**< Number of usable bytes in the block. */
+    size_t used; /**< Number of bytes already handed out. */
+} MemoryArenaBlock;
+
+/**
+ * @brief Memory arena struct definition.
+ *
+ * Allocations are carved from the current block until it is full, so a structure of n nodes
+ * costs about n / (blockSize / nodeSize) calls to malloc instead of n, and is released with a
+ * single call to freeMemoryArena.
+ */
+typedef struct MemoryArena {
+    MemoryArenaBlock* blocks; /**< Block currently being filled, linked to the older blocks. */
+    size_t blockSize; /**< Number of usable bytes in each new block. */
+    size_t allocationCount; /**< Number of allocations handed out since the arena was last emptied. */
+    size_t blockCount; /**< Number of blocks the arena currently holds. */
+} MemoryArena;
+
+// Memory arena functions
+void initMemoryArena(MemoryArena* arena, size_t blockSize);
+void* allocateFromMemoryArena(MemoryArena* arena, size_t size);
+void resetMemoryArena(MemoryArena* arena);
+void freeMemoryArena(MemoryArena* arena);
+void mergeMemoryArena(MemoryArena* arena, MemoryArena* other);
+
+// Functions for structures that may live either in an arena or on the heap
+void* allocateArenaNode(MemoryArena* arena, size_t size);
+void releaseArenaNode(MemoryArena* arena, void* node);
+
+#endif // MEMORYARENA_H
@@ -0,0 +1,197 @@
+/**
+ * @file memoryarena.cpp
+ * @brief Implementation of the memory arena, including block allocation, aligned bump allocation,
+ * merging of arenas and release of every block at once.
+ */
+#include "../header/memoryarena.h"
+#include <stdlib.h>
+
+/**
+ * @brief Size of a block header rounded up so the usable bytes start aligned.
+ */
+#define MEMORY_ARENA_HEADER_SIZE ((sizeof(MemoryArenaBlock) + MEMORY_ARENA_ALIGNMENT - 1) & ~(size_t)(MEMORY_ARENA_ALIGNMENT - 1))
+
+/**
+ * @brief Returns the first usable byte of a block.
+ *
+ * @param block The block.
+ * @return A pointer to the usable bytes that follow the block header.
+ */
+static unsigned char* getMemoryArenaBlockData(MemoryArenaBlock* block) {
+	return (unsigned char*)block + MEMORY_ARENA_HEADER_SIZE;
+}
+
+/**
+ * @brief Allocates a new block with the given number of usable bytes.
+ *
+ * @param size The number of usable bytes.
+ * @return The new block, or NULL if memory allocation failed.
+ */
+static MemoryArenaBlock* createMemoryArenaBlock(size_t size) {
+	MemoryArenaBlock* block = (MemoryArenaBlock*)malloc(MEMORY_ARENA_HEADER_SIZE + size);
+	if (block == NULL) {
+		return NULL;
+	}
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
+
+/**
+ * @brief Initializes an empty arena; no memory is allocated until the first allocation.
+ *
+ * @param arena The arena to initialize.
+ * @param blockSize The number of usable bytes in each block, or 0 for MEMORY_ARENA_DEFAULT_BLOCK_SIZE.
+ */
+void initMemoryArena(MemoryArena* arena, size_t blockSize) {
+	arena->blocks = NULL;
+	arena->blockSize = blockSize > 0 ? blockSize : MEMORY_ARENA_DEFAULT_BLOCK_SIZE;
+	arena->allocationCount = 0;
+	arena->blockCount = 0;
+}
+
+/**
+ * @brief Allocates memory from an arena.
+ *
+ * The memory stays valid until the arena is reset or freed and cannot be freed on its own.
+ * Requests larger than the block size get a block of their own.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer aligned to MEMORY_ARENA_ALIGNMENT, or NULL if memory allocation failed.
+ */
+void* allocateFromMemoryArena(MemoryArena* arena, size_t size) {
+	size = (size + MEMORY_ARENA_ALIGNMENT - 1) & ~(size_t)(MEMORY_ARENA_ALIGNMENT - 1);
+	if (size == 0) {
+		size = MEMORY_ARENA_ALIGNMENT;
+	}
+
+	MemoryArenaBlock* block = arena->blocks;
+	if (block == NULL || block->size - block->used < size) {
+		if (size > arena->blockSize && block != NULL) {
+			// Oversized requests are kept behind the current block so it can still be filled
+			MemoryArenaBlock* large = createMemoryArenaBlock(size);
+			if (large == NULL) {
+				return NULL;
+			}
+			large->used = size;
+			large->next = block->next;
+			block->next = large;
+			arena->blockCount++;
+			arena->allocationCount++;
+			return getMemoryArenaBlockData(large);
+		}
+
+		block = createMemoryArenaBlock(size > arena->blockSize ? size : arena->blockSize);
+		if (block == NULL) {
+			return NULL;
+		}
+		block->next = arena->blocks;
+		arena->blocks = block;
+		arena->blockCount++;
+	}
+
+	void* memory = getMemoryArenaBlockData(block) + block->used;
+	block->used += size;
+	arena->allocationCount++;
+	return memory;
+}
+
+/**
+ * @brief Releases every allocation of an arena but keeps its current block for reuse.
+ *
+ * @param arena The arena to reset.
+ */
+void resetMemoryArena(MemoryArena* arena) {
+	if (arena->blocks == NULL) {
+		return;
+	}
+
+	MemoryArenaBlock* current = arena->blocks->next;
+	while (current != NULL) {
+		MemoryArenaBlock* temp = current;
+		current = current->next;
+		free(temp);
+	}
+	arena->blocks->next = NULL;
+	arena->blocks->used = 0;
+	arena->allocationCount = 0;
+	arena->blockCount = 1;
+}
+
+/**
+ * @brief Frees every block of an arena together with all memory allocated from it.
+ *
+ * @param arena The arena to free; it is empty afterwards and can be used again.
+ */
+void freeMemoryArena(MemoryArena* arena) {
+	MemoryArenaBlock* current = arena->blocks;
+	while (current != NULL) {
+		MemoryArenaBlock* temp = current;
+		current = current->next;
+		free(temp);
+	}
+	arena->blocks = NULL;
+	arena->allocationCount = 0;
+	arena->blockCount = 0;
+}
+
+/**
+ * @brief Moves every block of one arena into another, so memory allocated from both is released
+ * together.
+ *
+ * The blocks are linked behind the current block of the target, which keeps being filled. This
+ * lets threads fill arenas of their own and hand the results to one owner without copying.
+ *
+ * @param arena The arena receiving the blocks.
+ * @param other The arena giving up its blocks; it is empty afterwards and can be used again.
+ */
+void mergeMemoryArena(MemoryArena* arena, MemoryArena* other) {
+	if (other->blocks != NULL) {
+		if (arena->blocks == NULL) {
+			arena->blocks = other->blocks;
+		}
+		else {
+			MemoryArenaBlock* last = other->blocks;
+			while (last->next != NULL) {
+				last = last->next;
+			}
+			last->next = arena->blocks->next;
+			arena->blocks->next = other->blocks;
+		}
+	}
+	arena->allocationCount += other->allocationCount;
+	arena->blockCount += other->blockCount;
+	other->blocks = NULL;
+	other->allocationCount = 0;
+	other->blockCount = 0;
+}
+
+/**
+ * @brief Allocates a node from an arena, or from the heap when no arena is given.
+ *
+ * @param arena The arena to allocate from, or NULL to use malloc.
+ * @param size The size of the node in bytes.
+ * @return A pointer to the node, or NULL if memory allocation failed.
+ */
+void* allocateArenaNode(MemoryArena* arena, size_t size) {
+	if (arena == NULL) {
+		return malloc(size);
+	}
+	return allocateFromMemoryArena(arena, size);
+}
+
+/**
+ * @brief Releases a node obtained from allocateArenaNode.
+ *
+ * Nodes of an arena are only released together with the arena, so this frees heap nodes only.
+ *
+ * @param arena The arena the node was allocated from, or NULL if it came from malloc.
+ * @param node The node to release.
+ */
+void releaseArenaNode(MemoryArena* arena, void* node) {
+	if (arena == NULL) {
+		free(node);
+	}
+}
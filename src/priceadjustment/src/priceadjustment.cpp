@@ -3,11 +3,16 @@
  * @brief This file contains functions to adjust and reset ingredient prices using different hash table search techniques.
  */
 #include "../../ingredientmanagement/header/ingredientmanagement.h"
+#include "../../ingredientmanagement/header/ingredientfile.h"
+#include "../../ingredientmanagement/header/ingredientlog.h"
+#include "../../ingredientmanagement/header/ingredientcatalog.h"
+#include "../../ingredientmanagement/header/ingredientpriceindex.h"
 #include "../../userauthentication/header/userauthentication.h"
 #include "../header/priceadjustment.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
  /**
   * @brief Converts a doubly linked list of ingredients to an array.
   * @param pathFileIngredients Path to the ingredient file.
@@ -15,7 +20,48 @@
   * @return Total number of ingredients or -1 if there was an error.
   */
 int ConvertDoubleLinkToArray(const char* pathFileIngredients, Ingredient** baseIngredients) {
+	// Versioned files without logged mutations are copied straight from the mapping into a single
+	// allocation; otherwise the log has to be replayed, which the list loader does
+	IngredientMap map;
+	lockIngredientFiles();
+	if (getIngredientLogLength(pathFileIngredients) == 0 && openIngredientMap(pathFileIngredients, &map)) {
+		int count = map.count - map.deletedCount;
+		if (count <= 0) {
+			closeIngredientMap(&map);
+			unlockIngredientFiles();
+			printf("Ingredients could not be loaded\n");
+			enterToContinue();
+			return -1;
+		}
+
+		*baseIngredients = (Ingredient*)malloc(count * sizeof(Ingredient));
+		if (*baseIngredients == NULL) {
+			closeIngredientMap(&map);
+			unlockIngredientFiles();
+			printf("Memory allocation failed\n");
+			enterToContinue();
+			return -1;
+		}
+		int copied = 0;
+		for (int i = 0; i < map.count && copied < count; i++) {
+			const IngredientRecord* record = getMappedIngredient(&map, i);
+			if (record->flags & INGREDIENT_RECORD_DELETED) {
+				continue;
+			}
+			Ingredient* ingredient = &(*baseIngredients)[copied++];
+			ingredient->id = record->id;
+			strncpy(ingredient->name, getMappedIngredientName(&map, record), INGREDIENT_NAME_SIZE - 1);
+			ingredient->name[INGREDIENT_NAME_SIZE - 1] = '\0';
+			ingredient->price = record->price;
+			ingredient->prev = ingredient->next = ingredient->npx = NULL;
+		}
+		closeIngredientMap(&map);
+		unlockIngredientFiles();
+		return copied;
+	}
+
 	Ingredient* ingredients = loadIngredientsFromFile(pathFileIngredients);
+	unlockIngredientFiles();
 	if (ingredients == NULL) {
 		printf("Ingredients could not be loaded\n");
 		enterToContinue();
@@ -33,48 +79,79 @@ int ConvertDoubleLinkToArray(const char* pathFileIngredients, Ingredient** baseI
 	// Allocate memory for the ingredients array
 	*baseIngredients = (Ingredient*)malloc(count * sizeof(Ingredient));
 
-	// Copy ingredients from linked list to array
+	// Copy ingredients from linked list to array, or free the list if there is no array
 	current = ingredients;
+	if (*baseIngredients == NULL) {
+		while (current != NULL) {
+			Ingredient* next = current->next;
+			free(current);
+			current = next;
+		}
+		printf("Memory allocation failed\n");
+		enterToContinue();
+		return -1;
+	}
 	for (int i = 0; i < count; i++) {
 		(*baseIngredients)[i] = *current;
-		current = current->next;
+		(*baseIngredients)[i].prev = (*baseIngredients)[i].next = (*baseIngredients)[i].npx = NULL;
+		Ingredient* next = current->next;
+		free(current);
+		current = next;
 	}
 
 	return count;
 }
+
 /**
- * @brief Prints the ingredients loaded from a file to the console.
- * @param pathFileIngredients Path to the ingredient file.
+ * @brief Prints the ingredients of a catalog in descending order of price.
+ * @param catalog Catalog whose price index is enabled.
  * @return Total number of ingredients printed.
  */
- /**
-  * @brief Prints the ingredients loaded from a file to the console in descending order of price.
-  * @param pathFileIngredients Path to the ingredient file.
-  * @return Total number of ingredients printed.
-  */
-int PrintIngredientsToConsole(const char* pathFileIngredients) {
-	// Find the total number of ingredients
-	Ingredient* ingredientsArray;
-	int count = ConvertDoubleLinkToArray(pathFileIngredients, &ingredientsArray);
-
-	if (count == -1) {
-		return 0;
-	}
-
-	// Sort ingredients using Max Heap to display them in descending order of price
-	sortIngredientsMaxHeap(ingredientsArray, count);
-
-	// Write the ingredients to the console
+static int printIngredientsByPrice(const IngredientCatalog* catalog) {
+	// Walk the bottom level of the price index backwards, from the most expensive ingredient
 	printf("Ingredients (sorted by price in descending order):\n");
-	for (int i = 0; i < count; i++) {
+	int count = 0;
+	for (const IngredientPriceNode* node = catalog->prices->last; node != NULL; node = node->prev) {
 		printf("+--------------------------------------+\n");
-		printf("| Ingredient ID: %-5d                   \n", ingredientsArray[i].id);
-		printf("| Name         : %-20s |\n", ingredientsArray[i].name);
-		printf("| Price        : $%-7.2f           \n", ingredientsArray[i].price);
+		printf("| Ingredient ID: %-5d                   \n", node->ingredient->id);
+		printf("| Name         : %-20s |\n", node->ingredient->name);
+		printf("| Price        : $%-7.2f           \n", node->ingredient->price);
 		printf("+--------------------------------------+\n");
+		count++;
 	}
+	return count;
+}
 
-	free(ingredientsArray);
+/**
+ * @brief Loads the ingredients of a file into a catalog with a price index.
+ * @param pathFileIngredients Path to the ingredient file.
+ * @param catalog Catalog to initialize.
+ * @return True if at least one ingredient was loaded and indexed, otherwise false.
+ */
+static bool loadIngredientsByPrice(const char* pathFileIngredients, IngredientCatalog* catalog) {
+	loadIngredientCatalog(catalog, pathFileIngredients);
+	if (catalog->head == NULL || !enableIngredientPriceIndex(catalog)) {
+		freeIngredientCatalog(catalog);
+		printf("Ingredients could not be loaded\n");
+		enterToContinue();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Prints the ingredients loaded from a file to the console in descending order of price.
+ * @param pathFileIngredients Path to the ingredient file.
+ * @return Total number of ingredients printed.
+ */
+int PrintIngredientsToConsole(const char* pathFileIngredients) {
+	IngredientCatalog catalog;
+	if (!loadIngredientsByPrice(pathFileIngredients, &catalog)) {
+		return 0;
+	}
+
+	int count = printIngredientsByPrice(&catalog);
+	freeIngredientCatalog(&catalog);
 	return count;
 }
 /**
@@ -304,10 +381,14 @@ Ingredient* bucketSearch(Bucket* buckets, int bucketSize, int ingredientId, floa
  */
 int adjustIngredientPrice(const char* pathFileIngredients) {
 	clearScreen();
+
+	// Hold the files from load to save, so no logged mutation lands in between and gets lost
+	lockIngredientFiles();
 	Ingredient* ingredients;
 	int totalIngredient = ConvertDoubleLinkToArray(pathFileIngredients, &ingredients);
 
 	if (totalIngredient == -1) {
+		unlockIngredientFiles();
 		return 0;
 	}
 
@@ -458,23 +539,27 @@ int adjustIngredientPrice(const char* pathFileIngredients) {
 
 	jump:
 
-		// Save the updated ingredients to file
-		FILE* file = fopen(pathFileIngredients, "wb");
-		if (!file) {
+		// Link the array into a list and save it through the ingredient storage
+		for (int i = 0; i < totalIngredient; i++) {
+			ingredients[i].prev = i > 0 ? &ingredients[i - 1] : NULL;
+			ingredients[i].next = i + 1 < totalIngredient ? &ingredients[i + 1] : NULL;
+		}
+		if (!saveIngredientsToFile(ingredients, pathFileIngredients)) {
 			printf("File could not be opened");
 			getchar();
 			enterToContinue();
 			break;
 		}
-		fwrite(ingredients, sizeof(Ingredient), totalIngredient, file);
-		fclose(file);
 
+		unlockIngredientFiles();
 		printf("The ingredient was successfully updated\n");
 		enterToContinue();
+		free(ingredients);
 		return 1;
 	}
 
 	// Free allocated memory
+	unlockIngredientFiles();
 	free(ingredients);
 	return 0;
 }
@@ -487,15 +572,13 @@ int adjustIngredientPrice(const char* pathFileIngredients) {
  */
 int resetIngredientPrice(const char* pathFileIngredients) {
 	clearScreen();
-	Ingredient* ingredients;
-	int totalIngredient = ConvertDoubleLinkToArray(pathFileIngredients, &ingredients);
-
-	if (totalIngredient == -1) {
+	IngredientCatalog catalog;
+	if (!loadIngredientsByPrice(pathFileIngredients, &catalog)) {
 		return 0;
 	}
 
 	// Show the current prices of all ingredients
-	PrintIngredientsToConsole(pathFileIngredients);
+	printIngredientsByPrice(&catalog);
 
 	//Choose one of them to reset the price
 	int ingredientId;
@@ -503,20 +586,30 @@ int resetIngredientPrice(const char* pathFileIngredients) {
 	scanf("%d", &ingredientId);
 	getchar();
 
-	//Find the ingredient and reset the price
-	for (int i = 0; i < totalIngredient; i++) { if (ingredients[i].id == ingredientId) { ingredients[i].price = 0.0; break; } }
+	//Find the ingredient and reset the price, moving it to the front of the price index
+	Ingredient* ingredient = findIngredientById(&catalog, ingredientId);
+	if (ingredient != NULL && !setCatalogIngredientPrice(&catalog, ingredient, 0.0f)) {
+		printf("Memory allocation failed");
+		getchar();
+		enterToContinue();
+		freeIngredientCatalog(&catalog);
+		return 0;
+	}
 
 	// Save the updated ingredients to file
-	FILE* file = fopen(pathFileIngredients, "wb");
-	if (!file) { printf("File could not be opened"); getchar(); enterToContinue(); return 0; }
-	fwrite(ingredients, sizeof(Ingredient), totalIngredient, file);
-	fclose(file);
+	if (!saveIngredientsToFile(catalog.head, pathFileIngredients)) {
+		printf("File could not be opened");
+		getchar();
+		enterToContinue();
+		freeIngredientCatalog(&catalog);
+		return 0;
+	}
 
 	printf("The ingredient price was successfully reset\n");
 	enterToContinue();
 
 	// Free allocated memory
-	free(ingredients);
+	freeIngredientCatalog(&catalog);
 	return 1;
 }
 
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h> // For uintptr_t
+#include "../../memoryarena/header/memoryarena.h"
 
  /**
   * @brief Maximum number of ingredients allowed per recipe.
@@ -26,6 +27,11 @@
     */
 #define MAX_RECIPES 100
 
+/**
+ * @brief Number of matching ingredient names listed when a typed name is ambiguous.
+ */
+#define RECIPE_INGREDIENT_COMPLETION_COUNT 5
+
     /**
      * @brief Recipe struct definition.
      */
@@ -78,6 +84,7 @@ typedef struct Graph {
     int time; /**< Timer for Tarjan's SCC algorithm. */
     int stack[MAX_RECIPES]; /**< Stack to store nodes. */
     int stackTop; /**< Top index of the stack. */
+    MemoryArena edgeArena; /**< Arena holding every adjacency list node. */
 } Graph;
 
 // Sparse Matrix Function Prototypes
@@ -104,6 +111,7 @@ int calculateRecipeCost(const char* pathFileRecipes, const char* pathFileIngredi
 
 // Graph Function Prototypes
 void initializeGraph(Graph* graph, int nodeCount);
+void freeGraph(Graph* graph);
 void addEdge(Graph* graph, int src, int dest);
 void push(Graph* graph, int node);
 int pop(Graph* graph);
@@ -0,0 +1,16 @@
+/**
+ * @file recipeexport.h
+ * @brief Header file for exporting recipes together with their computed costs as CSV or JSON.
+ */
+#ifndef RECIPEEXPORT_H
+#define RECIPEEXPORT_H
+
+#include "recipecosting.h"
+#include "../../ingredientmanagement/header/ingredientio.h"
+#include <stdbool.h>
+
+// Recipe export functions
+const char* getRecipeCategoryName(int category);
+bool exportRecipes(const char* pathFileRecipes, const char* pathFileIngredients, const char* filePath, ExportFormat format);
+
+#endif // RECIPEEXPORT_H
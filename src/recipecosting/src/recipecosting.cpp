@@ -3,9 +3,14 @@
  * @brief Implementation of recipe costing features including recipe creation, editing, costing, and ingredient analysis.
  */
 #include "../header/recipecosting.h"
+#include "../header/recipeexport.h"
 #include "../../userauthentication/header/userauthentication.h"
 #include "../../ingredientmanagement/header/ingredientmanagement.h"
+#include "../../ingredientmanagement/header/ingredientcatalog.h"
+#include "../../ingredientmanagement/header/ingredienttrie.h"
+#include "../../ingredientmanagement/header/ingredientpricetable.h"
 #include "../../priceadjustment/header/priceadjustment.h"
+#include <ctype.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,7 +24,7 @@
   * @brief Initializes the graph with the given number of nodes.
   *
   * This function initializes the adjacency list, visited nodes, discovery times,
-  * low links, and stack-related attributes of the graph.
+  * low links, stack-related attributes and the edge arena of the graph.
   *
   * @param graph Pointer to the Graph structure to be initialized.
   * @param nodeCount The total number of nodes in the graph.
@@ -34,20 +39,36 @@ void initializeGraph(Graph* graph, int nodeCount) {
 	}
 	graph->time = 0;
 	graph->stackTop = -1;
+	initMemoryArena(&graph->edgeArena, 0);
+}
+
+/**
+ * @brief Frees every edge of the graph at once.
+ *
+ * The adjacency lists must not be used afterwards until the graph is initialized again.
+ *
+ * @param graph Pointer to the Graph structure.
+ */
+void freeGraph(Graph* graph) {
+	freeMemoryArena(&graph->edgeArena);
 }
 
 /**
  * @brief Adds a directed edge from the source node to the destination node.
  *
  * This function creates a new edge from the source node to the destination node,
- * linking the recipes in the graph structure.
+ * linking the recipes in the graph structure. The edge is allocated from the edge
+ * arena of the graph and released by freeGraph.
  *
  * @param graph Pointer to the Graph structure.
  * @param src The source node index.
  * @param dest The destination node index.
  */
 void addEdge(Graph* graph, int src, int dest) {
-	Node* newNode = (Node*)malloc(sizeof(Node));
+	Node* newNode = (Node*)allocateFromMemoryArena(&graph->edgeArena, sizeof(Node));
+	if (newNode == NULL) {
+		return;
+	}
 	newNode->recipeIndex = dest;
 	newNode->next = graph->adjList[src];
 	graph->adjList[src] = newNode;
@@ -200,6 +221,7 @@ void analyzeSCC(const char* pathFileRecipes) {
 		}
 	}
 
+	freeGraph(&graph);
 	enterToContinue();
 }
 
@@ -221,9 +243,50 @@ struct BPlusTreeNode* createNode(int isLeaf) {
 	return newNode;
 }
 
+/**
+ * @brief Picks the ingredient a typed name refers to.
+ *
+ * A prefix that matches exactly one name, or that is a whole name ignoring case, selects that
+ * ingredient; otherwise the first matching names are listed so the user can type more.
+ *
+ * @param catalog The ingredient catalog with a name trie.
+ * @param prefix The typed name or the start of it.
+ * @return The selected ingredient, or NULL if the name is unknown or ambiguous.
+ */
+static Ingredient* selectIngredientByName(const IngredientCatalog* catalog, const char* prefix) {
+	Ingredient* matches[RECIPE_INGREDIENT_COMPLETION_COUNT + 1];
+	int matchCount = completeCatalogIngredientNames(catalog, prefix, matches, RECIPE_INGREDIENT_COMPLETION_COUNT + 1);
+	if (matchCount == 0) {
+		printf("No ingredient name starts with '%s'.\n", prefix);
+		return NULL;
+	}
+
+	// Completions come in alphabetical order, so a whole-name match is always the first one
+	const char* name = matches[0]->name;
+	int i = 0;
+	while (prefix[i] != '\0' && tolower((unsigned char)prefix[i]) == tolower((unsigned char)name[i])) {
+		i++;
+	}
+	if (matchCount == 1 || (prefix[i] == '\0' && name[i] == '\0')) {
+		return matches[0];
+	}
+
+	printf("Matching ingredients:\n");
+	for (int j = 0; j < matchCount && j < RECIPE_INGREDIENT_COMPLETION_COUNT; j++) {
+		printf("  ID: %d | Name: %s\n", matches[j]->id, matches[j]->name);
+	}
+	if (matchCount > RECIPE_INGREDIENT_COMPLETION_COUNT) {
+		printf("  ...\n");
+	}
+	printf("Type more of the name or enter an ID.\n");
+	return NULL;
+}
+
 /**
  * @brief Creates a new recipe by prompting the user for recipe details.
  *
+ * Ingredients can be picked by ID or by typing the start of their name.
+ *
  * @param pathFileIngredients File path to load the ingredients.
  * @param pathFileRecipes File path to save the created recipe.
  */
@@ -235,7 +298,7 @@ int createRecipe(const char* pathFileIngredients, const char* pathFileRecipes) {
 	int categoryChoice;
 	int selectedIngredients[MAX_INGREDIENTS];
 	int ingredientCount = 0;
-	char input[10];
+	char input[100];
 	int ingredientId;
 
 	// Step 1: Prompt for recipe name
@@ -265,11 +328,19 @@ int createRecipe(const char* pathFileIngredients, const char* pathFileRecipes) {
 	printf("Available Ingredients:\n");
 	PrintIngredientsToConsole(pathFileIngredients);
 
-	// Step 4: Select ingredients by ID
-	printf("Enter the ingredient ID to add to the recipe. Type 'done' when finished:\n");
+	// Step 4: Select ingredients by ID or name
+	MemoryArena ingredientArena;
+	initMemoryArena(&ingredientArena, 0);
+	IngredientCatalog ingredientCatalog;
+	loadIngredientCatalogInArena(&ingredientCatalog, pathFileIngredients, &ingredientArena);
+	enableIngredientNameTrie(&ingredientCatalog);
+
+	printf("Enter the ingredient ID or the start of its name to add to the recipe. Type 'done' when finished:\n");
 	while (ingredientCount < MAX_INGREDIENTS) {
-		printf("Ingredient ID (or 'done'): ");
-		fgets(input, sizeof(input), stdin);
+		printf("Ingredient ID or name (or 'done'): ");
+		if (fgets(input, sizeof(input), stdin) == NULL) {
+			break;
+		}
 		input[strcspn(input, "\n")] = '\0';
 
 		if (strcmp(input, "done") == 0) {
@@ -280,8 +351,16 @@ int createRecipe(const char* pathFileIngredients, const char* pathFileRecipes) {
 		if (ingredientId > 0) {
 			selectedIngredients[ingredientCount++] = ingredientId;
 		}
+		else if (input[0] != '\0' && !isdigit((unsigned char)input[0]) && input[0] != '-' && input[0] != '+') {
+			Ingredient* ingredient = selectIngredientByName(&ingredientCatalog, input);
+			if (ingredient != NULL) {
+				selectedIngredients[ingredientCount++] = ingredient->id;
+				printf("Added %s (ID: %d).\n", ingredient->name, ingredient->id);
+			}
+		}
 		else { printf("Invalid input or ingredient limit reached. Please enter a valid ingredient ID or 'done' to finish.\n"); }
 	}
+	freeIngredientCatalog(&ingredientCatalog);
 
 	// Step 5: Add the new recipe to the array
 	strcpy(recipes[recipeCount].name, recipeName);
@@ -305,7 +384,10 @@ int createRecipe(const char* pathFileIngredients, const char* pathFileRecipes) {
  */
 int editRecipe(const char* pathFileRecipes, const char* pathFileIngredients) {
 	Recipe recipes[MAX_RECIPES];
-	Ingredient* ingredientList = loadIngredientsFromFile(pathFileIngredients);
+	MemoryArena ingredientArena;
+	initMemoryArena(&ingredientArena, 0);
+	IngredientCatalog ingredientCatalog;
+	loadIngredientCatalogInArena(&ingredientCatalog, pathFileIngredients, &ingredientArena);
 	int recipeCount = loadRecipesFromFile(pathFileRecipes, recipes, MAX_RECIPES);
 
 	if (recipeCount == 0) {
@@ -372,13 +454,9 @@ int editRecipe(const char* pathFileRecipes, const char* pathFileIngredients) {
 		printf("Current Ingredients in Recipe:\n");
 		for (int i = 0; i < selectedRecipe->ingredientCount; i++) {
 			// Find ingredient name from ingredient list
-			Ingredient* current = ingredientList;
-			while (current != NULL) {
-				if (current->id == selectedRecipe->ingredients[i]) {
-					printf("ID: %d - %s\n", current->id, current->name);
-					break;
-				}
-				current = current->next;
+			Ingredient* current = findIngredientById(&ingredientCatalog, selectedRecipe->ingredients[i]);
+			if (current != NULL) {
+				printf("ID: %d - %s\n", current->id, current->name);
 			}
 		}
 		printf("\n");
@@ -416,13 +494,9 @@ int editRecipe(const char* pathFileRecipes, const char* pathFileIngredients) {
 			printf("Current ingredients in recipe:\n");
 			for (int i = 0; i < selectedRecipe->ingredientCount; i++) {
 				// Find and display ingredient name
-				Ingredient* current = ingredientList;
-				while (current != NULL) {
-					if (current->id == selectedRecipe->ingredients[i]) {
-						printf("ID: %d - %s\n", current->id, current->name);
-						break;
-					}
-					current = current->next;
+				Ingredient* current = findIngredientById(&ingredientCatalog, selectedRecipe->ingredients[i]);
+				if (current != NULL) {
+					printf("ID: %d - %s\n", current->id, current->name);
 				}
 			}
 			printf("\nEnter the ingredient ID to remove from the recipe. Type 'done' when finished:\n");
@@ -469,11 +543,7 @@ int editRecipe(const char* pathFileRecipes, const char* pathFileIngredients) {
 	}
 
 	// Free ingredient list memory
-	while (ingredientList != NULL) {
-		Ingredient* temp = ingredientList;
-		ingredientList = ingredientList->next;
-		free(temp);
-	}
+	freeIngredientCatalog(&ingredientCatalog);
 
 	// Step 4: Save updated recipes back to file
 	saveRecipesToFile(pathFileRecipes, recipes, recipeCount);
@@ -490,7 +560,10 @@ int editRecipe(const char* pathFileRecipes, const char* pathFileIngredients) {
  */
 int calculateRecipeCost(const char* pathFileRecipes, const char* pathFileIngredients) {
 	Recipe recipes[MAX_RECIPES];
-	Ingredient* ingredientList = loadIngredientsFromFile(pathFileIngredients);
+	MemoryArena ingredientArena;
+	initMemoryArena(&ingredientArena, 0);
+	IngredientCatalog ingredientCatalog;
+	loadIngredientCatalogInArena(&ingredientCatalog, pathFileIngredients, &ingredientArena);
 	int recipeCount = loadRecipesFromFile(pathFileRecipes, recipes, MAX_RECIPES);
 
 	if (recipeCount == 0) {
@@ -518,30 +591,29 @@ int calculateRecipeCost(const char* pathFileRecipes, const char* pathFileIngredi
 	Recipe* selectedRecipe = &recipes[recipeId - 1]; // Adjusting for 0-based indexing
 
 	// Step 3: Calculate total cost using Sparse Matrix
+	IngredientPriceTable ingredientPrices;
+	if (!buildIngredientPriceTable(&ingredientPrices, &ingredientCatalog)) {
+		freeIngredientCatalog(&ingredientCatalog);
+		printf("Ingredient prices could not be loaded to calculate cost.\n");
+		enterToContinue();
+		return -1;
+	}
 	double totalCost = 0.0;
 	SparseMatrixNode* costMatrix = NULL;
-	Ingredient* currentIngredient = ingredientList;
 	for (int i = 0; i < selectedRecipe->ingredientCount; i++) {
-		while (currentIngredient != NULL) {
-			if (currentIngredient->id == selectedRecipe->ingredients[i]) {
-				insertSparseMatrixNode(&costMatrix, recipeId, currentIngredient->id, currentIngredient->price);
-				totalCost += currentIngredient->price;
-				break;
-			}
-			currentIngredient = currentIngredient->next;
+		int entry = findIngredientPriceEntry(&ingredientPrices, selectedRecipe->ingredients[i]);
+		if (entry >= 0) {
+			insertSparseMatrixNode(&costMatrix, recipeId, ingredientPrices.ids[entry], ingredientPrices.prices[entry]);
+			totalCost += ingredientPrices.prices[entry];
 		}
-		currentIngredient = ingredientList; // Reset pointer to beginning of ingredient list
 	}
+	freeIngredientPriceTable(&ingredientPrices);
 
 	printf("The total cost of the recipe '%s' is: $%.2f\n", selectedRecipe->name, totalCost);
 	enterToContinue();
 
 	// Free ingredient list memory
-	while (ingredientList != NULL) {
-		Ingredient* temp = ingredientList;
-		ingredientList = ingredientList->next;
-		free(temp);
-	}
+	freeIngredientCatalog(&ingredientCatalog);
 
 	// Free sparse matrix memory
 	freeSparseMatrix(costMatrix);
@@ -585,8 +657,11 @@ int printRecipesToConsole(const char* pathFileRecipes) {
 		return -1; // Indicate error opening file
 	}
 
-	Ingredient* ingredientList = loadIngredientsFromFile("ingredient.bin");
-	if (!ingredientList) {
+	MemoryArena ingredientArena;
+	initMemoryArena(&ingredientArena, 0);
+	IngredientCatalog ingredientCatalog;
+	loadIngredientCatalogInArena(&ingredientCatalog, "ingredient.bin", &ingredientArena);
+	if (ingredientCatalog.head == NULL) {
 		printf("Error loading ingredients.\n");
 		fclose(file);
 		return -2; // Indicate error loading ingredients
@@ -615,39 +690,18 @@ int printRecipesToConsole(const char* pathFileRecipes) {
 		printf("%d) %s\n", i + 1, recipe.name);
 
 		// Display the recipe category
-		printf("   Category: ");
-		switch (recipe.category) {
-		case 1:
-			printf("Soup\n");
-			break;
-		case 2:
-			printf("Appetizer\n");
-			break;
-		case 3:
-			printf("Main Course\n");
-			break;
-		case 4:
-			printf("Dessert\n");
-			break;
-		default:
-			printf("Unknown\n");
-			break;
-		}
+		printf("   Category: %s\n", getRecipeCategoryName(recipe.category));
 
 		// Display the ingredients
 		printf("   Ingredients: ");
 		for (int j = 0; j < recipe.ingredientCount; j++) {
 			int ingredientId = recipe.ingredients[j];
-			Ingredient* current = ingredientList;
-			while (current != NULL) {
-				if (current->id == ingredientId) {
-					printf("%s", current->name);
-					if (j < recipe.ingredientCount - 1) {
-						printf(", ");
-					}
-					break;
+			Ingredient* current = findIngredientById(&ingredientCatalog, ingredientId);
+			if (current != NULL) {
+				printf("%s", current->name);
+				if (j < recipe.ingredientCount - 1) {
+					printf(", ");
 				}
-				current = current->next;
 			}
 		}
 		printf("\n");
@@ -656,11 +710,7 @@ int printRecipesToConsole(const char* pathFileRecipes) {
 	fclose(file);
 
 	// Free ingredient list memory
-	while (ingredientList != NULL) {
-		Ingredient* temp = ingredientList;
-		ingredientList = ingredientList->next;
-		free(temp);
-	}
+	freeIngredientCatalog(&ingredientCatalog);
 
 	return 0; // Indicate success
 }
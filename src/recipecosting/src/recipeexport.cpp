@@ -0,0 +1,124 @@
+/**
+ * @file recipeexport.cpp
+ * @brief Implementation of the recipe exporter, which costs every recipe against the ingredient
+ * catalog and streams the results through the buffered export writer.
+ */
+#include "../header/recipeexport.h"
+#include "../../ingredientmanagement/header/ingredientcatalog.h"
+
+/**
+ * @brief Returns the display name of a recipe category.
+ *
+ * @param category The recipe category, 1 to 4.
+ * @return The category name, or "Unknown" for other values.
+ */
+const char* getRecipeCategoryName(int category) {
+	switch (category) {
+	case 1:
+		return "Soup";
+	case 2:
+		return "Appetizer";
+	case 3:
+		return "Main Course";
+	case 4:
+		return "Dessert";
+	default:
+		return "Unknown";
+	}
+}
+
+/**
+ * @brief Writes every recipe with its ingredients and total cost to a CSV or JSON file.
+ *
+ * Recipe IDs are the 1-based positions used by the recipe menus. The cost is the sum of the prices
+ * of the ingredients that still exist; IDs that are no longer in the catalog are counted as missing.
+ * The CSV file has an "id,name,category,ingredient_ids,cost,missing_ingredients" header row with
+ * the ingredient IDs separated by semicolons.
+ *
+ * @param pathFileRecipes File path to load the recipes from.
+ * @param pathFileIngredients File path to load the ingredients from.
+ * @param filePath The file to write.
+ * @param format The file format.
+ * @return True if the file was written completely, otherwise false.
+ */
+bool exportRecipes(const char* pathFileRecipes, const char* pathFileIngredients, const char* filePath, ExportFormat format) {
+	Recipe recipes[MAX_RECIPES];
+	int recipeCount = loadRecipesFromFile(pathFileRecipes, recipes, MAX_RECIPES);
+
+	ExportWriter writer;
+	if (!openExportWriter(&writer, filePath)) {
+		return false;
+	}
+	MemoryArena ingredientArena;
+	initMemoryArena(&ingredientArena, 0);
+	IngredientCatalog ingredientCatalog;
+	loadIngredientCatalogInArena(&ingredientCatalog, pathFileIngredients, &ingredientArena);
+
+	if (format == EXPORT_FORMAT_CSV) {
+		writeExportString(&writer, "id,name,category,ingredient_ids,cost,missing_ingredients\n");
+	}
+	else {
+		writeExportString(&writer, "[");
+	}
+
+	for (int i = 0; i < recipeCount; i++) {
+		const Recipe* recipe = &recipes[i];
+		double totalCost = 0.0;
+		int missing = 0;
+		for (int j = 0; j < recipe->ingredientCount; j++) {
+			Ingredient* ingredient = findIngredientById(&ingredientCatalog, recipe->ingredients[j]);
+			if (ingredient != NULL) {
+				totalCost += ingredient->price;
+			}
+			else {
+				missing++;
+			}
+		}
+
+		if (format == EXPORT_FORMAT_CSV) {
+			writeExportInt(&writer, i + 1);
+			writeExportString(&writer, ",");
+			writeExportCsvField(&writer, recipe->name);
+			writeExportString(&writer, ",");
+			writeExportCsvField(&writer, getRecipeCategoryName(recipe->category));
+			writeExportString(&writer, ",");
+			for (int j = 0; j < recipe->ingredientCount; j++) {
+				if (j > 0) {
+					writeExportString(&writer, ";");
+				}
+				writeExportInt(&writer, recipe->ingredients[j]);
+			}
+			writeExportString(&writer, ",");
+			writeExportFixed(&writer, totalCost, 2);
+			writeExportString(&writer, ",");
+			writeExportInt(&writer, missing);
+			writeExportString(&writer, "\n");
+		}
+		else {
+			writeExportString(&writer, i == 0 ? "\n  {\"id\":" : ",\n  {\"id\":");
+			writeExportInt(&writer, i + 1);
+			writeExportString(&writer, ",\"name\":");
+			writeExportJsonString(&writer, recipe->name);
+			writeExportString(&writer, ",\"category\":");
+			writeExportJsonString(&writer, getRecipeCategoryName(recipe->category));
+			writeExportString(&writer, ",\"ingredients\":[");
+			for (int j = 0; j < recipe->ingredientCount; j++) {
+				if (j > 0) {
+					writeExportString(&writer, ",");
+				}
+				writeExportInt(&writer, recipe->ingredients[j]);
+			}
+			writeExportString(&writer, "],\"cost\":");
+			writeExportFixed(&writer, totalCost, 2);
+			writeExportString(&writer, ",\"missingIngredients\":");
+			writeExportInt(&writer, missing);
+			writeExportString(&writer, "}");
+		}
+	}
+
+	if (format == EXPORT_FORMAT_JSON) {
+		writeExportString(&writer, recipeCount > 0 ? "\n]\n" : "]\n");
+	}
+	freeIngredientCatalog(&ingredientCatalog);
+	return closeExportWriter(&writer);
+}
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "../../huffmancodec/header/huffmancodec.h"
+#include <string.h>
+#include <vector>
+
+class HuffmancodecTest : public ::testing::Test {
+protected:
+	HuffmanEncoder encoder;
+	HuffmanDecoder decoder;
+
+	void buildCodec(const uint8_t* data, size_t size) {
+		uint64_t freq[256] = { 0 };
+		uint8_t lengths[256];
+		countHuffmanSymbols(data, size, freq);
+		ASSERT_TRUE(buildHuffmanCodeLengths(freq, lengths));
+		ASSERT_TRUE(initHuffmanEncoder(&encoder, lengths));
+		ASSERT_TRUE(initHuffmanDecoder(&decoder, lengths));
+	}
+
+	void expectRoundTrip(const uint8_t* data, size_t size) {
+		std::vector<uint8_t> encoded(HUFFMAN_MAX_ENCODED_SIZE(size) + 1);
+		size_t encodedSize = 0;
+		ASSERT_TRUE(encodeHuffmanBuffer(&encoder, data, size, encoded.data(), encoded.size(), &encodedSize));
+
+		std::vector<uint8_t> decoded(size + 1);
+		ASSERT_TRUE(decodeHuffmanBuffer(&decoder, encoded.data(), encodedSize, decoded.data(), size));
+		EXPECT_EQ(memcmp(decoded.data(), data, size), 0);
+	}
+};
+
+TEST_F(HuffmancodecTest, RoundTripTextTest) {
+	const char* text = "Tomato, Cucumber, Onion, Extra Virgin Olive Oil, Sea Salt";
+	buildCodec((const uint8_t*)text, strlen(text));
+	expectRoundTrip((const uint8_t*)text, strlen(text));
+}
+
+TEST_F(HuffmancodecTest, RoundTripAllByteValuesTest) {
+	std::vector<uint8_t> data;
+	for (int i = 0; i < 256; i++) {
+		for (int j = 0; j <= i % 7; j++) {
+			data.push_back((uint8_t)i);
+		}
+	}
+	buildCodec(data.data(), data.size());
+	EXPECT_EQ(decoder.symbolCount, 256);
+	expectRoundTrip(data.data(), data.size());
+}
+
+TEST_F(HuffmancodecTest, SingleSymbolUsesOneBitTest) {
+	const uint8_t data[] = { 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'a' };
+	buildCodec(data, sizeof(data));
+	EXPECT_EQ(encoder.lengths['a'], 1);
+
+	uint8_t encoded[4];
+	size_t encodedSize = 0;
+	ASSERT_TRUE(encodeHuffmanBuffer(&encoder, data, sizeof(data), encoded, sizeof(encoded), &encodedSize));
+	EXPECT_EQ(encodedSize, 2u);
+	expectRoundTrip(data, sizeof(data));
+}
+
+TEST_F(HuffmancodecTest, FrequentSymbolsGetShorterCodesTest) {
+	uint64_t freq[256] = { 0 };
+	freq['e'] = 1000;
+	freq['t'] = 300;
+	freq['q'] = 2;
+	freq['z'] = 1;
+	uint8_t lengths[256];
+	ASSERT_TRUE(buildHuffmanCodeLengths(freq, lengths));
+	EXPECT_EQ(lengths['e'], 1);
+	EXPECT_LE(lengths['t'], lengths['q']);
+	EXPECT_LE(lengths['q'], lengths['z']);
+	EXPECT_EQ(lengths['a'], 0);
+}
+
+TEST_F(HuffmancodecTest, CodeLengthsAreLimitedTest) {
+	// Fibonacci frequencies produce the deepest possible Huffman tree
+	uint64_t freq[256] = { 0 };
+	uint64_t a = 1, b = 1;
+	for (int i = 0; i < 60; i++) {
+		freq[i] = a;
+		uint64_t next = a + b;
+		a = b;
+		b = next;
+	}
+	uint8_t lengths[256];
+	ASSERT_TRUE(buildHuffmanCodeLengths(freq, lengths));
+	for (int i = 0; i < 60; i++) {
+		EXPECT_GT(lengths[i], 0);
+		EXPECT_LE(lengths[i], HUFFMAN_MAX_CODE_LENGTH);
+	}
+	EXPECT_TRUE(validateHuffmanCodeLengths(lengths));
+}
+
+TEST_F(HuffmancodecTest, RejectOversubscribedLengthsTest) {
+	uint8_t lengths[256] = { 0 };
+	lengths['a'] = 1;
+	lengths['b'] = 1;
+	lengths['c'] = 2;
+	EXPECT_FALSE(validateHuffmanCodeLengths(lengths));
+	EXPECT_FALSE(initHuffmanEncoder(&encoder, lengths));
+	EXPECT_FALSE(initHuffmanDecoder(&decoder, lengths));
+}
+
+TEST_F(HuffmancodecTest, EncodeFailsForUnknownSymbolTest) {
+	const char* text = "abc";
+	buildCodec((const uint8_t*)text, strlen(text));
+
+	uint8_t encoded[8];
+	size_t encodedSize = 0;
+	EXPECT_FALSE(encodeHuffmanBuffer(&encoder, (const uint8_t*)"abd", 3, encoded, sizeof(encoded), &encodedSize));
+}
+
+TEST_F(HuffmancodecTest, EncodeFailsWhenOutputIsTooSmallTest) {
+	const char* text = "abcdefghijklmnop";
+	buildCodec((const uint8_t*)text, strlen(text));
+
+	uint8_t encoded[2];
+	size_t encodedSize = 0;
+	EXPECT_FALSE(encodeHuffmanBuffer(&encoder, (const uint8_t*)text, strlen(text), encoded, sizeof(encoded), &encodedSize));
+}
+
+TEST_F(HuffmancodecTest, DecodeFailsOnTruncatedInputTest) {
+	const char* text = "abcdefghijklmnop";
+	buildCodec((const uint8_t*)text, strlen(text));
+
+	uint8_t encoded[16];
+	size_t encodedSize = 0;
+	ASSERT_TRUE(encodeHuffmanBuffer(&encoder, (const uint8_t*)text, strlen(text), encoded, sizeof(encoded), &encodedSize));
+
+	uint8_t decoded[16];
+	EXPECT_FALSE(decodeHuffmanBuffer(&decoder, encoded, encodedSize - 1, decoded, strlen(text)));
+}
+
+/**
+ * @brief The main function of the test program.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @return int The exit status of the program.
+ */
+int main(int argc, char** argv) {
+#ifdef ENABLE_HUFFMANCODEC_TEST
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+#else
+	return 0;
+#endif
+}
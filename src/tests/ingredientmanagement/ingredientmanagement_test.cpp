@@ -2,12 +2,34 @@
 #include "../../ingredientmanagement/header/ingredientmanagement.h"
 #include "gtest/gtest.h"
 #include "../../ingredientmanagement/header/ingredientmanagement.h"
+#include "../../ingredientmanagement/header/ingredientfile.h"
+#include "../../ingredientmanagement/header/ingredienthuffman.h"
+#include "../../ingredientmanagement/header/ingredientlog.h"
+#include "../../ingredientmanagement/header/ingredientcatalog.h"
+#include "../../ingredientmanagement/header/ingredientsearch.h"
+#include "../../ingredientmanagement/header/ingredientnamescan.h"
+#include "../../ingredientmanagement/header/ingredienttrie.h"
+#include "../../ingredientmanagement/header/ingredientio.h"
+#include "../../ingredientmanagement/header/ingredientnamepool.h"
+#include "../../ingredientmanagement/header/ingredientpricetable.h"
+#include "../../ingredientmanagement/header/ingredientpriceindex.h"
+#include "../../ingredientmanagement/header/ingredientpager.h"
+#include "../../ingredientmanagement/header/ingredientstorage.h"
+#include "../../ingredientmanagement/header/ingredientsnapshot.h"
+#include "../../ingredientmanagement/header/ingredientnameset.h"
+#include "../../ingredientmanagement/header/ingredientchecksum.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 class IngredientmanagementTest : public ::testing::Test {
 protected:
 	const char* inputTest = "inputTest.bin";
 	const char* outputTest = "outputTest.bin";
 	const char* testFilePath = "testdeneme.bin";
+	const char* testLogPath = "testdeneme.bin" INGREDIENT_LOG_SUFFIX;
 	void SetUp() override {
 		// Setup test data
 	}
@@ -16,6 +38,16 @@ protected:
 		remove(inputTest);
 		remove(outputTest);
 		remove(testFilePath);
+		remove(testLogPath);
+	}
+
+	void freeIngredients(Ingredient* head) {
+		Ingredient* temp;
+		while (head != nullptr) {
+			temp = head;
+			head = head->next;
+			free(temp);
+		}
 	}
 
 	void simulateUserInput(const char* userInput) {
@@ -348,6 +380,135 @@ TEST_F(IngredientmanagementTest, ListIngredientsXLLTest) {
 	}
 }
 
+TEST_F(IngredientmanagementTest, IngredientViewingAcrossPagesTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	for (int id = 1; id <= INGREDIENT_PAGE_SIZE + 4; id++) {
+		Ingredient* ingredient = (Ingredient*)malloc(sizeof(Ingredient));
+		ingredient->id = id;
+		snprintf(ingredient->name, sizeof(ingredient->name), "Item%d", id);
+		ingredient->price = (float)id;
+		ingredient->npx = NULL;
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+	ASSERT_TRUE(saveIngredientsToFile(catalog.head, testFilePath));
+	freeIngredientCatalog(&catalog);
+
+	// Step past the end of the first page and back again
+	std::string input = "1\n";
+	for (int i = 0; i < INGREDIENT_PAGE_SIZE; i++) {
+		input += "1\n";
+	}
+	input += "2\n3\n6\n\n";
+	simulateUserInput(input.c_str());
+
+	int result = ingredientManagementMenu(testFilePath);
+
+	resetStdinStdout();
+
+	EXPECT_EQ(result, 0);
+	static char buffer[65536];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	char expected[32];
+	snprintf(expected, sizeof(expected), "Name: Item%d\n", INGREDIENT_PAGE_SIZE + 1);
+	EXPECT_NE(strstr(buffer, expected), nullptr);
+	EXPECT_EQ(strstr(buffer, "Invalid choice"), nullptr);
+}
+
+TEST_F(IngredientmanagementTest, IngredientViewingSkipsTombstonesTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	for (int id = 1; id <= INGREDIENT_PAGE_SIZE + 4; id++) {
+		Ingredient* ingredient = (Ingredient*)malloc(sizeof(Ingredient));
+		ingredient->id = id;
+		snprintf(ingredient->name, sizeof(ingredient->name), "Item%d", id);
+		ingredient->price = (float)id;
+		ingredient->npx = NULL;
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+	ASSERT_TRUE(saveIngredientsToFile(catalog.head, testFilePath));
+	freeIngredientCatalog(&catalog);
+	IngredientFileHeader header;
+	ASSERT_TRUE(deleteIngredientRecordInPlace(testFilePath, 3, &header));
+	ASSERT_TRUE(deleteIngredientRecordInPlace(testFilePath, INGREDIENT_PAGE_SIZE + 1, &header));
+
+	// Walk to the last live ingredient and one step further
+	std::string input = "1\n";
+	for (int i = 0; i < INGREDIENT_PAGE_SIZE + 2; i++) {
+		input += "1\n";
+	}
+	input += "\n3\n6\n\n";
+	simulateUserInput(input.c_str());
+	int result = ingredientManagementMenu(testFilePath);
+	resetStdinStdout();
+
+	EXPECT_EQ(result, 0);
+	static char buffer[65536];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	char expected[32];
+	snprintf(expected, sizeof(expected), "Name: Item%d\n", INGREDIENT_PAGE_SIZE + 4);
+	EXPECT_NE(strstr(buffer, expected), nullptr);
+	snprintf(expected, sizeof(expected), "Name: Item%d\n", INGREDIENT_PAGE_SIZE + 1);
+	EXPECT_EQ(strstr(buffer, expected), nullptr);
+	EXPECT_EQ(strstr(buffer, "Name: Item3\n"), nullptr);
+	EXPECT_NE(strstr(buffer, "Name: Item4\n"), nullptr);
+	EXPECT_NE(strstr(buffer, "no more ingredients"), nullptr);
+
+	// Browsing does not compact the file
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, (uint32_t)INGREDIENT_PAGE_SIZE + 4);
+	EXPECT_EQ(header.deletedCount, 2u);
+}
+
+TEST_F(IngredientmanagementTest, IngredientCursorReadsPageAtOffsetTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	head = addIngredient(head, "Tomatoes", 3.0, testFilePath);
+	// Files written before duplicate names were rejected can hold the same name twice
+	strcpy(head->next->next->next->name, "Tomato");
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+
+	IngredientCursor cursor;
+	ASSERT_TRUE(openIngredientCursor(testFilePath, &cursor));
+	EXPECT_EQ(cursor.count, 4);
+
+	Ingredient page[4];
+	ASSERT_EQ(readIngredientPage(&cursor, 1, page, 4), 3);
+	EXPECT_EQ(page[0].id, 2);
+	EXPECT_STREQ(page[0].name, "Cucumber");
+	EXPECT_STREQ(page[2].name, "Tomato");
+	EXPECT_FLOAT_EQ(page[2].price, 3.0f);
+	EXPECT_EQ(page[2].next, nullptr);
+	EXPECT_EQ(readIngredientPage(&cursor, 4, page, 4), 0);
+	EXPECT_EQ(readIngredientPage(&cursor, -1, page, 4), 0);
+
+	simulateUserInput("");
+	bool listed = listIngredientPageXLL(&cursor, 1, 2);
+	resetStdinStdout();
+	EXPECT_TRUE(listed);
+	char buffer[4096];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	EXPECT_NE(strstr(buffer, "| 2  | Cucumber"), nullptr);
+	EXPECT_NE(strstr(buffer, "| 3  | Onion"), nullptr);
+	EXPECT_EQ(strstr(buffer, "| 1  |"), nullptr);
+	EXPECT_EQ(strstr(buffer, "| 4  |"), nullptr);
+	// The neighbours outside the window still show up as next and previous
+	EXPECT_NE(strstr(buffer, "| Tomato               | 2.50   |"), nullptr);
+	EXPECT_NE(strstr(buffer, "| Tomato               | 3.00   |"), nullptr);
+	closeIngredientCursor(&cursor);
+
+	// Legacy files of raw structs need a full load
+	FILE* file = fopen(testFilePath, "wb");
+	ASSERT_NE(file, nullptr);
+	fwrite(head, sizeof(Ingredient), 1, file);
+	fclose(file);
+	EXPECT_FALSE(openIngredientCursor(testFilePath, &cursor));
+
+	freeIngredients(head);
+}
+
 // Test for listing ingredients using XLL when no ingredients are available
 TEST_F(IngredientmanagementTest, ListIngredientsXLLNoIngredientsTest) {
 	Ingredient* head = nullptr;
@@ -942,6 +1103,2632 @@ TEST_F(IngredientmanagementTest, KMPSearchTest) {
 //	}
 //}
 
+TEST_F(IngredientmanagementTest, SavedIngredientFileIsVersionedAndMappable) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(map.header->magic, INGREDIENT_FILE_MAGIC);
+	EXPECT_EQ(map.header->version, (uint32_t)INGREDIENT_FILE_VERSION);
+	EXPECT_EQ(map.header->recordSize, sizeof(IngredientRecord));
+	EXPECT_TRUE(map.header->flags & INGREDIENT_FILE_SORTED_BY_ID);
+	EXPECT_EQ(map.count, 3);
+
+	const IngredientRecord* record = findMappedIngredientById(&map, 2);
+	ASSERT_NE(record, nullptr);
+	EXPECT_STREQ(getMappedIngredientName(&map, record), "Cucumber");
+	EXPECT_FLOAT_EQ(record->price, 1.8);
+	EXPECT_EQ(findMappedIngredientById(&map, 4), nullptr);
+	EXPECT_EQ(getMappedIngredient(&map, 3), nullptr);
+	closeIngredientMap(&map);
+
+	// Clean up
+	Ingredient* temp;
+	while (head != nullptr) {
+		temp = head;
+		head = head->next;
+		free(temp);
+	}
+}
+
+TEST_F(IngredientmanagementTest, NamePoolInternsEachNameOnceTest) {
+	IngredientNamePool pool;
+	initIngredientNamePool(&pool);
+	uint32_t tomato = internIngredientName(&pool, "Tomato");
+	uint32_t onion = internIngredientName(&pool, "Onion");
+	EXPECT_NE(tomato, onion);
+	EXPECT_EQ(internIngredientName(&pool, "Tomato"), tomato);
+	EXPECT_EQ(pool.count, 2u);
+	EXPECT_EQ(pool.size, 13u);
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Onion"), onion);
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Garlic"), INGREDIENT_NAME_HANDLE_INVALID);
+	EXPECT_STREQ(getIngredientNameByHandle(&pool, tomato), "Tomato");
+	EXPECT_EQ(getIngredientNameByHandle(&pool, 2), nullptr);
+
+	// Names that are prefixes of each other stay distinct
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Tomatoes"), INGREDIENT_NAME_HANDLE_INVALID);
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Onio"), INGREDIENT_NAME_HANDLE_INVALID);
+	uint32_t onio = internIngredientName(&pool, "Onio");
+	EXPECT_NE(onio, onion);
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Onion"), onion);
+
+	// Growing the hash table keeps every handle
+	char name[32];
+	for (int i = 0; i < 1000; i++) {
+		snprintf(name, sizeof(name), "Spice %d", i);
+		ASSERT_EQ(internIngredientName(&pool, name), (uint32_t)i + 3);
+	}
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Spice 500"), 503u);
+	EXPECT_EQ(findIngredientNameHandle(&pool, "Tomato"), tomato);
+	freeIngredientNamePool(&pool);
+}
+
+TEST_F(IngredientmanagementTest, MappedNamesAreInternedTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	head = addIngredient(head, "Tomatoes", 3.1, testFilePath);
+	strcpy(head->next->next->name, "Tomato");
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(map.nameCount, 2u);
+	EXPECT_EQ(getMappedIngredient(&map, 0)->nameHandle, getMappedIngredient(&map, 2)->nameHandle);
+
+	const IngredientRecord* results[4];
+	ASSERT_EQ(findMappedIngredientsByName(&map, "Tomato", results, 4), 2);
+	EXPECT_EQ(results[0]->id, 1);
+	EXPECT_EQ(results[1]->id, 3);
+	EXPECT_EQ(findMappedIngredientsByName(&map, "Tomato", results, 1), 1);
+	EXPECT_EQ(findMappedIngredientsByName(&map, "Garlic", results, 4), 0);
+
+	Ingredient* loaded = buildIngredientListFromMap(&map, nullptr);
+	closeIngredientMap(&map);
+	ASSERT_NE(loaded, nullptr);
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_STREQ(loaded->next->name, "Onion");
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, NameSetFindsNormalizedNamesTest) {
+	char normalized[INGREDIENT_NAME_SIZE];
+	EXPECT_EQ(normalizeIngredientName("  Olive \t  OIL ", normalized), 9u);
+	EXPECT_STREQ(normalized, "olive oil");
+
+	IngredientNameSet set;
+	ASSERT_TRUE(initIngredientNameSet(&set));
+	Ingredient ingredients[40];
+	memset(ingredients, 0, sizeof(ingredients));
+	for (int i = 0; i < 40; i++) {
+		ingredients[i].id = i + 1;
+		snprintf(ingredients[i].name, sizeof(ingredients[i].name), "Spice %d", i);
+		ASSERT_TRUE(insertIngredientName(&set, &ingredients[i]));
+	}
+	EXPECT_EQ(findIngredientByNormalizedName(&set, " spice   17"), &ingredients[17]);
+	EXPECT_EQ(findIngredientByNormalizedName(&set, "Spice 40"), nullptr);
+
+	// Removing an entry keeps every other entry of its probe run reachable
+	for (int i = 0; i < 40; i += 2) {
+		removeIngredientName(&set, &ingredients[i]);
+	}
+	EXPECT_EQ(set.count, 20);
+	for (int i = 0; i < 40; i++) {
+		EXPECT_EQ(findIngredientByNormalizedName(&set, ingredients[i].name), i % 2 == 0 ? nullptr : &ingredients[i]);
+	}
+	freeIngredientNameSet(&set);
+}
+
+TEST_F(IngredientmanagementTest, AddAndEditRejectDuplicateNamesTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	ASSERT_NE(addCatalogIngredient(&catalog, "Olive Oil", 12.5f, testFilePath), nullptr);
+	ASSERT_NE(addCatalogIngredient(&catalog, "Tomato", 2.5f, testFilePath), nullptr);
+
+	simulateUserInput("");
+	Ingredient* duplicate = addCatalogIngredient(&catalog, "  olive   OIL", 9.0f, testFilePath);
+	resetStdinStdout();
+	EXPECT_EQ(duplicate, nullptr);
+	EXPECT_EQ(catalog.count, 2);
+	char buffer[1024];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	EXPECT_NE(strstr(buffer, "already exists with ID 1"), nullptr);
+
+	// Renaming Tomato to Olive Oil is refused until a free name is entered
+	simulateUserInput("1\n2\nOLIVE OIL\n\nCherry Tomato\n\n");
+	EXPECT_TRUE(editCatalogIngredient(&catalog, testFilePath));
+	resetStdinStdout();
+	EXPECT_STREQ(findIngredientById(&catalog, 2)->name, "Cherry Tomato");
+	EXPECT_EQ(findIngredientByName(&catalog, "cherry tomato"), findIngredientById(&catalog, 2));
+	EXPECT_EQ(findIngredientByName(&catalog, "Tomato"), nullptr);
+
+	simulateUserInput("\n");
+	removeCatalogIngredient(&catalog, 1, testFilePath);
+	resetStdinStdout();
+	EXPECT_EQ(findIngredientByName(&catalog, "Olive Oil"), nullptr);
+	EXPECT_NE(addCatalogIngredient(&catalog, "Olive Oil", 11.0f, testFilePath), nullptr);
+
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, MapFixedNameIngredientFileTest) {
+	IngredientFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = INGREDIENT_FILE_MAGIC;
+	header.version = INGREDIENT_FILE_VERSION_FIXED_NAMES;
+	header.headerSize = sizeof(IngredientFileHeader);
+	header.recordSize = sizeof(IngredientRecordV1);
+	header.recordCount = 2;
+	IngredientRecordV1 records[2];
+	memset(records, 0, sizeof(records));
+	records[0].id = 1;
+	records[0].price = 2.5f;
+	strcpy(records[0].name, "Tomato");
+	records[1].id = 2;
+	records[1].price = 1.8f;
+	strcpy(records[1].name, "Cucumber");
+	FILE* file = fopen(testFilePath, "wb");
+	ASSERT_NE(file, nullptr);
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(records, sizeof(IngredientRecordV1), 2, file);
+	fclose(file);
+
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(map.names, nullptr);
+	const IngredientRecord* record = findMappedIngredientById(&map, 2);
+	ASSERT_NE(record, nullptr);
+	EXPECT_STREQ(getMappedIngredientName(&map, record), "Cucumber");
+	const IngredientRecord* results[2];
+	EXPECT_EQ(findMappedIngredientsByName(&map, "Tomato", results, 2), 1);
+	closeIngredientMap(&map);
+
+	Ingredient* head = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(head, nullptr);
+	EXPECT_STREQ(head->name, "Tomato");
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, StorageBackendsRoundTripTest) {
+	const IngredientStorage* backends[] = { &ingredientStdioStorage, &ingredientMmapStorage, &ingredientMemoryStorage };
+	for (const IngredientStorage* backend : backends) {
+		SCOPED_TRACE(backend->name);
+		setIngredientStorage(backend);
+		Ingredient* head = nullptr;
+		head = addIngredient(head, "Tomato", 2.5, testFilePath);
+		head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+		head = addIngredient(head, "Onion", 1.2, testFilePath);
+
+		Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+		ASSERT_NE(loaded, nullptr);
+		ASSERT_NE(loaded->next, nullptr);
+		EXPECT_STREQ(loaded->next->name, "Cucumber");
+		ASSERT_NE(loaded->next->next, nullptr);
+		EXPECT_FLOAT_EQ(loaded->next->next->price, 1.2f);
+
+		IngredientMap map;
+		ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+		EXPECT_GE(map.count, 1);
+		closeIngredientMap(&map);
+
+		freeIngredients(loaded);
+		freeIngredients(head);
+		backend->remove(testFilePath);
+		remove(testLogPath);
+	}
+	setIngredientStorage(nullptr);
+	clearIngredientMemoryStorage();
+}
+
+TEST_F(IngredientmanagementTest, MemoryStorageStaysOffDiskTest) {
+	setIngredientStorage(&ingredientMemoryStorage);
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+
+	// The log is kept in memory next to the file, like on disk
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 1u);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 1);
+
+	// A view keeps the contents it was opened on
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+	EXPECT_EQ(map.count, 1);
+	closeIngredientMap(&map);
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(map.count, 3);
+	closeIngredientMap(&map);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+
+	IngredientCursor cursor;
+	ASSERT_TRUE(openIngredientCursor(testFilePath, &cursor));
+	Ingredient page[3];
+	ASSERT_EQ(readIngredientPage(&cursor, 0, page, 3), 3);
+	EXPECT_STREQ(page[2].name, "Onion");
+	closeIngredientCursor(&cursor);
+	setIngredientStorage(nullptr);
+	clearIngredientMemoryStorage();
+
+	FILE* file = fopen(testFilePath, "rb");
+	EXPECT_EQ(file, nullptr);
+	if (file != nullptr) {
+		fclose(file);
+	}
+	file = fopen(testLogPath, "rb");
+	EXPECT_EQ(file, nullptr);
+	if (file != nullptr) {
+		fclose(file);
+	}
+	EXPECT_EQ(loadIngredientsFromFile(testFilePath), nullptr);
+	freeIngredients(head);
+}
+
+static Ingredient makeIngredient(int id, const char* name, float price) {
+	Ingredient ingredient = {};
+	ingredient.id = id;
+	strncpy(ingredient.name, name, sizeof(ingredient.name) - 1);
+	ingredient.price = price;
+	return ingredient;
+}
+
+TEST_F(IngredientmanagementTest, LoadLegacyIngredientFileTest) {
+	Ingredient legacy[2] = {
+		makeIngredient(1, "Tomato", 2.5f),
+		makeIngredient(2, "Cucumber", 1.8f)
+	};
+	FILE* file = fopen(testFilePath, "wb");
+	ASSERT_NE(file, nullptr);
+	fwrite(legacy, sizeof(Ingredient), 2, file);
+	fclose(file);
+
+	IngredientMap map;
+	EXPECT_FALSE(openIngredientMap(testFilePath, &map));
+
+	Ingredient* head = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(head, nullptr);
+	EXPECT_STREQ(head->name, "Tomato");
+	ASSERT_NE(head->next, nullptr);
+	EXPECT_EQ(head->next->id, 2);
+	EXPECT_EQ(head->next->prev, head);
+
+	// Clean up
+	Ingredient* temp;
+	while (head != nullptr) {
+		temp = head;
+		head = head->next;
+		free(temp);
+	}
+}
+
+TEST_F(IngredientmanagementTest, AddIngredientAppendsToLogTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+
+	// Only the first ingredient rewrote the base file, the others were logged
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 1u);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 2);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_STREQ(loaded->name, "Tomato");
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_STREQ(loaded->next->name, "Cucumber");
+	ASSERT_NE(loaded->next->next, nullptr);
+	EXPECT_EQ(loaded->next->next->id, 3);
+	EXPECT_EQ(loaded->next->next->prev, loaded->next);
+	EXPECT_EQ(loaded->next->next->next, nullptr);
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, ReplayRemoveAndUpdateFromLogTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+
+	simulateUserInput("\n");
+	head = removeIngredient(head, 1, testFilePath);
+	resetStdinStdout();
+
+	Ingredient updated = *head->next;
+	strcpy(updated.name, "Shallot");
+	updated.price = 3.0f;
+	ASSERT_TRUE(appendIngredientLog(testFilePath, INGREDIENT_LOG_UPDATE, &updated));
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_EQ(loaded->id, 2);
+	EXPECT_EQ(loaded->prev, nullptr);
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_EQ(loaded->next->id, 3);
+	EXPECT_STREQ(loaded->next->name, "Shallot");
+	EXPECT_FLOAT_EQ(loaded->next->price, 3.0f);
+	EXPECT_EQ(loaded->next->next, nullptr);
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, CompactIngredientLogTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	ASSERT_EQ(getIngredientLogLength(testFilePath), 2);
+
+	ASSERT_TRUE(compactIngredientLog(testFilePath));
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(map.count, 3);
+	EXPECT_STREQ(getMappedIngredientName(&map, getMappedIngredient(&map, 2)), "Onion");
+	closeIngredientMap(&map);
+
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, BackgroundLogCompactionTest) {
+	setIngredientLogCompactionThreshold(2);
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	waitForIngredientLogCompaction();
+	setIngredientLogCompactionThreshold(INGREDIENT_LOG_DEFAULT_COMPACTION_THRESHOLD);
+
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 3u);
+
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, StaleLogIsIgnoredTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+
+	// Rewriting the base file gives it a new generation, so the old log no longer applies
+	Ingredient* onion = nullptr;
+	onion = addIngredient(onion, "Onion", 1.2, testFilePath);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_STREQ(loaded->name, "Onion");
+	EXPECT_EQ(loaded->next, nullptr);
+
+	freeIngredients(loaded);
+	freeIngredients(onion);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, RemoveMarksRecordDeletedInPlaceTest) {
+	setIngredientTombstoneCompactionShare(1.0);
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	ASSERT_TRUE(compactIngredientLog(testFilePath));
+
+	simulateUserInput("\n");
+	head = removeIngredient(head, 2, testFilePath);
+	resetStdinStdout();
+
+	// The record stays in the file as a tombstone and nothing is logged
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 3u);
+	EXPECT_EQ(header.deletedCount, 1u);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(map.deletedCount, 1);
+	EXPECT_TRUE(getMappedIngredient(&map, 1)->flags & INGREDIENT_RECORD_DELETED);
+	EXPECT_EQ(findMappedIngredientById(&map, 2), nullptr);
+	EXPECT_NE(findMappedIngredientById(&map, 3), nullptr);
+	const IngredientRecord* results[2];
+	EXPECT_EQ(findMappedIngredientsByName(&map, "Cucumber", results, 2), 0);
+	closeIngredientMap(&map);
+
+	IngredientCursor cursor;
+	ASSERT_TRUE(openIngredientCursor(testFilePath, &cursor));
+	Ingredient page[3];
+	ASSERT_EQ(readIngredientPage(&cursor, 0, page, 3), 2);
+	EXPECT_EQ(page[0].id, 1);
+	EXPECT_EQ(page[1].id, 3);
+	closeIngredientCursor(&cursor);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_EQ(loaded->id, 1);
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_EQ(loaded->next->id, 3);
+	EXPECT_EQ(loaded->next->prev, loaded);
+	EXPECT_EQ(loaded->next->next, nullptr);
+
+	setIngredientTombstoneCompactionShare(INGREDIENT_TOMBSTONE_DEFAULT_COMPACTION_SHARE);
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, RemoveOfLoggedIngredientIsLoggedTest) {
+	setIngredientTombstoneCompactionShare(1.0);
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	ASSERT_TRUE(compactIngredientLog(testFilePath));
+
+	// The base file holds a live record 2, but the log removed it and added a new ingredient 2
+	Ingredient replacement = *head->next;
+	strcpy(replacement.name, "Onion");
+	ASSERT_TRUE(appendIngredientLog(testFilePath, INGREDIENT_LOG_REMOVE, head->next));
+	ASSERT_TRUE(appendIngredientLog(testFilePath, INGREDIENT_LOG_ADD, &replacement));
+	EXPECT_FALSE(deleteIngredientInPlace(testFilePath, 2));
+
+	// An ingredient that only the log holds has no record to mark
+	head = addIngredient(head, "Garlic", 0.4, testFilePath);
+	EXPECT_FALSE(deleteIngredientInPlace(testFilePath, 3));
+
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.deletedCount, 0u);
+
+	simulateUserInput("\n\n");
+	head = removeIngredient(head, 2, testFilePath);
+	head = removeIngredient(head, 3, testFilePath);
+	resetStdinStdout();
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 5);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_EQ(loaded->id, 1);
+	EXPECT_EQ(loaded->next, nullptr);
+
+	setIngredientTombstoneCompactionShare(INGREDIENT_TOMBSTONE_DEFAULT_COMPACTION_SHARE);
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, TombstoneShareTriggersBackgroundCompactionTest) {
+	setIngredientTombstoneCompactionShare(0.5);
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	head = addIngredient(head, "Garlic", 0.4, testFilePath);
+	ASSERT_TRUE(compactIngredientLog(testFilePath));
+
+	simulateUserInput("\n");
+	head = removeIngredient(head, 1, testFilePath);
+	resetStdinStdout();
+	waitForIngredientLogCompaction();
+
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 4u);
+	EXPECT_EQ(header.deletedCount, 1u);
+
+	// The second delete reaches half of the records, so the file is rewritten without tombstones
+	simulateUserInput("\n");
+	head = removeIngredient(head, 3, testFilePath);
+	resetStdinStdout();
+	waitForIngredientLogCompaction();
+	setIngredientTombstoneCompactionShare(INGREDIENT_TOMBSTONE_DEFAULT_COMPACTION_SHARE);
+
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 2u);
+	EXPECT_EQ(header.deletedCount, 0u);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_EQ(loaded->id, 2);
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_EQ(loaded->next->id, 4);
+	EXPECT_EQ(loaded->next->next, nullptr);
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanFileRoundTripTest) {
+	const char* hufPath = "testdeneme.huf";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Extra Virgin Olive Oil", 12.75, testFilePath);
+	head = addIngredient(head, "Ooooooo", 0.5, testFilePath);
+
+	ASSERT_TRUE(writeHuffmanIngredientFile(head, hufPath));
+	Ingredient* loaded = readHuffmanIngredientFile(hufPath);
+
+	Ingredient* expected = head;
+	Ingredient* actual = loaded;
+	while (expected != nullptr) {
+		ASSERT_NE(actual, nullptr);
+		EXPECT_EQ(actual->id, expected->id);
+		EXPECT_STREQ(actual->name, expected->name);
+		EXPECT_FLOAT_EQ(actual->price, expected->price);
+		expected = expected->next;
+		actual = actual->next;
+	}
+	EXPECT_EQ(actual, nullptr);
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+	remove(hufPath);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanFileIsSmallerThanBinaryFileTest) {
+	const char* hufPath = "testdeneme.huf";
+	Ingredient* head = nullptr;
+	for (int i = 0; i < 50; i++) {
+		char name[32];
+		snprintf(name, sizeof(name), "Ingredient %d", i);
+		head = addIngredient(head, name, 1.0f + i, testFilePath);
+	}
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+	ASSERT_TRUE(writeHuffmanIngredientFile(head, hufPath));
+
+	FILE* bin = fopen(testFilePath, "rb");
+	FILE* huf = fopen(hufPath, "rb");
+	ASSERT_NE(bin, nullptr);
+	ASSERT_NE(huf, nullptr);
+	fseek(bin, 0, SEEK_END);
+	fseek(huf, 0, SEEK_END);
+	EXPECT_LT(ftell(huf), ftell(bin));
+	fclose(bin);
+	fclose(huf);
+
+	freeIngredients(head);
+	remove(hufPath);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanCodebookLimitsCodeLengthTest) {
+	// Fibonacci frequencies produce the deepest possible Huffman tree
+	uint64_t freq[256] = { 0 };
+	int a = 1, b = 1;
+	for (int i = 'A'; i < 'A' + 30; i++) {
+		freq[i] = a;
+		int next = a + b;
+		a = b;
+		b = next;
+	}
+
+	HuffmanCodebook book;
+	ASSERT_TRUE(buildHuffmanCodebook(freq, &book));
+	EXPECT_EQ(book.decoder.symbolCount, 30);
+	for (int i = 0; i < 256; i++) {
+		EXPECT_LE(book.encoder.lengths[i], HUFFMAN_MAX_CODE_LENGTH);
+	}
+
+	const char* name = "ABCDEFGHIJKLMNOPQRSTUVWXYZ^]\\[";
+	uint8_t payload[HUFFMAN_MAX_PAYLOAD_BYTES];
+	int payloadBytes = encodeHuffmanName(&book, name, payload, (int)sizeof(payload));
+	ASSERT_GT(payloadBytes, 0);
+	char decoded[100];
+	ASSERT_TRUE(decodeHuffmanName(&book, payload, payloadBytes, (int)strlen(name), decoded));
+	EXPECT_STREQ(decoded, name);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanCodebookRejectsOversubscribedLengthsTest) {
+	uint8_t lengths[256] = { 0 };
+	lengths['a'] = 1;
+	lengths['b'] = 1;
+	lengths['c'] = 1;
+	HuffmanCodebook book;
+	EXPECT_FALSE(initHuffmanCodebook(lengths, &book));
+}
+
+TEST_F(IngredientmanagementTest, LoadDamagedHuffmanFileTest) {
+	const char* hufPath = "testdeneme.huf";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	ASSERT_TRUE(writeHuffmanIngredientFile(head, hufPath));
+
+	// Cut the file in the middle of the only record
+	FILE* file = fopen(hufPath, "rb");
+	char buffer[512];
+	size_t size = fread(buffer, 1, sizeof(buffer), file);
+	fclose(file);
+	file = fopen(hufPath, "wb");
+	fwrite(buffer, 1, size - 2, file);
+	fclose(file);
+
+	simulateUserInput("");
+	Ingredient* loaded = readHuffmanIngredientFile(hufPath);
+	resetStdinStdout();
+	EXPECT_EQ(loaded, nullptr);
+
+	freeIngredients(head);
+	remove(hufPath);
+}
+
+static long huffmanFileSize(const char* hufPath) {
+	FILE* file = fopen(hufPath, "rb");
+	if (file == nullptr) {
+		return -1;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+TEST_F(IngredientmanagementTest, HuffmanFilePatchesSingleRecordsTest) {
+	const char* hufPath = "testdeneme.huf";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Potato", 0.9, testFilePath);
+	ASSERT_TRUE(writeHuffmanIngredientFile(head, hufPath));
+	long size = huffmanFileSize(hufPath);
+
+	// A new name made of characters the codebook covers is appended without touching the others
+	Ingredient added = { 4, "Cut", 3.0f, nullptr, nullptr, nullptr };
+	ASSERT_TRUE(storeHuffmanIngredient(hufPath, &added));
+	long appendedSize = huffmanFileSize(hufPath);
+	EXPECT_GT(appendedSize, size);
+
+	// A name of the same encoded length is overwritten in place
+	Ingredient renamed = { 4, "Tut", 3.5f, nullptr, nullptr, nullptr };
+	ASSERT_TRUE(storeHuffmanIngredient(hufPath, &renamed));
+	EXPECT_EQ(huffmanFileSize(hufPath), appendedSize);
+
+	ASSERT_TRUE(deleteHuffmanIngredient(hufPath, 2));
+	EXPECT_EQ(huffmanFileSize(hufPath), appendedSize);
+
+	Ingredient* loaded = readHuffmanIngredientFile(hufPath);
+	const int ids[] = { 1, 3, 4 };
+	const char* names[] = { "Tomato", "Potato", "Tut" };
+	Ingredient* current = loaded;
+	for (int i = 0; i < 3; i++) {
+		ASSERT_NE(current, nullptr);
+		EXPECT_EQ(current->id, ids[i]);
+		EXPECT_STREQ(current->name, names[i]);
+		current = current->next;
+	}
+	EXPECT_EQ(current, nullptr);
+	EXPECT_FLOAT_EQ(loaded->next->next->price, 3.5f);
+
+	// Characters missing from the codebook and unknown IDs need a full rewrite
+	Ingredient uncovered = { 5, "Basil", 1.0f, nullptr, nullptr, nullptr };
+	EXPECT_FALSE(storeHuffmanIngredient(hufPath, &uncovered));
+	EXPECT_FALSE(deleteHuffmanIngredient(hufPath, 2));
+	EXPECT_FALSE(storeHuffmanIngredient("missing.huf", &added));
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+	remove(hufPath);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanFileRefusesPatchWhenDeletedRecordsDominateTest) {
+	const char* hufPath = "testdeneme.huf";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Potato", 0.9, testFilePath);
+	head = addIngredient(head, "Carrot", 0.4, testFilePath);
+	ASSERT_TRUE(writeHuffmanIngredientFile(head, hufPath));
+
+	EXPECT_TRUE(deleteHuffmanIngredient(hufPath, 1));
+	EXPECT_TRUE(deleteHuffmanIngredient(hufPath, 2));
+	EXPECT_FALSE(deleteHuffmanIngredient(hufPath, 3));
+
+	// A longer name would leave a third deleted record next to two live ones
+	Ingredient renamed = { 4, "Carrotomato", 0.4f, nullptr, nullptr, nullptr };
+	EXPECT_FALSE(storeHuffmanIngredient(hufPath, &renamed));
+
+	freeIngredients(head);
+	remove(hufPath);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanFilePatchesNoticeOutsideRewritesTest) {
+	const char* hufPath = "testdeneme.huf";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Potato", 0.9, testFilePath);
+	ASSERT_TRUE(writeHuffmanIngredientFile(head, hufPath));
+	std::vector<char> original((size_t)huffmanFileSize(hufPath));
+	FILE* file = fopen(hufPath, "rb");
+	ASSERT_NE(file, nullptr);
+	ASSERT_EQ(fread(original.data(), 1, original.size(), file), original.size());
+	fclose(file);
+
+	// Patches after the rewrite use the records of the rewritten file
+	ASSERT_TRUE(writeHuffmanIngredientFile(head->next, hufPath));
+	Ingredient renamed = { 3, "Potaco", 1.1f, nullptr, nullptr, nullptr };
+	ASSERT_TRUE(storeHuffmanIngredient(hufPath, &renamed));
+
+	// Putting the original bytes back behind the writer's back is noticed before the next patch
+	file = fopen(hufPath, "wb");
+	ASSERT_NE(file, nullptr);
+	fwrite(original.data(), 1, original.size(), file);
+	fclose(file);
+	ASSERT_TRUE(deleteHuffmanIngredient(hufPath, 1));
+	Ingredient added = { 4, "Cut", 3.0f, nullptr, nullptr, nullptr };
+	ASSERT_TRUE(storeHuffmanIngredient(hufPath, &added));
+
+	Ingredient* loaded = readHuffmanIngredientFile(hufPath);
+	const int ids[] = { 2, 3, 4 };
+	const char* names[] = { "Cucumber", "Potato", "Cut" };
+	Ingredient* current = loaded;
+	for (int i = 0; i < 3; i++) {
+		ASSERT_NE(current, nullptr);
+		EXPECT_EQ(current->id, ids[i]);
+		EXPECT_STREQ(current->name, names[i]);
+		current = current->next;
+	}
+	EXPECT_EQ(current, nullptr);
+
+	remove(hufPath);
+	EXPECT_FALSE(storeHuffmanIngredient(hufPath, &added));
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, MutationsKeepHuffmanMirrorCurrentTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Potato", 0.9, testFilePath);
+	long size = huffmanFileSize(HUFFMAN_INGREDIENT_FILE_PATH);
+
+	simulateUserInput("\n");
+	head = removeIngredient(head, 2, testFilePath);
+	resetStdinStdout();
+	EXPECT_EQ(huffmanFileSize(HUFFMAN_INGREDIENT_FILE_PATH), size);
+
+	Ingredient* encoded = loadHuffmanEncodedIngredientsFromFile();
+	ASSERT_NE(encoded, nullptr);
+	ASSERT_NE(encoded->next, nullptr);
+	EXPECT_STREQ(encoded->name, "Tomato");
+	EXPECT_STREQ(encoded->next->name, "Potato");
+	EXPECT_EQ(encoded->next->next, nullptr);
+
+	freeIngredients(encoded);
+	freeIngredients(head);
+	remove(HUFFMAN_INGREDIENT_FILE_PATH);
+}
+
+static HuffmanTreeNode* buildTreeFromCodebook(const HuffmanCodebook* book) {
+	HuffmanTreeNode* root = createHuffmanTreeNode('\0', 0);
+	for (int i = 0; i < 256; i++) {
+		HuffmanTreeNode* node = root;
+		for (int bit = book->encoder.lengths[i] - 1; bit >= 0; bit--) {
+			HuffmanTreeNode** child = ((book->encoder.codes[i] >> bit) & 1) ? &node->right : &node->left;
+			if (*child == nullptr) {
+				*child = createHuffmanTreeNode('\0', 0);
+			}
+			node = *child;
+		}
+		if (node != root) {
+			node->character = (char)i;
+		}
+	}
+	return root;
+}
+
+static void decodeWithTreeWalk(const HuffmanTreeNode* root, const uint8_t* payload, int nameLength, char* name) {
+	const HuffmanTreeNode* current = root;
+	int decoded = 0;
+	for (long bit = 0; decoded < nameLength; bit++) {
+		current = ((payload[bit >> 3] >> (7 - (bit & 7))) & 1) ? current->right : current->left;
+		if (current->left == nullptr && current->right == nullptr) {
+			name[decoded++] = current->character;
+			current = root;
+		}
+	}
+	name[decoded] = '\0';
+}
+
+static void makeSyntheticName(int index, char* name, size_t size) {
+	static const char* words[] = { "Organic", "Red", "Onion", "Tomato", "Extra", "Virgin", "Olive", "Oil",
+		"Fresh", "Basil", "Smoked", "Paprika", "Whole", "Wheat", "Flour", "Sea", "Salt", "Black", "Pepper", "Garlic" };
+	snprintf(name, size, "%s %s %s %d", words[index % 20], words[(index / 20) % 20], words[(index / 400) % 20], index % 997);
+}
+
+TEST_F(IngredientmanagementTest, HuffmanTableMatchesTreeWalkTest) {
+	char names[500][100];
+	uint64_t freq[256] = { 0 };
+	for (int i = 0; i < 500; i++) {
+		makeSyntheticName(i * 37, names[i], sizeof(names[i]));
+		for (int j = 0; names[i][j] != '\0'; j++) {
+			freq[(unsigned char)names[i][j]]++;
+		}
+	}
+	// Rare characters with Fibonacci frequencies force codes longer than the table
+	const char* rare = "!#$%&*+;<=>?@^_`{|}~";
+	int a = 1, b = 1;
+	for (int i = 0; rare[i] != '\0'; i++) {
+		freq[(unsigned char)rare[i]] = a;
+		int next = a + b;
+		a = b;
+		b = next;
+	}
+	strcpy(names[0], "~Red|Onion!");
+	strcpy(names[1], rare);
+
+	HuffmanCodebook book;
+	ASSERT_TRUE(buildHuffmanCodebook(freq, &book));
+	EXPECT_GT(book.encoder.lengths[(unsigned char)'!'], HUFFMAN_TABLE_BITS);
+	HuffmanTreeNode* root = buildTreeFromCodebook(&book);
+
+	for (int i = 0; i < 500; i++) {
+		uint8_t payload[HUFFMAN_MAX_PAYLOAD_BYTES];
+		int payloadBytes = encodeHuffmanName(&book, names[i], payload, (int)sizeof(payload));
+		ASSERT_GT(payloadBytes, 0);
+
+		char tableDecoded[100];
+		char treeDecoded[100];
+		int nameLength = (int)strlen(names[i]);
+		ASSERT_TRUE(decodeHuffmanName(&book, payload, payloadBytes, nameLength, tableDecoded));
+		decodeWithTreeWalk(root, payload, nameLength, treeDecoded);
+		EXPECT_STREQ(tableDecoded, names[i]);
+		EXPECT_STREQ(treeDecoded, names[i]);
+	}
+
+	freeHuffmanTree(root);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_HuffmanDecodeBenchmark) {
+	const int nameCount = 1000000;
+	uint64_t freq[256] = { 0 };
+	char name[100];
+	for (int i = 0; i < nameCount; i++) {
+		makeSyntheticName(i, name, sizeof(name));
+		for (int j = 0; name[j] != '\0'; j++) {
+			freq[(unsigned char)name[j]]++;
+		}
+	}
+
+	HuffmanCodebook book;
+	ASSERT_TRUE(buildHuffmanCodebook(freq, &book));
+	HuffmanTreeNode* root = buildTreeFromCodebook(&book);
+
+	std::vector<uint8_t> payloads;
+	std::vector<int> offsets(nameCount + 1);
+	std::vector<uint8_t> lengths(nameCount);
+	for (int i = 0; i < nameCount; i++) {
+		makeSyntheticName(i, name, sizeof(name));
+		uint8_t payload[HUFFMAN_MAX_PAYLOAD_BYTES];
+		int payloadBytes = encodeHuffmanName(&book, name, payload, (int)sizeof(payload));
+		offsets[i] = (int)payloads.size();
+		lengths[i] = (uint8_t)strlen(name);
+		payloads.insert(payloads.end(), payload, payload + payloadBytes);
+	}
+	offsets[nameCount] = (int)payloads.size();
+
+	unsigned long checksum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < nameCount; i++) {
+		decodeWithTreeWalk(root, &payloads[offsets[i]], lengths[i], name);
+		checksum += (unsigned char)name[0];
+	}
+	double treeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < nameCount; i++) {
+		decodeHuffmanName(&book, &payloads[offsets[i]], offsets[i + 1] - offsets[i], lengths[i], name);
+		checksum -= (unsigned char)name[0];
+	}
+	double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(checksum, 0ul);
+	printf("Decoded %d names (%zu payload bytes): tree walk %.3f s, table %.3f s\n",
+		nameCount, payloads.size(), treeSeconds, tableSeconds);
+
+	freeHuffmanTree(root);
+}
+
+TEST_F(IngredientmanagementTest, CatalogFindLinkUnlinkTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	for (int id = 1; id <= 1000; id++) {
+		Ingredient* ingredient = (Ingredient*)malloc(sizeof(Ingredient));
+		ingredient->id = id * 7;
+		snprintf(ingredient->name, sizeof(ingredient->name), "Item%d", id);
+		ingredient->price = (float)id;
+		ingredient->npx = NULL;
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+	EXPECT_EQ(catalog.count, 1000);
+	EXPECT_GE(catalog.capacity, 2000);
+	EXPECT_EQ(catalog.tail->id, 7000);
+
+	// Remove every third ingredient so deletions have to repair the probe runs
+	for (int id = 3; id <= 1000; id += 3) {
+		Ingredient* removed = unlinkCatalogIngredient(&catalog, id * 7);
+		ASSERT_NE(removed, nullptr);
+		free(removed);
+	}
+	EXPECT_EQ(unlinkCatalogIngredient(&catalog, 21), nullptr);
+
+	for (int id = 1; id <= 1000; id++) {
+		Ingredient* found = findIngredientById(&catalog, id * 7);
+		if (id % 3 == 0) {
+			EXPECT_EQ(found, nullptr);
+		}
+		else {
+			ASSERT_NE(found, nullptr);
+			EXPECT_FLOAT_EQ(found->price, (float)id);
+		}
+	}
+	EXPECT_EQ(findIngredientById(&catalog, 8), nullptr);
+	EXPECT_EQ(catalog.count, 667);
+	EXPECT_EQ(catalog.head->id, 7);
+	EXPECT_EQ(catalog.tail->id, 7000);
+	EXPECT_EQ(catalog.tail->prev->id, 6986);
+
+	freeIngredientCatalog(&catalog);
+	EXPECT_EQ(catalog.head, nullptr);
+	EXPECT_EQ(catalog.count, 0);
+}
+
+TEST_F(IngredientmanagementTest, PriceTableDenseIdsTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	IngredientCatalog catalog;
+	attachIngredientCatalog(&catalog, head);
+
+	IngredientPriceTable table;
+	ASSERT_TRUE(buildIngredientPriceTable(&table, &catalog));
+	EXPECT_TRUE(table.dense);
+	EXPECT_EQ(table.count, 3);
+	EXPECT_EQ(findIngredientPriceEntry(&table, 2), 1);
+	EXPECT_STREQ(table.ingredients[1]->name, "Cucumber");
+	EXPECT_EQ(findIngredientPriceEntry(&table, 0), -1);
+	EXPECT_EQ(findIngredientPriceEntry(&table, 4), -1);
+
+	int ids[] = { 3, 1, 9, 3 };
+	int missing = 0;
+	EXPECT_NEAR(sumIngredientPrices(&table, ids, 4, &missing), 4.9, 1e-5);
+	EXPECT_EQ(missing, 1);
+
+	freeIngredientPriceTable(&table);
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, PriceTableSparseIdsTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	for (int id = 1; id <= 500; id++) {
+		Ingredient* ingredient = (Ingredient*)malloc(sizeof(Ingredient));
+		ingredient->id = id * 7;
+		snprintf(ingredient->name, sizeof(ingredient->name), "Item%d", id);
+		ingredient->price = (float)id;
+		ingredient->npx = NULL;
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+
+	IngredientPriceTable table;
+	ASSERT_TRUE(buildIngredientPriceTable(&table, &catalog));
+	EXPECT_FALSE(table.dense);
+	EXPECT_EQ(table.count, 500);
+	for (int id = 1; id <= 500; id++) {
+		int entry = findIngredientPriceEntry(&table, id * 7);
+		ASSERT_EQ(entry, id - 1);
+		EXPECT_EQ(table.ids[entry], id * 7);
+		EXPECT_FLOAT_EQ(table.prices[entry], (float)id);
+	}
+	EXPECT_EQ(findIngredientPriceEntry(&table, 8), -1);
+
+	freeIngredientPriceTable(&table);
+	EXPECT_EQ(findIngredientPriceEntry(&table, 7), -1);
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, PriceIndexRangeAndOrderTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	ASSERT_TRUE(enableIngredientPriceIndex(&catalog));
+	for (int id = 1; id <= 1000; id++) {
+		Ingredient* ingredient = (Ingredient*)malloc(sizeof(Ingredient));
+		ingredient->id = id;
+		snprintf(ingredient->name, sizeof(ingredient->name), "Item%d", id);
+		// Prices repeat every 100 IDs, so equal prices are ordered by ID
+		ingredient->price = (float)((id * 37) % 100);
+		ingredient->npx = NULL;
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+	EXPECT_EQ(catalog.prices->count, 1000);
+
+	Ingredient* results[1000];
+	int found = findCatalogIngredientsByPrice(&catalog, 10.0f, 12.0f, results, 1000);
+	ASSERT_EQ(found, 30);
+	for (int i = 1; i < found; i++) {
+		EXPECT_TRUE(results[i - 1]->price < results[i]->price
+			|| (results[i - 1]->price == results[i]->price && results[i - 1]->id < results[i]->id));
+	}
+	EXPECT_FLOAT_EQ(results[0]->price, 10.0f);
+	EXPECT_FLOAT_EQ(results[found - 1]->price, 12.0f);
+	EXPECT_EQ(findCatalogIngredientsByPrice(&catalog, 10.0f, 12.0f, results, 5), 5);
+	EXPECT_EQ(findCatalogIngredientsByPrice(&catalog, 12.5f, 12.9f, results, 1000), 0);
+
+	// Removing, repricing and adding keep the index in sync
+	for (int id = 1; id <= 1000; id += 2) {
+		Ingredient* removed = unlinkCatalogIngredient(&catalog, id);
+		ASSERT_NE(removed, nullptr);
+		free(removed);
+	}
+	ASSERT_TRUE(setCatalogIngredientPrice(&catalog, findIngredientById(&catalog, 2), 500.0f));
+	EXPECT_EQ(catalog.prices->last->ingredient->id, 2);
+	ASSERT_TRUE(setCatalogIngredientPrice(&catalog, findIngredientById(&catalog, 2), 500.0f));
+	EXPECT_EQ(catalog.prices->count, 500);
+	EXPECT_EQ(findCatalogIngredientsByPrice(&catalog, 10.0f, 12.0f, results, 1000), 20);
+
+	int descending = 0;
+	float previous = 1000.0f;
+	for (const IngredientPriceNode* node = catalog.prices->last; node != NULL; node = node->prev) {
+		EXPECT_LE(node->price, previous);
+		previous = node->price;
+		descending++;
+	}
+	EXPECT_EQ(descending, 500);
+
+	// Without an index the same range comes back in the same order
+	Ingredient* indexed[1000];
+	int indexedCount = findCatalogIngredientsByPrice(&catalog, 0.0f, 50.0f, indexed, 1000);
+	freeIngredientPriceIndex(catalog.prices);
+	free(catalog.prices);
+	catalog.prices = nullptr;
+	ASSERT_EQ(findCatalogIngredientsByPrice(&catalog, 0.0f, 50.0f, results, 1000), indexedCount);
+	for (int i = 0; i < indexedCount; i++) {
+		EXPECT_EQ(results[i], indexed[i]);
+	}
+
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, CatalogNextIdSkipsTakenIdsTest) {
+	Ingredient first = makeIngredient(5, "Tomato", 2.5f);
+	Ingredient second = makeIngredient(6, "Cucumber", 1.8f);
+	Ingredient third = makeIngredient(2, "Onion", 1.2f);
+	first.next = &second;
+	second.prev = &first;
+	second.next = &third;
+	third.prev = &second;
+
+	IngredientCatalog catalog;
+	attachIngredientCatalog(&catalog, &first);
+	EXPECT_EQ(catalog.count, 3);
+	EXPECT_EQ(catalog.tail, &third);
+	EXPECT_EQ(findIngredientById(&catalog, 6), &second);
+	EXPECT_EQ(getNextIngredientId(&catalog), 3);
+
+	EXPECT_EQ(detachIngredientCatalog(&catalog), &first);
+	EXPECT_EQ(catalog.slots, nullptr);
+	EXPECT_EQ(getNextIngredientId(&catalog), 1);
+}
+
+TEST_F(IngredientmanagementTest, WrappedCatalogWalksListTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+
+	IngredientCatalog catalog;
+	wrapIngredientCatalog(&catalog, head);
+	EXPECT_EQ(catalog.count, 2);
+	EXPECT_EQ(findIngredientById(&catalog, 2), head->next);
+	EXPECT_EQ(findIngredientByName(&catalog, " tomato "), head);
+
+	// Mutations through a wrapped catalog never build the indexes
+	ASSERT_NE(addCatalogIngredient(&catalog, "Onion", 1.2, testFilePath), nullptr);
+	EXPECT_EQ(addCatalogIngredient(&catalog, "ONION", 1.2, testFilePath), nullptr);
+	EXPECT_EQ(catalog.slots, nullptr);
+	EXPECT_EQ(catalog.names, nullptr);
+	EXPECT_EQ(getNextIngredientId(&catalog), 4);
+	EXPECT_STREQ(findIngredientById(&catalog, 3)->name, "Onion");
+
+	head = detachIngredientCatalog(&catalog);
+	simulateUserInput("\n");
+	head = removeIngredient(head, 1, testFilePath);
+	resetStdinStdout();
+	ASSERT_NE(head, nullptr);
+	EXPECT_EQ(head->id, 2);
+	EXPECT_EQ(head->next->id, 3);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, CatalogAddRemoveIngredientTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	Ingredient* tomato = addCatalogIngredient(&catalog, "Tomato", 2.5, testFilePath);
+	Ingredient* cucumber = addCatalogIngredient(&catalog, "Cucumber", 1.8, testFilePath);
+	ASSERT_NE(tomato, nullptr);
+	ASSERT_NE(cucumber, nullptr);
+	EXPECT_EQ(cucumber->id, 2);
+	EXPECT_EQ(addCatalogIngredient(&catalog, "X", 1.0, testFilePath), nullptr);
+
+	simulateUserInput("\n");
+	bool removed = removeCatalogIngredient(&catalog, 1, testFilePath);
+	resetStdinStdout();
+
+	EXPECT_TRUE(removed);
+	EXPECT_EQ(catalog.head, cucumber);
+	EXPECT_EQ(catalog.tail, cucumber);
+	EXPECT_EQ(findIngredientById(&catalog, 1), nullptr);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_STREQ(loaded->name, "Cucumber");
+	EXPECT_EQ(loaded->next, nullptr);
+
+	freeIngredients(loaded);
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, LoadIngredientsInArenaTest) {
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	head = addIngredient(head, "Onion", 1.2, testFilePath);
+	simulateUserInput("\n");
+	head = removeIngredient(head, 2, testFilePath);
+	resetStdinStdout();
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	IngredientCatalog catalog;
+	loadIngredientCatalogInArena(&catalog, testFilePath, &arena);
+	ASSERT_EQ(catalog.count, 2);
+	EXPECT_EQ(catalog.arena, &arena);
+	EXPECT_STREQ(catalog.head->name, "Tomato");
+	EXPECT_STREQ(catalog.tail->name, "Onion");
+	EXPECT_EQ(arena.blockCount, 1u);
+
+	// Nodes added to and removed from an arena catalog stay in the arena
+	Ingredient* garlic = addCatalogIngredient(&catalog, "Garlic", 0.9, testFilePath);
+	ASSERT_NE(garlic, nullptr);
+	EXPECT_EQ(arena.allocationCount, 4u);
+	simulateUserInput("\n");
+	EXPECT_TRUE(removeCatalogIngredient(&catalog, 1, testFilePath));
+	resetStdinStdout();
+	EXPECT_EQ(catalog.head->id, 3);
+
+	freeIngredientCatalog(&catalog);
+	EXPECT_EQ(arena.blocks, nullptr);
+	freeIngredients(head);
+}
+
+TEST_F(IngredientmanagementTest, ConstructHuffmanTreeInArenaTest) {
+	int freq[256];
+	countFrequencies("abracadabra", freq);
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	HuffmanTreeNode* root = constructHuffmanTreeInArena(freq, &arena);
+	ASSERT_NE(root, nullptr);
+	EXPECT_EQ(root->frequency, 11);
+
+	// Five distinct characters give five leaves and four merged nodes
+	EXPECT_EQ(arena.allocationCount, 9u);
+	EXPECT_EQ(arena.blockCount, 1u);
+	freeMemoryArena(&arena);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_ArenaLoadBenchmark) {
+	const int ingredientCount = 1000000;
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)calloc(1, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		ingredient->price = (float)(i % 100);
+		ingredient->prev = tail;
+		if (tail == NULL) {
+			head = ingredient;
+		}
+		else {
+			tail->next = ingredient;
+		}
+		tail = ingredient;
+	}
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+	freeIngredients(head);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	freeIngredients(loaded);
+	double heapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	start = std::chrono::steady_clock::now();
+	loaded = loadIngredientsFromFileInArena(testFilePath, &arena);
+	size_t blockCount = arena.blockCount;
+	freeMemoryArena(&arena);
+	double arenaSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_NE(loaded, nullptr);
+	printf("Loaded and freed %d ingredients: malloc %.3f s (%d mallocs, %d frees), arena %.3f s (%zu mallocs, %zu frees)\n",
+		ingredientCount, heapSeconds, ingredientCount, ingredientCount, arenaSeconds, blockCount, blockCount);
+}
+
+/**
+ * @brief Writes an ingredient file of synthetic ingredients with IDs 1 to ingredientCount.
+ */
+static void writeSyntheticIngredientFile(const char* filePath, int ingredientCount) {
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)calloc(1, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		ingredient->price = (float)(i % 100);
+		ingredient->prev = tail;
+		if (tail == NULL) {
+			head = ingredient;
+		}
+		else {
+			tail->next = ingredient;
+		}
+		tail = ingredient;
+	}
+	saveIngredientsToFile(head, filePath);
+	while (head != NULL) {
+		Ingredient* temp = head;
+		head = head->next;
+		free(temp);
+	}
+}
+
+TEST_F(IngredientmanagementTest, ParallelLoadMatchesSerialLoadTest) {
+	const int ingredientCount = 3 * INGREDIENT_PARALLEL_LOAD_MIN_CHUNK + 17;
+	writeSyntheticIngredientFile(testFilePath, ingredientCount);
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	Ingredient* serial = loadIngredientsFromFile(testFilePath);
+	Ingredient* parallel = loadIngredientsFromFileInParallel(testFilePath, &arena, 4);
+	Ingredient* heapParallel = loadIngredientsFromFileInParallel(testFilePath, NULL, 4);
+
+	// Chunks are stitched in file order with intact back links
+	int count = 0;
+	Ingredient* expected = serial;
+	Ingredient* actual = parallel;
+	Ingredient* heapActual = heapParallel;
+	while (expected != nullptr) {
+		ASSERT_NE(actual, nullptr);
+		ASSERT_NE(heapActual, nullptr);
+		ASSERT_EQ(actual->id, expected->id);
+		ASSERT_STREQ(actual->name, expected->name);
+		ASSERT_EQ(heapActual->id, expected->id);
+		ASSERT_EQ(actual->prev == nullptr ? 0 : actual->prev->id, expected->prev == nullptr ? 0 : expected->prev->id);
+		expected = expected->next;
+		actual = actual->next;
+		heapActual = heapActual->next;
+		count++;
+	}
+	EXPECT_EQ(actual, nullptr);
+	EXPECT_EQ(heapActual, nullptr);
+	EXPECT_EQ(count, ingredientCount);
+	EXPECT_EQ(arena.allocationCount, (size_t)ingredientCount);
+
+	freeIngredients(serial);
+	freeIngredients(heapParallel);
+	freeMemoryArena(&arena);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_ParallelLoadBenchmark) {
+	const int ingredientCount = 4000000;
+	writeSyntheticIngredientFile(testFilePath, ingredientCount);
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Ingredient* loaded = loadIngredientsFromFileInArena(testFilePath, &arena);
+	double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	EXPECT_NE(loaded, nullptr);
+	freeMemoryArena(&arena);
+
+	int threadCount = (int)std::thread::hardware_concurrency();
+	start = std::chrono::steady_clock::now();
+	loaded = loadIngredientsFromFileInParallel(testFilePath, &arena, 0);
+	double parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	EXPECT_NE(loaded, nullptr);
+	freeMemoryArena(&arena);
+
+	printf("Loaded %d ingredients: 1 thread %.3f s, %d threads %.3f s\n",
+		ingredientCount, serialSeconds, threadCount, parallelSeconds);
+}
+
+/**
+ * @brief Records every match reported by scanIngredientNames as "id:term:position".
+ */
+static void collectIngredientMatch(const Ingredient* ingredient, int termIndex, int position, void* context) {
+	std::vector<std::string>* matches = (std::vector<std::string>*)context;
+	matches->push_back(std::to_string(ingredient->id) + ":" + std::to_string(termIndex) + ":" + std::to_string(position));
+}
+
+TEST_F(IngredientmanagementTest, AhoCorasickReportsEveryMatchTest) {
+	Ingredient first = makeIngredient(1, "ushers", 1.0f);
+	Ingredient second = makeIngredient(2, "Cherry Tomato", 2.0f);
+	first.next = &second;
+
+	// Overlapping terms, a term inside another and a duplicate term
+	const char* terms[] = { "he", "she", "his", "hers", "he", "tom" };
+	IngredientMatcher matcher;
+	ASSERT_TRUE(buildIngredientMatcher(&matcher, terms, 6, false));
+
+	std::vector<std::string> matches;
+	int matchCount = scanIngredientNames(&matcher, &first, collectIngredientMatch, &matches);
+	freeIngredientMatcher(&matcher);
+
+	std::sort(matches.begin(), matches.end());
+	std::vector<std::string> expected = { "1:0:2", "1:1:1", "1:3:2", "1:4:2", "2:0:1", "2:4:1" };
+	EXPECT_EQ(matchCount, 6);
+	EXPECT_EQ(matches, expected);
+}
+
+TEST_F(IngredientmanagementTest, AhoCorasickIgnoreCaseTest) {
+	Ingredient first = makeIngredient(1, "Cherry Tomato", 2.0f);
+	Ingredient second = makeIngredient(2, "Red Onion", 1.0f);
+	first.next = &second;
+
+	const char* terms[] = { "tomato", "ONION", "", "garlic" };
+	IngredientMatcher matcher;
+	ASSERT_TRUE(buildIngredientMatcher(&matcher, terms, 4, true));
+
+	std::vector<std::string> matches;
+	EXPECT_EQ(scanIngredientNames(&matcher, &first, collectIngredientMatch, &matches), 2);
+	ASSERT_EQ(matches.size(), 2u);
+	EXPECT_EQ(matches[0], "1:0:7");
+	EXPECT_EQ(matches[1], "2:1:4");
+	freeIngredientMatcher(&matcher);
+
+	ASSERT_TRUE(buildIngredientMatcher(&matcher, terms, 4, false));
+	EXPECT_EQ(scanIngredientNames(&matcher, &first, NULL, NULL), 0);
+	freeIngredientMatcher(&matcher);
+}
+
+TEST_F(IngredientmanagementTest, SplitSearchTermsTest) {
+	char input[] = " Tomato ,onion,, Extra Virgin Olive Oil ,";
+	char* terms[8];
+	ASSERT_EQ(splitSearchTerms(input, terms, 8), 3);
+	EXPECT_STREQ(terms[0], "Tomato");
+	EXPECT_STREQ(terms[1], "onion");
+	EXPECT_STREQ(terms[2], "Extra Virgin Olive Oil");
+}
+
+TEST_F(IngredientmanagementTest, SearchIngredientsByTermsTest) {
+	Ingredient first = makeIngredient(1, "Cherry Tomato", 2.0f);
+	Ingredient second = makeIngredient(2, "Red Onion", 1.0f);
+	Ingredient third = makeIngredient(3, "Green Onion", 0.5f);
+	first.next = &second;
+	second.next = &third;
+
+	simulateUserInput("onion, tomato, garlic\n\n");
+	searchIngredientsByTerms(&first);
+	resetStdinStdout();
+
+	char buffer[2048];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	EXPECT_NE(strstr(buffer, "Name: Cherry Tomato"), nullptr);
+	EXPECT_NE(strstr(buffer, "Name: Red Onion"), nullptr);
+	EXPECT_NE(strstr(buffer, "Name: Green Onion"), nullptr);
+	EXPECT_NE(strstr(buffer, "Ingredient 'garlic' not found in the list."), nullptr);
+	EXPECT_NE(strstr(buffer, "3 match(es) found for 3 search term(s)."), nullptr);
+}
+
+TEST_F(IngredientmanagementTest, TrigramIndexQueryIntersectsPostingsTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	Ingredient first = makeIngredient(1, "Red Onion", 1.0f);
+	Ingredient second = makeIngredient(2, "Green Onion", 0.5f);
+	Ingredient third = makeIngredient(3, "Red Pepper", 1.5f);
+	linkCatalogIngredient(&catalog, &first);
+	linkCatalogIngredient(&catalog, &second);
+	ASSERT_TRUE(enableIngredientTrigramIndex(&catalog));
+	linkCatalogIngredient(&catalog, &third);
+
+	int* ids = NULL;
+	int count = queryIngredientTrigramIndex(catalog.trigrams, "onion", &ids);
+	ASSERT_EQ(count, 2);
+	EXPECT_EQ(ids[0], 1);
+	EXPECT_EQ(ids[1], 2);
+	free(ids);
+
+	ids = NULL;
+	EXPECT_EQ(queryIngredientTrigramIndex(catalog.trigrams, "Red P", &ids), 1);
+	ASSERT_NE(ids, nullptr);
+	EXPECT_EQ(ids[0], 3);
+	free(ids);
+
+	ids = NULL;
+	EXPECT_EQ(queryIngredientTrigramIndex(catalog.trigrams, "Garlic", &ids), 0);
+	free(ids);
+	EXPECT_EQ(queryIngredientTrigramIndex(catalog.trigrams, "On", &ids), -1);
+
+	detachIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, TrigramIndexFollowsCatalogChangesTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	ASSERT_TRUE(enableIngredientTrigramIndex(&catalog));
+	Ingredient* tomato = addCatalogIngredient(&catalog, "Cherry Tomato", 2.5, testFilePath);
+	Ingredient* onion = addCatalogIngredient(&catalog, "Red Onion", 1.0, testFilePath);
+	ASSERT_NE(tomato, nullptr);
+	ASSERT_NE(onion, nullptr);
+
+	Ingredient* results[4];
+	ASSERT_EQ(findCatalogIngredientsByName(&catalog, "Tomato", results, 4), 1);
+	EXPECT_EQ(results[0], tomato);
+
+	renameCatalogIngredient(&catalog, tomato, "Plum Tomato");
+	EXPECT_EQ(findCatalogIngredientsByName(&catalog, "Cherry", results, 4), 0);
+	ASSERT_EQ(findCatalogIngredientsByName(&catalog, "Plum", results, 4), 1);
+	EXPECT_EQ(results[0], tomato);
+
+	simulateUserInput("\n");
+	bool removed = removeCatalogIngredient(&catalog, onion->id, testFilePath);
+	resetStdinStdout();
+	EXPECT_TRUE(removed);
+	EXPECT_EQ(findCatalogIngredientsByName(&catalog, "Onion", results, 4), 0);
+
+	// Patterns shorter than a trigram fall back to scanning every name
+	ASSERT_EQ(findCatalogIngredientsByName(&catalog, "Pl", results, 4), 1);
+	EXPECT_EQ(results[0], tomato);
+
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, SearchCatalogIngredientsByTermsTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	Ingredient first = makeIngredient(1, "Cherry Tomato", 2.0f);
+	Ingredient second = makeIngredient(2, "Red Onion", 1.0f);
+	Ingredient third = makeIngredient(3, "Green Onion", 0.5f);
+	linkCatalogIngredient(&catalog, &first);
+	linkCatalogIngredient(&catalog, &second);
+	linkCatalogIngredient(&catalog, &third);
+	ASSERT_TRUE(enableIngredientTrigramIndex(&catalog));
+
+	simulateUserInput("ONION, garlic\n\n");
+	searchCatalogIngredientsByTerms(&catalog);
+	resetStdinStdout();
+
+	char buffer[2048];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	EXPECT_EQ(strstr(buffer, "Name: Cherry Tomato"), nullptr);
+	EXPECT_NE(strstr(buffer, "Name: Red Onion"), nullptr);
+	EXPECT_NE(strstr(buffer, "Name: Green Onion"), nullptr);
+	EXPECT_NE(strstr(buffer, "Ingredient 'garlic' not found in the list."), nullptr);
+	EXPECT_NE(strstr(buffer, "2 match(es) found for 2 search term(s)."), nullptr);
+
+	detachIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_TrigramSearchBenchmark) {
+	const int ingredientCount = 300000;
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)allocateFromMemoryArena(&arena, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		ingredient->price = (float)(i % 100);
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+	catalog.arena = &arena;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ASSERT_TRUE(enableIngredientTrigramIndex(&catalog));
+	double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const char* pattern = "Basil Paprika Sea 4";
+	const int rounds = 100;
+	static Ingredient* results[ingredientCount];
+
+	start = std::chrono::steady_clock::now();
+	int scanned = 0;
+	int lps[sizeof(((Ingredient*)0)->name)];
+	int m = strlen(pattern);
+	computeLPSArray(pattern, lps, m);
+	for (int round = 0; round < rounds; round++) {
+		scanned = 0;
+		for (Ingredient* current = catalog.head; current != NULL; current = current->next) {
+			if (KMPSearchWithLPS(current->name, pattern, lps, m)) {
+				results[scanned++] = current;
+			}
+		}
+	}
+	double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+	start = std::chrono::steady_clock::now();
+	int indexed = 0;
+	for (int round = 0; round < rounds; round++) {
+		indexed = findCatalogIngredientsByName(&catalog, pattern, results, ingredientCount);
+	}
+	double indexSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+	EXPECT_EQ(indexed, scanned);
+	printf("Searched %d names for '%s' (%d hits): full scan %.3f ms, trigram index %.3f ms (built in %.3f s)\n",
+		ingredientCount, pattern, indexed, scanSeconds * 1000.0, indexSeconds * 1000.0, buildSeconds);
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, FuzzyDistanceMatchesEditDistanceTest) {
+	IngredientFuzzyPattern fuzzy;
+	ASSERT_TRUE(buildIngredientFuzzyPattern(&fuzzy, "tomato", true));
+	EXPECT_EQ(getIngredientNameDistance(&fuzzy, "Cherry Tomato", -1), 0);
+	EXPECT_EQ(getIngredientNameDistance(&fuzzy, "Cherry Tomatto", -1), 1);
+	EXPECT_EQ(getIngredientNameDistance(&fuzzy, "Tmoato", -1), 2);
+	EXPECT_EQ(getIngredientNameDistance(&fuzzy, "", -1), 6);
+
+	ASSERT_TRUE(buildIngredientFuzzyPattern(&fuzzy, "tomato", false));
+	EXPECT_EQ(getIngredientNameDistance(&fuzzy, "Tomato", -1), 1);
+
+	char longPattern[INGREDIENT_FUZZY_MAX_PATTERN_LENGTH + 2];
+	memset(longPattern, 'a', sizeof(longPattern) - 1);
+	longPattern[sizeof(longPattern) - 1] = '\0';
+	EXPECT_FALSE(buildIngredientFuzzyPattern(&fuzzy, longPattern, true));
+	EXPECT_FALSE(buildIngredientFuzzyPattern(&fuzzy, "", true));
+
+	longPattern[INGREDIENT_FUZZY_MAX_PATTERN_LENGTH] = '\0';
+	ASSERT_TRUE(buildIngredientFuzzyPattern(&fuzzy, longPattern, true));
+	longPattern[10] = 'b';
+	EXPECT_EQ(getIngredientNameDistance(&fuzzy, longPattern, -1), 1);
+}
+
+TEST_F(IngredientmanagementTest, FindIngredientsFuzzyRanksByDistanceTest) {
+	Ingredient first = makeIngredient(1, "Red Onin", 1.0f);
+	Ingredient second = makeIngredient(2, "Green Onion", 0.5f);
+	Ingredient third = makeIngredient(3, "Garlic", 0.8f);
+	Ingredient fourth = makeIngredient(4, "Onions", 0.7f);
+	first.next = &second;
+	second.next = &third;
+	third.next = &fourth;
+
+	IngredientFuzzyMatch results[4];
+	int count = findIngredientsFuzzy(&first, "ONIONS", 2, results, 4);
+	ASSERT_EQ(count, 3);
+	EXPECT_EQ(results[0].ingredient, &fourth);
+	EXPECT_EQ(results[0].distance, 0);
+	EXPECT_EQ(results[1].ingredient, &second);
+	EXPECT_EQ(results[1].distance, 1);
+	EXPECT_EQ(results[2].ingredient, &first);
+	EXPECT_EQ(results[2].distance, 2);
+
+	EXPECT_EQ(findIngredientsFuzzy(&first, "ONIONS", 2, results, 1), 1);
+	EXPECT_EQ(results[0].ingredient, &fourth);
+	EXPECT_EQ(findIngredientsFuzzy(&first, "", 2, results, 4), -1);
+}
+
+TEST_F(IngredientmanagementTest, SearchIngredientsByTermsSuggestsNamesTest) {
+	Ingredient first = makeIngredient(1, "Cherry Tomato", 2.0f);
+	Ingredient second = makeIngredient(2, "Red Onion", 1.0f);
+	first.next = &second;
+
+	simulateUserInput("tomatto\n\n");
+	searchIngredientsByTerms(&first);
+	resetStdinStdout();
+
+	char buffer[2048];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	EXPECT_NE(strstr(buffer, "Ingredient 'tomatto' not found in the list."), nullptr);
+	EXPECT_NE(strstr(buffer, "Did you mean: Cherry Tomato (1 edit)?"), nullptr);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_FuzzySearchBenchmark) {
+	const int ingredientCount = 300000;
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)allocateFromMemoryArena(&arena, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		ingredient->next = NULL;
+		if (tail == NULL) {
+			head = ingredient;
+		}
+		else {
+			tail->next = ingredient;
+		}
+		tail = ingredient;
+	}
+
+	const char* pattern = "Paprka Olive";
+	const int rounds = 20;
+	IngredientFuzzyMatch results[10];
+	int found = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int round = 0; round < rounds; round++) {
+		found = findIngredientsFuzzy(head, pattern, 2, results, 10);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+	EXPECT_GT(found, 0);
+	printf("Fuzzy search for '%s' within 2 edits over %d names: %.3f ms\n", pattern, ingredientCount, seconds * 1000.0);
+	freeMemoryArena(&arena);
+}
+
+TEST_F(IngredientmanagementTest, NameArenaPacksLowerCaseNamesTest) {
+	Ingredient first = makeIngredient(1, "Red Onion", 1.0f);
+	Ingredient second = makeIngredient(2, "", 0.5f);
+	Ingredient third = makeIngredient(3, "Basil", 0.8f);
+	first.next = &second;
+	second.next = &third;
+
+	IngredientNameArena arena;
+	ASSERT_TRUE(buildIngredientNameArena(&arena, &first));
+	ASSERT_EQ(arena.count, 3);
+	EXPECT_EQ(arena.size, (size_t)(1 + 9 + 1 + 1 + 5));
+	EXPECT_EQ(arena.data[0], 9);
+	EXPECT_EQ(memcmp(arena.data + arena.starts[0], "red onion", 9), 0);
+	EXPECT_EQ(arena.data[arena.starts[1] - 1], 0);
+	EXPECT_EQ(memcmp(arena.data + arena.starts[2], "basil", 5), 0);
+	EXPECT_EQ(arena.ingredients[2], &third);
+	freeIngredientNameArena(&arena);
+	EXPECT_EQ(arena.data, nullptr);
+}
+
+TEST_F(IngredientmanagementTest, NameArenaScanBackendsAgreeTest) {
+	const int ingredientCount = 2000;
+	std::vector<Ingredient> ingredients(ingredientCount);
+	for (int i = 0; i < ingredientCount; i++) {
+		ingredients[i].id = i + 1;
+		makeSyntheticName(i * 7, ingredients[i].name, sizeof(ingredients[i].name));
+		ingredients[i].next = i + 1 < ingredientCount ? &ingredients[i + 1] : NULL;
+	}
+	IngredientNameArena arena;
+	ASSERT_TRUE(buildIngredientNameArena(&arena, &ingredients[0]));
+
+	// Names end right before the next length byte, so no match may span two records
+	const char* patterns[] = { "ONION", "a", "oil 1", "pepper garlic", "tomato flour", "1 o", "nothing", "" };
+	std::vector<Ingredient*> expected(ingredientCount);
+	std::vector<Ingredient*> actual(ingredientCount);
+	for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+		int expectedCount = 0;
+		for (int i = 0; i < ingredientCount; i++) {
+			std::string name(ingredients[i].name);
+			std::string pattern(patterns[p]);
+			std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+			std::transform(pattern.begin(), pattern.end(), pattern.begin(), ::tolower);
+			if (name.find(pattern) != std::string::npos) {
+				expected[expectedCount++] = &ingredients[i];
+			}
+		}
+		for (int backend = INGREDIENT_SCAN_SCALAR; backend <= INGREDIENT_SCAN_AVX2; backend++) {
+			int count = scanIngredientNameArena(&arena, patterns[p], (IngredientScanBackend)backend, actual.data(), ingredientCount);
+			ASSERT_EQ(count, expectedCount) << patterns[p] << " with " << getIngredientScanBackendName((IngredientScanBackend)backend);
+			for (int i = 0; i < count; i++) {
+				EXPECT_EQ(actual[i], expected[i]);
+			}
+		}
+	}
+
+	Ingredient* firstMatch = NULL;
+	EXPECT_EQ(scanIngredientNameArena(&arena, "onion", getIngredientScanBackend(), &firstMatch, 1), 1);
+	EXPECT_NE(firstMatch, nullptr);
+	freeIngredientNameArena(&arena);
+}
+
+TEST_F(IngredientmanagementTest, NameScanIgnoresCaseTest) {
+	Ingredient first = makeIngredient(1, "Cherry Tomato", 2.0f);
+	Ingredient second = makeIngredient(2, "Red Onion", 1.0f);
+	first.next = &second;
+
+	IngredientNameArena arena;
+	ASSERT_TRUE(buildIngredientNameArena(&arena, &first));
+	Ingredient* match = NULL;
+	EXPECT_EQ(scanIngredientNameArena(&arena, "ONION", getIngredientScanBackend(), &match, 1), 1);
+	EXPECT_EQ(match, &second);
+	EXPECT_EQ(scanIngredientNameArena(&arena, "garlic", getIngredientScanBackend(), &match, 1), 0);
+	freeIngredientNameArena(&arena);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_NameScanBenchmark) {
+	const int ingredientCount = 1000000;
+	MemoryArena nodes;
+	initMemoryArena(&nodes, 0);
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)allocateFromMemoryArena(&nodes, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		ingredient->next = NULL;
+		if (tail == NULL) {
+			head = ingredient;
+		}
+		else {
+			tail->next = ingredient;
+		}
+		tail = ingredient;
+	}
+	IngredientNameArena arena;
+	ASSERT_TRUE(buildIngredientNameArena(&arena, head));
+
+	// A pattern that occurs nowhere forces every backend through the whole catalog
+	const char* pattern = "saffron";
+	const int rounds = 20;
+	std::vector<Ingredient*> results(ingredientCount);
+	int m = strlen(pattern);
+	int lps[16];
+	computeLPSArray(pattern, lps, m);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int found = 0;
+	for (int round = 0; round < rounds; round++) {
+		for (Ingredient* current = head; current != NULL; current = current->next) {
+			found += KMPSearchWithLPS(current->name, pattern, lps, m);
+		}
+	}
+	double kmpSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+	printf("Scanned %d names (%zu bytes packed): KMP over nodes %.2f ms", ingredientCount, arena.size, kmpSeconds * 1000.0);
+
+	for (int backend = INGREDIENT_SCAN_SCALAR; backend <= (int)getIngredientScanBackend(); backend++) {
+		start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; round++) {
+			found += scanIngredientNameArena(&arena, pattern, (IngredientScanBackend)backend, results.data(), ingredientCount);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+		printf(", %s %.2f ms (%.1f GB/s)", getIngredientScanBackendName((IngredientScanBackend)backend), seconds * 1000.0, arena.size / seconds / 1e9);
+	}
+	printf("\n");
+
+	EXPECT_EQ(found, 0);
+	freeIngredientNameArena(&arena);
+	freeMemoryArena(&nodes);
+}
+
+TEST_F(IngredientmanagementTest, IngredientTrieSplitsAndCompletesTest) {
+	IngredientTrie trie;
+	ASSERT_TRUE(initIngredientTrie(&trie));
+	EXPECT_TRUE(insertIngredientTrie(&trie, "Tomato", 1));
+	EXPECT_TRUE(insertIngredientTrie(&trie, "Tomato Paste", 2));
+	EXPECT_TRUE(insertIngredientTrie(&trie, "Tofu", 3));
+	EXPECT_TRUE(insertIngredientTrie(&trie, "Basil", 4));
+	EXPECT_TRUE(insertIngredientTrie(&trie, "tomato", 5));
+	EXPECT_EQ(trie.count, 5);
+
+	// "to" is shared by three names, so the first edge is split there
+	ASSERT_EQ(trie.root->childCount, 2);
+	IngredientTrieNode* to = trie.root->children[1];
+	EXPECT_EQ(std::string(to->label, to->labelLength), "to");
+	EXPECT_EQ(to->childCount, 2);
+
+	int ids[8];
+	ASSERT_EQ(completeIngredientTrie(&trie, "TO", ids, 8), 4);
+	EXPECT_EQ(ids[0], 3);
+	EXPECT_EQ(ids[1], 1);
+	EXPECT_EQ(ids[2], 5);
+	EXPECT_EQ(ids[3], 2);
+	EXPECT_EQ(completeIngredientTrie(&trie, "tomato p", ids, 8), 1);
+	EXPECT_EQ(ids[0], 2);
+	EXPECT_EQ(completeIngredientTrie(&trie, "tomatoes", ids, 8), 0);
+	EXPECT_EQ(completeIngredientTrie(&trie, "", ids, 2), 2);
+	EXPECT_EQ(ids[0], 4);
+
+	EXPECT_FALSE(removeIngredientTrie(&trie, "Tomato", 9));
+	EXPECT_TRUE(removeIngredientTrie(&trie, "Tofu", 3));
+	EXPECT_TRUE(removeIngredientTrie(&trie, "Tomato", 1));
+	EXPECT_TRUE(removeIngredientTrie(&trie, "Tomato", 5));
+
+	// With only "tomato paste" left below "to" the chain is merged back into one edge
+	ASSERT_EQ(trie.root->childCount, 2);
+	IngredientTrieNode* merged = trie.root->children[1];
+	EXPECT_EQ(std::string(merged->label, merged->labelLength), "tomato paste");
+	EXPECT_EQ(merged->childCount, 0);
+	EXPECT_EQ(completeIngredientTrie(&trie, "tom", ids, 8), 1);
+	EXPECT_EQ(trie.count, 2);
+	freeIngredientTrie(&trie);
+}
+
+TEST_F(IngredientmanagementTest, CatalogNameTrieFollowsChangesTest) {
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	Ingredient* tomato = addCatalogIngredient(&catalog, "Cherry Tomato", 2.5, testFilePath);
+	ASSERT_NE(tomato, nullptr);
+	ASSERT_TRUE(enableIngredientNameTrie(&catalog));
+	Ingredient* cheese = addCatalogIngredient(&catalog, "Cheddar", 4.0, testFilePath);
+	ASSERT_NE(cheese, nullptr);
+
+	Ingredient* results[4];
+	ASSERT_EQ(completeCatalogIngredientNames(&catalog, "ch", results, 4), 2);
+	EXPECT_EQ(results[0], cheese);
+	EXPECT_EQ(results[1], tomato);
+
+	renameCatalogIngredient(&catalog, tomato, "Plum Tomato");
+	ASSERT_EQ(completeCatalogIngredientNames(&catalog, "ch", results, 4), 1);
+	EXPECT_EQ(results[0], cheese);
+	ASSERT_EQ(completeCatalogIngredientNames(&catalog, "plum", results, 4), 1);
+	EXPECT_EQ(results[0], tomato);
+
+	// A name that folds to the same key keeps a single entry
+	ASSERT_TRUE(renameCatalogIngredient(&catalog, cheese, "CHEDDAR"));
+	ASSERT_EQ(completeCatalogIngredientNames(&catalog, "ch", results, 4), 1);
+	EXPECT_STREQ(results[0]->name, "CHEDDAR");
+
+	simulateUserInput("\n");
+	bool removed = removeCatalogIngredient(&catalog, cheese->id, testFilePath);
+	resetStdinStdout();
+	EXPECT_TRUE(removed);
+	EXPECT_EQ(completeCatalogIngredientNames(&catalog, "ch", results, 4), 0);
+
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_TrieCompletionBenchmark) {
+	const int ingredientCount = 300000;
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	IngredientCatalog catalog;
+	initIngredientCatalog(&catalog);
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)allocateFromMemoryArena(&arena, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		linkCatalogIngredient(&catalog, ingredient);
+	}
+	catalog.arena = &arena;
+
+	const int rounds = 1000;
+	Ingredient* results[10];
+	int found = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int round = 0; round < 10; round++) {
+		found = completeCatalogIngredientNames(&catalog, "smoked paprika o", results, 10);
+	}
+	double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 10;
+
+	start = std::chrono::steady_clock::now();
+	ASSERT_TRUE(enableIngredientNameTrie(&catalog));
+	double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < rounds; round++) {
+		found = completeCatalogIngredientNames(&catalog, "smoked paprika o", results, 10);
+	}
+	double trieSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+	EXPECT_EQ(found, 10);
+	printf("Top 10 completions over %d names: list scan %.3f ms, trie %.4f ms (built in %.3f s)\n",
+		ingredientCount, scanSeconds * 1000.0, trieSeconds * 1000.0, buildSeconds);
+	freeIngredientCatalog(&catalog);
+}
+
+TEST_F(IngredientmanagementTest, ParseIngredientCsvLineTest) {
+	char name[INGREDIENT_NAME_SIZE];
+	float price = 0.0f;
+	const char* line = "  Olive Oil , 12.50\r";
+	ASSERT_TRUE(parseIngredientCsvLine(line, strlen(line), name, &price));
+	EXPECT_STREQ(name, "Olive Oil");
+	EXPECT_FLOAT_EQ(price, 12.5f);
+
+	line = "Salt, Sea,1e-1";
+	ASSERT_TRUE(parseIngredientCsvLine(line, strlen(line), name, &price));
+	EXPECT_STREQ(name, "Salt, Sea");
+	EXPECT_FLOAT_EQ(price, 0.1f);
+
+	line = "\"Pepper \"\"Black\"\", Ground\", +3";
+	ASSERT_TRUE(parseIngredientCsvLine(line, strlen(line), name, &price));
+	EXPECT_STREQ(name, "Pepper \"Black\", Ground");
+	EXPECT_FLOAT_EQ(price, 3.0f);
+
+	const char* invalid[] = { "Basil", ",1.0", "Basil,", "Basil,abc", "Basil,1.5x", "Basil,-1", "Basil,inf", "\"Basil,1.0", "\"Basil\" x,1.0" };
+	for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		EXPECT_FALSE(parseIngredientCsvLine(invalid[i], strlen(invalid[i]), name, &price)) << invalid[i];
+	}
+
+	std::string longName(INGREDIENT_NAME_SIZE, 'a');
+	std::string longLine = longName + ",1.0";
+	EXPECT_FALSE(parseIngredientCsvLine(longLine.c_str(), longLine.size(), name, &price));
+	longLine = longName.substr(1) + ",1.0";
+	EXPECT_TRUE(parseIngredientCsvLine(longLine.c_str(), longLine.size(), name, &price));
+}
+
+TEST_F(IngredientmanagementTest, ImportIngredientsFromCsvTest) {
+	const char* csvPath = "testimport.csv";
+	Ingredient* head = NULL;
+	head = addIngredient(head, "Tomato", 2.5f, testFilePath);
+	freeIngredients(head);
+
+	FILE* csv = fopen(csvPath, "wb");
+	ASSERT_NE(csv, nullptr);
+	fputs("name,price\r\nBasil,1.25\r\n\r\nbroken row\nGarlic,0.75\nOnion,x\n\"Salt, Sea\",0.5", csv);
+	fclose(csv);
+
+	IngredientImportResult result;
+	ASSERT_TRUE(importIngredientsFromCsv(csvPath, testFilePath, &result));
+	EXPECT_EQ(result.imported, 3);
+	EXPECT_EQ(result.rejected, 2);
+	EXPECT_EQ(result.firstRejectedLine, 4);
+	EXPECT_EQ(result.firstId, 2);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	const char* names[] = { "Tomato", "Basil", "Garlic", "Salt, Sea" };
+	Ingredient* current = loaded;
+	for (int i = 0; i < 4; i++) {
+		ASSERT_NE(current, nullptr);
+		EXPECT_EQ(current->id, i + 1);
+		EXPECT_STREQ(current->name, names[i]);
+		current = current->next;
+	}
+	EXPECT_EQ(current, nullptr);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+	freeIngredients(loaded);
+
+	Ingredient* encoded = loadHuffmanEncodedIngredientsFromFile();
+	ASSERT_NE(encoded, nullptr);
+	EXPECT_STREQ(encoded->next->name, "Basil");
+	freeIngredients(encoded);
+
+	EXPECT_FALSE(importIngredientsFromCsv("missing.csv", testFilePath, &result));
+	remove(csvPath);
+}
+
+TEST_F(IngredientmanagementTest, ImportRejectsOverlongRowOnceTest) {
+	const char* csvPath = "testimport.csv";
+	FILE* csv = fopen(csvPath, "wb");
+	ASSERT_NE(csv, nullptr);
+	fputs("name,price\n", csv);
+	std::string overlong(3 * INGREDIENT_CSV_BUFFER_SIZE + 100, 'a');
+	fputs(overlong.c_str(), csv);
+	fputs(",1.0\nBasil,1.0\nOnion,x\n", csv);
+	fclose(csv);
+
+	// The row spans several buffer refills but is still a single rejected line
+	IngredientImportResult result;
+	ASSERT_TRUE(importIngredientsFromCsv(csvPath, testFilePath, &result));
+	EXPECT_EQ(result.imported, 1);
+	EXPECT_EQ(result.rejected, 2);
+	EXPECT_EQ(result.firstRejectedLine, 2);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_STREQ(loaded->name, "Basil");
+	EXPECT_EQ(loaded->next, nullptr);
+	freeIngredients(loaded);
+	remove(csvPath);
+}
+
+TEST_F(IngredientmanagementTest, ImportMergesRowsWithExistingNamesTest) {
+	const char* csvPath = "testimport.csv";
+	Ingredient* head = NULL;
+	head = addIngredient(head, "Tomato", 2.5f, testFilePath);
+	freeIngredients(head);
+
+	FILE* csv = fopen(csvPath, "wb");
+	ASSERT_NE(csv, nullptr);
+	fputs("TOMATO ,3.5\nBasil,1.0\n basil,2.0\n", csv);
+	fclose(csv);
+
+	IngredientImportResult result;
+	ASSERT_TRUE(importIngredientsFromCsv(csvPath, testFilePath, &result));
+	EXPECT_EQ(result.imported, 1);
+	EXPECT_EQ(result.merged, 2);
+
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	ASSERT_NE(loaded, nullptr);
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_STREQ(loaded->name, "Tomato");
+	EXPECT_FLOAT_EQ(loaded->price, 3.5f);
+	EXPECT_STREQ(loaded->next->name, "Basil");
+	EXPECT_FLOAT_EQ(loaded->next->price, 2.0f);
+	EXPECT_EQ(loaded->next->next, nullptr);
+
+	freeIngredients(loaded);
+	remove(csvPath);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_CsvImportBenchmark) {
+	const char* csvPath = "testimport.csv";
+	const int rowCount = 1000000;
+	FILE* csv = fopen(csvPath, "wb");
+	ASSERT_NE(csv, nullptr);
+	fputs("name,price\n", csv);
+	char name[INGREDIENT_NAME_SIZE];
+	for (int i = 0; i < rowCount; i++) {
+		makeSyntheticName(i, name, sizeof(name));
+		fprintf(csv, "%s,%d.%02d\n", name, i % 100, i % 97);
+	}
+	fclose(csv);
+
+	IngredientImportResult result;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ASSERT_TRUE(importIngredientsFromCsv(csvPath, testFilePath, &result));
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(result.imported, rowCount);
+	printf("Imported %d CSV rows into the ingredient and Huffman files in %.3f s\n", result.imported, seconds);
+	remove(csvPath);
+}
+
+static std::string readWholeFile(const char* filePath) {
+	std::string content;
+	FILE* file = fopen(filePath, "rb");
+	if (file == NULL) {
+		return content;
+	}
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		content.append(buffer, read);
+	}
+	fclose(file);
+	return content;
+}
+
+TEST_F(IngredientmanagementTest, ExportIngredientsCsvRoundTripTest) {
+	const char* csvPath = "testexport.csv";
+	Ingredient first = makeIngredient(1, "Olive Oil", 12.5f);
+	Ingredient second = makeIngredient(2, "Pepper \"Black\", Ground", 0.1f);
+	Ingredient third = makeIngredient(3, " Basil", 3.0f);
+	first.next = &second;
+	second.next = &third;
+
+	ASSERT_TRUE(exportIngredients(&first, csvPath, EXPORT_FORMAT_CSV));
+	EXPECT_EQ(readWholeFile(csvPath), "id,name,price\n1,Olive Oil,12.5\n2,\"Pepper \"\"Black\"\", Ground\",0.1\n3,\" Basil\",3\n");
+
+	// Every row reads back through the import parser once the ID column is dropped
+	std::string content = readWholeFile(csvPath);
+	size_t lineStart = content.find('\n') + 1;
+	for (Ingredient* expected = &first; expected != NULL; expected = expected->next) {
+		size_t lineEnd = content.find('\n', lineStart);
+		size_t fieldStart = content.find(',', lineStart) + 1;
+		char name[INGREDIENT_NAME_SIZE];
+		float price;
+		ASSERT_TRUE(parseIngredientCsvLine(content.c_str() + fieldStart, lineEnd - fieldStart, name, &price));
+		EXPECT_STREQ(name, expected->name);
+		EXPECT_EQ(price, expected->price);
+		lineStart = lineEnd + 1;
+	}
+	remove(csvPath);
+}
+
+TEST_F(IngredientmanagementTest, ExportIngredientsJsonTest) {
+	const char* jsonPath = "testexport.json";
+	Ingredient first = makeIngredient(1, "Olive \"Extra\" Oil", 12.5f);
+	Ingredient second = makeIngredient(2, "Tab\there\\", 0.25f);
+	first.next = &second;
+
+	ASSERT_TRUE(exportIngredients(&first, jsonPath, EXPORT_FORMAT_JSON));
+	EXPECT_EQ(readWholeFile(jsonPath),
+		"[\n  {\"id\":1,\"name\":\"Olive \\\"Extra\\\" Oil\",\"price\":12.5},\n  {\"id\":2,\"name\":\"Tab\\there\\\\\",\"price\":0.25}\n]\n");
+
+	ASSERT_TRUE(exportIngredients(NULL, jsonPath, EXPORT_FORMAT_JSON));
+	EXPECT_EQ(readWholeFile(jsonPath), "[]\n");
+	remove(jsonPath);
+
+	ExportFormat format;
+	EXPECT_TRUE(parseExportFormat("json", &format));
+	EXPECT_EQ(format, EXPORT_FORMAT_JSON);
+	EXPECT_FALSE(parseExportFormat("xml", &format));
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_ExportIngredientsBenchmark) {
+	const char* csvPath = "testexport.csv";
+	const int ingredientCount = 1000000;
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	Ingredient* head = NULL;
+	Ingredient* tail = NULL;
+	for (int i = 0; i < ingredientCount; i++) {
+		Ingredient* ingredient = (Ingredient*)allocateFromMemoryArena(&arena, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		makeSyntheticName(i, ingredient->name, sizeof(ingredient->name));
+		ingredient->price = (float)(i % 10000) / 100.0f;
+		ingredient->next = NULL;
+		if (tail == NULL) {
+			head = ingredient;
+		}
+		else {
+			tail->next = ingredient;
+		}
+		tail = ingredient;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	FILE* file = fopen(csvPath, "wb");
+	for (Ingredient* current = head; current != NULL; current = current->next) {
+		fprintf(file, "%d,%s,%.2f\n", current->id, current->name, current->price);
+	}
+	fclose(file);
+	double printfSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	ASSERT_TRUE(exportIngredients(head, csvPath, EXPORT_FORMAT_CSV));
+	double csvSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	ASSERT_TRUE(exportIngredients(head, csvPath, EXPORT_FORMAT_JSON));
+	double jsonSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("Exported %d ingredients: fprintf per row %.3f s, CSV writer %.3f s, JSON writer %.3f s\n",
+		ingredientCount, printfSeconds, csvSeconds, jsonSeconds);
+	remove(csvPath);
+	freeMemoryArena(&arena);
+}
+
+TEST_F(IngredientmanagementTest, SnapshotRoundTripTest) {
+	const char* snapshotPath = "testdeneme.snap";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato Paste", 2.5, testFilePath);
+	head = addIngredient(head, "Tomato", 1.8, testFilePath);
+	head = addIngredient(head, "Olive Oil", 12.345f, testFilePath);
+	head = addIngredient(head, "Tomatoes", -0.75f, testFilePath);
+	strcpy(head->next->next->next->name, "Tomato");
+	head->next->next->id = 40;
+	head->next->next->next->id = 7;
+
+	ASSERT_TRUE(writeIngredientSnapshot(head, snapshotPath));
+	Ingredient* loaded = readIngredientSnapshot(snapshotPath);
+
+	// Records come back in ascending ID order with exact prices
+	const int ids[] = { 1, 2, 7, 40 };
+	const char* names[] = { "Tomato Paste", "Tomato", "Tomato", "Olive Oil" };
+	const float prices[] = { 2.5f, 1.8f, -0.75f, 12.345f };
+	Ingredient* current = loaded;
+	for (int i = 0; i < 4; i++) {
+		ASSERT_NE(current, nullptr);
+		EXPECT_EQ(current->id, ids[i]);
+		EXPECT_STREQ(current->name, names[i]);
+		EXPECT_EQ(current->price, prices[i]);
+		current = current->next;
+	}
+	EXPECT_EQ(current, nullptr);
+
+	FILE* file = fopen(snapshotPath, "rb");
+	ASSERT_NE(file, nullptr);
+	IngredientSnapshotHeader header;
+	ASSERT_EQ(fread(&header, sizeof(header), 1, file), 1u);
+	fclose(file);
+	EXPECT_EQ(header.nameCount, 3u);
+	EXPECT_EQ(header.priceScale, 1000u);
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+	remove(snapshotPath);
+}
+
+static uint32_t readSnapshotPriceScale(const char* snapshotPath) {
+	IngredientSnapshotHeader header = {};
+	FILE* file = fopen(snapshotPath, "rb");
+	if (file != nullptr) {
+		if (fread(&header, sizeof(header), 1, file) != 1) {
+			header.priceScale = UINT32_MAX;
+		}
+		fclose(file);
+	}
+	return header.priceScale;
+}
+
+TEST_F(IngredientmanagementTest, SnapshotKeepsLargeAndFinePricesExactTest) {
+	const char* snapshotPath = "testdeneme.snap";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Saffron", 1.0e10f, testFilePath);
+	head = addIngredient(head, "Truffle", 2.5f, testFilePath);
+
+	// A price too large for the finest scale still fits a coarser one
+	ASSERT_TRUE(writeIngredientSnapshot(head, snapshotPath));
+	EXPECT_EQ(readSnapshotPriceScale(snapshotPath), 100u);
+	Ingredient* loaded = readIngredientSnapshot(snapshotPath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_EQ(loaded->price, 1.0e10f);
+	freeIngredients(loaded);
+
+	// Prices no decimal scale can hold are stored as raw floats instead of being rounded
+	head->next->price = 0.1234567f;
+	ASSERT_TRUE(writeIngredientSnapshot(head, snapshotPath));
+	EXPECT_EQ(readSnapshotPriceScale(snapshotPath), (uint32_t)INGREDIENT_SNAPSHOT_RAW_PRICES);
+	loaded = readIngredientSnapshot(snapshotPath);
+	ASSERT_NE(loaded, nullptr);
+	ASSERT_NE(loaded->next, nullptr);
+	EXPECT_EQ(loaded->price, 1.0e10f);
+	EXPECT_EQ(loaded->next->price, 0.1234567f);
+
+	freeIngredients(loaded);
+	freeIngredients(head);
+	remove(snapshotPath);
+}
+
+TEST_F(IngredientmanagementTest, SnapshotIsSmallerThanBinaryFileTest) {
+	const char* snapshotPath = "testdeneme.snap";
+	Ingredient* head = nullptr;
+	Ingredient* tail = nullptr;
+	for (int i = 0; i < 200; i++) {
+		Ingredient* ingredient = (Ingredient*)calloc(1, sizeof(Ingredient));
+		ingredient->id = i + 1;
+		snprintf(ingredient->name, sizeof(ingredient->name), "Organic Ingredient %03d", i);
+		ingredient->price = (float)(i % 50) + 0.25f;
+		ingredient->prev = tail;
+		if (tail == nullptr) {
+			head = ingredient;
+		}
+		else {
+			tail->next = ingredient;
+		}
+		tail = ingredient;
+	}
+
+	ASSERT_TRUE(saveIngredientsToFile(head, testFilePath));
+	ASSERT_TRUE(writeIngredientSnapshot(head, snapshotPath));
+
+	FILE* bin = fopen(testFilePath, "rb");
+	FILE* snapshot = fopen(snapshotPath, "rb");
+	ASSERT_NE(bin, nullptr);
+	ASSERT_NE(snapshot, nullptr);
+	fseek(bin, 0, SEEK_END);
+	fseek(snapshot, 0, SEEK_END);
+	EXPECT_LT(ftell(snapshot) * 4, ftell(bin));
+	fclose(bin);
+	fclose(snapshot);
+
+	Ingredient* loaded = readIngredientSnapshot(snapshotPath);
+	ASSERT_NE(loaded, nullptr);
+	EXPECT_STREQ(loaded->next->name, "Organic Ingredient 001");
+	freeIngredients(loaded);
+	freeIngredients(head);
+	remove(snapshotPath);
+}
+
+TEST_F(IngredientmanagementTest, LoadDamagedSnapshotTest) {
+	const char* snapshotPath = "testdeneme.snap";
+	Ingredient* head = nullptr;
+	head = addIngredient(head, "Tomato", 2.5, testFilePath);
+	head = addIngredient(head, "Cucumber", 1.8, testFilePath);
+	ASSERT_TRUE(writeIngredientSnapshot(head, snapshotPath));
+
+	FILE* file = fopen(snapshotPath, "rb");
+	char buffer[512];
+	size_t size = fread(buffer, 1, sizeof(buffer), file);
+	fclose(file);
+	file = fopen(snapshotPath, "wb");
+	fwrite(buffer, 1, size - 1, file);
+	fclose(file);
+
+	EXPECT_EQ(readIngredientSnapshot(snapshotPath), nullptr);
+	EXPECT_EQ(readIngredientSnapshot("missing.snap"), nullptr);
+
+	freeIngredients(head);
+	remove(snapshotPath);
+}
+
+TEST_F(IngredientmanagementTest, Crc32cMatchesKnownValuesTest) {
+	const char* digits = "123456789";
+	EXPECT_EQ(updateCrc32c(0, digits, 9), 0xE3069283u);
+	EXPECT_EQ(updateCrc32cPortable(0, digits, 9), 0xE3069283u);
+	EXPECT_EQ(updateCrc32c(0, digits, 0), 0u);
+
+	// Both implementations agree on every length and alignment, and CRCs chain across calls
+	std::vector<unsigned char> data(1000);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (unsigned char)(i * 131 + 7);
+	}
+	for (size_t offset = 0; offset < 8; offset++) {
+		for (size_t size = 0; size + offset <= data.size(); size += 37) {
+			uint32_t expected = updateCrc32cPortable(0, &data[offset], size);
+			EXPECT_EQ(updateCrc32c(0, &data[offset], size), expected);
+			EXPECT_EQ(updateCrc32c(updateCrc32c(0, &data[offset], size / 3), &data[offset + size / 3], size - size / 3), expected);
+		}
+	}
+}
+
+TEST_F(IngredientmanagementTest, DamagedIngredientBlockIsReportedTest) {
+	writeSyntheticIngredientFile(testFilePath, 600);
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_TRUE(header.flags & INGREDIENT_FILE_CHECKSUMMED);
+	EXPECT_EQ(header.blockSize, (uint32_t)INGREDIENT_FILE_BLOCK_SIZE);
+
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_GE(map.blockCount, 3u);
+	closeIngredientMap(&map);
+
+	// Flip one bit in the second block
+	size_t damagedOffset = header.headerSize + INGREDIENT_FILE_BLOCK_SIZE + 100;
+	FILE* file = fopen(testFilePath, "r+b");
+	ASSERT_NE(file, nullptr);
+	fseek(file, (long)damagedOffset, SEEK_SET);
+	int byte = fgetc(file);
+	fseek(file, (long)damagedOffset, SEEK_SET);
+	fputc(byte ^ 0x10, file);
+	fclose(file);
+
+	simulateUserInput("");
+	EXPECT_FALSE(openIngredientMap(testFilePath, &map));
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	resetStdinStdout();
+	EXPECT_EQ(loaded, nullptr);
+
+	char buffer[1024];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	char expected[128];
+	snprintf(expected, sizeof(expected), "damaged in block 1 (bytes %u to %u)",
+		header.headerSize + INGREDIENT_FILE_BLOCK_SIZE, header.headerSize + 2 * INGREDIENT_FILE_BLOCK_SIZE - 1);
+	EXPECT_NE(strstr(buffer, expected), nullptr);
+	EXPECT_EQ(strstr(buffer, "block 0"), nullptr);
+	EXPECT_EQ(strstr(buffer, "block 2 "), nullptr);
+}
+
+TEST_F(IngredientmanagementTest, IngredientCursorCountsLiveRecordsTest) {
+	writeSyntheticIngredientFile(testFilePath, 40);
+	IngredientFileHeader header;
+	ASSERT_TRUE(deleteIngredientRecordInPlace(testFilePath, 3, &header));
+	ASSERT_TRUE(deleteIngredientRecordInPlace(testFilePath, 20, &header));
+
+	IngredientCursor cursor;
+	ASSERT_TRUE(openIngredientCursor(testFilePath, &cursor));
+	EXPECT_EQ(cursor.count, 38);
+
+	// Positions skip the tombstones, so consecutive pages neither overlap nor leave gaps
+	Ingredient page[16];
+	ASSERT_EQ(readIngredientPage(&cursor, 0, page, 16), 16);
+	EXPECT_EQ(page[2].id, 4);
+	EXPECT_EQ(page[15].id, 17);
+	ASSERT_EQ(readIngredientPage(&cursor, 16, page, 16), 16);
+	EXPECT_EQ(page[0].id, 18);
+	EXPECT_EQ(page[1].id, 19);
+	EXPECT_EQ(page[2].id, 21);
+	ASSERT_EQ(readIngredientPage(&cursor, 36, page, 16), 2);
+	EXPECT_EQ(page[1].id, 40);
+	EXPECT_EQ(readIngredientPage(&cursor, 38, page, 16), 0);
+
+	// The window of a listing and its neighbours are live ingredients as well
+	Ingredient neighbours[3];
+	ASSERT_EQ(readIngredientPage(&cursor, 35, neighbours, 3), 3);
+	EXPECT_EQ(neighbours[0].id, 38);
+	simulateUserInput("");
+	bool listed = listIngredientPageXLL(&cursor, 36, 1);
+	resetStdinStdout();
+	EXPECT_TRUE(listed);
+	char buffer[4096];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	EXPECT_NE(strstr(buffer, "| 39 |"), nullptr);
+	EXPECT_EQ(strstr(buffer, "| 40 |"), nullptr);
+	char expected[128];
+	snprintf(expected, sizeof(expected), "| %-20s | %-6.2f |", neighbours[0].name, neighbours[0].price);
+	EXPECT_NE(strstr(buffer, expected), nullptr);
+	snprintf(expected, sizeof(expected), "| %-20s | %-6.2f |", neighbours[2].name, neighbours[2].price);
+	EXPECT_NE(strstr(buffer, expected), nullptr);
+	closeIngredientCursor(&cursor);
+}
+
+static void appendLoggedIngredient(const char* filePath, IngredientLogOperation operation, int id, const char* name, float price) {
+	Ingredient ingredient = {};
+	ingredient.id = id;
+	strcpy(ingredient.name, name);
+	ingredient.price = price;
+	ASSERT_TRUE(appendIngredientLog(filePath, operation, &ingredient));
+}
+
+static void expectCursorMatchesLoad(IngredientCursor* cursor, const char* filePath, int pageSize) {
+	Ingredient* loaded = loadIngredientsFromFile(filePath);
+	std::vector<Ingredient> page(pageSize);
+	int position = 0;
+	const Ingredient* expected = loaded;
+	int read;
+	while ((read = readIngredientPage(cursor, position, page.data(), pageSize)) > 0) {
+		for (int i = 0; i < read; i++, expected = expected->next) {
+			ASSERT_NE(expected, nullptr) << "position " << position + i;
+			EXPECT_EQ(page[i].id, expected->id) << "position " << position + i;
+			EXPECT_STREQ(page[i].name, expected->name) << "position " << position + i;
+			EXPECT_FLOAT_EQ(page[i].price, expected->price) << "position " << position + i;
+		}
+		position += read;
+	}
+	EXPECT_EQ(expected, nullptr);
+	EXPECT_EQ(cursor->count, position);
+	while (loaded != NULL) {
+		Ingredient* temp = loaded;
+		loaded = loaded->next;
+		free(temp);
+	}
+}
+
+TEST_F(IngredientmanagementTest, IngredientCursorMergesLogTest) {
+	writeSyntheticIngredientFile(testFilePath, 40);
+	IngredientFileHeader header;
+	ASSERT_TRUE(deleteIngredientRecordInPlace(testFilePath, 3, &header));
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_UPDATE, 10, "renamed ten", 9.0f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_REMOVE, 20, "", 0.0f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_ADD, 41, "forty one", 4.1f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_ADD, 42, "forty two", 4.2f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_REMOVE, 41, "", 0.0f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_ADD, 20, "twenty again", 2.0f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_UPDATE, 42, "forty two", 7.0f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_ADD, 5, "ignored", 1.0f);
+	appendLoggedIngredient(testFilePath, INGREDIENT_LOG_UPDATE, 3, "ignored", 1.0f);
+
+	IngredientCursor cursor;
+	ASSERT_TRUE(openIngredientCursor(testFilePath, &cursor));
+	EXPECT_EQ(cursor.count, 40);
+	expectCursorMatchesLoad(&cursor, testFilePath, 16);
+	expectCursorMatchesLoad(&cursor, testFilePath, 64);
+
+	Ingredient page[2];
+	ASSERT_EQ(readIngredientPage(&cursor, 38, page, 2), 2);
+	EXPECT_EQ(page[0].id, 42);
+	EXPECT_STREQ(page[1].name, "twenty again");
+
+	// Browsing leaves the file alone; a compaction under an open cursor keeps every position
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 9);
+	ASSERT_TRUE(compactIngredientLog(testFilePath));
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+	expectCursorMatchesLoad(&cursor, testFilePath, 16);
+	ASSERT_EQ(readIngredientPage(&cursor, 38, page, 2), 2);
+	EXPECT_EQ(page[0].id, 42);
+	EXPECT_STREQ(page[1].name, "twenty again");
+	closeIngredientCursor(&cursor);
+}
+
+TEST_F(IngredientmanagementTest, TornTombstoneIsAcceptedTest) {
+	writeSyntheticIngredientFile(testFilePath, 600);
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+
+	// A crash between the flags and the checksum of a delete leaves only the flags written
+	IngredientMap map;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	const IngredientRecord* record = findMappedIngredientById(&map, 300);
+	ASSERT_NE(record, nullptr);
+	size_t flagsOffset = (size_t)((const char*)record - (const char*)map.view.data) + offsetof(IngredientRecord, flags);
+	uint32_t flags = record->flags;
+	closeIngredientMap(&map);
+
+	uint32_t tornFlags = flags | INGREDIENT_RECORD_DELETED;
+	FILE* file = fopen(testFilePath, "r+b");
+	ASSERT_NE(file, nullptr);
+	fseek(file, (long)flagsOffset, SEEK_SET);
+	fwrite(&tornFlags, sizeof(tornFlags), 1, file);
+	fclose(file);
+
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(findMappedIngredientById(&map, 300), nullptr);
+	closeIngredientMap(&map);
+
+	// The next delete in the same block writes a checksum that covers both tombstones
+	ASSERT_TRUE(deleteIngredientRecordInPlace(testFilePath, 301, &header));
+	EXPECT_EQ(header.deletedCount, 1u);
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	EXPECT_EQ(findMappedIngredientById(&map, 301), nullptr);
+	closeIngredientMap(&map);
+	Ingredient* loaded = loadIngredientsFromFile(testFilePath);
+	int count = 0;
+	for (Ingredient* current = loaded; current != nullptr; current = current->next) {
+		count++;
+	}
+	EXPECT_EQ(count, 598);
+	freeIngredients(loaded);
+
+	// Any other flag bit is still damage
+	uint32_t damagedFlags = flags | 0x4u;
+	ASSERT_TRUE(openIngredientMap(testFilePath, &map));
+	record = findMappedIngredientById(&map, 302);
+	ASSERT_NE(record, nullptr);
+	flagsOffset = (size_t)((const char*)record - (const char*)map.view.data) + offsetof(IngredientRecord, flags);
+	closeIngredientMap(&map);
+	file = fopen(testFilePath, "r+b");
+	ASSERT_NE(file, nullptr);
+	fseek(file, (long)flagsOffset, SEEK_SET);
+	fwrite(&damagedFlags, sizeof(damagedFlags), 1, file);
+	fclose(file);
+	simulateUserInput("");
+	EXPECT_FALSE(openIngredientMap(testFilePath, &map));
+	resetStdinStdout();
+}
+
+TEST_F(IngredientmanagementTest, CompactionLeavesDamagedFileAloneTest) {
+	writeSyntheticIngredientFile(testFilePath, 600);
+	Ingredient added = {};
+	added.id = 601;
+	strcpy(added.name, "late arrival");
+	added.price = 1.5f;
+	ASSERT_TRUE(appendIngredientLog(testFilePath, INGREDIENT_LOG_ADD, &added));
+	IngredientFileHeader header;
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+
+	// A damaged block, a damaged file header and a damaged log header each stop the compaction
+	const size_t damagedOffsets[] = { header.headerSize + INGREDIENT_FILE_BLOCK_SIZE + 100, 0 };
+	for (size_t damagedOffset : damagedOffsets) {
+		SCOPED_TRACE(damagedOffset);
+		std::string intact = readWholeFile(testFilePath);
+		FILE* file = fopen(testFilePath, "r+b");
+		ASSERT_NE(file, nullptr);
+		fseek(file, (long)damagedOffset, SEEK_SET);
+		fputc(intact[damagedOffset] ^ 0x10, file);
+		fclose(file);
+		std::string damaged = readWholeFile(testFilePath);
+
+		simulateUserInput("");
+		EXPECT_FALSE(compactIngredientLog(testFilePath));
+		resetStdinStdout();
+		EXPECT_EQ(readWholeFile(testFilePath), damaged);
+		EXPECT_EQ(getIngredientLogLength(testFilePath), 1);
+
+		file = fopen(testFilePath, "wb");
+		ASSERT_NE(file, nullptr);
+		fwrite(intact.data(), 1, intact.size(), file);
+		fclose(file);
+	}
+
+	std::string log = readWholeFile(testLogPath);
+	FILE* file = fopen(testLogPath, "r+b");
+	ASSERT_NE(file, nullptr);
+	fputc(log[0] ^ 0x10, file);
+	fclose(file);
+	std::string intact = readWholeFile(testFilePath);
+	EXPECT_FALSE(compactIngredientLog(testFilePath));
+	EXPECT_EQ(readWholeFile(testFilePath), intact);
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 1);
+
+	// Once the log is repaired the compaction goes through
+	file = fopen(testLogPath, "r+b");
+	ASSERT_NE(file, nullptr);
+	fputc(log[0], file);
+	fclose(file);
+	EXPECT_TRUE(compactIngredientLog(testFilePath));
+	EXPECT_EQ(getIngredientLogLength(testFilePath), 0);
+	ASSERT_TRUE(readIngredientFileHeader(testFilePath, &header));
+	EXPECT_EQ(header.recordCount, 601u);
+}
+
+TEST_F(IngredientmanagementTest, DISABLED_ChecksumVerificationBenchmark) {
+	const int ingredientCount = 4000000;
+	writeSyntheticIngredientFile(testFilePath, ingredientCount);
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Ingredient* loaded = loadIngredientsFromFileInArena(testFilePath, &arena);
+	double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	EXPECT_NE(loaded, nullptr);
+	freeMemoryArena(&arena);
+
+	IngredientStorageView view;
+	ASSERT_TRUE(openIngredientStorageView(testFilePath, &view));
+	size_t fileSize = view.size;
+	std::vector<uint32_t> checksums(fileSize / INGREDIENT_FILE_BLOCK_SIZE + 1);
+	start = std::chrono::steady_clock::now();
+	computeCrc32cBlocks(view.data, fileSize, INGREDIENT_FILE_BLOCK_SIZE, checksums.data());
+	double hardwareSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	start = std::chrono::steady_clock::now();
+	uint32_t portable = 0;
+	for (size_t offset = 0; offset < fileSize; offset += INGREDIENT_FILE_BLOCK_SIZE) {
+		size_t length = fileSize - offset < INGREDIENT_FILE_BLOCK_SIZE ? fileSize - offset : INGREDIENT_FILE_BLOCK_SIZE;
+		portable ^= updateCrc32cPortable(0, (const char*)view.data + offset, length);
+	}
+	double portableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	EXPECT_NE(checksums[0], 0u);
+	EXPECT_NE(portable, 0u);
+	closeIngredientStorageView(&view);
+
+	printf("Loaded %d ingredients in %.3f s; block checksums of %zu bytes: %s %.3f s (%.1f%%), slicing-by-8 %.3f s (%.1f%%)\n",
+		ingredientCount, loadSeconds, fileSize, hasHardwareCrc32c() ? "SSE4.2" : "tables", hardwareSeconds,
+		100.0 * hardwareSeconds / loadSeconds, portableSeconds, 100.0 * portableSeconds / loadSeconds);
+}
+
 /**
  * @brief The main function of the test program.
  *
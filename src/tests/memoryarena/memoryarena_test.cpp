@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include "../../memoryarena/header/memoryarena.h"
+#include <stdint.h>
+#include <string.h>
+
+class MemoryarenaTest : public ::testing::Test {
+protected:
+	MemoryArena arena;
+
+	void SetUp() override {
+		initMemoryArena(&arena, 256);
+	}
+
+	void TearDown() override {
+		freeMemoryArena(&arena);
+	}
+};
+
+TEST_F(MemoryarenaTest, AllocationsAreAlignedAndDistinctTest) {
+	char* first = (char*)allocateFromMemoryArena(&arena, 3);
+	char* second = (char*)allocateFromMemoryArena(&arena, 20);
+	ASSERT_NE(first, nullptr);
+	ASSERT_NE(second, nullptr);
+	EXPECT_EQ((uintptr_t)first % MEMORY_ARENA_ALIGNMENT, 0u);
+	EXPECT_EQ((uintptr_t)second % MEMORY_ARENA_ALIGNMENT, 0u);
+	EXPECT_GE(second - first, 16);
+
+	memset(first, 'a', 3);
+	memset(second, 'b', 20);
+	EXPECT_EQ(first[2], 'a');
+	EXPECT_EQ(second[0], 'b');
+}
+
+TEST_F(MemoryarenaTest, BlocksAreSharedByManyAllocationsTest) {
+	for (int i = 0; i < 64; i++) {
+		ASSERT_NE(allocateFromMemoryArena(&arena, 16), nullptr);
+	}
+	EXPECT_EQ(arena.allocationCount, 64u);
+	EXPECT_EQ(arena.blockCount, 4u);
+}
+
+TEST_F(MemoryarenaTest, OversizedAllocationGetsOwnBlockTest) {
+	char* small = (char*)allocateFromMemoryArena(&arena, 16);
+	char* large = (char*)allocateFromMemoryArena(&arena, 1000);
+	char* next = (char*)allocateFromMemoryArena(&arena, 16);
+	ASSERT_NE(large, nullptr);
+	memset(large, 'x', 1000);
+	EXPECT_EQ(arena.blockCount, 2u);
+
+	// The current block keeps being filled after the oversized request
+	EXPECT_EQ(next, small + 16);
+}
+
+TEST_F(MemoryarenaTest, ResetKeepsCurrentBlockTest) {
+	char* first = (char*)allocateFromMemoryArena(&arena, 200);
+	allocateFromMemoryArena(&arena, 200);
+	EXPECT_EQ(arena.blockCount, 2u);
+
+	resetMemoryArena(&arena);
+	EXPECT_EQ(arena.allocationCount, 0u);
+	EXPECT_EQ(arena.blockCount, 1u);
+	char* again = (char*)allocateFromMemoryArena(&arena, 200);
+	ASSERT_NE(again, nullptr);
+	EXPECT_NE(again, first);
+	EXPECT_EQ(arena.allocationCount, 1u);
+	EXPECT_EQ(arena.blockCount, 1u);
+}
+
+TEST_F(MemoryarenaTest, FreeLeavesArenaReusableTest) {
+	allocateFromMemoryArena(&arena, 100);
+	freeMemoryArena(&arena);
+	EXPECT_EQ(arena.blocks, nullptr);
+	EXPECT_EQ(arena.allocationCount, 0u);
+	EXPECT_EQ(arena.blockCount, 0u);
+	EXPECT_NE(allocateFromMemoryArena(&arena, 100), nullptr);
+	EXPECT_EQ(arena.blockCount, 1u);
+}
+
+TEST_F(MemoryarenaTest, MergeMovesBlocksBehindCurrentBlockTest) {
+	char* small = (char*)allocateFromMemoryArena(&arena, 16);
+
+	MemoryArena other;
+	initMemoryArena(&other, 256);
+	char* moved = (char*)allocateFromMemoryArena(&other, 200);
+	allocateFromMemoryArena(&other, 200);
+	memset(moved, 'm', 200);
+
+	mergeMemoryArena(&arena, &other);
+	EXPECT_EQ(other.blocks, nullptr);
+	EXPECT_EQ(other.blockCount, 0u);
+	EXPECT_EQ(arena.blockCount, 3u);
+	EXPECT_EQ(arena.allocationCount, 3u);
+	EXPECT_EQ(moved[199], 'm');
+
+	// The current block keeps being filled after the merge
+	EXPECT_EQ((char*)allocateFromMemoryArena(&arena, 16), small + 16);
+
+	mergeMemoryArena(&other, &arena);
+	EXPECT_EQ(arena.blocks, nullptr);
+	EXPECT_EQ(other.blockCount, 3u);
+	freeMemoryArena(&other);
+}
+
+TEST_F(MemoryarenaTest, ArenaNodeFallsBackToHeapTest) {
+	void* heapNode = allocateArenaNode(NULL, 32);
+	ASSERT_NE(heapNode, nullptr);
+	releaseArenaNode(NULL, heapNode);
+
+	void* arenaNode = allocateArenaNode(&arena, 32);
+	ASSERT_NE(arenaNode, nullptr);
+	EXPECT_EQ(arena.allocationCount, 1u);
+	releaseArenaNode(&arena, arenaNode);
+	EXPECT_EQ(arena.allocationCount, 1u);
+}
+
+/**
+ * @brief The main function of the test program.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @return int The exit status of the program.
+ */
+int main(int argc, char** argv) {
+#ifdef ENABLE_MEMORYARENA_TEST
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+#else
+	return 0;
+#endif
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "../../priceadjustment/header/priceadjustment.h"  // Adjust this include path based on your project structure
+#include "../../ingredientmanagement/header/ingredientlog.h"
 extern User loggedUser;
 
 class PriceadjustmentTest : public ::testing::Test {
@@ -210,6 +211,77 @@ TEST_F(PriceadjustmentTest, ResetPriceSuccess) {
 
 	EXPECT_EQ(result, 1);
 }
+TEST_F(PriceadjustmentTest, PrintIngredientsInDescendingPriceOrder) {
+	createIngredients();
+	simulateUserInput("\n");
+	int count = PrintIngredientsToConsole(testPathFileIngrednients);
+	resetStdinStdout();
+
+	EXPECT_EQ(count, 5);
+	char buffer[4096];
+	readOutput(outputTest, buffer, sizeof(buffer));
+	const char* fifth = strstr(buffer, "Ingredient5");
+	const char* third = strstr(buffer, "Ingredient3");
+	const char* first = strstr(buffer, "Ingredient1");
+	ASSERT_NE(fifth, nullptr);
+	ASSERT_NE(third, nullptr);
+	ASSERT_NE(first, nullptr);
+	EXPECT_LT(fifth, third);
+	EXPECT_LT(third, first);
+}
+TEST_F(PriceadjustmentTest, ResetPriceMovesIngredientToCheapest) {
+	createIngredients();
+	simulateUserInput("4\n\n");
+	int result = resetIngredientPrice(testPathFileIngrednients);
+	resetStdinStdout();
+	EXPECT_EQ(result, 1);
+
+	Ingredient* ingredients;
+	simulateUserInput("\n");
+	int count = ConvertDoubleLinkToArray(testPathFileIngrednients, &ingredients);
+	resetStdinStdout();
+	ASSERT_EQ(count, 5);
+	EXPECT_FLOAT_EQ(ingredients[3].price, 0.0f);
+	EXPECT_FLOAT_EQ(ingredients[4].price, 5.0f);
+	free(ingredients);
+}
+TEST_F(PriceadjustmentTest, AdjustPriceKeepsLoggedIngredients) {
+	// The first ingredient rewrites the file, the other two only reach the log
+	Ingredient* head = NULL;
+	head = addIngredient(head, "Tomato", 1.0, testPathFileIngrednients);
+	head = addIngredient(head, "Cucumber", 2.0, testPathFileIngrednients);
+	head = addIngredient(head, "Onion", 3.0, testPathFileIngrednients);
+	ASSERT_EQ(getIngredientLogLength(testPathFileIngrednients), 2);
+
+	simulateUserInput("1\n1\n9\n\n");
+	int result = adjustIngredientPrice(testPathFileIngrednients);
+	resetStdinStdout();
+	EXPECT_EQ(result, 1);
+
+	Ingredient* loaded = loadIngredientsFromFile(testPathFileIngrednients);
+	const char* names[] = { "Tomato", "Cucumber", "Onion" };
+	const float prices[] = { 9.0f, 2.0f, 3.0f };
+	Ingredient* current = loaded;
+	for (int i = 0; i < 3; i++) {
+		ASSERT_NE(current, nullptr);
+		EXPECT_STREQ(current->name, names[i]);
+		EXPECT_FLOAT_EQ(current->price, prices[i]);
+		current = current->next;
+	}
+	EXPECT_EQ(current, nullptr);
+
+	while (loaded != NULL) {
+		Ingredient* next = loaded->next;
+		free(loaded);
+		loaded = next;
+	}
+	while (head != NULL) {
+		Ingredient* next = head->next;
+		free(head);
+		head = next;
+	}
+	std::remove("test_ingredients.bin" INGREDIENT_LOG_SUFFIX);
+}
 TEST_F(PriceadjustmentTest, ConvertDoubleLinkToArray_NoIngredients) {
 	// Arrange
 	Ingredient* ingredients;
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "../header/recipecosting.h"  
+#include "../header/recipeexport.h"
 #include "../header/ingredientmanagement.h" 
 #include "../header/userauthentication.h"
 #include <cstdio>  
@@ -134,6 +135,57 @@ TEST_F(RecipeCostingTest, CreateRecipe_DuplicateIngredientIds) {
 	EXPECT_EQ(result, 1);
 }
 
+TEST_F(RecipeCostingTest, CreateRecipe_SelectIngredientsByName) {
+	const char* inputSequence = "Test Recipe\n1\ningr\ningredient3\nIngredient5\nsalt\ndone\n\n\n\n";
+	simulateUserInput(inputSequence);
+
+	int result = createRecipe(testPathFileIngredients, testPathFileRecipes);
+	resetStdinStdout();
+
+	EXPECT_EQ(result, 1);
+	Recipe recipes[MAX_RECIPES];
+	int recipeCount = loadRecipesFromFile(testPathFileRecipes, recipes, MAX_RECIPES);
+	ASSERT_EQ(recipeCount, 3);
+	ASSERT_EQ(recipes[2].ingredientCount, 2);
+	EXPECT_EQ(recipes[2].ingredients[0], 3);
+	EXPECT_EQ(recipes[2].ingredients[1], 5);
+}
+
+TEST_F(RecipeCostingTest, ExportRecipes_CsvAndJson) {
+	const char* exportPath = "testrecipes.export";
+	Recipe recipes[MAX_RECIPES];
+	int recipeCount = loadRecipesFromFile(testPathFileRecipes, recipes, MAX_RECIPES);
+	strcpy(recipes[recipeCount].name, "Salad, \"Green\"");
+	recipes[recipeCount].category = 2;
+	recipes[recipeCount].ingredientCount = 2;
+	recipes[recipeCount].ingredients[0] = 5;
+	recipes[recipeCount].ingredients[1] = 99;
+	saveRecipesToFile(testPathFileRecipes, recipes, recipeCount + 1);
+
+	char buffer[1024];
+	ASSERT_TRUE(exportRecipes(testPathFileRecipes, testPathFileIngredients, exportPath, EXPORT_FORMAT_CSV));
+	FILE* file = fopen(exportPath, "rb");
+	ASSERT_NE(file, nullptr);
+	size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+	buffer[length] = '\0';
+	EXPECT_STREQ(buffer, "id,name,category,ingredient_ids,cost,missing_ingredients\n"
+		"1,Recipe1,Soup,1;2,3.00,0\n"
+		"2,Recipe2,Appetizer,3;4,7.00,0\n"
+		"3,\"Salad, \"\"Green\"\"\",Appetizer,5;99,5.00,1\n");
+
+	ASSERT_TRUE(exportRecipes(testPathFileRecipes, testPathFileIngredients, exportPath, EXPORT_FORMAT_JSON));
+	file = fopen(exportPath, "rb");
+	ASSERT_NE(file, nullptr);
+	length = fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+	buffer[length] = '\0';
+	EXPECT_EQ(buffer[0], '[');
+	EXPECT_NE(strstr(buffer, "{\"id\":1,\"name\":\"Recipe1\",\"category\":\"Soup\",\"ingredients\":[1,2],\"cost\":3.00,\"missingIngredients\":0}"), nullptr);
+	EXPECT_NE(strstr(buffer, "\"name\":\"Salad, \\\"Green\\\"\""), nullptr);
+	remove(exportPath);
+}
+
 TEST_F(RecipeCostingTest, EditRecipe_Success) {
 	const char* inputSequence = "1\n1\nNew Recipe Name\n\n\n\n";
 	simulateUserInput(inputSequence);
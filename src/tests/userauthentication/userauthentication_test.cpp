@@ -280,6 +280,49 @@ TEST_F(UserauthenticationTest, mainMenuViewUserTest) {
 	EXPECT_EQ(result, 0);
 }
 
+TEST_F(UserauthenticationTest, LoadUsersIntoXORListInArenaTest) {
+	FILE* file = fopen(pathFileUsers, "wb");
+	ASSERT_NE(file, nullptr);
+	int userCount = 3;
+	fwrite(&userCount, sizeof(int), 1, file);
+	for (int i = 1; i <= userCount; i++) {
+		User user = {};
+		user.id = i;
+		snprintf(user.name, sizeof(user.name), "User%d", i);
+		fwrite(&user, sizeof(User), 1, file);
+	}
+	fclose(file);
+
+	MemoryArena arena;
+	initMemoryArena(&arena, 0);
+	XORNode* head = loadUsersIntoXORListInArena(pathFileUsers, &arena);
+	ASSERT_NE(head, nullptr);
+	EXPECT_EQ(arena.allocationCount, 3u);
+	EXPECT_EQ(arena.blockCount, 1u);
+
+	// Walk forward through the XOR links
+	XORNode* prev = NULL;
+	XORNode* current = head;
+	int expectedId = 1;
+	while (current != NULL) {
+		EXPECT_EQ(current->user.id, expectedId++);
+		XORNode* next = (XORNode*)((uintptr_t)prev ^ (uintptr_t)current->xorPtr);
+		prev = current;
+		current = next;
+	}
+	EXPECT_EQ(expectedId, 4);
+
+	freeMemoryArena(&arena);
+
+	// The heap-based loader builds the same list
+	head = loadUsersIntoXORList(pathFileUsers);
+	ASSERT_NE(head, nullptr);
+	XORNode* second = head->xorPtr;
+	ASSERT_NE(second, nullptr);
+	EXPECT_EQ(second->user.id, 2);
+	freeXORList(head);
+}
+
 /**
  * @brief The main function of the test program.
  *
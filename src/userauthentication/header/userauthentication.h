@@ -6,6 +6,7 @@
 #ifndef USERAUTHENTICATION_H
 #define USERAUTHENTICATION_H
 
+#include "../../memoryarena/header/memoryarena.h"
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -27,9 +28,12 @@ typedef struct XORNode {
 
 // Xor
 XORNode* createXORNode(User user);
+XORNode* createXORNodeInArena(MemoryArena* arena, User user);
 XORNode* insertXORNode(XORNode* head, User user);
+XORNode* insertXORNodeInArena(XORNode* head, User user, MemoryArena* arena);
 void viewUsers(const XORNode* head);
 XORNode* loadUsersIntoXORList(const char* pathFileUsers);
+XORNode* loadUsersIntoXORListInArena(const char* pathFileUsers, MemoryArena* arena);
 void freeXORList(XORNode* head);
 
 // Tools
@@ -32,7 +32,18 @@ User loggedUser;
  * @return Pointer to the newly created XOR node.
  */
 XORNode* createXORNode(User user) {
-	XORNode* newNode = (XORNode*)malloc(sizeof(XORNode));
+	return createXORNodeInArena(NULL, user);
+}
+
+/**
+ * @brief Creates a new XOR node with the given user data in an arena.
+ *
+ * @param arena Arena to allocate the node from, or NULL to allocate it with malloc.
+ * @param user User data to store in the node.
+ * @return Pointer to the newly created XOR node.
+ */
+XORNode* createXORNodeInArena(MemoryArena* arena, User user) {
+	XORNode* newNode = (XORNode*)allocateArenaNode(arena, sizeof(XORNode));
 	if (!newNode) {
 		printf("Memory allocation failed.\n");
 		exit(EXIT_FAILURE);
@@ -50,7 +61,19 @@ XORNode* createXORNode(User user) {
  * @return Pointer to the updated head of the XOR list.
  */
 XORNode* insertXORNode(XORNode* head, User user) {
-	XORNode* newNode = createXORNode(user);
+	return insertXORNodeInArena(head, user, NULL);
+}
+
+/**
+ * @brief Inserts a user into an XOR doubly linked list whose nodes live in an arena.
+ *
+ * @param head Pointer to the head of the XOR list.
+ * @param user User data to insert.
+ * @param arena Arena to allocate the node from, or NULL to allocate it with malloc.
+ * @return Pointer to the updated head of the XOR list.
+ */
+XORNode* insertXORNodeInArena(XORNode* head, User user, MemoryArena* arena) {
+	XORNode* newNode = createXORNodeInArena(arena, user);
 	if (!head) {
 		return newNode; 
 	}
@@ -151,6 +174,19 @@ void viewUsers(const XORNode* head) {
  * @return Pointer to the head of the XOR list.
  */
 XORNode* loadUsersIntoXORList(const char* pathFileUsers) {
+	return loadUsersIntoXORListInArena(pathFileUsers, NULL);
+}
+
+/**
+ * @brief Loads users from a file into an XOR doubly linked list whose nodes live in an arena.
+ *
+ * Users are appended at the remembered tail, so loading n users takes O(n) time.
+ *
+ * @param pathFileUsers Path to the file containing user data.
+ * @param arena Arena to allocate the nodes from, or NULL to allocate each node with malloc.
+ * @return Pointer to the head of the XOR list.
+ */
+XORNode* loadUsersIntoXORListInArena(const char* pathFileUsers, MemoryArena* arena) {
 	FILE* file = fopen(pathFileUsers, "rb");
 	if (!file) {
 		printf("Failed to open user file.\n");
@@ -161,11 +197,21 @@ XORNode* loadUsersIntoXORList(const char* pathFileUsers) {
 	fread(&userCount, sizeof(int), 1, file);
 
 	XORNode* head = NULL;
+	XORNode* tail = NULL;
 	User tempUser;
 
 	for (int i = 0; i < userCount; ++i) {
 		fread(&tempUser, sizeof(User), 1, file);
-		head = insertXORNode(head, tempUser);
+		XORNode* newNode = createXORNodeInArena(arena, tempUser);
+		if (!head) {
+			head = newNode;
+		}
+		else {
+			// The tail's link only holds its predecessor, so folding in the new node makes it the next one
+			tail->xorPtr = (XORNode*)((uintptr_t)tail->xorPtr ^ (uintptr_t)newNode);
+			newNode->xorPtr = tail;
+		}
+		tail = newNode;
 	}
 
 	fclose(file);
@@ -567,6 +613,7 @@ int userOperations(const char* pathFileIngredients, const char* pathFileRecipes)
 int mainMenu(const char* pathFileUsers, const char* pathFileIngredients, const char* pathFileRecipes) {
 	int choice;
 	XORNode* userList = NULL; 
+	MemoryArena userArena;
 
 	while (1) {
 		clearScreen();
@@ -602,16 +649,17 @@ int mainMenu(const char* pathFileUsers, const char* pathFileIngredients, const c
 
 		case 5:
 			clearScreen();
-			userList = loadUsersIntoXORList(pathFileUsers);
+			initMemoryArena(&userArena, 0);
+			userList = loadUsersIntoXORListInArena(pathFileUsers, &userArena);
 			if (!userList) {
 				printf("No users found to display.\n");
 				enterToContinue();
 			}
 			else {
 				viewUsers(userList);
-				freeXORList(userList);
 				userList = NULL;
 			}
+			freeMemoryArena(&userArena);
 			break;
 
 		default: